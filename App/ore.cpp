@@ -66,18 +66,29 @@ int main(int argc, char** argv) {
         exit(0);
     }
 
-    if (argc != 2) {
-        std::cout << endl << "usage: ORE path/to/ore.xml" << endl << endl;
+    // resident service mode, reading requests from stdin, see OREApp::serve()
+    bool service = argc == 3 && string(argv[1]) == "--service";
+
+    if (argc != 2 && !service) {
+        std::cout << endl << "usage: ORE path/to/ore.xml" << endl;
+        std::cout << "       ORE --service path/to/ore.xml" << endl << endl;
         return -1;
     }
 
     ore::data::initBuilders();
 
-    string inputFile(argv[1]);
+    string inputFile(argv[service ? 2 : 1]);
 
     try {
         auto params = boost::make_shared<Parameters>();
         params->fromFile(inputFile);
+        if (service) {
+            // stdout is used for the responses, so no console output here
+            OREApp ore(params, false);
+            ore.startService();
+            ore.serve(std::cin, std::cout);
+            return 0;
+        }
         OREApp ore(params, true);
         ore.run();
         return 0;
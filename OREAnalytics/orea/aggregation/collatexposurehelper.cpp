@@ -19,6 +19,10 @@
 #include <orea/aggregation/collatexposurehelper.hpp>
 #include <ql/errors.hpp>
 
+#include <boost/make_shared.hpp>
+
+#include <map>
+
 using namespace std;
 using namespace QuantLib;
 
@@ -248,5 +252,172 @@ boost::shared_ptr<vector<boost::shared_ptr<CollateralAccount>>> CollateralExposu
         QL_FAIL("CollateralExposureHelper - unknown error when generating collateralBalancePaths");
     }
 }
+
+namespace {
+// position of a simulation date on the date grid, consistent with estimateUncollatValue(), the value at the simulation
+// date is npv1 + (npv2 - npv1) * weight with npv1, npv2 the values at pos1, pos2, a null position refers to t0
+struct GridPosition {
+    Size pos1, pos2;
+    Real weight;
+};
+
+GridPosition gridPosition(const Date& simulationDate, const Date& date_t0, const vector<Date>& dateGrid) {
+    QL_REQUIRE(simulationDate >= date_t0, "CollatExposureHelper error: simulation date < start date");
+    QL_REQUIRE(dateGrid[0] >= date_t0, "CollatExposureHelper error: cube dateGrid starts before t0");
+    if (simulationDate >= dateGrid.back())
+        return {dateGrid.size() - 1, dateGrid.size() - 1, 0.0};
+    if (simulationDate == date_t0)
+        return {Null<Size>(), Null<Size>(), 0.0};
+    Size pos2 = std::lower_bound(dateGrid.begin(), dateGrid.end(), simulationDate) - dateGrid.begin();
+#ifdef FLAT_INTERPOLATION
+    return {pos2, pos2, 0.0};
+#else
+    if (dateGrid[pos2] == simulationDate)
+        return {pos2, pos2, 0.0};
+    Date t1 = pos2 == 0 ? date_t0 : dateGrid[pos2 - 1];
+    return {pos2 == 0 ? Null<Size>() : pos2 - 1, pos2,
+            double(simulationDate - t1) / double(dateGrid[pos2] - t1)};
+#endif
+}
+
+void estimateValues(const GridPosition& p, const Real& value_t0, const vector<vector<Real>>& values,
+                    vector<Real>& result) {
+    if (p.pos2 == Null<Size>()) {
+        std::fill(result.begin(), result.end(), value_t0);
+    } else if (p.pos1 == p.pos2) {
+        std::copy(values[p.pos2].begin(), values[p.pos2].end(), result.begin());
+    } else {
+        for (Size k = 0; k < result.size(); ++k) {
+            Real npv1 = p.pos1 == Null<Size>() ? value_t0 : values[p.pos1][k];
+            result[k] = npv1 + (values[p.pos2][k] - npv1) * p.weight;
+        }
+    }
+}
+} // namespace
+
+vector<vector<Real>> CollateralExposureHelper::collateralBalances(
+    const boost::shared_ptr<NettingSetDefinition>& csaDef, const Real& nettingSetPv, const Date& date_t0,
+    const vector<vector<Real>>& nettingSetValues, const Date& nettingSet_maturity, const vector<Date>& dateGrid,
+    const Real& csaFxTodayRate, const vector<vector<Real>>& csaFxScenarioRates, const Real& csaTodayCollatCurve,
+    const vector<vector<Real>>& csaScenCollatCurves, const CalculationType& calcType) {
+
+    const boost::shared_ptr<CSA>& csa = csaDef->csaDetails();
+    const Real ia = csa->independentAmountHeld(), thresholdRcv = csa->thresholdRcv(),
+               thresholdPay = csa->thresholdPay(), mtaRcv = csa->mtaRcv(), mtaPay = csa->mtaPay(),
+               spreadRcv = csa->collatSpreadRcv(), spreadPay = csa->collatSpreadPay();
+
+    // the same t0 balance and margin call settlement lags as in collateralBalancePaths() and updateMarginCall()
+
+    Real bal_t0 = marginRequirementCalc(boost::make_shared<CollateralAccount>(csaDef, date_t0), nettingSetPv, date_t0);
+    Period lag = calcType == NoLag ? 0 * Days : csa->marginPeriodOfRisk();
+    Period lagUs = calcType == AsymmetricDVA ? 0 * Days : lag;
+    Period lagCtp = calcType == AsymmetricCVA ? 0 * Days : lag;
+
+    Size numScenarios = nettingSetValues.front().size();
+    QL_REQUIRE(numScenarios == csaFxScenarioRates.front().size(), "netting values -v- scenario FX rate mismatch");
+    Date simEndDate = std::min(nettingSet_maturity, dateGrid.back()) + csa->marginPeriodOfRisk();
+
+    // scenario balances and the date up to which they are accrued
+
+    vector<Real> balance(numScenarios, bal_t0);
+    vector<Date> balanceDate(numScenarios, date_t0);
+    vector<Real> uncollatVal(numScenarios), fxValue(numScenarios), annualisedZeroRate(numScenarios);
+    vector<Real> outstanding(numScenarios), marginUs(numScenarios), marginCtp(numScenarios);
+
+    // open margin calls by pay date, a zero amount means that there is no margin call in the scenario
+    std::multimap<Date, vector<Real>> marginCalls;
+
+    auto accrue = [&balance, &balanceDate, &annualisedZeroRate, spreadRcv, spreadPay](const Size k, const Date& d) {
+        if (d > balanceDate[k]) {
+            int accrualDays = d - balanceDate[k];
+            Real accrualRate = balance[k] >= 0.0 ? (annualisedZeroRate[k] - spreadRcv)
+                                                 : (annualisedZeroRate[k] - spreadPay);
+            balance[k] *= std::pow(1.0 + accrualRate / 365.0, accrualDays);
+            balanceDate[k] = d;
+        }
+    };
+
+    // the balance as of a grid date is the balance as of the last account update on or before that date
+
+    vector<vector<Real>> result(dateGrid.size(), vector<Real>(numScenarios, 0.0));
+    Size nextGridDate = 0;
+    auto recordBefore = [&dateGrid, &nextGridDate, &result, &balance](const Date& d) {
+        for (; nextGridDate < dateGrid.size() && dateGrid[nextGridDate] < d; ++nextGridDate)
+            result[nextGridDate] = balance;
+    };
+
+    Date tmpDate = date_t0;
+    Date nextMarginReqDateUs = date_t0;
+    Date nextMarginReqDateCtp = date_t0;
+    while (tmpDate <= simEndDate) {
+        bool eligMarginReqDateUs = tmpDate == nextMarginReqDateUs;
+        bool eligMarginReqDateCtp = tmpDate == nextMarginReqDateCtp;
+
+        GridPosition p = gridPosition(tmpDate, date_t0, dateGrid);
+        estimateValues(p, nettingSetPv, nettingSetValues, uncollatVal);
+        estimateValues(p, csaFxTodayRate, csaFxScenarioRates, fxValue);
+        estimateValues(p, csaTodayCollatCurve, csaScenCollatCurves, annualisedZeroRate);
+
+        // settle the margin calls due in the order of their pay dates and bring the balances up to the simulation date
+
+        while (!marginCalls.empty() && marginCalls.begin()->first <= tmpDate) {
+            const Date& payDate = marginCalls.begin()->first;
+            const vector<Real>& amount = marginCalls.begin()->second;
+            recordBefore(payDate);
+            for (Size k = 0; k < numScenarios; ++k) {
+                if (amount[k] != 0.0) {
+                    accrue(k, payDate);
+                    balance[k] += amount[k];
+                }
+            }
+            marginCalls.erase(marginCalls.begin());
+        }
+        recordBefore(tmpDate);
+        for (Size k = 0; k < numScenarios; ++k)
+            accrue(k, tmpDate);
+
+        // margin requirement given the outstanding margin calls, see marginRequirementCalc()
+
+        std::fill(outstanding.begin(), outstanding.end(), 0.0);
+        for (auto const& m : marginCalls) {
+            for (Size k = 0; k < numScenarios; ++k)
+                outstanding[k] += m.second[k];
+        }
+        bool hasMarginUs = false, hasMarginCtp = false;
+        for (Size k = 0; k < numScenarios; ++k) {
+            Real value = uncollatVal[k] / fxValue[k];
+            Real csaAmount =
+                value - ia >= 0 ? max(value - ia - thresholdRcv, 0.0) : min(value - ia + thresholdPay, 0.0);
+            Real collatShortfall = csaAmount - balance[k] - outstanding[k];
+            Real mta = collatShortfall >= 0.0 ? mtaRcv : mtaPay;
+            Real margin = fabs(collatShortfall) >= mta ? collatShortfall : 0.0;
+            marginUs[k] = margin > 0.0 && eligMarginReqDateUs ? margin : 0.0;
+            marginCtp[k] = margin < 0.0 && eligMarginReqDateCtp ? margin : 0.0;
+            hasMarginUs = hasMarginUs || marginUs[k] != 0.0;
+            hasMarginCtp = hasMarginCtp || marginCtp[k] != 0.0;
+        }
+        if (hasMarginUs && hasMarginCtp && lagUs == lagCtp) {
+            for (Size k = 0; k < numScenarios; ++k)
+                marginUs[k] += marginCtp[k];
+            marginCalls.emplace(tmpDate + lagUs, marginUs);
+        } else {
+            if (hasMarginUs)
+                marginCalls.emplace(tmpDate + lagUs, marginUs);
+            if (hasMarginCtp)
+                marginCalls.emplace(tmpDate + lagCtp, marginCtp);
+        }
+
+        if (nextMarginReqDateUs == tmpDate)
+            nextMarginReqDateUs = tmpDate + csa->marginCallFrequency();
+        if (nextMarginReqDateCtp == tmpDate)
+            nextMarginReqDateCtp = tmpDate + csa->marginPostFrequency();
+        tmpDate = std::min(nextMarginReqDateUs, nextMarginReqDateCtp);
+    }
+
+    // the account is closed after the maturity of the portfolio, i.e. the remaining balances are zero
+    recordBefore(simEndDate + Period(1, Days));
+
+    return result;
+}
 } // namespace analytics
 } // namespace ore
@@ -108,6 +108,20 @@ public:
         const vector<vector<Real>>& nettingSetValues, const Date& nettingSet_maturity, const vector<Date>& dateGrid,
         const Real& csaFxTodayRate, const vector<vector<Real>>& csaFxScenarioRates, const Real& csaTodayCollatCurve,
         const vector<vector<Real>>& csaScenCollatCurves, const CalculationType& calcType = Symmetric);
+
+    /*!
+      Path-vectorised version of collateralBalancePaths(), returns the collateral
+      balances as of the dateGrid dates by date and scenario, i.e. the values
+      accountBalance(dateGrid[j]) of the scenario collateral accounts.
+
+      All scenarios are processed per margin date in one pass, the balances and
+      the outstanding margin calls are held as arrays over the scenarios.
+    */
+    static vector<vector<Real>> collateralBalances(
+        const boost::shared_ptr<NettingSetDefinition>& csaDef, const Real& nettingSetPv, const Date& date_t0,
+        const vector<vector<Real>>& nettingSetValues, const Date& nettingSet_maturity, const vector<Date>& dateGrid,
+        const Real& csaFxTodayRate, const vector<vector<Real>>& csaFxScenarioRates, const Real& csaTodayCollatCurve,
+        const vector<vector<Real>>& csaScenCollatCurves, const CalculationType& calcType = Symmetric);
 };
 
 //! Convert text representation to CollateralExposureHelper::CalculationType
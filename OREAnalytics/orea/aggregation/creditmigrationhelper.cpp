@@ -28,10 +28,13 @@
 
 #include <qle/math/matrixfunctions.hpp>
 #include <qle/models/transitionmatrix.hpp>
+#include <qle/utilities/workerpool.hpp>
 
 #include <ql/math/distributions/normaldistribution.hpp>
 #include <ql/time/daycounters/actualactual.hpp>
 
+#include <cstdint>
+
 using namespace QuantLib;
 using namespace QuantExt;
 
@@ -56,8 +59,6 @@ CreditMigrationHelper::CreditMigrationHelper(const boost::shared_ptr<CreditSimul
 
     rescaledTransitionMatrices_.resize(cube_->numDates());
     init();
-    if (evaluation_ == Evaluation::TerminalSimulation)
-        initEntityStateSimulation();
 } // CreditMigrationHelper()
 
 namespace {
@@ -82,6 +83,18 @@ Real prob_tauA_lt_tauB_lt_T(const Real pa, const Real pb, const Real T) {
     return res;
 }
 
+// seed of the rng for the inner paths of an outer path, this is the splitmix64 mix of the seed and the path index,
+// truncated to the 32 bits used by the rng, so that it does not depend on the platform or the boost version; a
+// zero seed would make the rng use the clock
+unsigned long pathSeed(const Size seed, const Size path) {
+    std::uint64_t z = static_cast<std::uint64_t>(seed) + (static_cast<std::uint64_t>(path) + 1) * 0x9e3779b97f4a7c15ULL;
+    z = (z ^ (z >> 30)) * 0xbf58476d1ce4e5b9ULL;
+    z = (z ^ (z >> 27)) * 0x94d049bb133111ebULL;
+    z = z ^ (z >> 31);
+    unsigned long res = static_cast<unsigned long>(z & 0xffffffffULL);
+    return res == 0 ? 1 : res;
+}
+
 } // anonymous namespace
 
 std::map<string, Matrix> CreditMigrationHelper::rescaledTransitionMatrices(const Size date) {
@@ -197,25 +210,15 @@ void CreditMigrationHelper::init() {
 
 } // init
 
-void CreditMigrationHelper::initEntityStateSimulation() {
-
-    LOG("Init entity state simulation");
-
-    simulatedEntityState_ =
-        std::vector<std::vector<Size>>(parameters_->entities().size(), std::vector<Size>(cube_->samples()));
-
-    LOG("Init entity state simulation done.");
-
-} // initEntityStatesSimulation
-
-std::vector<Matrix> CreditMigrationHelper::initEntityStateSimulation(const Size date, const Size path) {
+std::vector<std::vector<Real>>
+CreditMigrationHelper::initEntityStateSimulation(const Size date, const Size path,
+                                                 const std::map<string, Matrix>& transMat) const {
     std::vector<Matrix> res = std::vector<Matrix>(parameters_->entities().size(), Matrix(n_, n_, 0.0));
 
     const std::vector<string>& matrixNames = parameters_->transitionMatrices();
 
     // build terminal matrices conditional on global states
     Size numWarnings = 0;
-    auto transMat = rescaledTransitionMatrices(date);
     for (Size i = 0; i < parameters_->entities().size(); ++i) {
         const Matrix& m = transMat.at(matrixNames[i]);
         for (Size ii = 0; ii < m.rows(); ++ii) {
@@ -240,45 +243,41 @@ std::vector<Matrix> CreditMigrationHelper::initEntityStateSimulation(const Size
         }
     }
 
-    // ... and finally build partial sums over columns for the simulation
+    // ... and finally build partial sums over the columns of the initial state row for the simulation
+    std::vector<std::vector<Real>> thresholds(parameters_->entities().size(), std::vector<Real>(n_));
     for (Size i = 0; i < parameters_->entities().size(); ++i) {
-        Matrix& m = res[i];
-        for (Size ii = 0; ii < m.rows(); ++ii) {
-            for (Size jj = 1; jj < m.columns(); ++jj) {
-                m[ii][jj] += m[ii][jj - 1];
-            }
-        }
+        Size initialState = parameters_->initialStates()[i];
+        Real sum = 0.0;
+        for (Size jj = 0; jj < n_; ++jj)
+            thresholds[i][jj] = (sum += res[i][initialState][jj]);
     }
 
-    return res;
+    return thresholds;
 }
 
-void CreditMigrationHelper::simulateEntityStates(const std::vector<Matrix>& cond, const Size path,
-                                                 const MersenneTwisterUniformRng& mt) {
+void CreditMigrationHelper::simulateEntityStates(const std::vector<std::vector<Real>>& cond,
+                                                 const MersenneTwisterUniformRng& mt,
+                                                 std::vector<Size>& entityStates) const {
 
     QL_REQUIRE(evaluation_ != Evaluation::Analytic,
                "CreditMigrationHelper::simulateEntityStates() unexpected call, not in simulation mode");
 
     for (Size i = 0; i < parameters_->entities().size(); ++i) {
-        Size initialState = parameters_->initialStates()[i];
-            Real tmp = mt.next().value;
-            Size entityState =
-                std::lower_bound(cond[i].row_begin(initialState), cond[i].row_end(initialState), tmp) -
-                cond[i].row_begin(initialState);
-            entityState = std::min(entityState, cond[i].columns() - 1); // play safe
-            simulatedEntityState_[i][path] = entityState;
-            initialState = entityState;
+        Real tmp = mt.next().value;
+        // the number of thresholds below tmp, i.e. the lower bound of tmp in the cumulative probabilities, counted
+        // without branches since the number of states is small
+        const std::vector<Real>& c = cond[i];
+        Size entityState = 0;
+        for (Size j = 0; j < c.size(); ++j)
+            entityState += c[j] < tmp ? 1 : 0;
+        entityState = std::min(entityState, c.size() - 1); // play safe
+        entityStates[i] = entityState;
     }
 
 } // simulateEntityStates
 
-Size CreditMigrationHelper::simulatedEntityState(const Size i, const Size path) const {
-    QL_REQUIRE(evaluation_ != Evaluation::Analytic,
-               "CreditMigrationHelper::simulatedEntityState() unexpected call, not in simulation mode");
-    return simulatedEntityState_[i][path];
-} // simulatedEntityState
-
-Real CreditMigrationHelper::generateMigrationPnl(const Size date, const Size path, const Size n) const {
+Real CreditMigrationHelper::generateMigrationPnl(const Size date, const Size path, const Size n,
+                                                 const std::vector<Size>& entityStates) const {
 
     QL_REQUIRE(!parameters_->doubleDefault(),
                "CreditMigrationHelper::generateMigrationPnl() does not support double default");
@@ -289,7 +288,7 @@ Real CreditMigrationHelper::generateMigrationPnl(const Size date, const Size pat
     for (Size i = 0; i < entities.size(); ++i) {
         // compute credit state of entitiy
         // issuer migration risk
-        Size simEntityState = simulatedEntityState(i, path);
+        Size simEntityState = entityStates[i];
         for (auto const& tradeId : issuerTradeIds_[i]) {
             try {
                 Size tid = cube_->idsAndIndexes().at(tradeId);
@@ -472,110 +471,136 @@ Array CreditMigrationHelper::pnlDistribution(const Size date) {
     Size numPaths = cube_->samples();
     Real avgCash = 0.0;
 
-    HullWhiteBucketing hwBucketing(bucketing_.upperBucketBound().begin(), bucketing_.upperBucketBound().end());
-
-    MersenneTwisterUniformRng mt(parameters_->seed());
-
-    for (Size path = 0; path < numPaths; ++path) {
-
-        // 2a market pnl (t0 to horizon date, over whole cube)
-
-        Real cash = 0.0;
-
-        if (parameters_->marketRisk()) {
-            for (Size j = 0; j <= date + 1; ++j) {
-                for (auto const& tradeId : tradeIds) {
-                    Size i = cube_->idsAndIndexes().at(tradeId);
-                    // get cumulative survival probability on the path
-                    Real sp = 1.0;
-                    //Real rr = 0.0;
-                    // FIXME 1
-                    // Methodology question: Do we need/want to multiply with the stochastic discount factor
-                    // here if we do an explicit credit default simulation at horizon?
-                    // FIXME 2
-                    // make CDS PnL neutral bei weighting flows with surv prob and generating protection flow
-                    // with default prob
-                    if (parameters_->zeroMarketPnl() && j > 0 &&
-                        tradeCreditCurves_.find(tradeId) != tradeCreditCurves_.end()) {
-                        string creditCurve = tradeCreditCurves_.at(tradeId);
-                        sp = aggData_->get(j - 1, path, AggregationScenarioDataType::SurvivalWeight, creditCurve);
-                        //rr = aggData_->get(j - 1, path, AggregationScenarioDataType::RecoveryRate, creditCurve);
-                    }
-                    if (j == 0) {
-                        // at t0 we flip the sign of the npvs to get the initial cash balance
-                        cash -= cube_->getT0(i, 0);
-                        // collect intermediate cashflows
-                        if (cubeIndexCashflows_ != Null<Size>())
-                            cash += cube_->getT0(i, cubeIndexCashflows_);
-                    } else if (j <= date) {
-                        // collect intermediate cashflows
-                        if (cubeIndexCashflows_ != Null<Size>())
-                            cash += sp * cube_->get(i, j - 1, path, cubeIndexCashflows_);
-                    } else {
-                        // at the horizon date we realise the npv
-                        cash += sp * cube_->get(i, j - 1, path, 0);
+    // the paths are split into contiguous ranges, one per thread, each thread has its own bucketing and result
+    // distribution, the inner paths of each outer path are generated by an rng seeded from the seed and the outer
+    // path index, so that the result does not depend on the number of threads
+
+    Size nThreads = std::max<Size>(std::min(parameters_->threads(), numPaths), 1);
+    std::vector<Array> threadRes(nThreads, Array(bucketing_.buckets(), 0.0));
+    std::vector<Real> threadCash(nThreads, 0.0);
+
+    auto task = [&](Size t) {
+
+        Size firstPath = numPaths * t / nThreads, lastPath = numPaths * (t + 1) / nThreads;
+
+        HullWhiteBucketing hwBucketing(bucketing_.upperBucketBound().begin(), bucketing_.upperBucketBound().end());
+
+        std::vector<Size> entityStates(entities.size());
+
+        for (Size path = firstPath; path < lastPath; ++path) {
+
+            // 2a market pnl (t0 to horizon date, over whole cube)
+
+            Real cash = 0.0;
+
+            if (parameters_->marketRisk()) {
+                for (Size j = 0; j <= date + 1; ++j) {
+                    for (auto const& tradeId : tradeIds) {
+                        Size i = cube_->idsAndIndexes().at(tradeId);
+                        // get cumulative survival probability on the path
+                        Real sp = 1.0;
+                        //Real rr = 0.0;
+                        // FIXME 1
+                        // Methodology question: Do we need/want to multiply with the stochastic discount factor
+                        // here if we do an explicit credit default simulation at horizon?
+                        // FIXME 2
+                        // make CDS PnL neutral bei weighting flows with surv prob and generating protection flow
+                        // with default prob
+                        if (parameters_->zeroMarketPnl() && j > 0 &&
+                            tradeCreditCurves_.find(tradeId) != tradeCreditCurves_.end()) {
+                            string creditCurve = tradeCreditCurves_.at(tradeId);
+                            sp = aggData_->get(j - 1, path, AggregationScenarioDataType::SurvivalWeight, creditCurve);
+                            //rr = aggData_->get(j - 1, path, AggregationScenarioDataType::RecoveryRate, creditCurve);
+                        }
+                        if (j == 0) {
+                            // at t0 we flip the sign of the npvs to get the initial cash balance
+                            cash -= cube_->getT0(i, 0);
+                            // collect intermediate cashflows
+                            if (cubeIndexCashflows_ != Null<Size>())
+                                cash += cube_->getT0(i, cubeIndexCashflows_);
+                        } else if (j <= date) {
+                            // collect intermediate cashflows
+                            if (cubeIndexCashflows_ != Null<Size>())
+                                cash += sp * cube_->get(i, j - 1, path, cubeIndexCashflows_);
+                        } else {
+                            // at the horizon date we realise the npv
+                            cash += sp * cube_->get(i, j - 1, path, 0);
+                        }
                     }
+                } // for data
+            }     // if market risk
+
+            if (!parameters_->creditRisk()) {
+                // if we just add scalar market pnl realisations, we don't really need
+                // the bucketing algorithm to do that, we just update the result
+                // distribution directly
+                threadRes[t][hwBucketing.index(cash)] += 1.0 / static_cast<Real>(numPaths);
+                continue;
+            }
+
+            // 2b credit migration pnl (at horizon date, over entities specified in credit simulation parameters)
+
+            std::vector<Array> condProbs, pnl;
+
+            if (evaluation_ != Evaluation::Analytic) {
+                // 2b-1 generate pnl on the path using simulated idiosyncratic factors
+                condProbs.resize(1, Array(parameters_->paths(), 1.0 / static_cast<Real>(parameters_->paths())));
+                // we could build the distribution more efficiently here, but later in 2c we add the market pnl
+                // maybe extend the hw bucketing so that we can feed precomputed distributions and just update
+                // these with additional data?
+                pnl.resize(1, Array(parameters_->paths(), 0.0));
+                auto cond = initEntityStateSimulation(date, path, transMat);
+                MersenneTwisterUniformRng mt(pathSeed(parameters_->seed(), path));
+                for (Size path2 = 0; path2 < parameters_->paths(); ++path2) {
+                    simulateEntityStates(cond, mt, entityStates);
+                    pnl[0][path2] = generateMigrationPnl(date, path, n_, entityStates);
                 }
-            } // for data
-        }     // if market risk
-
-        if (!parameters_->creditRisk()) {
-            // if we just add scalar market pnl realisations, we don't really need
-            // the bucketing algorithm to do that, we just update the result
-            // distribution directly
-            res[hwBucketing.index(cash)] += 1.0 / static_cast<Real>(numPaths);
-            continue;
-        }
+            } else {
+                // 2b-2 generate pnl distribution without simulation of idiosyncratic factors using the conditional
+                // independence of migration on the path / systemic factors
+
+                // n+1 states, since for CDS we have to subdivide the issuer default into
+                // i) default of issuer and non-default of CDS cpty
+                // ii) default of issuer, default of CDS cpty (but after the issuer default)
+                // iii) default of issuer, default of CDS cpty (before the issuer default)
+                // for non-CDS trades for all sub-states the pnl will be set to the same value
+                // for CDS trades i)+ii) will have the same pnl, but iii) will have a zero pnl
+                // in total, we only have to distinguish i)+ii) and iii), i.e. we need one
+                // additional state
+
+                condProbs.resize(entities.size(), Array(n_ + 1, 0.0));
+                pnl.resize(entities.size(), Array(n_ + 1, 0.0));
+                generateConditionalMigrationPnl(date, path, transMat, condProbs, pnl);
+            }
 
-        // 2b credit migration pnl (at horizon date, over entities specified in credit simulation parameters)
-
-        std::vector<Array> condProbs, pnl;
-
-        if (evaluation_ != Evaluation::Analytic) {
-            // 2b-1 generate pnl on the path using simulated idiosyncratic factors
-            condProbs.resize(1, Array(parameters_->paths(), 1.0 / static_cast<Real>(parameters_->paths())));
-            // we could build the distribution more efficiently here, but later in 2c we add the market pnl
-            // maybe extend the hw bucketing so that we can feed precomputed distributions and just update
-            // these with additional data?
-            pnl.resize(1, Array(parameters_->paths(), 0.0));
-            auto cond = initEntityStateSimulation(date, path);
-            for (Size path2 = 0; path2 < parameters_->paths(); ++path2) {
-                simulateEntityStates(cond, path, mt);
-                pnl[0][path2] = generateMigrationPnl(date, path, n_);
+            // 2c aggregate market pnl and credit migration pnl
+
+            if (parameters_->marketRisk()) {
+                condProbs.push_back(Array(1, 1.0));
+                pnl.push_back(Array(1, cash));
             }
-        } else {
-            // 2b-2 generate pnl distribution without simulation of idiosyncratic factors using the conditional
-            // independence of migration on the path / systemic factors
-
-            // n+1 states, since for CDS we have to subdivide the issuer default into
-            // i) default of issuer and non-default of CDS cpty
-            // ii) default of issuer, default of CDS cpty (but after the issuer default)
-            // iii) default of issuer, default of CDS cpty (before the issuer default)
-            // for non-CDS trades for all sub-states the pnl will be set to the same value
-            // for CDS trades i)+ii) will have the same pnl, but iii) will have a zero pnl
-            // in total, we only have to distinguish i)+ii) and iii), i.e. we need one
-            // additional state
-
-            condProbs.resize(entities.size(), Array(n_ + 1, 0.0));
-            pnl.resize(entities.size(), Array(n_ + 1, 0.0));
-            generateConditionalMigrationPnl(date, path, transMat, condProbs, pnl);
-        }
 
-        // 2c aggregate market pnl and credit migration pnl
+            hwBucketing.computeMultiState(condProbs.begin(), condProbs.end(), pnl.begin());
 
-        if (parameters_->marketRisk()) {
-            condProbs.push_back(Array(1, 1.0));
-            pnl.push_back(Array(1, cash));
-        }
+            // 2d add pnl contribution of path to result distribution
+            threadRes[t] += hwBucketing.probability() / static_cast<Real>(numPaths);
+            // average market risk pnl
+            threadCash[t] += cash / static_cast<Real>(numPaths);
 
-        hwBucketing.computeMultiState(condProbs.begin(), condProbs.end(), pnl.begin());
+        } // for path
+    };
 
-        // 2d add pnl contribution of path to result distribution
-        res += hwBucketing.probability() / static_cast<Real>(numPaths);
-        // average market risk pnl
-        avgCash += cash / static_cast<Real>(numPaths);
+    if (nThreads > 1) {
+        QuantExt::WorkerPool pool(nThreads);
+        pool.run(nThreads, task);
+    } else {
+        task(0);
+    }
 
-    } // for path
+    for (Size t = 0; t < nThreads; ++t) {
+        res += threadRes[t];
+        avgCash += threadCash[t];
+    }
 
     DLOG("Expected Market Risk PnL at date " << date << ": " << avgCash);
     return res;
@@ -81,25 +81,22 @@ private:
         using the simulated global state paths stored in the aggregation scenario data object */
     void init();
 
-    //! Allocate 3d storage for the simulated idiosyncratic factors by entity, date and sample
-    void initEntityStateSimulation();
-
-    /*! Initialise the entity state simulationn for a given date for
+    /*! Initialise the entity state simulation for a given date for
         Evaluation = TerminalSimulation:
-        Return transition matrix for each entity for the given date,
+        Return the cumulative transition probabilities from the initial state for each entity for the given date,
         conditional on the global terminal state on the given path */
-    std::vector<Matrix> initEntityStateSimulation(const Size date, const Size path);
+    std::vector<std::vector<Real>> initEntityStateSimulation(const Size date, const Size path,
+                                                             const std::map<string, Matrix>& transMat) const;
 
     /*! Generate one entity state sample path for all entities given the global state path
-        and given the conditional transition matrices for all entities at the terminal date. */
-    void simulateEntityStates(const std::vector<Matrix>& cond, const Size path, const MersenneTwisterUniformRng& mt);
-
-    //! Look up the simulated entity credit state for the given entity, date and path
-    Size simulatedEntityState(const Size i, const Size path) const;
+        and given the conditional cumulative transition probabilities for all entities at the terminal date. */
+    void simulateEntityStates(const std::vector<std::vector<Real>>& cond, const MersenneTwisterUniformRng& mt,
+                              std::vector<Size>& entityStates) const;
 
     /*! Return a single PnL impact due to credit migration or default of Bond/CDS issuers and default of
       netting set counterparties on the given global path */
-    Real generateMigrationPnl(const Size date, const Size path, const Size n) const;
+    Real generateMigrationPnl(const Size date, const Size path, const Size n,
+                              const std::vector<Size>& entityStates) const;
 
     /*! Return a vector of PnL impacts and associated conditional probabilities for the specified global path,
       due to credit migration or default of Bond/CDS issuers and default of netting set counterparties */
@@ -133,10 +130,6 @@ private:
     std::vector<std::map<string, Matrix>> rescaledTransitionMatrices_;
     // Variance of the systemic part (Y_i) of entity state X_i
     std::vector<Real> globalVar_;
-    // Storage for the simulated idiosyncratic factors Z by entity, sample number
-    std::vector<std::vector<Size>> simulatedEntityState_;
-
-    std::vector<std::vector<Matrix>> entityStateSimulationMatrices_;
     // Systemic part (Y_i) of entity state X_i by date index, entity index, sample number
     std::vector<std::vector<std::vector<Real>>> globalStates_;
 };
@@ -22,70 +22,202 @@
 */
 
 #include <orea/aggregation/cvaspreadsensitivitycalculator.hpp>
+#include <ored/utilities/log.hpp>
+
+#include <ql/math/comparison.hpp>
+
+#include <algorithm>
 
 namespace ore {
 namespace analytics {
 
+CVASpreadSensitivityCalculator::Method parseCvaSensitivityMethod(const string& s) {
+    static map<string, CVASpreadSensitivityCalculator::Method> m = {
+        {"BumpAndRevalue", CVASpreadSensitivityCalculator::Method::BumpAndRevalue},
+        {"Analytic", CVASpreadSensitivityCalculator::Method::Analytic},
+        {"AnalyticWithValidation", CVASpreadSensitivityCalculator::Method::AnalyticWithValidation}};
+    auto it = m.find(s);
+    if (it != m.end()) {
+        return it->second;
+    } else {
+        QL_FAIL("CVA sensitivity method \"" << s << "\" not recognized");
+    }
+}
+
+std::ostream& operator<<(std::ostream& out, CVASpreadSensitivityCalculator::Method m) {
+    if (m == CVASpreadSensitivityCalculator::Method::BumpAndRevalue)
+        out << "BumpAndRevalue";
+    else if (m == CVASpreadSensitivityCalculator::Method::Analytic)
+        out << "Analytic";
+    else if (m == CVASpreadSensitivityCalculator::Method::AnalyticWithValidation)
+        out << "AnalyticWithValidation";
+    else
+        QL_FAIL("CVA sensitivity method not covered");
+    return out;
+}
+
 CVASpreadSensitivityCalculator::CVASpreadSensitivityCalculator(const string& key, const Date& asof,
                                                                const vector<Real>& epe, const vector<Date>& dates,
                                                                const Handle<DefaultProbabilityTermStructure>& dts,
                                                                const Real& recovery,
                                                                const Handle<YieldTermStructure>& yts,
-                                                               const vector<Period>& shiftTenors, Real shiftSize)
+                                                               const vector<Period>& shiftTenors, Real shiftSize,
+                                                               Method method)
     : key_(key), asof_(asof), epe_(epe), dates_(dates), dts_(dts), recovery_(recovery), yts_(yts),
-      shiftTenors_(shiftTenors), shiftSize_(shiftSize) {
+      shiftTenors_(shiftTenors), shiftSize_(shiftSize), method_(method) {
     shiftTimes_ = vector<Real>(shiftTenors.size(), 0.0);
-    hazardRateSensitivities_ = vector<Real>(shiftTenors.size(), 0.0);
-    cdsSpreadSensitivities_ = vector<Real>(shiftTenors.size(), 0.0);
     for (Size i = 0; i < shiftTenors_.size(); ++i)
         shiftTimes_[i] = dts_->timeFromReference(asof_ + shiftTenors_[i]);
 
+    if (method_ == Method::BumpAndRevalue)
+        bumpAndRevalue(hazardRateSensitivities_, jacobi_);
+    else
+        analytic(hazardRateSensitivities_, jacobi_);
+    cdsSpreadSensitivities_ = cdsSpreadSensitivities(hazardRateSensitivities_, jacobi_);
+
+    if (method_ == Method::AnalyticWithValidation) {
+        Matrix bumpedJacobi;
+        bumpAndRevalue(bumpedHazardRateSensitivities_, bumpedJacobi);
+        bumpedCdsSpreadSensitivities_ = cdsSpreadSensitivities(bumpedHazardRateSensitivities_, bumpedJacobi);
+        // the analytic sensitivities are first order, so we expect relative differences of the order of the shift
+        // size times the bucket end time, anything beyond the tolerance below indicates an inconsistency
+        Real tolerance = 0.01;
+        auto check = [this, tolerance](const string& label, Size i, Real analyticValue, Real bumped) {
+            Real diff = analyticValue - bumped;
+            DLOG("CVA Calculator key=" << key_ << " " << label << "[" << i << "] analytic=" << analyticValue
+                                       << " bumped=" << bumped << " diff=" << diff);
+            if (std::abs(diff) > tolerance * std::abs(bumped) && !close_enough(analyticValue, bumped))
+                WLOG("CVA Calculator key=" << key_ << ": analytic " << label << " sensitivity " << analyticValue
+                                           << " deviates from bump and revalue result " << bumped << " at "
+                                           << shiftTenors_[i] << " by more than " << tolerance * 100.0 << "%");
+        };
+        for (Size i = 0; i < shiftTenors_.size(); ++i) {
+            check("hazard rate", i, hazardRateSensitivities_[i], bumpedHazardRateSensitivities_[i]);
+            check("cds spread", i, cdsSpreadSensitivities_[i], bumpedCdsSpreadSensitivities_[i]);
+        }
+    }
+}
+
+void CVASpreadSensitivityCalculator::bumpAndRevalue(vector<Real>& hazardRateSensitivities, Matrix& jacobi) {
+    hazardRateSensitivities = vector<Real>(shiftTenors_.size(), 0.0);
     Real cvaBase = cva();
-    Array input(shiftTenors_.size(), 0.0);
     for (Size i = 0; i < shiftTenors_.size(); ++i) {
         Real cvaShifted = cva(true, i);
-        hazardRateSensitivities_[i] = cvaShifted - cvaBase;
-        input[i] = hazardRateSensitivities_[i];
+        hazardRateSensitivities[i] = cvaShifted - cvaBase;
     }
     DLOG("CVA Calculator key=" << key_ << " cvaBase=" << cvaBase);
 
-    jacobi_ = Matrix(shiftTenors_.size(), shiftTenors_.size(), 0.0);
+    jacobi = Matrix(shiftTenors_.size(), shiftTenors_.size(), 0.0);
     for (Size i = 0; i < shiftTenors_.size(); ++i) {
         Real cdsSpreadBase = fairCdsSpread(i);
         DLOG("CVA Calculator key=" << key_ << " fairSpread[" << i << "]=" << cdsSpreadBase);
         Real row = 0.0;
         for (Size j = 0; j <= i; ++j) {
             Real cdsSpread = fairCdsSpread(i, true, j);
-            jacobi_[j][i] = (cdsSpread - cdsSpreadBase) / shiftSize_;
-            row += jacobi_[j][i];
-            DLOG("CVA Calculator key=" << key_ << " jacobi[" << j << "][" << i << "]=" << jacobi_[j][i]);
+            jacobi[j][i] = (cdsSpread - cdsSpreadBase) / shiftSize_;
+            row += jacobi[j][i];
+            DLOG("CVA Calculator key=" << key_ << " jacobi[" << j << "][" << i << "]=" << jacobi[j][i]);
         }
         DLOG("CVA Calculator key=" << key_ << " jacobi column[" << i << "]=" << row);
     }
+}
 
-    Array output = inverse(jacobi_) * input;
-    for (Size i = 0; i < shiftTenors_.size(); ++i)
-        cdsSpreadSensitivities_[i] = output[i];
+void CVASpreadSensitivityCalculator::analytic(vector<Real>& hazardRateSensitivities, Matrix& jacobi) {
+    Size nBuckets = shiftTimes_.size();
+
+    // A shift h of the hazard rates in bucket i multiplies S(t) by exp(-h * tau_i(t)), with tau_i(t) the time spent
+    // in the bucket up to t, i.e. dS(t) / dh_i = -S(t) * tau_i(t). With t_0 = asof the CVA is
+    //   (1 - R) * sum_j (S(t_j) - S(t_{j+1})) * EPE_{j+1},
+    // so the adjoint of S(t_j) is (1 - R) * (EPE_{j+1} - EPE_j) where the terms outside the date grid vanish.
+
+    vector<Real> dCva(nBuckets, 0.0);
+    Real cvaBase = 0.0, s0 = 0.0;
+    for (Size j = 0; j <= dates_.size(); ++j) {
+        Time t = dts_->timeFromReference(j == 0 ? asof_ : dates_[j - 1]);
+        Real s = dts_->survivalProbability(t);
+        if (j > 0)
+            cvaBase += (1.0 - recovery_) * (s0 - s) * epe_[j];
+        Real sBar = (1.0 - recovery_) * ((j < dates_.size() ? epe_[j + 1] : 0.0) - (j > 0 ? epe_[j] : 0.0));
+        for (Size i = 0; i < nBuckets; ++i)
+            dCva[i] -= sBar * s * bucketTime(t, i);
+        s0 = s;
+    }
+    DLOG("CVA Calculator key=" << key_ << " cvaBase=" << cvaBase);
+
+    hazardRateSensitivities = vector<Real>(nBuckets, 0.0);
+    for (Size i = 0; i < nBuckets; ++i)
+        hazardRateSensitivities[i] = dCva[i] * shiftSize_;
+
+    // The fair spread of the CDS of term k is (1 - R) * E_k / D_k with
+    //   E_k = sum_l (S(t_{l-1}) - S(t_l)) * P(t_l) and D_k = sum_l dt * S(t_l) * P(t_l)
+    // on the 6M schedule of fairCdsSpread(). The schedules of all terms are nested, so we accumulate the sums and
+    // their derivatives along the longest schedule and read off the jacobian columns at the term ends.
+
+    Real dt = 0.5;
+    vector<Size> n(nBuckets, 0);
+    for (Size k = 0; k < nBuckets; ++k) {
+        Real T = shiftTimes_[k];
+        n[k] = Size(floor(T / dt + 0.5));
+        QL_REQUIRE(fabs(T - dt * n[k]) < 0.1 * dt, "shift term is not a multiple of 6M");
+    }
+    Size nMax = nBuckets == 0 ? 0 : *std::max_element(n.begin(), n.end());
+
+    jacobi = Matrix(nBuckets, nBuckets, 0.0);
+    Real enumerator = 0.0, denominator = 0.0;
+    vector<Real> dEnumerator(nBuckets, 0.0), dDenominator(nBuckets, 0.0);
+    s0 = dts_->survivalProbability(0.0);
+    for (Size l = 1; l <= nMax; ++l) {
+        Real t0 = dt * (l - 1);
+        Real t1 = dt * l;
+        Real s1 = dts_->survivalProbability(t1);
+        Real dis = yts_->discount(t1);
+        enumerator += (s0 - s1) * dis;
+        denominator += dt * s1 * dis;
+        for (Size j = 0; j < nBuckets; ++j) {
+            Real tau1 = bucketTime(t1, j);
+            dEnumerator[j] += (s1 * tau1 - s0 * bucketTime(t0, j)) * dis;
+            dDenominator[j] -= dt * s1 * tau1 * dis;
+        }
+        for (Size k = 0; k < nBuckets; ++k) {
+            if (n[k] != l)
+                continue;
+            DLOG("CVA Calculator key=" << key_ << " fairSpread[" << k
+                                       << "]=" << (1.0 - recovery_) * enumerator / denominator);
+            for (Size j = 0; j <= k; ++j) {
+                jacobi[j][k] = (1.0 - recovery_) * (dEnumerator[j] * denominator - enumerator * dDenominator[j]) /
+                               (denominator * denominator);
+                DLOG("CVA Calculator key=" << key_ << " jacobi[" << j << "][" << k << "]=" << jacobi[j][k]);
+            }
+        }
+        s0 = s1;
+    }
 }
 
-Real CVASpreadSensitivityCalculator::survivalProbability(Time t, bool shift, Size index) {
-    if (shift == false)
-        return dts_->survivalProbability(t);
+vector<Real> CVASpreadSensitivityCalculator::cdsSpreadSensitivities(const vector<Real>& hazardRateSensitivities,
+                                                                    const Matrix& jacobi) {
+    Array input(hazardRateSensitivities.begin(), hazardRateSensitivities.end());
+    Array output = inverse(jacobi) * input;
+    return vector<Real>(output.begin(), output.end());
+}
 
+Time CVASpreadSensitivityCalculator::bucketTime(Time t, Size index) const {
     QL_REQUIRE(index < shiftTimes_.size(), "index " << index << " out of range");
     Real t2 = shiftTimes_[index];
     Real t1 = index == 0 ? 0.0 : shiftTimes_[index - 1];
     bool lastBucket = index == shiftTimes_.size() - 1 ? true : false;
     if (t < t1)
+        return 0.0;
+    else if (t < t2 || lastBucket)
+        return t - t1;
+    else // t >= t2
+        return t2 - t1;
+}
+
+Real CVASpreadSensitivityCalculator::survivalProbability(Time t, bool shift, Size index) {
+    if (shift == false)
         return dts_->survivalProbability(t);
-    else if (t < t2) {
-        return dts_->survivalProbability(t) * exp(-shiftSize_ * (t - t1));
-    } else { // t >= t2
-        if (!lastBucket)
-            return dts_->survivalProbability(t) * exp(-shiftSize_ * (t2 - t1));
-        else
-            return dts_->survivalProbability(t) * exp(-shiftSize_ * (t - t1));
-    }
+
+    return dts_->survivalProbability(t) * exp(-shiftSize_ * bucketTime(t, index));
 }
 
 Real CVASpreadSensitivityCalculator::survivalProbability(Date d, bool shift, Size index) {
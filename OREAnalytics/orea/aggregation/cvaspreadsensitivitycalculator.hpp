@@ -50,6 +50,17 @@ using namespace std;
 */
 class CVASpreadSensitivityCalculator {
 public:
+    //! Calculation method for the hazard rate sensitivities and the CDS spread jacobian
+    enum class Method {
+        //! Recompute CVA and fair CDS spreads with shifted hazard rates for each bucket
+        BumpAndRevalue,
+        /*! First order sensitivities w.r.t. all hazard rate buckets computed in a single adjoint pass over the
+            exposure profile and the CDS schedule, scaled by the shift size */
+        Analytic,
+        //! Analytic sensitivities, additionally compared against the bump and revalue results
+        AnalyticWithValidation
+    };
+
     CVASpreadSensitivityCalculator(//! For logging purposes to distinguish sensi runs, e.g. for different netting sets
 				   const std::string& key,
 				   //! Asof date
@@ -67,7 +78,9 @@ public:
 				   //! Shift grid
 				   const vector<Period>& shiftTenors,
 				   //! Shift size
-				   Real shiftSize = 0.0001);  
+				   Real shiftSize = 0.0001,
+				   //! Calculation method
+				   Method method = Method::BumpAndRevalue);
   
     //! Inspectors
     // @{
@@ -88,9 +101,15 @@ public:
     const vector<Real> hazardRateSensitivities() { return hazardRateSensitivities_; }
     const vector<Real> cdsSpreadSensitivities() { return cdsSpreadSensitivities_; }
     const Matrix& jacobi() { return jacobi_; }
+    Method method() { return method_; }
+    //! Bump and revalue results, only populated for Method::AnalyticWithValidation
+    const vector<Real>& bumpedHazardRateSensitivities() { return bumpedHazardRateSensitivities_; }
+    const vector<Real>& bumpedCdsSpreadSensitivities() { return bumpedCdsSpreadSensitivities_; }
     // @}
 
 private:
+    // time spent in the specified hazard rate bucket up to time t, the last bucket extends to infinity
+    Time bucketTime(Time t, Size index) const;
     // survival probability with shifted hazard rates in the specified bucket 
     Real survivalProbability(Date d, bool shift, Size index);
     Real survivalProbability(Time t, bool shift, Size index);
@@ -98,6 +117,12 @@ private:
     Real cva(bool shift = false, Size index = 0);
     //! Fair CDS Spread calculation with and without shifted hazard rates
     Real fairCdsSpread(Size term, bool shift = false, Size index = 0);
+    //! Hazard rate sensitivities and CDS spread jacobian by bump and revalue
+    void bumpAndRevalue(vector<Real>& hazardRateSensitivities, Matrix& jacobi);
+    //! Hazard rate sensitivities and CDS spread jacobian by adjoint differentiation
+    void analytic(vector<Real>& hazardRateSensitivities, Matrix& jacobi);
+    //! CDS spread sensitivities implied by the hazard rate sensitivities and the jacobian
+    vector<Real> cdsSpreadSensitivities(const vector<Real>& hazardRateSensitivities, const Matrix& jacobi);
 		     
     string key_;
     Date asof_;
@@ -110,10 +135,19 @@ private:
 
     vector<Real> shiftTimes_;
     Real shiftSize_;
+    Method method_;
     vector<Real> hazardRateSensitivities_;
     vector<Real> cdsSpreadSensitivities_;  
     Matrix jacobi_;
+    vector<Real> bumpedHazardRateSensitivities_;
+    vector<Real> bumpedCdsSpreadSensitivities_;
 };
 
+//! Convert text representation to CVASpreadSensitivityCalculator::Method
+CVASpreadSensitivityCalculator::Method parseCvaSensitivityMethod(const string& s);
+
+//! Write CVASpreadSensitivityCalculator::Method
+std::ostream& operator<<(std::ostream& out, CVASpreadSensitivityCalculator::Method m);
+
 } // namespace analytics
 } // namespace ore
@@ -31,12 +31,16 @@
 
 #include <qle/math/nadarayawatson.hpp>
 #include <qle/math/stabilisedglls.hpp>
+#include <qle/utilities/workerpool.hpp>
 
 #include <boost/accumulators/accumulators.hpp>
 #include <boost/accumulators/statistics/error_of_mean.hpp>
 #include <boost/accumulators/statistics/mean.hpp>
 #include <boost/accumulators/statistics/stats.hpp>
 
+#include <algorithm>
+#include <tuple>
+
 using namespace std;
 using namespace QuantLib;
 
@@ -51,11 +55,12 @@ RegressionDynamicInitialMarginCalculator::RegressionDynamicInitialMarginCalculat
     const boost::shared_ptr<CubeInterpretation>& cubeInterpretation,
     const boost::shared_ptr<AggregationScenarioData>& scenarioData, Real quantile, Size horizonCalendarDays,
     Size regressionOrder, std::vector<std::string> regressors, Size localRegressionEvaluations,
-    Real localRegressionBandWidth, const std::map<std::string, Real>& currentIM)
+    Real localRegressionBandWidth, const std::map<std::string, Real>& currentIM, const Size threads)
 : DynamicInitialMarginCalculator(inputs, portfolio, cube, cubeInterpretation, scenarioData, quantile, horizonCalendarDays,
                                  currentIM),
       regressionOrder_(regressionOrder), regressors_(regressors),
-      localRegressionEvaluations_(localRegressionEvaluations), localRegressionBandWidth_(localRegressionBandWidth) {
+      localRegressionEvaluations_(localRegressionEvaluations), localRegressionBandWidth_(localRegressionBandWidth),
+      threads_(threads) {
     Size dates = cube_->dates().size();
     Size samples = cube_->samples();
     for (const auto& nettingSetId : nettingSetIds_) {
@@ -122,6 +127,9 @@ void RegressionDynamicInitialMarginCalculator::build() {
     Size simple_dim_index_h = Size(floor(quantile_ * (samples - 1) + 0.5));
     Size simple_dim_index_p = Size(floor((1.0 - quantile_) * (samples - 1) + 0.5));
 
+    // Netting sets to be processed by regression with their position in the dim cube and DIM scaling factor
+    vector<std::tuple<string, Size, Real>> regressionNettingSets;
+
     Size nettingSetCount = 0;
     for (auto n : nettingSetIds_) {
         LOG("Process netting set " << n);
@@ -158,6 +166,7 @@ void RegressionDynamicInitialMarginCalculator::build() {
                 }
                 WLOG("Overriding DIM for netting set " << n << " succeeded");
                 // continue to the next netting set
+                nettingSetCount++;
                 continue;
             }
         }
@@ -176,149 +185,187 @@ void RegressionDynamicInitialMarginCalculator::build() {
             nettingSetScaling_.find(n) == nettingSetScaling_.end() ? 1.0 : nettingSetScaling_[n];
         LOG("Netting set DIM scaling factor: " << nettingSetDimScaling);
 
-        for (Size j = 0; j < stopDatesLoop; ++j) {
-            accumulator_set<double, stats<boost::accumulators::tag::mean, boost::accumulators::tag::variance>> accDiff;
-            accumulator_set<double, stats<boost::accumulators::tag::mean>> accOneOverNumeraire;
-            for (Size k = 0; k < samples; ++k) {
-                Real numDefault =
-                    cubeInterpretation_->getDefaultAggregationScenarioData(AggregationScenarioDataType::Numeraire, j, k);
-                Real numCloseOut =
-                    cubeInterpretation_->getCloseOutAggregationScenarioData(AggregationScenarioDataType::Numeraire, j, k);
-                Real npvDefault = nettingSetNPV_[n][j][k];
-                Real flow = nettingSetFLOW_[n][j][k];
-                Real npvCloseOut = nettingSetCloseOutNPV_[n][j][k];
-                accDiff((npvCloseOut * numCloseOut) + (flow * numDefault) - (npvDefault * numDefault));
-                accOneOverNumeraire(1.0 / numDefault);
-            }
-
-            Size mporCalendarDays = cubeInterpretation_->getMporCalendarDays(cube_, j);
-            Real horizonScaling = sqrt(1.0 * horizonCalendarDays_ / mporCalendarDays);
+        regressionNettingSets.push_back(std::make_tuple(n, nettingSetCount, nettingSetDimScaling));
+        nettingSetCount++;
+    }
 
-            Real stdevDiff = sqrt(boost::accumulators::variance(accDiff));
-            Real E_OneOverNumeraire =
-                mean(accOneOverNumeraire); // "re-discount" (the stdev is calculated on non-discounted deltaNPVs)
+    // Numeraires and scenario data regressors by date and sample, these are shared by all netting sets. The entries
+    // of regressors that refer to the netting set NPV are left empty and filled per netting set below.
+    vector<vector<Real>> numDefault(stopDatesLoop, vector<Real>(samples));
+    vector<vector<Real>> numCloseOut(stopDatesLoop, vector<Real>(samples));
+    vector<vector<vector<Real>>> scenarioRegressors(stopDatesLoop);
+    for (Size j = 0; j < stopDatesLoop; ++j) {
+        for (Size k = 0; k < samples; ++k) {
+            numDefault[j][k] =
+                cubeInterpretation_->getDefaultAggregationScenarioData(AggregationScenarioDataType::Numeraire, j, k);
+            numCloseOut[j][k] =
+                cubeInterpretation_->getCloseOutAggregationScenarioData(AggregationScenarioDataType::Numeraire, j, k);
+        }
+        scenarioRegressors[j] = scenarioRegressorValues(j);
+    }
 
-            nettingSetZeroOrderDIM_[n][j] = stdevDiff * horizonScaling * confidenceLevel;
-            nettingSetZeroOrderDIM_[n][j] *= E_OneOverNumeraire;
+    // Each task processes one netting set and date, i.e. it writes to its own date slot of the result containers
+    // only. The result containers are accessed via at() which does not modify the maps.
+    auto task = [&](const Size t) {
+        const string& n = std::get<0>(regressionNettingSets[t / stopDatesLoop]);
+        Size cubeIndex = std::get<1>(regressionNettingSets[t / stopDatesLoop]);
+        Real nettingSetDimScaling = std::get<2>(regressionNettingSets[t / stopDatesLoop]);
+        Size j = t % stopDatesLoop;
+
+        const vector<Real>& npv = nettingSetNPV_.at(n)[j];
+        const vector<Real>& flow = nettingSetFLOW_.at(n)[j];
+        const vector<Real>& closeOutNpv = nettingSetCloseOutNPV_.at(n)[j];
+        vector<Real>& deltaNpv = nettingSetDeltaNPV_.at(n)[j];
+        vector<Real>& dimResult = nettingSetDIM_.at(n)[j];
+        vector<Real>& localDimResult = nettingSetLocalDIM_.at(n)[j];
+        vector<Array>& regressorResult = regressorArray_.at(n)[j];
+
+        accumulator_set<double, stats<boost::accumulators::tag::mean, boost::accumulators::tag::variance>> accDiff;
+        accumulator_set<double, stats<boost::accumulators::tag::mean>> accOneOverNumeraire;
+        vector<Real> rx0(samples, 0.0);
+        vector<Array> rx(samples, Array());
+        vector<Real> ry1(samples, 0.0);
+        vector<Real> ry2(samples, 0.0);
+        for (Size k = 0; k < samples; ++k) {
+            Real x = npv[k] * numDefault[j][k];
+            Real f = flow[k] * numDefault[j][k];
+            Real y = closeOutNpv[k] * numCloseOut[j][k];
+            Real z = (y + f - x);
+            accDiff(z);
+            accOneOverNumeraire(1.0 / numDefault[j][k]);
+            if (regressors_.empty()) {
+                rx[k] = Array(1, npv[k]);
+            } else {
+                rx[k] = Array(regressors_.size());
+                for (Size i = 0; i < regressors_.size(); ++i)
+                    rx[k][i] = scenarioRegressors[j][i].empty() ? npv[k] : scenarioRegressors[j][i][k];
+            }
+            rx0[k] = rx[k][0];
+            ry1[k] = z;     // for local regression
+            ry2[k] = z * z; // for least squares regression
+            deltaNpv[k] = z;
+            regressorResult[k] = rx[k];
+        }
 
-            vector<Real> rx0(samples, 0.0);
-            vector<Array> rx(samples, Array());
-            vector<Real> ry1(samples, 0.0);
-            vector<Real> ry2(samples, 0.0);
+        Size mporCalendarDays = cubeInterpretation_->getMporCalendarDays(cube_, j);
+        Real horizonScaling = sqrt(1.0 * horizonCalendarDays_ / mporCalendarDays);
+
+        Real stdevDiff = sqrt(boost::accumulators::variance(accDiff));
+        Real E_OneOverNumeraire =
+            mean(accOneOverNumeraire); // "re-discount" (the stdev is calculated on non-discounted deltaNPVs)
+
+        nettingSetZeroOrderDIM_.at(n)[j] = stdevDiff * horizonScaling * confidenceLevel * E_OneOverNumeraire;
+
+        // We only need two order statistics, so a partial selection is sufficient here. The second selection is
+        // restricted to the partition left resp. right of the first selected element.
+        vector<Real> delNpvVec_copy = deltaNpv;
+        auto h = delNpvVec_copy.begin() + simple_dim_index_h;
+        auto p = delNpvVec_copy.begin() + simple_dim_index_p;
+        std::nth_element(delNpvVec_copy.begin(), h, delNpvVec_copy.end());
+        if (simple_dim_index_p < simple_dim_index_h)
+            std::nth_element(delNpvVec_copy.begin(), p, h);
+        else if (simple_dim_index_p > simple_dim_index_h)
+            std::nth_element(std::next(h), p, delNpvVec_copy.end());
+        Real simpleDim_h = *h * horizonScaling;                                 // the usual scaling factors
+        Real simpleDim_p = *p * horizonScaling;                                 // the usual scaling factors
+        nettingSetSimpleDIMh_.at(n)[j] = simpleDim_h * E_OneOverNumeraire; // discounted DIM
+        nettingSetSimpleDIMp_.at(n)[j] = simpleDim_p * E_OneOverNumeraire; // discounted DIM
+
+        QL_REQUIRE(rx.size() > v.size(), "not enough points for regression with polynom order " << polynomOrder);
+        if (close_enough(stdevDiff, 0.0)) {
+            LOG("DIM: Zero std dev estimation at step " << j);
+            // Skip IM calculation if all samples have zero NPV (e.g. after latest maturity)
             for (Size k = 0; k < samples; ++k) {
-                Real numDefault =
-                    cubeInterpretation_->getDefaultAggregationScenarioData(AggregationScenarioDataType::Numeraire, j, k);
-                Real numCloseOut =
-                    cubeInterpretation_->getCloseOutAggregationScenarioData(AggregationScenarioDataType::Numeraire, j, k);
-                Real x = nettingSetNPV_[n][j][k] * numDefault;
-                Real f = nettingSetFLOW_[n][j][k] * numDefault;
-                Real y = nettingSetCloseOutNPV_[n][j][k] * numCloseOut;
-                Real z = (y + f - x);
-                rx[k] = regressors_.empty() ? Array(1, nettingSetNPV_[n][j][k]) : regressorArray(n, j, k);
-                rx0[k] = rx[k][0];
-                ry1[k] = z;     // for local regression
-                ry2[k] = z * z; // for least squares regression
-                nettingSetDeltaNPV_[n][j][k] = z;
-                regressorArray_[n][j][k] = rx[k];
+                dimResult[k] = 0.0;
+                localDimResult[k] = 0.0;
             }
-            vector<Real> delNpvVec_copy = nettingSetDeltaNPV_[n][j];
-            sort(delNpvVec_copy.begin(), delNpvVec_copy.end());
-            Real simpleDim_h = delNpvVec_copy[simple_dim_index_h];
-            Real simpleDim_p = delNpvVec_copy[simple_dim_index_p];
-            simpleDim_h *= horizonScaling;                                  // the usual scaling factors
-            simpleDim_p *= horizonScaling;                                  // the usual scaling factors
-            nettingSetSimpleDIMh_[n][j] = simpleDim_h * E_OneOverNumeraire; // discounted DIM
-            nettingSetSimpleDIMp_[n][j] = simpleDim_p * E_OneOverNumeraire; // discounted DIM
-
-            QL_REQUIRE(rx.size() > v.size(), "not enough points for regression with polynom order " << polynomOrder);
-            if (close_enough(stdevDiff, 0.0)) {
-                LOG("DIM: Zero std dev estimation at step " << j);
-                // Skip IM calculation if all samples have zero NPV (e.g. after latest maturity)
-                for (Size k = 0; k < samples; ++k) {
-                    nettingSetDIM_[n][j][k] = 0.0;
-                    nettingSetLocalDIM_[n][j][k] = 0.0;
-                }
-            } else {
-                // Least squares polynomial regression with specified polynom order
-                QuantExt::StabilisedGLLS ls(rx, ry2, v, QuantExt::StabilisedGLLS::MeanStdDev);
-                LOG("DIM data normalisation at time step "
-                    << j << ": " << scientific << setprecision(6) << " x-shift = " << ls.xShift() << " x-multiplier = "
-                    << ls.xMultiplier() << " y-shift = " << ls.yShift() << " y-multiplier = " << ls.yMultiplier());
-                LOG("DIM regression coefficients at time step " << j << ": " << fixed << setprecision(6)
-                                                                << ls.transformedCoefficients());
-
-                // Local regression versus first regression variable (i.e. we do not perform a
-                // multidimensional local regression):
-                // We evaluate this at a limited number of samples only for validation purposes.
-                // Note that computational effort scales quadratically with number of samples.
-                // NadarayaWatson needs a large number of samples for good results.
-                QuantExt::NadarayaWatson lr(rx0.begin(), rx0.end(), ry1.begin(),
-                                            GaussianKernel(0.0, localRegressionBandWidth_));
-                Size localRegressionSamples = samples;
-                if (localRegressionEvaluations_ > 0)
-                    localRegressionSamples = Size(floor(1.0 * samples / localRegressionEvaluations_ + .5));
-
-                // Evaluate regression function to compute DIM for each scenario
-                for (Size k = 0; k < samples; ++k) {
-                    // Real num1 = scenarioData_->get(j, k, AggregationScenarioDataType::Numeraire);
-                    Real numDefault = cubeInterpretation_->getDefaultAggregationScenarioData(
-                        AggregationScenarioDataType::Numeraire, j, k);
-                    Array regressor = regressors_.empty() ? Array(1, nettingSetNPV_[n][j][k]) : regressorArray(n, j, k);
-                    Real e = ls.eval(regressor, v);
-                    if (e < 0.0)
-                        LOG("Negative variance regression for date " << j << ", sample " << k
-                                                                     << ", regressor = " << regressor);
-
-                    // Note:
-                    // 1) We assume vanishing mean of "z", because the drift over a MPOR is usually small,
-                    //    and to avoid a second regression for the conditional mean
-                    // 2) In particular the linear regression function can yield negative variance values in
-                    //    extreme scenarios where an exact analytical or delta VaR calculation would yield a
-                    //    variance approaching zero. We correct this here by taking the positive part.
-                    Real std = sqrt(std::max(e, 0.0));
-                    Real scalingFactor = horizonScaling * confidenceLevel * nettingSetDimScaling;
-                    // Real dim = std * scalingFactor / num1;
-                    Real dim = std * scalingFactor / numDefault;
-                    dimCube_->set(dim, nettingSetCount, j, k);
-                    nettingSetDIM_[n][j][k] = dim;
-                    nettingSetExpectedDIM_[n][j] += dim / samples;
-
-                    // Evaluate the Kernel regression for a subset of the samples only (performance)
-                    if (localRegressionEvaluations_ > 0 && (k % localRegressionSamples == 0))
-                        // nettingSetLocalDIM_[n][j][k] = lr.standardDeviation(regressor[0]) * scalingFactor / num1;
-                        nettingSetLocalDIM_[n][j][k] = lr.standardDeviation(regressor[0]) * scalingFactor / numDefault;
-                    else
-                        nettingSetLocalDIM_[n][j][k] = 0.0;
-                }
+        } else {
+            // Least squares polynomial regression with specified polynom order
+            QuantExt::StabilisedGLLS ls(rx, ry2, v, QuantExt::StabilisedGLLS::MeanStdDev);
+            LOG("DIM data normalisation at time step "
+                << j << ": " << scientific << setprecision(6) << " x-shift = " << ls.xShift() << " x-multiplier = "
+                << ls.xMultiplier() << " y-shift = " << ls.yShift() << " y-multiplier = " << ls.yMultiplier());
+            LOG("DIM regression coefficients at time step " << j << ": " << fixed << setprecision(6)
+                                                            << ls.transformedCoefficients());
+
+            // Local regression versus first regression variable (i.e. we do not perform a
+            // multidimensional local regression):
+            // We evaluate this at a limited number of samples only for validation purposes.
+            // Note that computational effort scales quadratically with number of samples.
+            // NadarayaWatson needs a large number of samples for good results.
+            QuantExt::NadarayaWatson lr(rx0.begin(), rx0.end(), ry1.begin(),
+                                        GaussianKernel(0.0, localRegressionBandWidth_));
+            Size localRegressionSamples = samples;
+            if (localRegressionEvaluations_ > 0)
+                localRegressionSamples = Size(floor(1.0 * samples / localRegressionEvaluations_ + .5));
+
+            // Evaluate regression function to compute DIM for each scenario, reusing the regressors from above
+            Real scalingFactor = horizonScaling * confidenceLevel * nettingSetDimScaling;
+            Real expectedDim = 0.0;
+            for (Size k = 0; k < samples; ++k) {
+                Real e = ls.eval(rx[k], v);
+                if (e < 0.0)
+                    LOG("Negative variance regression for date " << j << ", sample " << k
+                                                                 << ", regressor = " << rx[k]);
+
+                // Note:
+                // 1) We assume vanishing mean of "z", because the drift over a MPOR is usually small,
+                //    and to avoid a second regression for the conditional mean
+                // 2) In particular the linear regression function can yield negative variance values in
+                //    extreme scenarios where an exact analytical or delta VaR calculation would yield a
+                //    variance approaching zero. We correct this here by taking the positive part.
+                Real std = sqrt(std::max(e, 0.0));
+                Real dim = std * scalingFactor / numDefault[j][k];
+                dimCube_->set(dim, cubeIndex, j, k);
+                dimResult[k] = dim;
+                expectedDim += dim / samples;
+
+                // Evaluate the Kernel regression for a subset of the samples only (performance)
+                if (localRegressionEvaluations_ > 0 && (k % localRegressionSamples == 0))
+                    localDimResult[k] = lr.standardDeviation(rx0[k]) * scalingFactor / numDefault[j][k];
+                else
+                    localDimResult[k] = 0.0;
             }
+            nettingSetExpectedDIM_.at(n)[j] += expectedDim;
         }
-
-        nettingSetCount++;
+    };
+
+    Size nTasks = regressionNettingSets.size() * stopDatesLoop;
+    LOG("DIM regression over " << regressionNettingSets.size() << " netting sets and " << stopDatesLoop
+                               << " dates using " << std::min(threads_, std::max<Size>(nTasks, 1)) << " threads");
+    if (threads_ > 1 && nTasks > 1) {
+        QuantExt::WorkerPool pool(std::min(threads_, nTasks));
+        pool.run(nTasks, task);
+    } else {
+        for (Size t = 0; t < nTasks; ++t)
+            task(t);
     }
+
     LOG("DIM by polynomial regression done");
 }
 
-Array RegressionDynamicInitialMarginCalculator::regressorArray(string nettingSet, Size dateIndex,
-                                                                           Size sampleIndex) {
-    Array a(regressors_.size());
+vector<vector<Real>> RegressionDynamicInitialMarginCalculator::scenarioRegressorValues(Size dateIndex) const {
+    Size samples = cube_->samples();
+    vector<vector<Real>> result(regressors_.size());
     for (Size i = 0; i < regressors_.size(); ++i) {
-        string variable = regressors_[i];
-        if (boost::to_upper_copy(variable) ==
-            "NPV") // this allows possibility to include NPV as a regressor alongside more fundamental risk factors
-            a[i] = nettingSetNPV_[nettingSet][dateIndex][sampleIndex];
-        else if (scenarioData_->has(AggregationScenarioDataType::IndexFixing, variable))
-            a[i] = cubeInterpretation_->getDefaultAggregationScenarioData(AggregationScenarioDataType::IndexFixing,
-                                                                      dateIndex, sampleIndex, variable);
+        const string& variable = regressors_[i];
+        // this allows possibility to include NPV as a regressor alongside more fundamental risk factors
+        if (boost::to_upper_copy(variable) == "NPV")
+            continue;
+        AggregationScenarioDataType type;
+        if (scenarioData_->has(AggregationScenarioDataType::IndexFixing, variable))
+            type = AggregationScenarioDataType::IndexFixing;
         else if (scenarioData_->has(AggregationScenarioDataType::FXSpot, variable))
-            a[i] = cubeInterpretation_->getDefaultAggregationScenarioData(AggregationScenarioDataType::FXSpot, dateIndex,
-                                                                      sampleIndex, variable);
+            type = AggregationScenarioDataType::FXSpot;
         else if (scenarioData_->has(AggregationScenarioDataType::Generic, variable))
-            a[i] = cubeInterpretation_->getDefaultAggregationScenarioData(AggregationScenarioDataType::Generic, dateIndex,
-                                                                      sampleIndex, variable);
+            type = AggregationScenarioDataType::Generic;
         else
             QL_FAIL("scenario data does not provide data for " << variable);
+        result[i].resize(samples);
+        for (Size k = 0; k < samples; ++k)
+            result[i][k] = cubeInterpretation_->getDefaultAggregationScenarioData(type, dateIndex, k, variable);
     }
-    return a;
+    return result;
 }
 
 map<string, Real> RegressionDynamicInitialMarginCalculator::unscaledCurrentDIM() {
@@ -391,7 +438,7 @@ map<string, Real> RegressionDynamicInitialMarginCalculator::unscaledCurrentDIM()
         Real variance_t0 = boost::accumulators::variance(acc_delMtm);
         Real sqrt_t0 = sqrt(variance_t0);
         t0dimReg[key] = (sqrt_t0 * confidenceLevel * E_OneOverNumeraire);
-        std::sort(t0_delMtM_dist.begin(), t0_delMtM_dist.end());
+        std::nth_element(t0_delMtM_dist.begin(), t0_delMtM_dist.begin() + simple_dim_index_h, t0_delMtM_dist.end());
         t0dimSimple[key] = (t0_delMtM_dist[simple_dim_index_h] * E_OneOverNumeraire);
 
         LOG("T0 IM (Reg) - {" << key << "} = " << t0dimReg[key]);
@@ -63,7 +63,9 @@ public:
         //! Local regression band width in standard deviations of the regression variable
         Real localRegressionBandWidth = 0,
 	//! Actual t0 IM by netting set used to scale the DIM evolution, no scaling if the argument is omitted
-	const std::map<std::string, Real>& currentIM = std::map<std::string, Real>());
+	const std::map<std::string, Real>& currentIM = std::map<std::string, Real>(),
+        //! Number of threads used to process the netting sets and dates in parallel
+        const Size threads = 1);
 
     map<string, Real> unscaledCurrentDIM() override;
     void build() override;
@@ -78,13 +80,15 @@ public:
     const vector<Real>& simpleResultsLower(const string& nettingSet);
 
 private:
-    //! Compile the array of DIM regressors for the specified netting set, date and sample index
-    Array regressorArray(string nettingSet, Size dateIndex, Size sampleIndex);
+    /*! Compile the scenario data DIM regressors for the specified date index by regressor and sample, the entries
+        for the NPV regressor are left empty since they depend on the netting set */
+    vector<vector<Real>> scenarioRegressorValues(Size dateIndex) const;
 
     Size regressionOrder_;
     vector<string> regressors_;
     Size localRegressionEvaluations_;
     Real localRegressionBandWidth_;
+    Size threads_;
 
     // For each netting set: Array of regressor values by date and sample
     map<string, vector<vector<Array>>> regressorArray_;
@@ -129,7 +129,13 @@ void ExposureCalculator::build() {
         pfe[0] = std::max(npv0, 0.0);
         exposureCube_->setT0(epe[0], tradeId, ExposureIndex::EPE);
         exposureCube_->setT0(ene[0], tradeId, ExposureIndex::ENE);
+        // the cube values and hence all exposures and netting set contributions vanish beyond the live date range
+        Size liveDates = cube_->liveDates(i);
         for (Size j = 0; j < dates_.size(); ++j) {
+            if (j >= liveDates) {
+                eee_b[j + 1] = eee_b[j];
+                continue;
+            }
             Date d = cube_->dates()[j];
             vector<Real> distribution(cube_->samples(), 0.0);
             for (Size k = 0; k < cube_->samples(); ++k) {
@@ -0,0 +1,254 @@
+/*
+ Copyright (C) 2023 Quaternion Risk Management Ltd
+ All rights reserved.
+
+ This file is part of ORE, a free-software/open-source library
+ for transparent pricing and risk analysis - http://opensourcerisk.org
+
+ ORE is free software: you can redistribute it and/or modify it
+ under the terms of the Modified BSD License.  You should have received a
+ copy of the license along with this program.
+ The license is also available online at <http://opensourcerisk.org>
+
+ This program is distributed on the basis that it will form a useful
+ contribution to risk analytics and model standardisation, but WITHOUT
+ ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ FITNESS FOR A PARTICULAR PURPOSE. See the license for more details.
+*/
+
+#include <orea/aggregation/exposurecalculator.hpp>
+#include <orea/aggregation/incrementalxvacalculator.hpp>
+#include <orea/aggregation/nettedexposurecalculator.hpp>
+#include <orea/aggregation/staticcreditxvacalculator.hpp>
+#include <orea/cube/inmemorycube.hpp>
+
+#include <ored/utilities/log.hpp>
+
+namespace ore {
+namespace analytics {
+
+namespace {
+template <class F> Real sumDifference(const IncrementalXvaCalculator::Result& r, F f) {
+    Real sum = 0.0;
+    for (auto const& [nid, x] : r.incremental) {
+        sum += f(x);
+        auto b = r.baseline.find(nid);
+        if (b != r.baseline.end())
+            sum -= f(b->second);
+    }
+    return sum;
+}
+} // namespace
+
+Real IncrementalXvaCalculator::Result::marginalCva() const {
+    return sumDifference(*this, [](const NettingSetXva& x) { return x.cva; });
+}
+
+Real IncrementalXvaCalculator::Result::marginalDva() const {
+    return sumDifference(*this, [](const NettingSetXva& x) { return x.dva; });
+}
+
+Real IncrementalXvaCalculator::Result::marginalFba() const {
+    return sumDifference(*this, [](const NettingSetXva& x) { return x.fba; });
+}
+
+Real IncrementalXvaCalculator::Result::marginalFca() const {
+    return sumDifference(*this, [](const NettingSetXva& x) { return x.fca; });
+}
+
+IncrementalXvaCalculator::IncrementalXvaCalculator(
+    const boost::shared_ptr<Portfolio>& portfolio, const boost::shared_ptr<NettingSetManager>& nettingSetManager,
+    const boost::shared_ptr<Market>& market, const string& configuration, const boost::shared_ptr<NPVCube>& cube,
+    const boost::shared_ptr<AggregationScenarioData>& scenarioData,
+    const boost::shared_ptr<CubeInterpretation>& cubeInterpretation, const string& baseCurrency, const Real quantile,
+    const string& calculationType, const string& dvaName, const string& fvaBorrowingCurve,
+    const string& fvaLendingCurve, const Real marginalAllocationLimit, const bool fullInitialCollateralisation,
+    const bool exerciseNextBreak, const bool withMporStickyDate, const MporCashFlowMode mporCashFlowMode)
+    : portfolio_(portfolio), nettingSetManager_(nettingSetManager), market_(market), configuration_(configuration),
+      cube_(cube), scenarioData_(scenarioData), cubeInterpretation_(cubeInterpretation), baseCurrency_(baseCurrency),
+      quantile_(quantile), calcType_(parseCollateralCalculationType(calculationType)), dvaName_(dvaName),
+      fvaBorrowingCurve_(fvaBorrowingCurve), fvaLendingCurve_(fvaLendingCurve),
+      marginalAllocationLimit_(marginalAllocationLimit), fullInitialCollateralisation_(fullInitialCollateralisation),
+      exerciseNextBreak_(exerciseNextBreak), withMporStickyDate_(withMporStickyDate),
+      mporCashFlowMode_(mporCashFlowMode) {
+
+    QL_REQUIRE(cubeInterpretation_ != nullptr, "IncrementalXvaCalculator: cubeInterpretation is not given.");
+    QL_REQUIRE(!cubeInterpretation_->flipViewXVA(), "IncrementalXvaCalculator: flipViewXVA is not supported");
+    QL_REQUIRE(marginalAllocationLimit > 0.0, "IncrementalXvaCalculator: positive allocationLimit expected");
+
+    // same defaults and checks as in PostProcess
+
+    if (mporCashFlowMode_ == MporCashFlowMode::Unspecified)
+        mporCashFlowMode_ = withMporStickyDate_ ? MporCashFlowMode::NonePay : MporCashFlowMode::BothPay;
+
+    QL_REQUIRE(!withMporStickyDate_ || mporCashFlowMode_ == MporCashFlowMode::NonePay,
+               "IncrementalXvaCalculator: MporMode StickyDate supports only MporCashFlowMode NonePay");
+    QL_REQUIRE(cubeInterpretation_->storeFlows() || withMporStickyDate_ ||
+                   mporCashFlowMode_ == MporCashFlowMode::BothPay,
+               "IncrementalXvaCalculator: If cube does not hold any mpor flows and MporMode is set to ActualDate, then "
+               "MporCashFlowMode must be set to BothPay");
+
+    QL_REQUIRE(portfolio_->size() == cube_->idsAndIndexes().size(),
+               "IncrementalXvaCalculator: portfolio size (" << portfolio_->size()
+                                                            << ") does not match cube trade size ("
+                                                            << cube_->idsAndIndexes().size() << ")");
+
+    for (auto const& [tradeId, trade] : portfolio_->trades()) {
+        QL_REQUIRE(cube_->idsAndIndexes().count(tradeId) == 1,
+                   "IncrementalXvaCalculator: trade " << tradeId << " not found in cube");
+        nettingSetTrades_[trade->envelope().nettingSetId()].push_back(tradeId);
+    }
+}
+
+const IncrementalXvaCalculator::NettingSetXva& IncrementalXvaCalculator::baseline(const string& nettingSetId) {
+    auto b = baseline_.find(nettingSetId);
+    if (b != baseline_.end())
+        return b->second;
+
+    NettingSetXva result;
+    if (nettingSetTrades_.find(nettingSetId) == nettingSetTrades_.end()) {
+        // a new netting set, i.e. no exposure without the candidate trades
+        result.epe.resize(cube_->dates().size() + 1, 0.0);
+        result.ene.resize(cube_->dates().size() + 1, 0.0);
+    } else {
+        map<string, NettingSetXva> nettingSetXva;
+        map<string, Real> allocatedCva, allocatedDva;
+        run({nettingSetId}, nullptr, nullptr, nettingSetXva, allocatedCva, allocatedDva);
+        result = nettingSetXva.at(nettingSetId);
+    }
+    return baseline_[nettingSetId] = result;
+}
+
+IncrementalXvaCalculator::Result IncrementalXvaCalculator::calculate(const boost::shared_ptr<Portfolio>& candidates,
+                                                                     const boost::shared_ptr<NPVCube>& candidateCube) {
+    QL_REQUIRE(candidates != nullptr && candidates->size() > 0, "IncrementalXvaCalculator: no candidate trades given");
+    QL_REQUIRE(candidateCube != nullptr, "IncrementalXvaCalculator: no candidate cube given");
+    QL_REQUIRE(candidates->size() == candidateCube->idsAndIndexes().size(),
+               "IncrementalXvaCalculator: candidate portfolio size ("
+                   << candidates->size() << ") does not match candidate cube trade size ("
+                   << candidateCube->idsAndIndexes().size() << ")");
+    QL_REQUIRE(candidateCube->dates() == cube_->dates(),
+               "IncrementalXvaCalculator: candidate cube dates do not match the cube dates");
+    QL_REQUIRE(candidateCube->samples() == cube_->samples(), "IncrementalXvaCalculator: candidate cube samples ("
+                                                                 << candidateCube->samples()
+                                                                 << ") do not match the cube samples ("
+                                                                 << cube_->samples() << ")");
+    QL_REQUIRE(candidateCube->depth() == cube_->depth(), "IncrementalXvaCalculator: candidate cube depth ("
+                                                             << candidateCube->depth()
+                                                             << ") does not match the cube depth (" << cube_->depth()
+                                                             << ")");
+
+    set<string> nettingSetIds;
+    for (auto const& [tradeId, trade] : candidates->trades()) {
+        QL_REQUIRE(!portfolio_->has(tradeId),
+                   "IncrementalXvaCalculator: candidate trade " << tradeId << " already exists in the portfolio");
+        QL_REQUIRE(candidateCube->idsAndIndexes().count(tradeId) == 1,
+                   "IncrementalXvaCalculator: candidate trade " << tradeId << " not found in candidate cube");
+        nettingSetIds.insert(trade->envelope().nettingSetId());
+    }
+
+    Result result;
+    for (auto const& nid : nettingSetIds)
+        result.baseline[nid] = baseline(nid);
+
+    LOG("IncrementalXvaCalculator: compute xva for " << candidates->size() << " candidate trades in "
+                                                     << nettingSetIds.size() << " netting sets");
+    run(nettingSetIds, candidates, candidateCube, result.incremental, result.allocatedCva, result.allocatedDva);
+
+    return result;
+}
+
+void IncrementalXvaCalculator::run(const set<string>& nettingSetIds, const boost::shared_ptr<Portfolio>& candidates,
+                                   const boost::shared_ptr<NPVCube>& candidateCube,
+                                   map<string, NettingSetXva>& nettingSetXva, map<string, Real>& allocatedCva,
+                                   map<string, Real>& allocatedDva) const {
+
+    // collect the trades of the netting sets and the source cube and index of their values
+
+    auto portfolio = boost::make_shared<Portfolio>();
+    map<string, pair<NPVCube*, Size>> source;
+    for (auto const& nid : nettingSetIds) {
+        auto t = nettingSetTrades_.find(nid);
+        if (t == nettingSetTrades_.end())
+            continue;
+        for (auto const& tradeId : t->second) {
+            portfolio->add(portfolio_->get(tradeId));
+            source[tradeId] = std::make_pair(cube_.get(), cube_->idsAndIndexes().at(tradeId));
+        }
+    }
+    if (candidates) {
+        for (auto const& [tradeId, trade] : candidates->trades()) {
+            portfolio->add(trade);
+            source[tradeId] = std::make_pair(candidateCube.get(), candidateCube->idsAndIndexes().at(tradeId));
+        }
+    }
+
+    // copy the values into a cube consistent with the portfolio, i.e. with the same trade ids in the same order
+
+    set<string> tradeIds;
+    for (auto const& s : source)
+        tradeIds.insert(s.first);
+    auto cube = boost::make_shared<DoublePrecisionInMemoryCubeN>(cube_->asof(), tradeIds, cube_->dates(),
+                                                                 cube_->samples(), cube_->depth());
+    Size i = 0;
+    for (auto const& [tradeId, s] : source) {
+        for (Size d = 0; d < cube_->depth(); ++d) {
+            cube->setT0(s.first->getT0(s.second, d), i, d);
+            for (Size j = 0; j < cube_->dates().size(); ++j)
+                for (Size k = 0; k < cube_->samples(); ++k)
+                    cube->set(s.first->get(s.second, j, k, d), i, j, k, d);
+        }
+        ++i;
+    }
+
+    // run the exposure and xva calculators as in PostProcess on the subset of trades
+
+    auto exposureCalculator = boost::make_shared<ExposureCalculator>(
+        portfolio, cube, cubeInterpretation_, market_, exerciseNextBreak_, baseCurrency_, configuration_, quantile_,
+        calcType_, false, false);
+    exposureCalculator->build();
+
+    auto nettedExposureCalculator = boost::make_shared<NettedExposureCalculator>(
+        portfolio, market_, cube, baseCurrency_, configuration_, quantile_, calcType_, false, nettingSetManager_,
+        exposureCalculator->nettingSetDefaultValue(), exposureCalculator->nettingSetCloseOutValue(),
+        exposureCalculator->nettingSetMporPositiveFlow(), exposureCalculator->nettingSetMporNegativeFlow(),
+        scenarioData_, cubeInterpretation_, false, nullptr, fullInitialCollateralisation_, candidates != nullptr,
+        marginalAllocationLimit_, exposureCalculator->exposureCube(), ExposureCalculator::allocatedEPE,
+        ExposureCalculator::allocatedENE, false, withMporStickyDate_, mporCashFlowMode_);
+    nettedExposureCalculator->build();
+
+    StaticCreditXvaCalculator xvaCalculator(
+        portfolio, market_, configuration_, baseCurrency_, dvaName_, fvaBorrowingCurve_, fvaLendingCurve_, false,
+        nullptr, exposureCalculator->exposureCube(), nettedExposureCalculator->exposureCube(),
+        ExposureCalculator::EPE, ExposureCalculator::ENE, NettedExposureCalculator::EPE,
+        NettedExposureCalculator::ENE);
+    xvaCalculator.build();
+
+    for (auto const& nid : nettingSetIds) {
+        NettingSetXva& x = nettingSetXva[nid];
+        x.cva = xvaCalculator.nettingSetCva(nid);
+        x.dva = xvaCalculator.nettingSetDva(nid);
+        x.fba = xvaCalculator.nettingSetFba(nid);
+        x.fca = xvaCalculator.nettingSetFca(nid);
+        x.epe = nettedExposureCalculator->epe(nid);
+        x.ene = nettedExposureCalculator->ene(nid);
+    }
+
+    // allocated xva of the candidate trades
+
+    if (candidates) {
+        StaticCreditXvaCalculator allocatedXvaCalculator(
+            portfolio, market_, configuration_, baseCurrency_, dvaName_, fvaBorrowingCurve_, fvaLendingCurve_, false,
+            nullptr, exposureCalculator->exposureCube(), nettedExposureCalculator->exposureCube(),
+            ExposureCalculator::allocatedEPE, ExposureCalculator::allocatedENE, NettedExposureCalculator::EPE,
+            NettedExposureCalculator::ENE);
+        allocatedXvaCalculator.build();
+        for (auto const& [tradeId, trade] : candidates->trades()) {
+            allocatedCva[tradeId] = allocatedXvaCalculator.tradeCva(tradeId);
+            allocatedDva[tradeId] = allocatedXvaCalculator.tradeDva(tradeId);
+        }
+    }
+}
+
+} // namespace analytics
+} // namespace ore
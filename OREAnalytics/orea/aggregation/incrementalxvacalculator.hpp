@@ -0,0 +1,134 @@
+/*
+ Copyright (C) 2023 Quaternion Risk Management Ltd
+ All rights reserved.
+
+ This file is part of ORE, a free-software/open-source library
+ for transparent pricing and risk analysis - http://opensourcerisk.org
+
+ ORE is free software: you can redistribute it and/or modify it
+ under the terms of the Modified BSD License.  You should have received a
+ copy of the license along with this program.
+ The license is also available online at <http://opensourcerisk.org>
+
+ This program is distributed on the basis that it will form a useful
+ contribution to risk analytics and model standardisation, but WITHOUT
+ ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ FITNESS FOR A PARTICULAR PURPOSE. See the license for more details.
+*/
+
+/*! \file orea/aggregation/incrementalxvacalculator.hpp
+    \brief Incremental (what-if) XVA for candidate trades against an existing NPV cube
+    \ingroup analytics
+*/
+
+#pragma once
+
+#include <orea/aggregation/collatexposurehelper.hpp>
+#include <orea/cube/cubeinterpretation.hpp>
+#include <orea/cube/npvcube.hpp>
+#include <orea/scenario/aggregationscenariodata.hpp>
+
+#include <ored/marketdata/market.hpp>
+#include <ored/portfolio/nettingsetmanager.hpp>
+#include <ored/portfolio/portfolio.hpp>
+#include <ored/utilities/parsers.hpp>
+
+namespace ore {
+namespace analytics {
+using namespace QuantLib;
+using namespace data;
+using namespace std;
+
+//! Incremental XVA calculator
+/*!
+  Computes the marginal XVA of candidate trades against the NPV cube of a previous run, e.g. an overnight cube
+  loaded from disk. The candidate trades must be priced on the same scenarios, i.e. their cube must have the same
+  dates, samples and depth as the existing cube.
+
+  Only the netting sets the candidate trades belong to are processed: the existing trades of these netting sets and
+  the candidate trades are aggregated to netting set exposures, collateral balances and static credit XVA using the
+  same calculators as in PostProcess (ExposureCalculator, NettedExposureCalculator and StaticCreditXvaCalculator).
+  The results without the candidate trades are computed once per netting set and cached, so that repeated what-if
+  calculations only require the run with the candidate trades added.
+
+  The candidate trades' XVA is allocated using the marginal allocation method of the NettedExposureCalculator.
+
+  Dynamic credit, dynamic initial margin (and hence MVA) and the flipped view are not supported.
+*/
+class IncrementalXvaCalculator {
+public:
+    //! XVA and exposure profiles of a netting set
+    struct NettingSetXva {
+        Real cva = 0.0, dva = 0.0, fba = 0.0, fca = 0.0;
+        //! expected positive / negative exposure including t0, i.e. of size cube dates + 1
+        vector<Real> epe, ene;
+    };
+
+    //! Results of an incremental calculation
+    struct Result {
+        //! affected netting sets without the candidate trades
+        map<string, NettingSetXva> baseline;
+        //! affected netting sets with the candidate trades
+        map<string, NettingSetXva> incremental;
+        //! allocated XVA of the candidate trades
+        map<string, Real> allocatedCva, allocatedDva;
+
+        //! marginal XVA, summed over the affected netting sets
+        Real marginalCva() const;
+        Real marginalDva() const;
+        Real marginalFba() const;
+        Real marginalFca() const;
+    };
+
+    /*! For the parameters see PostProcess, the portfolio and the cube must be consistent, i.e. contain the same trade
+        ids in the same order */
+    IncrementalXvaCalculator(const boost::shared_ptr<Portfolio>& portfolio,
+                             const boost::shared_ptr<NettingSetManager>& nettingSetManager,
+                             const boost::shared_ptr<Market>& market, const string& configuration,
+                             const boost::shared_ptr<NPVCube>& cube,
+                             const boost::shared_ptr<AggregationScenarioData>& scenarioData,
+                             const boost::shared_ptr<CubeInterpretation>& cubeInterpretation,
+                             const string& baseCurrency, const Real quantile = 0.95,
+                             const string& calculationType = "Symmetric", const string& dvaName = "",
+                             const string& fvaBorrowingCurve = "", const string& fvaLendingCurve = "",
+                             const Real marginalAllocationLimit = 1.0, const bool fullInitialCollateralisation = false,
+                             const bool exerciseNextBreak = false, const bool withMporStickyDate = false,
+                             const MporCashFlowMode mporCashFlowMode = MporCashFlowMode::Unspecified);
+
+    /*! Compute the XVA of the netting sets of the candidate trades with and without these trades. The candidate
+        portfolio and cube must be consistent and the candidate trade ids must not exist in the portfolio. */
+    Result calculate(const boost::shared_ptr<Portfolio>& candidates, const boost::shared_ptr<NPVCube>& candidateCube);
+
+    //! XVA of a netting set of the portfolio without candidate trades
+    const NettingSetXva& baseline(const string& nettingSetId);
+
+private:
+    /* aggregate the trades of the portfolio in the given netting sets together with the candidate trades (if not
+       null), fill the netting set results and the allocated XVA of the candidate trades */
+    void run(const set<string>& nettingSetIds, const boost::shared_ptr<Portfolio>& candidates,
+             const boost::shared_ptr<NPVCube>& candidateCube, map<string, NettingSetXva>& nettingSetXva,
+             map<string, Real>& allocatedCva, map<string, Real>& allocatedDva) const;
+
+    boost::shared_ptr<Portfolio> portfolio_;
+    boost::shared_ptr<NettingSetManager> nettingSetManager_;
+    boost::shared_ptr<Market> market_;
+    string configuration_;
+    boost::shared_ptr<NPVCube> cube_;
+    boost::shared_ptr<AggregationScenarioData> scenarioData_;
+    boost::shared_ptr<CubeInterpretation> cubeInterpretation_;
+    string baseCurrency_;
+    Real quantile_;
+    CollateralExposureHelper::CalculationType calcType_;
+    string dvaName_, fvaBorrowingCurve_, fvaLendingCurve_;
+    Real marginalAllocationLimit_;
+    bool fullInitialCollateralisation_, exerciseNextBreak_, withMporStickyDate_;
+    MporCashFlowMode mporCashFlowMode_;
+
+    // trade ids of the portfolio per netting set
+    map<string, vector<string>> nettingSetTrades_;
+    // cached results without candidate trades
+    map<string, NettingSetXva> baseline_;
+};
+
+} // namespace analytics
+} // namespace ore
@@ -20,6 +20,8 @@
 
 #include <ored/portfolio/trade.hpp>
 
+#include <qle/utilities/workerpool.hpp>
+
 #include <ql/time/date.hpp>
 #include <ql/time/calendars/weekendsonly.hpp>
 
@@ -43,7 +45,8 @@ NettedExposureCalculator::NettedExposureCalculator(
     const boost::shared_ptr<DynamicInitialMarginCalculator>& dimCalculator, const bool fullInitialCollateralisation,
     const bool marginalAllocation, const Real marginalAllocationLimit,
     const boost::shared_ptr<NPVCube>& tradeExposureCube, const Size allocatedEpeIndex, const Size allocatedEneIndex,
-    const bool flipViewXVA, const bool withMporStickyDate, const MporCashFlowMode mporCashFlowMode)
+    const bool flipViewXVA, const bool withMporStickyDate, const MporCashFlowMode mporCashFlowMode,
+    const Size threads)
     : portfolio_(portfolio), market_(market), cube_(cube), baseCurrency_(baseCurrency), configuration_(configuration),
       quantile_(quantile), calcType_(calcType), multiPath_(multiPath), nettingSetManager_(nettingSetManager),
       nettingSetDefaultValue_(nettingSetDefaultValue), nettingSetCloseOutValue_(nettingSetCloseOutValue),
@@ -53,7 +56,7 @@ NettedExposureCalculator::NettedExposureCalculator(
       marginalAllocation_(marginalAllocation), marginalAllocationLimit_(marginalAllocationLimit),
       tradeExposureCube_(tradeExposureCube), allocatedEpeIndex_(allocatedEpeIndex),
       allocatedEneIndex_(allocatedEneIndex), flipViewXVA_(flipViewXVA), withMporStickyDate_(withMporStickyDate),
-      mporCashFlowMode_(mporCashFlowMode) {
+      mporCashFlowMode_(mporCashFlowMode), threads_(threads) {
 
     set<string> nettingSetIds;
     for (auto nettingSet : nettingSetDefaultValue) {
@@ -126,8 +129,23 @@ void NettedExposureCalculator::build() {
     vector<vector<Real>> averagePositiveAllocation(portfolio_->size(), vector<Real>(cube_->dates().size(), 0.0));
     vector<vector<Real>> averageNegativeAllocation(portfolio_->size(), vector<Real>(cube_->dates().size(), 0.0));
 
+    // The collateral account balance paths are simulated for chunks of netting sets with one netting set per thread,
+    // so that only the balances and scenario data of one chunk are held at a time.
+    // There are no balances for netting sets without CSA or with inactive CSA.
+    map<string, vector<vector<Real>>> collateralBalance;
+    auto chunkEnd = nettingSetDefaultValue_.begin();
+
     Size nettingSetCount = 0;
-    for (auto n : nettingSetDefaultValue_) {
+    for (auto nIt = nettingSetDefaultValue_.begin(); nIt != nettingSetDefaultValue_.end(); ++nIt) {
+        if (nIt == chunkEnd) {
+            collateralBalance.clear();
+            vector<string> chunk;
+            for (; chunkEnd != nettingSetDefaultValue_.end() && chunk.size() < std::max<Size>(threads_, 1);
+                 ++chunkEnd)
+                chunk.push_back(chunkEnd->first);
+            collateralBalance = collateralBalances(chunk, nettingSetValueToday, nettingSetMaturity);
+        }
+        const auto& n = *nIt;
         string nettingSetId = n.first;
         vector<vector<Real>> data = n.second;
         boost::shared_ptr<NettingSetDefinition> netting = nettingSetManager_->get(nettingSetId);
@@ -139,13 +157,8 @@ void NettedExposureCalculator::build() {
         vector<vector<Real>> nettingSetMporNegativeFlow = nettingSetMporNegativeFlow_[nettingSetId];
 
         LOG("Aggregate exposure for netting set " << nettingSetId);
-        // Get the collateral account balance paths for the netting set.
-        // The pointer may remain empty if there is no CSA or if it is inactive.
-        boost::shared_ptr<vector<boost::shared_ptr<CollateralAccount>>> collateral =
-            collateralPaths(nettingSetId,
-                            nettingSetValueToday[nettingSetId],
-                            nettingSetDefaultValue_[nettingSetId],
-                            nettingSetMaturity[nettingSetId]);
+        auto c = collateralBalance.find(nettingSetId);
+        const vector<vector<Real>>* collateral = c == collateralBalance.end() ? nullptr : &c->second;
 
 	// Get the CSA index for Eonia Floor calculation below
         colva_[nettingSetId] = 0.0;
@@ -216,7 +229,7 @@ void NettedExposureCalculator::build() {
             for (Size k = 0; k < cube_->samples(); ++k) {
                 Real balance = 0.0;
                 if (collateral) {
-                    balance = collateral->at(k)->accountBalance(date);
+                    balance = (*collateral)[j][k];
                     if (netting->csaDetails()->csaCurrency() != baseCurrency_) {
                         // Convert from CSACurrency to baseCurrency
                         double fxRate = scenarioData_->get(j, k, AggregationScenarioDataType::FXSpot,
@@ -390,78 +403,108 @@ void NettedExposureCalculator::build() {
     }
 }
 
-boost::shared_ptr<vector<boost::shared_ptr<CollateralAccount>>>
-NettedExposureCalculator::collateralPaths(
-    const string& nettingSetId,
-    const Real& nettingSetValueToday,
-    const vector<vector<Real>>& nettingSetValue,
-    const Date& nettingSetMaturity) {
+map<string, vector<vector<Real>>>
+NettedExposureCalculator::collateralBalances(const vector<string>& nettingSetIds,
+                                             const map<string, Real>& nettingSetValueToday,
+                                             const map<string, Date>& nettingSetMaturity) {
+
+    // collect the inputs of the collateral simulation, this requires market access and is done sequentially
+
+    struct CollateralInput {
+        string nettingSetId;
+        boost::shared_ptr<NettingSetDefinition> netting;
+        Real csaFxRateToday, csaRateToday;
+        vector<vector<Real>> csaScenFxRates, csaScenRates;
+    };
+    vector<CollateralInput> inputs;
+
+    for (auto const& nettingSetId : nettingSetIds) {
+        if (!nettingSetManager_->has(nettingSetId) || !nettingSetManager_->get(nettingSetId)->activeCsaFlag()) {
+            LOG("CSA missing or inactive for netting set " << nettingSetId);
+            continue;
+        }
 
-    boost::shared_ptr<vector<boost::shared_ptr<CollateralAccount>>> collateral;
+        LOG("Build collateral account balance paths for netting set " << nettingSetId);
+        boost::shared_ptr<NettingSetDefinition> netting = nettingSetManager_->get(nettingSetId);
+        string csaFxPair = netting->csaDetails()->csaCurrency() + baseCurrency_;
+        Real csaFxRateToday = 1.0;
+        if (netting->csaDetails()->csaCurrency() != baseCurrency_)
+            csaFxRateToday = market_->fxRate(csaFxPair, configuration_)->value();
+        LOG("CSA FX rate for pair " << csaFxPair << " = " << csaFxRateToday);
+
+        // Don't use Settings::instance().evaluationDate() here, this has moved to simulation end date.
+        Date today = market_->asofDate();
+        string csaIndexName = netting->csaDetails()->index();
+        // avoid thrown errors of the index fixing here on holidays of the index, instead take the preceding date then.
+        if (!market_->iborIndex(csaIndexName, configuration_)->isValidFixingDate(today)) {
+            today = market_->iborIndex(csaIndexName, configuration_)->fixingCalendar().adjust(today, Preceding);
+        }
+        Real csaRateToday = market_->iborIndex(csaIndexName, configuration_)->fixing(today);
+        LOG("CSA compounding rate for index " << csaIndexName << " = " << setprecision(8) << csaRateToday
+                                              << " as of " << today);
+
+        // Copy scenario data to keep the collateral exposure helper unchanged
+        vector<vector<Real>> csaScenFxRates(cube_->dates().size(), vector<Real>(cube_->samples(), 0.0));
+        vector<vector<Real>> csaScenRates(cube_->dates().size(), vector<Real>(cube_->samples(), 0.0));
+        if (netting->csaDetails()->csaCurrency() != baseCurrency_) {
+            QL_REQUIRE(scenarioData_->has(AggregationScenarioDataType::FXSpot, netting->csaDetails()->csaCurrency()),
+                       "scenario data does not provide FX rates for " << csaFxPair);
+        }
+        if (csaIndexName != "") {
+            QL_REQUIRE(scenarioData_->has(AggregationScenarioDataType::IndexFixing, csaIndexName),
+                       "scenario data does not provide index values for " << csaIndexName);
+        }
+        for (Size j = 0; j < cube_->dates().size(); ++j) {
+            for (Size k = 0; k < cube_->samples(); ++k) {
+                if (netting->csaDetails()->csaCurrency() != baseCurrency_)
+                    csaScenFxRates[j][k] = cubeInterpretation_->getDefaultAggregationScenarioData(
+                        AggregationScenarioDataType::FXSpot, j, k, netting->csaDetails()->csaCurrency());
+                else
+                    csaScenFxRates[j][k] = 1.0;
+                if (csaIndexName != "") {
+                    csaScenRates[j][k] = cubeInterpretation_->getDefaultAggregationScenarioData(
+                        AggregationScenarioDataType::IndexFixing, j, k, csaIndexName);
+                }
+            }
+        }
 
-    if (!nettingSetManager_->has(nettingSetId) || !nettingSetManager_->get(nettingSetId)->activeCsaFlag()) {
-        LOG("CSA missing or inactive for netting set " << nettingSetId);
-        return collateral;
+        inputs.push_back({nettingSetId, netting, csaFxRateToday, csaRateToday, std::move(csaScenFxRates),
+                          std::move(csaScenRates)});
     }
 
-    LOG("Build collateral account balance paths for netting set " << nettingSetId);
-    boost::shared_ptr<NettingSetDefinition> netting = nettingSetManager_->get(nettingSetId);
-    string csaFxPair = netting->csaDetails()->csaCurrency() + baseCurrency_;
-    Real csaFxRateToday = 1.0;
-    if (netting->csaDetails()->csaCurrency() != baseCurrency_)
-        csaFxRateToday = market_->fxRate(csaFxPair, configuration_)->value();
-    LOG("CSA FX rate for pair " << csaFxPair << " = " << csaFxRateToday);
-
-    // Don't use Settings::instance().evaluationDate() here, this has moved to simulation end date.
-    Date today = market_->asofDate();
-    string csaIndexName = netting->csaDetails()->index();
-    // avoid thrown errors of the index fixing here on holidays of the index, instead take the preceding date then.
-    if (!market_->iborIndex(csaIndexName, configuration_)->isValidFixingDate(today)) {
-        today = market_->iborIndex(csaIndexName, configuration_)->fixingCalendar().adjust(today, Preceding);
-    }
-    Real csaRateToday = market_->iborIndex(csaIndexName, configuration_)->fixing(today);
-    LOG("CSA compounding rate for index " << csaIndexName << " = " << setprecision(8) << csaRateToday << " as of " << today);
-
-    // Copy scenario data to keep the collateral exposure helper unchanged
-    vector<vector<Real>> csaScenFxRates(cube_->dates().size(), vector<Real>(cube_->samples(), 0.0));
-    vector<vector<Real>> csaScenRates(cube_->dates().size(), vector<Real>(cube_->samples(), 0.0));
-    if (netting->csaDetails()->csaCurrency() != baseCurrency_) {
-        QL_REQUIRE(scenarioData_->has(AggregationScenarioDataType::FXSpot, netting->csaDetails()->csaCurrency()),
-                   "scenario data does not provide FX rates for " << csaFxPair);
-    }
-    if (csaIndexName != "") {
-        QL_REQUIRE(scenarioData_->has(AggregationScenarioDataType::IndexFixing, csaIndexName),
-                   "scenario data does not provide index values for " << csaIndexName);
-    }
-    for (Size j = 0; j < cube_->dates().size(); ++j) {
-        for (Size k = 0; k < cube_->samples(); ++k) {
-	  if (netting->csaDetails()->csaCurrency() != baseCurrency_)
-              csaScenFxRates[j][k] = cubeInterpretation_->getDefaultAggregationScenarioData(
-                  AggregationScenarioDataType::FXSpot, j, k, netting->csaDetails()->csaCurrency());
-            else
-                csaScenFxRates[j][k] = 1.0;
-            if (csaIndexName != "") {
-                csaScenRates[j][k] = cubeInterpretation_->getDefaultAggregationScenarioData(
-                    AggregationScenarioDataType::IndexFixing, j, k, csaIndexName);
-            }
-        }
+    // the collateral simulation only depends on the inputs and runs in parallel over the netting sets
+
+    const Date asof = market_->asofDate();
+    vector<vector<vector<Real>>> balances(inputs.size());
+    auto simulate = [this, &asof, &inputs, &balances, &nettingSetValueToday, &nettingSetMaturity](const Size i) {
+        const CollateralInput& in = inputs[i];
+        balances[i] = CollateralExposureHelper::collateralBalances(
+            in.netting,                                  // this netting set's definition
+            nettingSetValueToday.at(in.nettingSetId),    // today's netting set NPV
+            asof,                                        // original evaluation date
+            nettingSetDefaultValue_.at(in.nettingSetId), // matrix of netting set values by date and sample
+            nettingSetMaturity.at(in.nettingSetId),      // netting set's maximum maturity date
+            cube_->dates(),                              // vector of future evaluation dates
+            in.csaFxRateToday,                           // today's FX rate for CSA to base currency, possibly 1
+            in.csaScenFxRates,                           // matrix of fx rates by date and sample, possibly 1
+            in.csaRateToday,                             // today's collateral compounding rate in CSA currency
+            in.csaScenRates,                             // matrix of CSA ccy short rates by date and sample
+            calcType_);
+    };
+    if (threads_ > 1 && inputs.size() > 1) {
+        QuantExt::WorkerPool pool(std::min(threads_, inputs.size()));
+        pool.run(inputs.size(), simulate);
+    } else {
+        for (Size i = 0; i < inputs.size(); ++i)
+            simulate(i);
     }
 
-    collateral = CollateralExposureHelper::collateralBalancePaths(
-        netting,              // this netting set's definition
-        nettingSetValueToday, // today's netting set NPV
-        market_->asofDate(),  // original evaluation date
-        nettingSetValue,      // matrix of netting set values by date and sample
-        nettingSetMaturity,   // netting set's maximum maturity date
-        cube_->dates(),               // vector of future evaluation dates
-        csaFxRateToday,       // today's FX rate for CSA to base currency, possibly 1
-        csaScenFxRates,       // matrix of fx rates by date and sample, possibly 1
-        csaRateToday,         // today's collateral compounding rate in CSA currency
-        csaScenRates,         // matrix of CSA ccy short rates by date and sample
-        calcType_);
-    LOG("Collateral account balance paths for netting set " << nettingSetId << " done");
-
-    return collateral;
+    map<string, vector<vector<Real>>> result;
+    for (Size i = 0; i < inputs.size(); ++i) {
+        LOG("Collateral account balance paths for netting set " << inputs[i].nettingSetId << " done");
+        result[inputs[i].nettingSetId] = std::move(balances[i]);
+    }
+    return result;
 }
 
 vector<Real> NettedExposureCalculator::getMeanExposure(const string& tid, ExposureIndex index) {
@@ -59,7 +59,9 @@ public:
         // Marginal Allocation
         const bool marginalAllocation, const Real marginalAllocationLimit,
         const boost::shared_ptr<NPVCube>& tradeExposureCube, const Size allocatedEpeIndex, const Size allocatedEneIndex,
-        const bool flipViewXVA, const bool withMporStickyDate, const MporCashFlowMode mporCashFlowMode);
+        const bool flipViewXVA, const bool withMporStickyDate, const MporCashFlowMode mporCashFlowMode,
+        // Number of threads for the collateral simulation of the netting sets
+        const Size threads = 1);
 
     virtual ~NettedExposureCalculator() {}
     const boost::shared_ptr<NPVCube>& exposureCube() { return exposureCube_; }
@@ -135,14 +137,14 @@ protected:
     map<string, Real> collateralFloor_;
     vector<Real> getMeanExposure(const string& tid, ExposureIndex index);
 
-    boost::shared_ptr<vector<boost::shared_ptr<CollateralAccount>>>
-    collateralPaths(const string& nettingSetId,
-        const Real& nettingSetValueToday,
-        const vector<vector<Real>>& nettingSetValue,
-        const Date& nettingSetMaturity);
+    // collateral balances by date and sample for the given netting sets with active CSA, computed in parallel
+    map<string, vector<vector<Real>>> collateralBalances(const vector<string>& nettingSetIds,
+                                                         const map<string, Real>& nettingSetValueToday,
+                                                         const map<string, Date>& nettingSetMaturity);
 
     bool withMporStickyDate_;
     MporCashFlowMode mporCashFlowMode_;
+    Size threads_;
 };
 
 } // namespace analytics
@@ -25,6 +25,7 @@
 
 #include <orea/aggregation/collatexposurehelper.hpp>
 #include <orea/aggregation/creditmigrationcalculator.hpp>
+#include <orea/aggregation/cvaspreadsensitivitycalculator.hpp>
 #include <orea/aggregation/dimcalculator.hpp>
 #include <orea/aggregation/exposurecalculator.hpp>
 #include <orea/aggregation/nettedexposurecalculator.hpp>
@@ -167,7 +168,12 @@ public:
         //! If set to true, cash flows in the margin period of risk are ignored in the collateral modelling
         bool withMporStickyDate = false,
         //! Treatment of cash flows over the margin period of risk
-        const MporCashFlowMode mporCashFlowMode = MporCashFlowMode::Unspecified);
+        const MporCashFlowMode mporCashFlowMode = MporCashFlowMode::Unspecified,
+        //! Number of threads for the collateral simulation of the netting sets
+        const Size threads = 1,
+        //! CVA spread sensitivity calculation method
+        const CVASpreadSensitivityCalculator::Method cvaSpreadSensiMethod =
+            CVASpreadSensitivityCalculator::Method::BumpAndRevalue);
 
     void setDimCalculator(boost::shared_ptr<DynamicInitialMarginCalculator> dimCalculator) {
         dimCalculator_ = dimCalculator;
@@ -359,6 +365,7 @@ protected:
     vector<Period> cvaSpreadSensiGrid_;
     vector<Time> cvaSpreadSensiTimes_;
     Real cvaSpreadSensiShiftSize_;
+    CVASpreadSensitivityCalculator::Method cvaSpreadSensiMethod_;
     Real kvaCapitalDiscountRate_;
     Real kvaAlpha_;
     Real kvaRegAdjustment_;
@@ -378,6 +385,7 @@ protected:
     std::vector<std::vector<Real>> creditMigrationPdf_;
     bool withMporStickyDate_;
     MporCashFlowMode mporCashFlowMode_;
+    Size threads_;
 };
 
 } // namespace analytics
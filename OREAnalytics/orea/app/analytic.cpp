@@ -159,6 +159,12 @@ void Analytic::buildMarket(const boost::shared_ptr<ore::data::InMemoryLoader>& l
     QL_REQUIRE(loader, "market data loader not set");
     QL_REQUIRE(configurations().curveConfig, "curve configurations not set");
     
+    // in resident mode the market is kept as long as the loader did not change
+    if (resident_ && market_ && loader_ == loader) {
+        LOG("Reuse resident market");
+        return;
+    }
+
     // first build the market if we have a todaysMarketParams
     if (configurations().todaysMarketParams) {
         try {
@@ -192,6 +198,11 @@ void Analytic::marketCalibration(const boost::shared_ptr<MarketCalibrationReport
 }
 
 void Analytic::buildPortfolio() {
+    if (resident_ && market_ && portfolio_ && residentEngineFactory_) {
+        buildResidentPortfolio();
+        return;
+    }
+
     QuantLib::ext::shared_ptr<Portfolio> tmp = portfolio_ ? portfolio_ : inputs()->portfolio();
         
     // create a new empty portfolio
@@ -210,6 +221,11 @@ void Analytic::buildPortfolio() {
         boost::shared_ptr<EngineFactory> factory = impl()->engineFactory();
         portfolio()->build(factory, "analytic/" + label());
 
+        if (resident_) {
+            residentEngineFactory_ = factory;
+            residentTrades_ = tmp->trades();
+        }
+
         // remove dates that will have matured
         Date maturityDate = inputs()->asof();
         if (inputs()->portfolioFilterDate() != Null<Date>())
@@ -217,11 +233,94 @@ void Analytic::buildPortfolio() {
 
         LOG("Filter trades that expire before " << maturityDate);
         portfolio()->removeMatured(maturityDate);
+
+        if (resident_) {
+            residentInstruments_.clear();
+            for (const auto& [tradeId, trade] : portfolio()->trades())
+                residentInstruments_[tradeId] = trade->instrument();
+        }
     } else {
         ALOG("Skip building the portfolio, because market not set");
     }
 }
 
+void Analytic::buildResidentPortfolio() {
+    LOG("Update the resident portfolio");
+    const QuantLib::ext::shared_ptr<Portfolio>& source = inputs()->portfolio();
+
+    /* Remove trades that were removed from or amended in the input portfolio since the last build. The trade
+       objects are shared with other analytics, e.g. the xva analytic resets them and builds them against the
+       simulation market. The instrument wrapper is replaced on each reset and build, so a trade whose instrument
+       differs from the one recorded after our last build was rebuilt elsewhere and is removed as well. */
+    Size removed = 0, rebuilt = 0;
+    for (auto it = residentTrades_.begin(); it != residentTrades_.end();) {
+        bool amended = source->get(it->first) != it->second;
+        bool stale = false;
+        if (!amended) {
+            auto trade = portfolio()->get(it->first);
+            auto inst = residentInstruments_.find(it->first);
+            stale = trade && (inst == residentInstruments_.end() || trade->instrument() != inst->second);
+        }
+        if (amended || stale) {
+            portfolio()->remove(it->first);
+            residentInstruments_.erase(it->first);
+            it = residentTrades_.erase(it);
+            if (amended)
+                ++removed;
+            else
+                ++rebuilt;
+        } else {
+            ++it;
+        }
+    }
+
+    // build the new trades using the resident engine factory, i.e. reusing the engine builders and their models
+    auto newTrades = boost::make_shared<Portfolio>(inputs()->buildFailedTrades());
+    for (const auto& [tradeId, trade] : source->trades()) {
+        if (residentTrades_.find(tradeId) == residentTrades_.end()) {
+            trade->reset();
+            newTrades->add(trade);
+            residentTrades_[tradeId] = trade;
+        }
+    }
+    LOG("Removed " << removed << " trades, " << rebuilt << " trades were rebuilt elsewhere, building "
+                    << newTrades->size() << " trades");
+    if (newTrades->size() == 0)
+        return;
+
+    QuantLib::ext::shared_ptr<Portfolio> tmp = portfolio_;
+    portfolio_ = newTrades;
+    replaceTrades();
+    portfolio_->build(residentEngineFactory_, "analytic/" + label());
+    Date maturityDate = inputs()->asof();
+    if (inputs()->portfolioFilterDate() != Null<Date>())
+        maturityDate = inputs()->portfolioFilterDate();
+    portfolio_->removeMatured(maturityDate);
+    for (const auto& [tradeId, trade] : portfolio_->trades()) {
+        residentInstruments_[tradeId] = trade->instrument();
+        tmp->add(trade);
+    }
+    portfolio_ = tmp;
+}
+
+void Analytic::setResident(const bool resident) {
+    resident_ = resident;
+    if (!resident_)
+        resetResident();
+    for (const auto& [_, a] : dependentAnalytics_)
+        a->setResident(resident);
+}
+
+void Analytic::resetResident() {
+    market_ = nullptr;
+    portfolio_ = nullptr;
+    residentEngineFactory_ = nullptr;
+    residentTrades_.clear();
+    residentInstruments_.clear();
+    for (const auto& [_, a] : dependentAnalytics_)
+        a->resetResident();
+}
+
 /*******************************************************************
  * MARKET Analytic
  *******************************************************************/
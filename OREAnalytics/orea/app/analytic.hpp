@@ -147,7 +147,19 @@ public:
 
     virtual std::set<QuantLib::Date> marketDates() const { return {inputs_->asof()}; }
 
+    /*! In resident mode the market, the engine factory and the built portfolio are kept between runs: buildMarket()
+        reuses the market as long as it is called with the same loader, and buildPortfolio() only builds trades that
+        were added to or amended in the input portfolio or reset elsewhere since the last run. The flag is passed on
+        to the dependent analytics. */
+    void setResident(const bool resident);
+    bool resident() const { return resident_; }
+    //! drop the resident market and portfolio, the next run builds them from scratch
+    void resetResident();
+
 protected:
+    //! incremental portfolio build in resident mode
+    void buildResidentPortfolio();
+
     std::unique_ptr<Impl> impl_;
 
     //! list of analytic types run by this analytic
@@ -170,6 +182,13 @@ protected:
     bool writeIntermediateReports_ = true;
 
     std::map<std::string, boost::shared_ptr<Analytic>> dependentAnalytics_;
+
+    /*! resident mode, the engine factory, the input trades processed by the last portfolio build and the instruments
+        they were built to */
+    bool resident_ = false;
+    boost::shared_ptr<ore::data::EngineFactory> residentEngineFactory_;
+    std::map<std::string, boost::shared_ptr<ore::data::Trade>> residentTrades_;
+    std::map<std::string, boost::shared_ptr<ore::data::InstrumentWrapper>> residentInstruments_;
 };
 
 class Analytic::Impl {
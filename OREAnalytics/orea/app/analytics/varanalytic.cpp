@@ -59,8 +59,9 @@ void VarAnalyticImpl::runAnalytic(const boost::shared_ptr<ore::data::InMemoryLoa
             tradePortfolio[pId].insert(make_pair(tradeId, Null<Size>()));
     }
 
-    ParametricVarCalculator::ParametricVarParams varParams(inputs_->varMethod(), inputs_->mcVarSamples(),
-                                                           inputs_->mcVarSeed());
+    ParametricVarCalculator::ParametricVarParams varParams(
+        inputs_->varMethod(), inputs_->mcVarSamples(), inputs_->mcVarSeed(), inputs_->nThreads(),
+        inputs_->varCovarianceLambda(), inputs_->varCovarianceShrinkage());
 
     LOG("Build VaR calculator");
     auto calc = boost::make_shared<ParametricVarReport>(tradePortfolio, inputs_->portfolioFilter(), 
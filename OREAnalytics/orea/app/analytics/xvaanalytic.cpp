@@ -22,6 +22,7 @@
 #include <orea/app/structuredanalyticserror.hpp>
 #include <orea/app/structuredanalyticswarning.hpp>
 #include <orea/cube/jointnpvcube.hpp>
+#include <orea/cube/truncatednpvcube.hpp>
 #include <orea/engine/amcvaluationengine.hpp>
 #include <orea/engine/cptycalculator.hpp>
 #include <orea/engine/mporcalculator.hpp>
@@ -181,12 +182,26 @@ void XvaAnalyticImpl::initCube(boost::shared_ptr<NPVCube>& cube, const std::set<
     for (Size i = 0; i < grid_->valuationDates().size(); ++i)
         DLOG("initCube: grid[" << i << "]=" << io::iso_date(grid_->valuationDates()[i]));
     
-    if (cubeDepth == 1)
-        cube = boost::make_shared<SinglePrecisionInMemoryCube>(inputs_->asof(),
-            ids, grid_->valuationDates(), samples_, 0.0f);
+    cube = makeCube(inputs_->asof(), ids, grid_->valuationDates(), samples_, cubeDepth);
+}
+
+boost::shared_ptr<NPVCube> XvaAnalyticImpl::makeCube(const Date& asof, const std::set<std::string>& ids,
+                                                     const std::vector<Date>& dates, Size samples,
+                                                     Size cubeDepth) const {
+    if (inputs_->truncateCube())
+        return boost::make_shared<SinglePrecisionTruncatedNpvCube>(asof, ids, dates, samples, cubeDepth,
+                                                                   tradeMaturities_);
+    else if (cubeDepth == 1)
+        return boost::make_shared<SinglePrecisionInMemoryCube>(asof, ids, dates, samples, 0.0f);
     else
-        cube = boost::make_shared<SinglePrecisionInMemoryCubeN>(inputs_->asof(),
-            ids, grid_->valuationDates(), samples_, cubeDepth, 0.0f);    
+        return boost::make_shared<SinglePrecisionInMemoryCubeN>(asof, ids, dates, samples, cubeDepth, 0.0f);
+}
+
+void XvaAnalyticImpl::setTradeMaturities(const boost::shared_ptr<Portfolio>& portfolio) {
+    if (!inputs_->truncateCube())
+        return;
+    for (const auto& [tradeId, trade] : portfolio->trades())
+        tradeMaturities_[tradeId] = trade->maturity();
 }
 
 
@@ -195,6 +210,7 @@ void XvaAnalyticImpl::initClassicRun(const boost::shared_ptr<Portfolio>& portfol
     LOG("XVA: initClassicRun");
 
     initCubeDepth();
+    setTradeMaturities(portfolio);
 
     // May have been set already
     if (scenarioData_.empty()) {
@@ -268,16 +284,31 @@ void XvaAnalyticImpl::buildClassicCube(const boost::shared_ptr<Portfolio>& portf
 
     LOG("XVA::buildCube"); 
     
+    // batch pricing of vanilla swaps replicates the DiscountingSwapEngineOptimised only
+    bool batchPricing = false;
+    if (inputs_->batchPricing()) {
+        auto const& engineData = inputs_->simulationPricingEngine();
+        if (engineData && engineData->hasProduct("Swap") &&
+            engineData->engine("Swap") == "DiscountingSwapEngineOptimised")
+            batchPricing = true;
+        else
+            WLOG("XVA::buildCube: batch pricing requires the DiscountingSwapEngineOptimised for Swap in the "
+                 "simulation pricing engine config, batch pricing is disabled");
+    }
+
     // set up valuation calculator factory
-    auto calculators = [this]() {
+    auto calculators = [this, batchPricing]() {
         vector<boost::shared_ptr<ValuationCalculator>> calculators;
+        boost::shared_ptr<NPVCalculator> npvCalc;
+        if (batchPricing)
+            npvCalc = boost::make_shared<BatchNPVCalculator>(inputs_->exposureBaseCurrency());
+        else
+            npvCalc = boost::make_shared<NPVCalculator>(inputs_->exposureBaseCurrency());
         if (analytic()->configurations().scenarioGeneratorData->withCloseOutLag()) {
-            boost::shared_ptr<NPVCalculator> npvCalc =
-                boost::make_shared<NPVCalculator>(inputs_->exposureBaseCurrency());
             calculators.push_back(boost::make_shared<MPORCalculator>(npvCalc, cubeInterpreter_->defaultDateNpvIndex(),
                                                                      cubeInterpreter_->closeOutDateNpvIndex()));
         } else
-            calculators.push_back(boost::make_shared<NPVCalculator>(inputs_->exposureBaseCurrency()));
+            calculators.push_back(npvCalc);
         if (inputs_->storeFlows())
             calculators.push_back(boost::make_shared<CashflowCalculator>(
                 inputs_->exposureBaseCurrency(), inputs_->asof(), grid_, cubeInterpreter_->mporFlowsIndex()));
@@ -330,11 +361,7 @@ void XvaAnalyticImpl::buildClassicCube(const boost::shared_ptr<Portfolio>& portf
         auto cubeFactory = [this](const QuantLib::Date& asof, const std::set<std::string>& ids,
                                   const std::vector<QuantLib::Date>& dates,
                                   const Size samples) -> boost::shared_ptr<NPVCube> {
-            if (cubeDepth_ == 1)
-                return boost::make_shared<SinglePrecisionInMemoryCube>(asof, ids, dates, samples, 0.0f);
-            else
-                return boost::make_shared<SinglePrecisionInMemoryCubeN>(asof, ids, dates, samples,
-                                                                                        cubeDepth_, 0.0f);
+            return makeCube(asof, ids, dates, samples, cubeDepth_);
         };
 
         std::function<boost::shared_ptr<NPVCube>(const QuantLib::Date&, const std::set<std::string>&,
@@ -364,6 +391,12 @@ void XvaAnalyticImpl::buildClassicCube(const boost::shared_ptr<Portfolio>& portf
         engine.registerProgressIndicator(progressBar);
         engine.registerProgressIndicator(progressLog);
 
+        // if the trades were priced before, e.g. by a preceding NPV analytic, their pricing stats are used to split
+        // the portfolio and the engine skips its own build and pricing on a separate init market
+        bool priced = std::all_of(portfolio->trades().begin(), portfolio->trades().end(),
+                                  [](const auto& t) { return t.second->getNumberOfPricings() > 0; });
+        engine.setReuseBuiltPortfolio(priced);
+
         engine.buildCube(portfolio, calculators, cptyCalculators,
                          analytic()->configurations().scenarioGeneratorData->withMporStickyDate());
 
@@ -450,6 +483,7 @@ void XvaAnalyticImpl::amcRun(bool doClassicRun) {
     }
 
     initCubeDepth();
+    setTradeMaturities(amcPortfolio_);
 
     std::string message = "XVA: Build AMC Cube " + std::to_string(amcPortfolio_->size()) + " x " +
                           std::to_string(grid_->valuationDates().size()) + " x " + std::to_string(samples_) + "... ";
@@ -471,11 +505,7 @@ void XvaAnalyticImpl::amcRun(bool doClassicRun) {
         auto cubeFactory = [this](const QuantLib::Date& asof, const std::set<std::string>& ids,
                                   const std::vector<QuantLib::Date>& dates,
                                   const Size samples) -> boost::shared_ptr<NPVCube> {
-            if (cubeDepth_ == 1)
-                return boost::make_shared<SinglePrecisionInMemoryCube>(asof, ids, dates, samples, 0.0f);
-            else
-                return boost::make_shared<SinglePrecisionInMemoryCubeN>(asof, ids, dates, samples,
-                                                                                        cubeDepth_, 0.0f);
+            return makeCube(asof, ids, dates, samples, cubeDepth_);
         };
         AMCValuationEngine amcEngine(inputs_->nThreads(), inputs_->asof(), samples_, analytic()->loader(),
                                      inputs_->scenarioGeneratorData(),
@@ -554,7 +584,8 @@ void XvaAnalyticImpl::runPostProcessor() {
         ALOG("dim calculator not set, create RegressionDynamicInitialMarginCalculator");
         dimCalculator_ = boost::make_shared<RegressionDynamicInitialMarginCalculator>(
             inputs_, analytic()->portfolio(), cube_, cubeInterpreter_, *scenarioData_, dimQuantile, dimHorizonCalendarDays, dimRegressionOrder,
-            dimRegressors, dimLocalRegressionEvaluations, dimLocalRegressionBandwidth);
+            dimRegressors, dimLocalRegressionEvaluations, dimLocalRegressionBandwidth, std::map<std::string, Real>(),
+            inputs_->nThreads());
     }
 
     std::vector<Period> cvaSensiGrid = inputs_->cvaSensiGrid();
@@ -573,7 +604,8 @@ void XvaAnalyticImpl::runPostProcessor() {
         kvaTheirPdFloor, kvaOurCvaRiskWeight, kvaTheirCvaRiskWeight, cptyCube_, flipViewBorrowingCurvePostfix,
         flipViewLendingCurvePostfix, inputs_->creditSimulationParameters(), inputs_->creditMigrationDistributionGrid(),
         inputs_->creditMigrationTimeSteps(), creditStateCorrelationMatrix(),
-        analytic()->configurations().scenarioGeneratorData->withMporStickyDate(), inputs_->mporCashFlowMode());
+        analytic()->configurations().scenarioGeneratorData->withMporStickyDate(), inputs_->mporCashFlowMode(),
+        inputs_->nThreads(), inputs_->cvaSensiMethod());
     LOG("post done");
 }
 
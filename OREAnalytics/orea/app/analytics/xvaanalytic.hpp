@@ -46,6 +46,9 @@ protected:
 
     void initCubeDepth();
     void initCube(boost::shared_ptr<NPVCube>& cube, const std::set<std::string>& ids, Size cubeDepth);    
+    boost::shared_ptr<NPVCube> makeCube(const Date& asof, const std::set<std::string>& ids,
+                                        const std::vector<Date>& dates, Size samples, Size cubeDepth) const;
+    void setTradeMaturities(const boost::shared_ptr<Portfolio>& portfolio);
 
     void initClassicRun(const boost::shared_ptr<Portfolio>& portfolio);
     void buildClassicCube(const boost::shared_ptr<Portfolio>& portfolio);
@@ -72,6 +75,8 @@ protected:
     boost::shared_ptr<PostProcess> postProcess_;
     
     Size cubeDepth_ = 0;
+    // trade maturities used to truncate the cubes
+    std::map<std::string, Date> tradeMaturities_;
     boost::shared_ptr<DateGrid> grid_;
     Size samples_ = 0;
 
@@ -198,6 +198,27 @@ void AnalyticsManager::runAnalytics(const std::set<std::string>& analyticTypes,
     inputs_->writeOutParameters();
 }
 
+void AnalyticsManager::rerunAnalytics(const std::set<std::string>& analyticTypes) {
+    QL_REQUIRE(marketDataLoader_->loader(), "AnalyticsManager::rerunAnalytics: loader not populated, call runAnalytics()");
+    requestedAnalytics_ = analyticTypes;
+    for (auto a : analytics_) {
+        if (matches(analyticTypes, a.second->analyticTypes()) > 0) {
+            LOG("rerun analytic with label '" << a.first << "'");
+            a.second->runAnalytic(marketDataLoader_->loader(), analyticTypes);
+        }
+    }
+    if (inputs_->portfolio()) {
+        auto pricingStatsReport = boost::make_shared<InMemoryReport>();
+        ReportWriter(inputs_->reportNaString()).writePricingStats(*pricingStatsReport, inputs_->portfolio());
+        reports_["STATS"]["pricingstats"] = pricingStatsReport;
+    }
+}
+
+void AnalyticsManager::setResident(const bool resident) {
+    for (auto a : analytics_)
+        a.second->setResident(resident);
+}
+
 Analytic::analytic_reports const AnalyticsManager::reports() {
     Analytic::analytic_reports reports = reports_;
     for (auto a : analytics_) {
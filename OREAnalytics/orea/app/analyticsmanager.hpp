@@ -50,7 +50,14 @@ public:
     std::vector<QuantLib::ext::shared_ptr<ore::data::TodaysMarketParameters>> todaysMarketParams();
     void runAnalytics(const std::set<std::string>& analyticTypes,
                       const boost::shared_ptr<MarketCalibrationReportBase>& marketCalibrationReport = nullptr);
+    /*! Run the analytics again on the market data loaded by the last call to runAnalytics(), without populating
+        the loader, to be used with resident analytics, see Analytic::setResident() */
+    void rerunAnalytics(const std::set<std::string>& analyticTypes);
     void addAnalytic(const std::string& label, const boost::shared_ptr<Analytic>& analytic);
+    //! set all registered analytics to resident mode
+    void setResident(const bool resident);
+    //! the market data loader
+    const boost::shared_ptr<MarketDataLoader>& marketDataLoader() const { return marketDataLoader_; }
 
     // returns a vector of all analytics, including dependent analytics
     std::map<std::string, boost::shared_ptr<Analytic>> analytics() { return analytics_; }
@@ -134,13 +134,13 @@ void InputParameters::setTodaysMarketParamsFromFile(const std::string& fileName)
 }
 
 void InputParameters::setPortfolio(const std::string& xml) {
-    portfolio_ = boost::make_shared<Portfolio>(buildFailedTrades_);
+    portfolio_ = boost::make_shared<Portfolio>(buildFailedTrades_, nThreads_);
     portfolio_->fromXMLString(xml);
 }
 
 void InputParameters::setPortfolioFromFile(const std::string& fileNameString, const std::string& inputPath) {
     vector<string> files = getFileNames(fileNameString, inputPath);
-    portfolio_ = boost::make_shared<Portfolio>(buildFailedTrades_);
+    portfolio_ = boost::make_shared<Portfolio>(buildFailedTrades_, nThreads_);
     for (auto file : files) {
         LOG("Loading portfolio from file: " << file);
         portfolio_->fromFile(file);
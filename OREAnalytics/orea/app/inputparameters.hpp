@@ -24,6 +24,7 @@
 
 #include <boost/filesystem/path.hpp>
 #include <orea/aggregation/creditsimulationparameters.hpp>
+#include <orea/aggregation/cvaspreadsensitivitycalculator.hpp>
 #include <orea/app/parameters.hpp>
 #include <orea/cube/npvcube.hpp>
 #include <orea/engine/sensitivitystream.hpp>
@@ -161,6 +162,8 @@ public:
     void setVarMethod(const std::string& s) { varMethod_ = s; }
     void setMcVarSamples(Size s) { mcVarSamples_ = s; }
     void setMcVarSeed(long l) { mcVarSeed_ = l; }
+    void setVarCovarianceLambda(Real r) { varCovarianceLambda_ = r; }
+    void setVarCovarianceShrinkage(Real r) { varCovarianceShrinkage_ = r; }
     void setCovarianceData(ore::data::CSVReader& reader);  
     void setCovarianceDataFromFile(const std::string& fileName);
     void setCovarianceDataFromBuffer(const std::string& xml);
@@ -181,6 +184,8 @@ public:
     void setStoreFlows(bool b) { storeFlows_ = b; }
     void setStoreCreditStateNPVs(Size states) { storeCreditStateNPVs_ = states; }
     void setStoreSurvivalProbabilities(bool b) { storeSurvivalProbabilities_ = b; }
+    void setTruncateCube(bool b) { truncateCube_ = b; }
+    void setBatchPricing(bool b) { batchPricing_ = b; }
     void setWriteCube(bool b) { writeCube_ = b; }
     void setWriteScenarios(bool b) { writeScenarios_ = b; }
     void setExposureSimMarketParams(const std::string& xml);
@@ -240,6 +245,7 @@ public:
     void setCvaSensi(bool b) { cvaSensi_ = b; }
     void setCvaSensiGrid(const std::string& s); // parse to vector<Period>
     void setCvaSensiShiftSize(Real r) { cvaSensiShiftSize_ = r; }
+    void setCvaSensiMethod(const CVASpreadSensitivityCalculator::Method m) { cvaSensiMethod_ = m; }
     void setDvaName(const std::string& s) { dvaName_ = s; }
     void setRawCubeOutput(bool b) { rawCubeOutput_ = b; }
     void setNetCubeOutput(bool b) { netCubeOutput_ = b; }
@@ -445,6 +451,8 @@ public:
     const std::string& varMethod() { return varMethod_; }
     Size mcVarSamples() { return mcVarSamples_; }
     long mcVarSeed() { return mcVarSeed_; }
+    Real varCovarianceLambda() { return varCovarianceLambda_; }
+    Real varCovarianceShrinkage() { return varCovarianceShrinkage_; }
     const std::map<std::pair<RiskFactorKey, RiskFactorKey>, Real>& covarianceData() { return covarianceData_; }
     const boost::shared_ptr<SensitivityStream>& sensitivityStream() { return sensitivityStream_; }
     
@@ -463,6 +471,8 @@ public:
     bool storeFlows() { return storeFlows_; }
     Size storeCreditStateNPVs() { return storeCreditStateNPVs_; }
     bool storeSurvivalProbabilities() { return storeSurvivalProbabilities_; }
+    bool truncateCube() { return truncateCube_; }
+    bool batchPricing() { return batchPricing_; }
     bool writeCube() { return writeCube_; }
     bool writeScenarios() { return writeScenarios_; }
     const boost::shared_ptr<ore::analytics::ScenarioSimMarketParameters>& exposureSimMarketParams() { return exposureSimMarketParams_; }
@@ -505,6 +515,7 @@ public:
     bool cvaSensi() { return cvaSensi_; }
     const std::vector<Period>& cvaSensiGrid() { return cvaSensiGrid_; }
     Real cvaSensiShiftSize() { return cvaSensiShiftSize_; }
+    CVASpreadSensitivityCalculator::Method cvaSensiMethod() { return cvaSensiMethod_; }
     const std::string& dvaName() { return dvaName_; }
     bool rawCubeOutput() { return rawCubeOutput_; }
     bool netCubeOutput() { return netCubeOutput_; }
@@ -713,6 +724,9 @@ protected:
     std::string varMethod_;
     Size mcVarSamples_ = 0;
     long mcVarSeed_ = 0;
+    // EWMA decay and shrinkage intensity for covariances estimated from historical shifts
+    Real varCovarianceLambda_ = Null<Real>();
+    Real varCovarianceShrinkage_ = 0.0;
     std::map<std::pair<RiskFactorKey, RiskFactorKey>, Real> covarianceData_;
     boost::shared_ptr<SensitivityStream> sensitivityStream_;
     
@@ -731,6 +745,8 @@ protected:
     bool storeFlows_ = false;
     Size storeCreditStateNPVs_ = 0;
     bool storeSurvivalProbabilities_ = false;
+    bool truncateCube_ = false;
+    bool batchPricing_ = false;
     bool writeCube_ = false;
     bool writeScenarios_ = false;
     boost::shared_ptr<ore::analytics::ScenarioSimMarketParameters> exposureSimMarketParams_;
@@ -770,6 +786,7 @@ protected:
     bool cvaSensi_ = false;
     std::vector<Period> cvaSensiGrid_;
     Real cvaSensiShiftSize_ = 0.0001;
+    CVASpreadSensitivityCalculator::Method cvaSensiMethod_ = CVASpreadSensitivityCalculator::Method::BumpAndRevalue;
     std::string dvaName_ = "";
     bool rawCubeOutput_ = false;
     bool netCubeOutput_ = false;
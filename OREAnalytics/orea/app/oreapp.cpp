@@ -233,6 +233,7 @@ void OREApp::analytics() {
 
         // Create the analytics manager
         analyticsManager_ = boost::make_shared<AnalyticsManager>(inputs_, loader);
+        analyticsManager_->setResident(resident_);
         LOG("Available analytics: " << to_string(analyticsManager_->validAnalytics()));
         CONSOLEW("Requested analytics");
         CONSOLE(to_string(inputs_->analytics()));
@@ -247,41 +248,7 @@ void OREApp::analytics() {
         // Run the requested analytics
         analyticsManager_->runAnalytics(inputs_->analytics(), mcr);
 
-        // Write reports to files in the results path
-        Analytic::analytic_reports reports = analyticsManager_->reports();
-        analyticsManager_->toFile(reports,
-                                  inputs_->resultsPath().string(), outputs_->fileNameMap(),
-                                  inputs_->csvSeparator(), inputs_->csvCommentCharacter(),
-                                  inputs_->csvQuoteChar(), inputs_->reportNaString());
-
-        // Write npv cube(s)
-        for (auto a : analyticsManager_->npvCubes()) {
-            for (auto b : a.second) {
-                LOG("write npv cube " << b.first);
-                string reportName = b.first;
-                std::string fileName = inputs_->resultsPath().string() + "/" + outputs_->outputFileName(reportName, "csv.gz");
-                LOG("write npv cube " << reportName << " to file " << fileName);
-                NPVCubeWithMetaData r;
-                r.cube = b.second;
-                if (b.first == "cube") {
-                    // store meta data together with npv cube
-                    r.scenarioGeneratorData = inputs_->scenarioGeneratorData();
-                    r.storeFlows = inputs_->storeFlows();
-                    r.storeCreditStateNPVs = inputs_->storeCreditStateNPVs();
-                }
-                saveCube(fileName, r);
-            }
-        }
-        
-        // Write market cube(s)
-        for (auto a : analyticsManager_->mktCubes()) {
-            for (auto b : a.second) {
-                string reportName = b.first;
-                std::string fileName = inputs_->resultsPath().string() + "/" + outputs_->outputFileName(reportName, "csv.gz");
-                LOG("write market cube " << reportName << " to file " << fileName);
-                saveAggregationScenarioData(fileName, *b.second);
-            }
-        }        
+        writeResults();
     }
     catch (std::exception& e) {
         ostringstream oss;
@@ -296,6 +263,44 @@ void OREApp::analytics() {
     LOG("ORE analytics done");
 }
 
+void OREApp::writeResults() {
+    // Write reports to files in the results path
+    Analytic::analytic_reports reports = analyticsManager_->reports();
+    analyticsManager_->toFile(reports,
+                              inputs_->resultsPath().string(), outputs_->fileNameMap(),
+                              inputs_->csvSeparator(), inputs_->csvCommentCharacter(),
+                              inputs_->csvQuoteChar(), inputs_->reportNaString());
+
+    // Write npv cube(s)
+    for (auto a : analyticsManager_->npvCubes()) {
+        for (auto b : a.second) {
+            LOG("write npv cube " << b.first);
+            string reportName = b.first;
+            std::string fileName = inputs_->resultsPath().string() + "/" + outputs_->outputFileName(reportName, "csv.gz");
+            LOG("write npv cube " << reportName << " to file " << fileName);
+            NPVCubeWithMetaData r;
+            r.cube = b.second;
+            if (b.first == "cube") {
+                // store meta data together with npv cube
+                r.scenarioGeneratorData = inputs_->scenarioGeneratorData();
+                r.storeFlows = inputs_->storeFlows();
+                r.storeCreditStateNPVs = inputs_->storeCreditStateNPVs();
+            }
+            saveCube(fileName, r);
+        }
+    }
+    
+    // Write market cube(s)
+    for (auto a : analyticsManager_->mktCubes()) {
+        for (auto b : a.second) {
+            string reportName = b.first;
+            std::string fileName = inputs_->resultsPath().string() + "/" + outputs_->outputFileName(reportName, "csv.gz");
+            LOG("write market cube " << reportName << " to file " << fileName);
+            saveAggregationScenarioData(fileName, *b.second);
+        }
+    }
+}
+
 OREApp::OREApp(boost::shared_ptr<Parameters> params, bool console, 
                const boost::filesystem::path& logRootPath)
     : params_(params), inputs_(nullptr) {
@@ -462,6 +467,85 @@ void OREApp::run(const std::vector<std::string>& marketData,
     LOG("ORE analytics done");
 }
 
+void OREApp::startService() {
+    QL_REQUIRE(params_, "OREApp::startService(): requires ORE parameters");
+    resident_ = true;
+    run();
+    QL_REQUIRE(analyticsManager_ && analyticsManager_->marketDataLoader()->loader(),
+               "OREApp::startService(): initial run failed, see log for details");
+}
+
+Size OREApp::updateTrades(const std::string& portfolioXml) {
+    QL_REQUIRE(resident_ && analyticsManager_, "OREApp::updateTrades(): service not started");
+    Portfolio trades(inputs_->buildFailedTrades());
+    trades.fromXMLString(portfolioXml);
+    for (const auto& [tradeId, trade] : trades.trades()) {
+        inputs_->portfolio()->remove(tradeId);
+        inputs_->portfolio()->add(trade);
+    }
+    LOG("OREApp::updateTrades(): added or amended " << trades.size() << " trades");
+    return trades.size();
+}
+
+Size OREApp::removeTrades(const std::vector<std::string>& tradeIds) {
+    QL_REQUIRE(resident_ && analyticsManager_, "OREApp::removeTrades(): service not started");
+    Size count = 0;
+    for (const auto& tradeId : tradeIds) {
+        if (inputs_->portfolio()->remove(tradeId))
+            ++count;
+        else
+            WLOG("OREApp::removeTrades(): trade " << tradeId << " not found");
+    }
+    LOG("OREApp::removeTrades(): removed " << count << " trades");
+    return count;
+}
+
+void OREApp::rerun() {
+    QL_REQUIRE(resident_ && analyticsManager_, "OREApp::rerun(): service not started");
+    runTimer_.start();
+    structuredLogger_->clear();
+    Settings::instance().evaluationDate() = inputs_->asof();
+    analyticsManager_->rerunAnalytics(inputs_->analytics());
+    runTimer_.stop();
+    LOG("OREApp::rerun() done, run time " << runTimer_.format(default_places, "%w") << " sec");
+}
+
+void OREApp::serve(std::istream& in, std::ostream& out) {
+    QL_REQUIRE(resident_ && analyticsManager_, "OREApp::serve(): service not started");
+    string line;
+    while (std::getline(in, line)) {
+        boost::trim(line);
+        if (line.empty())
+            continue;
+        string command = line.substr(0, line.find_first_of(" \t"));
+        string args = boost::trim_copy(line.substr(command.size()));
+        boost::to_upper(command);
+        try {
+            if (command == "QUIT") {
+                out << "OK" << std::endl;
+                break;
+            } else if (command == "TRADES") {
+                out << "OK " << updateTrades(args) << std::endl;
+            } else if (command == "REMOVE") {
+                vector<string> tokens;
+                boost::split(tokens, args, boost::is_any_of(" \t"), boost::token_compress_on);
+                out << "OK " << removeTrades(tokens) << std::endl;
+            } else if (command == "RUN") {
+                rerun();
+                out << "OK " << getRunTime() << std::endl;
+            } else if (command == "WRITE") {
+                writeResults();
+                out << "OK" << std::endl;
+            } else {
+                QL_FAIL("unknown command '" << command << "'");
+            }
+        } catch (const std::exception& e) {
+            ALOG("OREApp::serve(): " << e.what());
+            out << "ERROR " << e.what() << std::endl;
+        }
+    }
+}
+
 void OREApp::buildInputParameters(boost::shared_ptr<InputParameters> inputs,
                                   const boost::shared_ptr<Parameters>& params) {
     QL_REQUIRE(inputs, "InputParameters not created yet");
@@ -852,6 +936,14 @@ void OREApp::buildInputParameters(boost::shared_ptr<InputParameters> inputs,
         tmp = params_->get("parametricVar", "mcSeed", false);
         if (tmp != "")
             inputs->setMcVarSeed(parseInteger(tmp));
+
+        tmp = params_->get("parametricVar", "covarianceLambda", false);
+        if (tmp != "")
+            inputs->setVarCovarianceLambda(parseReal(tmp));
+
+        tmp = params_->get("parametricVar", "covarianceShrinkage", false);
+        if (tmp != "")
+            inputs->setVarCovarianceShrinkage(parseReal(tmp));
         
         tmp = params_->get("parametricVar", "covarianceInputFile", false);
         QL_REQUIRE(tmp != "", "covarianceInputFile not provided");
@@ -1018,6 +1110,14 @@ void OREApp::buildInputParameters(boost::shared_ptr<InputParameters> inputs,
         tmp = params_->get("simulation", "storeSurvivalProbabilities", false);
         if (tmp == "Y")
             inputs->setStoreSurvivalProbabilities(true);
+
+        tmp = params_->get("simulation", "truncateCube", false);
+        if (tmp == "Y")
+            inputs->setTruncateCube(true);
+
+        tmp = params_->get("simulation", "batchPricing", false);
+        if (tmp == "Y")
+            inputs->setBatchPricing(true);
         
         tmp = params_->get("simulation", "nettingSetId", false);
         if (tmp != "")
@@ -1185,6 +1285,10 @@ void OREApp::buildInputParameters(boost::shared_ptr<InputParameters> inputs,
     if (tmp != "")
         inputs->setCvaSensiShiftSize(parseReal(tmp));
 
+    tmp = params_->get("xva", "cvaSensiMethod", false);
+    if (tmp != "")
+        inputs->setCvaSensiMethod(parseCvaSensitivityMethod(tmp));
+
     tmp = params_->get("xva", "dvaName", false);
     if (tmp != "")
         inputs->setDvaName(tmp);
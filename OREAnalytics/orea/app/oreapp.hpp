@@ -77,9 +77,34 @@ public:
     Real getRunTime();
 
     std::string version();
-    
+
+    //! \name Resident service mode
+    //@{
+    /*! Run the analytics once after using the first OREApp c'tor and keep the market, the built portfolios and the
+        model calibrations in memory for the incremental trade updates and reruns below. The market data is fixed
+        for the lifetime of the service. */
+    void startService();
+    //! add or amend the trades in the given portfolio xml, returns the number of trades
+    Size updateTrades(const std::string& portfolioXml);
+    //! remove trades from the portfolio, returns the number of trades removed
+    Size removeTrades(const std::vector<std::string>& tradeIds);
+    //! rerun the analytics, only new or amended trades are built
+    void rerun();
+    /*! Request loop reading one command per line from the input stream and writing one response line per command
+        (OK or ERROR followed by details) to the output stream. Commands are
+        - TRADES portfolio xml
+        - REMOVE tradeId1 tradeId2 ...
+        - RUN
+        - WRITE (write the reports to the results path)
+        - QUIT
+    */
+    void serve(std::istream& in, std::ostream& out);
+    //@}
+
 protected:
     virtual void analytics();
+    //! write reports and cubes to the results path
+    void writeResults();
 
     //! Populate InputParameters object from classic ORE key-value pairs in Parameters 
     void buildInputParameters(boost::shared_ptr<InputParameters> inputs,
@@ -102,6 +127,7 @@ protected:
     boost::shared_ptr<AnalyticsManager> analyticsManager_;
     boost::shared_ptr<StructuredLogger> structuredLogger_;
     boost::timer::cpu_timer runTimer_;
+    bool resident_ = false;
 };
 
 } // namespace analytics
@@ -19,7 +19,9 @@
 #include <orea/cube/jointnpvcube.hpp>
 
 #include <ql/errors.hpp>
+#include <ql/math/comparison.hpp>
 
+#include <algorithm>
 #include <numeric>
 #include <set>
 
@@ -147,5 +149,15 @@ void JointNPVCube::set(Real value, Size id, Size date, Size sample, Size depth)
     (*c.begin()).first->set(value, (*c.begin()).second, date, sample, depth);
 }
 
+Size JointNPVCube::liveDates(Size id) const {
+    // with a non-zero accumulator init value the aggregated values do not vanish beyond the input cubes' ranges
+    if (!QuantLib::close_enough(accumulatorInit_, 0.0))
+        return numDates();
+    Size result = 0;
+    for (auto const& p : cubeAndId(id))
+        result = std::max(result, p.first->liveDates(p.second));
+    return result;
+}
+
 } // namespace analytics
 } // namespace ore
@@ -115,6 +115,11 @@ public:
     /*! simliar as above, but remove all values for a given id and scenario and keep T0 values */
     virtual void remove(Size id, Size sample);
 
+    /*! the number of dates, starting from the first date, on which the cube can hold non-zero values for the given id,
+        the values on all later dates are zero; aggregation code can use this to skip the zero tail of short dated
+        trades, the default implementation returns numDates() */
+    virtual Size liveDates(Size id) const { return numDates(); }
+
     Size getTradeIndex(const std::string& id) const { return index(id); }
 
 protected:
@@ -0,0 +1,141 @@
+/*
+ Copyright (C) 2023 Quaternion Risk Management Ltd
+ All rights reserved.
+
+ This file is part of ORE, a free-software/open-source library
+ for transparent pricing and risk analysis - http://opensourcerisk.org
+
+ ORE is free software: you can redistribute it and/or modify it
+ under the terms of the Modified BSD License.  You should have received a
+ copy of the license along with this program.
+ The license is also available online at <http://opensourcerisk.org>
+
+ This program is distributed on the basis that it will form a useful
+ contribution to risk analytics and model standardisation, but WITHOUT
+ ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ FITNESS FOR A PARTICULAR PURPOSE. See the license for more details.
+*/
+
+#include <orea/cube/truncatednpvcube.hpp>
+
+#include <ored/utilities/log.hpp>
+
+#include <ql/errors.hpp>
+#include <ql/math/comparison.hpp>
+
+#include <algorithm>
+
+namespace ore {
+namespace analytics {
+
+template <typename T> TruncatedNpvCube<T>::TruncatedNpvCube() : samples_(0), depth_(0) {}
+
+template <typename T>
+TruncatedNpvCube<T>::TruncatedNpvCube(const Date& asof, const std::set<std::string>& ids,
+                                      const std::vector<Date>& dates, Size samples, Size depth,
+                                      const std::map<std::string, Date>& maturities)
+    : asof_(asof), dates_(dates), samples_(samples), depth_(depth), t0Data_(ids.size() * depth, T()),
+      liveDates_(ids.size(), dates.size()), data_(ids.size()) {
+    QL_REQUIRE(ids.size() > 0, "TruncatedNpvCube::TruncatedNpvCube no ids specified");
+    QL_REQUIRE(dates.size() > 0, "TruncatedNpvCube::TruncatedNpvCube no dates specified");
+    QL_REQUIRE(samples > 0, "TruncatedNpvCube::TruncatedNpvCube samples must be > 0");
+    QL_REQUIRE(depth > 0, "TruncatedNpvCube::TruncatedNpvCube depth must be > 0");
+    QL_REQUIRE(std::is_sorted(dates.begin(), dates.end()), "TruncatedNpvCube::TruncatedNpvCube dates must be sorted");
+    Size pos = 0;
+    for (const auto& id : ids) {
+        // store up to and including the first date on or after the maturity, this date still sees the flows
+        // paid on the maturity date and serves as close-out date for the previous date
+        auto m = maturities.find(id);
+        if (m != maturities.end() && m->second != Date()) {
+            Size firstDateAfterMaturity =
+                std::distance(dates.begin(), std::lower_bound(dates.begin(), dates.end(), m->second));
+            liveDates_[pos] = std::min(firstDateAfterMaturity + 1, dates.size());
+        }
+        data_[pos] = std::vector<T>(liveDates_[pos] * samples * depth, T());
+        ids_[id] = pos++;
+    }
+    Size full = ids.size() * dates.size() * samples * depth;
+    Size stored = storedValues();
+    LOG("TruncatedNpvCube: " << ids.size() << " ids x " << dates.size() << " dates x " << samples << " samples x "
+                             << depth << " depth, storing " << stored << " of " << full << " values ("
+                             << static_cast<Real>(stored * sizeof(T)) / 1024.0 / 1024.0 << " MB, saving "
+                             << static_cast<Real>((full - stored) * sizeof(T)) / 1024.0 / 1024.0 << " MB or "
+                             << (full > 0 ? static_cast<Real>(full - stored) / static_cast<Real>(full) * 100.0 : 0.0)
+                             << "% compared to a full cube)");
+}
+
+template <typename T> Size TruncatedNpvCube<T>::numIds() const { return ids_.size(); }
+template <typename T> Size TruncatedNpvCube<T>::numDates() const { return dates_.size(); }
+template <typename T> Size TruncatedNpvCube<T>::samples() const { return samples_; }
+template <typename T> Size TruncatedNpvCube<T>::depth() const { return depth_; }
+template <typename T> Date TruncatedNpvCube<T>::asof() const { return asof_; }
+template <typename T> const std::map<std::string, Size>& TruncatedNpvCube<T>::idsAndIndexes() const { return ids_; }
+template <typename T> const std::vector<QuantLib::Date>& TruncatedNpvCube<T>::dates() const { return dates_; }
+
+template <typename T> Size TruncatedNpvCube<T>::liveDates(Size i) const {
+    QL_REQUIRE(i < numIds(), "Out of bounds on ids (i=" << i << ", numIds=" << numIds() << ")");
+    return liveDates_[i];
+}
+
+template <typename T> Size TruncatedNpvCube<T>::storedValues() const {
+    Size result = 0;
+    for (auto const& d : data_)
+        result += d.size();
+    return result;
+}
+
+template <typename T> Real TruncatedNpvCube<T>::getT0(Size i, Size d) const {
+    this->check(i, 0, 0, d);
+    return static_cast<Real>(t0Data_[i * depth_ + d]);
+}
+
+template <typename T> void TruncatedNpvCube<T>::setT0(Real value, Size i, Size d) {
+    this->check(i, 0, 0, d);
+    t0Data_[i * depth_ + d] = static_cast<T>(value);
+}
+
+template <typename T> Real TruncatedNpvCube<T>::get(Size i, Size j, Size k, Size d) const {
+    this->check(i, j, k, d);
+    if (j >= liveDates_[i])
+        return 0.0;
+    return static_cast<Real>(data_[i][pos(j, k, d)]);
+}
+
+template <typename T> void TruncatedNpvCube<T>::set(Real value, Size i, Size j, Size k, Size d) {
+    this->check(i, j, k, d);
+    if (j >= liveDates_[i]) {
+        if (QuantLib::close_enough(value, 0.0))
+            return;
+        // extend the stored range, the given maturity was too early
+        liveDates_[i] = j + 1;
+        data_[i].resize(liveDates_[i] * samples_ * depth_, T());
+    }
+    data_[i][pos(j, k, d)] = static_cast<T>(value);
+}
+
+template <typename T> void TruncatedNpvCube<T>::remove(Size i) {
+    this->check(i, 0, 0, 0);
+    std::fill(std::next(t0Data_.begin(), i * depth_), std::next(t0Data_.begin(), (i + 1) * depth_), T());
+    std::fill(data_[i].begin(), data_[i].end(), T());
+}
+
+template <typename T> void TruncatedNpvCube<T>::remove(Size i, Size k) {
+    this->check(i, 0, k, 0);
+    for (Size j = 0; j < liveDates_[i]; ++j)
+        std::fill(std::next(data_[i].begin(), pos(j, k, 0)), std::next(data_[i].begin(), pos(j, k + 1, 0)), T());
+}
+
+template <typename T> void TruncatedNpvCube<T>::check(Size i, Size j, Size k, Size d) const {
+    QL_REQUIRE(i < numIds(), "Out of bounds on ids (i=" << i << ", numIds=" << numIds() << ")");
+    QL_REQUIRE(j < numDates(), "Out of bounds on dates (j=" << j << ", numDates=" << numDates() << ")");
+    QL_REQUIRE(k < samples(), "Out of bounds on samples (k=" << k << ", samples=" << samples() << ")");
+    QL_REQUIRE(d < depth(), "Out of bounds on depth (d=" << d << ", depth=" << depth() << ")");
+}
+
+// template instantiations for float and double
+
+template class TruncatedNpvCube<float>;
+template class TruncatedNpvCube<double>;
+
+} // namespace analytics
+} // namespace ore
@@ -0,0 +1,89 @@
+/*
+ Copyright (C) 2023 Quaternion Risk Management Ltd
+ All rights reserved.
+
+ This file is part of ORE, a free-software/open-source library
+ for transparent pricing and risk analysis - http://opensourcerisk.org
+
+ ORE is free software: you can redistribute it and/or modify it
+ under the terms of the Modified BSD License.  You should have received a
+ copy of the license along with this program.
+ The license is also available online at <http://opensourcerisk.org>
+
+ This program is distributed on the basis that it will form a useful
+ contribution to risk analytics and model standardisation, but WITHOUT
+ ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ FITNESS FOR A PARTICULAR PURPOSE. See the license for more details.
+*/
+
+/*! \file orea/cube/truncatednpvcube.hpp
+    \brief in memory cube, storing values per id only up to the id's maturity
+    \ingroup cube
+*/
+
+#pragma once
+
+#include <orea/cube/npvcube.hpp>
+
+#include <map>
+#include <set>
+
+namespace ore {
+namespace analytics {
+using QuantLib::Date;
+using QuantLib::Real;
+using QuantLib::Size;
+
+//! TruncatedNpvCube stores the values for each id in a contiguous block up to the id's maturity
+/*! For each id the values are stored for the dates up to and including the first date on or after the id's maturity,
+    the values on later dates are zero and not stored. Ids without maturity (or with a null date as maturity) are
+    stored on all dates. If a non-zero value is set beyond the stored date range, the range is extended, so that
+    the cube is correct even if the given maturities are too early.
+
+    Get and set are O(1), the cube reports the saved memory in its log line and the stored date range of each id via
+    liveDates(), so that aggregation code can skip the zero tail.
+
+    \ingroup cube
+*/
+template <typename T> class TruncatedNpvCube : public ore::analytics::NPVCube {
+public:
+    TruncatedNpvCube();
+    TruncatedNpvCube(const Date& asof, const std::set<std::string>& ids, const std::vector<Date>& dates, Size samples,
+                     Size depth, const std::map<std::string, Date>& maturities);
+    Size numIds() const override;
+    Size numDates() const override;
+    Size samples() const override;
+    Size depth() const override;
+    Date asof() const override;
+    const std::map<std::string, Size>& idsAndIndexes() const override;
+    const std::vector<QuantLib::Date>& dates() const override;
+    Real getT0(Size i, Size d) const override;
+    void setT0(Real value, Size i, Size d) override;
+    Real get(Size i, Size j, Size k, Size d) const override;
+    void set(Real value, Size i, Size j, Size k, Size d) override;
+    void remove(Size i) override;
+    void remove(Size i, Size k) override;
+    Size liveDates(Size i) const override;
+
+    //! number of stored values (excluding T0 values)
+    Size storedValues() const;
+
+private:
+    void check(Size i, Size j, Size k, Size d) const;
+    Size pos(Size j, Size k, Size d) const { return (j * samples_ + k) * depth_ + d; }
+
+    QuantLib::Date asof_;
+    std::map<std::string, Size> ids_;
+    std::vector<QuantLib::Date> dates_;
+    Size samples_;
+    Size depth_;
+    std::vector<T> t0Data_;
+    std::vector<Size> liveDates_;
+    std::vector<std::vector<T>> data_;
+};
+
+using SinglePrecisionTruncatedNpvCube = TruncatedNpvCube<float>;
+using DoublePrecisionTruncatedNpvCube = TruncatedNpvCube<double>;
+
+} // namespace analytics
+} // namespace ore
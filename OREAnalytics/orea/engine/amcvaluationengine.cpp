@@ -30,10 +30,12 @@
 
 #include <qle/indexes/fallbackiborindex.hpp>
 #include <qle/instruments/payment.hpp>
+#include <qle/methods/mcpathrepository.hpp>
 #include <qle/methods/multipathgeneratorbase.hpp>
 #include <qle/methods/multipathvariategenerator.hpp>
 #include <qle/pricingengines/mcmultilegbaseengine.hpp>
 #include <qle/models/lgmimpliedyieldtermstructure.hpp>
+#include <qle/utilities/workerpool.hpp>
 
 #include <ql/instruments/compositeinstrument.hpp>
 
@@ -142,7 +144,8 @@ void runCoreEngine(const boost::shared_ptr<ore::data::Portfolio>& portfolio,
                    const boost::shared_ptr<ore::analytics::ScenarioGeneratorData>& sgd,
                    const std::vector<string>& aggDataIndices, const std::vector<string>& aggDataCurrencies,
                    const Size aggDataNumberCreditStates, boost::shared_ptr<ore::analytics::AggregationScenarioData> asd,
-                   boost::shared_ptr<NPVCube> outputCube, boost::shared_ptr<ProgressIndicator> progressIndicator) {
+                   boost::shared_ptr<NPVCube> outputCube, boost::shared_ptr<ProgressIndicator> progressIndicator,
+                   const Size pathRepositorySize) {
 
     progressIndicator->updateProgress(0, portfolio->size() + 1);
 
@@ -222,6 +225,9 @@ void runCoreEngine(const boost::shared_ptr<ore::data::Portfolio>& portfolio,
     McEngineStats::instance().calc_timer.start();
     McEngineStats::instance().calc_timer.stop();
 
+    // engines with identical calibration path settings share their paths during the extraction
+    McPathRepository::instance().clear();
+    McPathRepository::instance().setMaxSize(pathRepositorySize);
 
     auto extractAmcCalculator = [&amcCalculators, &tradeId, &tradeLabel, &tradeType, &effectiveMultiplier,
                                  &currencyIndex, &tradeFees, &model,
@@ -304,6 +310,10 @@ void runCoreEngine(const boost::shared_ptr<ore::data::Portfolio>& portfolio,
     timer.stop();
     calibrationTime += timer.elapsed().wall * 1e-9;
     LOG("Extracted " << amcCalculators.size() << " AMCCalculators for " << portfolio->size() << " source trades");
+    LOG("Calibration path repository hits " << McPathRepository::instance().hits() << ", misses "
+                                            << McPathRepository::instance().misses());
+    McPathRepository::instance().clear();
+    McPathRepository::instance().setMaxSize(0);
 
     // set up buffers for fx rates and ir states that we need below for the runs against interface 1 and 2
     // we set these buffers up on the full grid (i.e. valuation + close-out dates, also including the T0 date)
@@ -646,7 +656,8 @@ void AMCValuationEngine::buildCube(const boost::shared_ptr<Portfolio>& portfolio
         // we can use the mt progress indicator here although we are running on a single thread
         runCoreEngine(portfolio, model_, market_, scenarioGeneratorData_, aggDataIndices_, aggDataCurrencies_,
                       aggDataNumberCreditStates_, asd_, outputCube,
-                      boost::make_shared<ore::analytics::MultiThreadedProgressIndicator>(this->progressIndicators()));
+                      boost::make_shared<ore::analytics::MultiThreadedProgressIndicator>(this->progressIndicators()),
+                      pathRepositorySize_);
     } catch (const std::exception& e) {
         QL_FAIL("Error during amc val engine run: " << e.what());
     }
@@ -738,6 +749,10 @@ void AMCValuationEngine::buildCube(const boost::shared_ptr<ore::data::Portfolio>
     using resultType = int;
     std::vector<std::future<resultType>> results(eff_nThreads);
 
+    // reserve the additional threads, so that the worker pools of the pricing engines do not oversubscribe the cores
+
+    QuantExt::WorkerPool::ThreadReservation threadReservation(eff_nThreads - 1);
+
     std::vector<std::thread> jobs; // not needed if thread pool is used
 
     // get obs mode of main thread, so that we can set this mode in the worker threads below
@@ -794,7 +809,8 @@ void AMCValuationEngine::buildCube(const boost::shared_ptr<ore::data::Portfolio>
                 // run core engine code (asd is written for thread id 0 only)
 
                 runCoreEngine(portfolio, cam, initMarket, scenarioGeneratorData_, aggDataIndices_, aggDataCurrencies_,
-                              aggDataNumberCreditStates_, id == 0 ? asd_ : nullptr, miniCubes_[id], progressIndicator);
+                              aggDataNumberCreditStates_, id == 0 ? asd_ : nullptr, miniCubes_[id], progressIndicator,
+                              pathRepositorySize_);
 
                 // return code 0 = ok
 
@@ -83,9 +83,15 @@ public:
     //! Get aggregation data
     const boost::shared_ptr<ore::analytics::AggregationScenarioData>& aggregationScenarioData() const { return asd_; }
 
+    /*! Set / get the maximum number of values stored in the repository of calibration paths shared between the amc
+        engines (see QuantExt::McPathRepository), zero disables the sharing */
+    QuantLib::Size& pathRepositorySize() { return pathRepositorySize_; }
+    QuantLib::Size pathRepositorySize() const { return pathRepositorySize_; }
+
 private:
     // set / get via additional methods
     boost::shared_ptr<ore::analytics::AggregationScenarioData> asd_;
+    QuantLib::Size pathRepositorySize_ = 25000000;
 
     // running in single or multi threaded mode?
     bool useMultithreading_ = false;
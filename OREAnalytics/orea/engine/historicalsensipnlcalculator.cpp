@@ -20,9 +20,13 @@
 #include <orea/cube/inmemorycube.hpp>
 #include <ored/utilities/to_string.hpp>
 
+#include <qle/utilities/workerpool.hpp>
+
 #include <boost/accumulators/statistics/tail_quantile.hpp>
 #include <boost/range/adaptor/indexed.hpp>
 
+#include <cmath>
+
 using namespace std;
 using namespace QuantLib;
 using namespace boost::accumulators;
@@ -81,48 +85,125 @@ void cacheTradeSensitivities(TradeSensiCache& cache, ore::analytics::Sensitivity
 namespace ore {
 namespace analytics {
 
+CovarianceCalculator::CovarianceCalculator(ore::data::TimePeriod covariancePeriod, const Size threads,
+                                           const Real lambda, const Real shrinkage)
+    : covariancePeriod_(covariancePeriod), threads_(threads), lambda_(lambda), shrinkage_(shrinkage) {
+    QL_REQUIRE(threads_ > 0, "CovarianceCalculator: threads must be positive");
+    QL_REQUIRE(lambda_ == Null<Real>() || (lambda_ > 0.0 && lambda_ <= 1.0),
+               "CovarianceCalculator: EWMA decay factor (" << lambda_ << ") must be in (0,1]");
+    QL_REQUIRE(shrinkage_ >= 0.0 && shrinkage_ <= 1.0,
+               "CovarianceCalculator: shrinkage intensity (" << shrinkage_ << ") must be in [0,1]");
+}
+
 void CovarianceCalculator::initialise(const set<pair<RiskFactorKey, Size>>& keys) {
-    // Set up the boost accumulators that will calculate the covariance between the time series of historical shifts for
-    // each relevant risk factor key i.e. the risk factor keys in the set keys over the benchmark period
-    
-    for (auto ito = keys.begin(); ito != keys.end(); ito++) {
-        accCov_[make_pair(ito->second, ito->second)] = accumulator();
-        for (auto iti = keys.begin(); iti != ito; iti++) {
-            accCov_[make_pair(iti->second, ito->second)] = accumulator();
-        }
-    }
+    // Remember the cube indices of the relevant risk factor keys i.e. the risk factor keys in the set keys, the
+    // historical shifts of these keys over the benchmark period are collected in updateAccumulators()
+    cubeIndices_.clear();
+    cubeIndices_.reserve(keys.size());
+    for (auto const& k : keys)
+        cubeIndices_.push_back(k.second);
+    shifts_.clear();
+    observations_ = 0;
 }
 
 void CovarianceCalculator::updateAccumulators(const ext::shared_ptr<NPVCube>& shiftCube, Date startDate, Date endDate, Size index) {
     TLOG("Updating Covariance accumlators for sensitivity record " << index);
     if (covariancePeriod_.contains(startDate) &&
         covariancePeriod_.contains(endDate)) {
-        // Update the covariance accumulators if in benchmark period
-        for (auto it = accCov_.begin(); it != accCov_.end(); it++) {
-            Real oShift = shiftCube->get(it->first.first, 0, index);
-            if (it->first.first == it->first.second) {
-                it->second(oShift, covariate1 = oShift);
-            } else {
-                Real iShift = shiftCube->get(it->first.second, 0, index);
-                it->second(oShift, covariate1 = iShift);
-            }
-        }
+        // Append the shifts to the shift matrix if in benchmark period
+        for (auto const& i : cubeIndices_)
+            shifts_.push_back(shiftCube->get(i, 0, index));
+        ++observations_;
     }
 }
 
 void CovarianceCalculator::populateCovariance(const std::set<std::pair<RiskFactorKey, QuantLib::Size>>& keys) {
     LOG("Populate the covariance matrix with the calculated covariances");
-    covariance_ = Matrix(keys.size(), keys.size());
-    Size i = 0;
-    for (auto ito = keys.begin(); ito != keys.end(); ito++) {
-        covariance_[i][i] = boost::accumulators::covariance(accCov_.at(make_pair(ito->second, ito->second)));
-        Size j = 0;
-        for (auto iti = keys.begin(); iti != ito; iti++) {
-            covariance_[i][j] = covariance_[j][i] =
-                boost::accumulators::covariance(accCov_.at(make_pair(iti->second, ito->second)));
-            j++;
+    Size n = cubeIndices_.size();
+    Size m = observations_;
+    QL_REQUIRE(keys.size() == n, "CovarianceCalculator: number of keys (" << keys.size()
+                                                                          << ") does not match initialised keys (" << n
+                                                                          << ")");
+    covariance_ = Matrix(n, n, 0.0);
+    if (n == 0 || m == 0) {
+        WLOG("CovarianceCalculator: no observations in covariance period, covariance matrix is zero");
+        return;
+    }
+
+    // observation weights normalised to one, for EWMA the latest observation has the highest weight
+
+    vector<Real> weights(m, 1.0 / static_cast<Real>(m));
+    if (lambda_ != Null<Real>()) {
+        Real sum = 0.0;
+        for (Size k = 0; k < m; ++k)
+            sum += (weights[k] = std::pow(lambda_, static_cast<Real>(m - 1 - k)));
+        for (auto& w : weights)
+            w /= sum;
+    }
+
+    // centre and weight the shifts, the result is stored risk factor by risk factor so that the inner products
+    // below run over contiguous memory
+
+    vector<Real> mean(n, 0.0);
+    for (Size k = 0; k < m; ++k) {
+        const Real* row = &shifts_[k * n];
+        for (Size i = 0; i < n; ++i)
+            mean[i] += weights[k] * row[i];
+    }
+    vector<Real> x(n * m);
+    for (Size k = 0; k < m; ++k) {
+        const Real* row = &shifts_[k * n];
+        Real w = std::sqrt(weights[k]);
+        for (Size i = 0; i < n; ++i)
+            x[i * m + k] = w * (row[i] - mean[i]);
+    }
+
+    // compute the upper triangle of x x^T in blocks of risk factors, each block is one task writing to a distinct
+    // part of the covariance matrix, within a block the observations are processed in chunks
+
+    const Size blockSize = 64, chunkSize = 256;
+    Size nBlocks = (n + blockSize - 1) / blockSize;
+    vector<pair<Size, Size>> blocks;
+    for (Size bi = 0; bi < nBlocks; ++bi)
+        for (Size bj = bi; bj < nBlocks; ++bj)
+            blocks.push_back(make_pair(bi, bj));
+
+    auto task = [this, &blocks, &x, n, m, blockSize, chunkSize](Size b) {
+        Size i0 = blocks[b].first * blockSize, i1 = std::min(i0 + blockSize, n);
+        Size j0 = blocks[b].second * blockSize, j1 = std::min(j0 + blockSize, n);
+        for (Size k0 = 0; k0 < m; k0 += chunkSize) {
+            Size k1 = std::min(k0 + chunkSize, m);
+            for (Size i = i0; i < i1; ++i) {
+                const Real* xi = &x[i * m];
+                for (Size j = std::max(i, j0); j < j1; ++j) {
+                    const Real* xj = &x[j * m];
+                    Real s = 0.0;
+                    for (Size k = k0; k < k1; ++k)
+                        s += xi[k] * xj[k];
+                    covariance_[i][j] += s;
+                }
+            }
+        }
+    };
+
+    Size threads = std::min(threads_, blocks.size());
+    if (threads > 1) {
+        DLOG("Computing " << n << " x " << n << " covariance matrix from " << m << " observations in " << blocks.size()
+                          << " blocks using " << threads << " threads");
+        QuantExt::WorkerPool pool(threads);
+        pool.run(blocks.size(), task);
+    } else {
+        for (Size b = 0; b < blocks.size(); ++b)
+            task(b);
+    }
+
+    // fill the lower triangle and apply the shrinkage
+
+    for (Size i = 0; i < n; ++i) {
+        for (Size j = i + 1; j < n; ++j) {
+            covariance_[i][j] *= 1.0 - shrinkage_;
+            covariance_[j][i] = covariance_[i][j];
         }
-        i++;
     }
 }
 
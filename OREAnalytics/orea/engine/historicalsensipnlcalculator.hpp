@@ -31,17 +31,7 @@
 
 #include <ql/math/matrix.hpp>
 #include <ql/shared_ptr.hpp>
-
-#include <boost/accumulators/accumulators.hpp>
-// Including <boost/accumulators/statistics.hpp> causes the following swig wrapper compiler errors
-//   explicit specialization of 'boost::accumulators::feature_of<boost::accumulators::tag::weighted_skewness>'
-//   explicit specialization of 'boost::accumulators::feature_of<boost::accumulators::tag::weighted_kurtosis>'
-// see https://github.com/boostorg/accumulators/issues/20
-// The following subset of includes is sufficient here and circumvents the swig errors
-#include <boost/accumulators/statistics/stats.hpp>
-#include <boost/accumulators/statistics/variance.hpp>
-#include <boost/accumulators/statistics/covariance.hpp>
-#include <boost/accumulators/statistics/variates/covariate.hpp>
+#include <ql/utilities/null.hpp>
 
 namespace ore {
 namespace analytics {
@@ -72,21 +62,36 @@ protected:
     ore::data::TimePeriod pnlPeriod_;
 };
 
+//! Covariance of the historical sensitivity shifts over a covariance period
+/*! The shifts of the relevant risk factors are gathered scenario by scenario into a contiguous matrix. The covariance
+    matrix is computed in populateCovariance() as the product of the centred shift matrix with its transpose, where
+    only the upper triangle is computed in blocks of risk factors and observations which are small enough to stay in
+    the cache. The blocks are distributed over the given number of threads.
+
+    By default all observations are weighted equally and the covariance is normalised by the number of observations.
+    If an EWMA decay factor lambda is given, the k-th observation before the latest one is weighted by lambda^k. A
+    shrinkage intensity s in [0,1] shrinks the covariance matrix towards its diagonal, i.e. the off-diagonal elements
+    are multiplied by 1 - s.
+*/
 class CovarianceCalculator {
 public:
-    CovarianceCalculator(ore::data::TimePeriod covariancePeriod) : covariancePeriod_(covariancePeriod) {}
+    CovarianceCalculator(ore::data::TimePeriod covariancePeriod, const QuantLib::Size threads = 1,
+                         const QuantLib::Real lambda = QuantLib::Null<QuantLib::Real>(),
+                         const QuantLib::Real shrinkage = 0.0);
     void initialise(const std::set<std::pair<RiskFactorKey, QuantLib::Size>>& keys);
     void updateAccumulators(const QuantLib::ext::shared_ptr<NPVCube>& shiftCube, QuantLib::Date startDate, QuantLib::Date endDate, QuantLib::Size index);
     void populateCovariance(const std::set<std::pair<RiskFactorKey, QuantLib::Size>>& keys);
     const Matrix& covariance() const { return covariance_; }
 
 private:
-    typedef boost::accumulators::accumulator_set<
-        QuantLib::Real,
-        boost::accumulators::stats<boost::accumulators::tag::covariance<QuantLib::Real, boost::accumulators::tag::covariate1>>>
-        accumulator;
-    std::map<std::pair<QuantLib::Size, QuantLib::Size>, accumulator> accCov_;
     ore::data::TimePeriod covariancePeriod_;
+    QuantLib::Size threads_;
+    QuantLib::Real lambda_, shrinkage_;
+    // index of the risk factors in the shift cube
+    std::vector<QuantLib::Size> cubeIndices_;
+    // shifts in the covariance period, one row of cubeIndices_.size() shifts per observation
+    std::vector<QuantLib::Real> shifts_;
+    QuantLib::Size observations_ = 0;
     QuantLib::Matrix covariance_;
 };
 
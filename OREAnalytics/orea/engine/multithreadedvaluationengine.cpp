@@ -121,24 +121,28 @@ void MultiThreadedValuationEngine::buildCube(
 
     // build portfolio against init market and trigger single pricing to generate pricing stats
 
-    LOG("Reset and build portfolio against init market to produce pricing stats from a single pricing. Using pricing "
-        "configuration '"
-        << configuration_ << "'.");
-
-    boost::shared_ptr<ore::data::Market> initMarket = boost::make_shared<ore::data::TodaysMarket>(
-        today_, todaysMarketParams_, loader_, curveConfigs_, true, true, true, referenceData_, false,
-        iborFallbackConfig_, false, handlePseudoCurrenciesTodaysMarket_);
-
-    auto engineFactory = boost::make_shared<ore::data::EngineFactory>(
-        engineData_, initMarket,
-        std::map<ore::data::MarketContext, string>{{ore::data::MarketContext::pricing, configuration_}}, referenceData_,
-        iborFallbackConfig_);
-
-    portfolio->build(engineFactory, context_, true);
-
-    for (auto const& [tid, t] : portfolio->trades()) {
-        TLOG("got npv for " << tid << ": " << std::setprecision(12) << t->instrument()->NPV() << " "
-                            << t->npvCurrency());
+    if (reuseBuiltPortfolio_) {
+        LOG("Reuse built portfolio, pricing stats are taken from previous pricings.");
+    } else {
+        LOG("Reset and build portfolio against init market to produce pricing stats from a single pricing. Using "
+            "pricing configuration '"
+            << configuration_ << "'.");
+
+        boost::shared_ptr<ore::data::Market> initMarket = boost::make_shared<ore::data::TodaysMarket>(
+            today_, todaysMarketParams_, loader_, curveConfigs_, true, true, true, referenceData_, false,
+            iborFallbackConfig_, false, handlePseudoCurrenciesTodaysMarket_);
+
+        auto engineFactory = boost::make_shared<ore::data::EngineFactory>(
+            engineData_, initMarket,
+            std::map<ore::data::MarketContext, string>{{ore::data::MarketContext::pricing, configuration_}},
+            referenceData_, iborFallbackConfig_);
+
+        portfolio->build(engineFactory, context_, true);
+
+        for (auto const& [tid, t] : portfolio->trades()) {
+            TLOG("got npv for " << tid << ": " << std::setprecision(12) << t->instrument()->NPV() << " "
+                                << t->npvCurrency());
+        }
     }
 
     // split portfolio into nThreads parts such that each part has an approximately similar total avg pricing time
@@ -187,12 +191,8 @@ void MultiThreadedValuationEngine::buildCube(
             portfolioIndex = 0;
     }
 
-    // output the portfolios into strings so that the worker threads can load them from there
-
-    std::vector<std::string> portfoliosAsString;
-    for (auto const& p : portfolios) {
-        portfoliosAsString.emplace_back(p->toXMLString());
-    }
+    // the worker threads serialise their part of the portfolio into a string and load it from there, so that the
+    // serialisation and parsing of the trades is done in parallel
 
     // log info on the portfolio split
 
@@ -261,7 +261,7 @@ void MultiThreadedValuationEngine::buildCube(
 
     for (Size i = 0; i < eff_nThreads; ++i) {
 
-        auto job = [this, obsMode, dryRun, &calculators, &cptyCalculators, mporStickyDate, &portfoliosAsString,
+        auto job = [this, obsMode, dryRun, &calculators, &cptyCalculators, mporStickyDate, &portfolios,
                     &scenarioGenerators, &loaders, &workerPricingStats, &progressIndicator](int id) -> resultType {
             // set thread local singletons
 
@@ -305,7 +305,7 @@ void MultiThreadedValuationEngine::buildCube(
                 // build portfolio against sim market
 
                 auto portfolio = boost::make_shared<ore::data::Portfolio>();
-                portfolio->fromXMLString(portfoliosAsString[id]);
+                portfolio->fromXMLString(portfolios[id]->toXMLString());
                 auto engineFactory = boost::make_shared<ore::data::EngineFactory>(
                     engineData_, simMarket, std::map<ore::data::MarketContext, string>(), referenceData_,
                     iborFallbackConfig_);
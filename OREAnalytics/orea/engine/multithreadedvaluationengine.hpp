@@ -71,6 +71,11 @@ public:
     // can be optionally called to set the agg scen data (which is done in the ssm for single-threaded runs)
     void setAggregationScenarioData(const boost::shared_ptr<AggregationScenarioData>& aggregationScenarioData);
 
+    /* if set to true, the portfolio passed to buildCube() is not rebuilt against a separate init market to produce
+       pricing stats, instead the pricing stats of previous pricings of the trades are used to split the portfolio
+       (trades without pricing stats are distributed evenly), the trades keep their current build */
+    void setReuseBuiltPortfolio(const bool reuseBuiltPortfolio) { reuseBuiltPortfolio_ = reuseBuiltPortfolio; }
+
     /* analoguous to buildCube() in the single-threaded engine, results are retrieved using below constructors
        if no cptyCalculators is given a function returning an empty vector of calculators will be returned */
     void
@@ -123,6 +128,7 @@ private:
     std::string context_;
 
     boost::shared_ptr<AggregationScenarioData> aggregationScenarioData_;
+    bool reuseBuiltPortfolio_ = false;
 
     std::vector<boost::shared_ptr<ore::analytics::NPVCube>> miniCubes_;
     std::vector<boost::shared_ptr<ore::analytics::NPVCube>> miniNettingSetCubes_;
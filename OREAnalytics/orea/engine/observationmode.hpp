@@ -25,12 +25,20 @@
 
 #include <ql/patterns/observable.hpp>
 
+#include <vector>
+
 namespace ore {
 namespace analytics {
 
 //! The Global Observation setting
 /*!
   This singleton is used in ORE to control the usage of the QuantLib::ObservableSettings
+
+  In mode DirtyFlag notifications are disabled while a scenario is applied to the simulation market, as in mode
+  Disable. The dependencies of the market term structures on the simulation market quotes and of the instruments on
+  both are detected once by probing the observer graph. After each scenario update only the term structures and
+  instruments depending on changed quotes are updated, instead of all of them as in mode Disable.
+
   \ingroup utilities
  */
 class ObservationMode : public QuantLib::Singleton<ObservationMode> {
@@ -41,7 +49,7 @@ private:
 
 public:
     //! Allowable mode mode
-    enum class Mode { None, Disable, Defer, Unregister };
+    enum class Mode { None, Disable, Defer, Unregister, DirtyFlag };
 
     Mode mode() { return mode_; }
 
@@ -56,6 +64,8 @@ public:
             mode_ = Mode::Defer;
         else if (s == "Unregister")
             mode_ = Mode::Unregister;
+        else if (s == "DirtyFlag")
+            mode_ = Mode::DirtyFlag;
         else {
             QL_FAIL("Invalid ObserverMode string " << s);
         }
@@ -64,5 +74,29 @@ public:
 private:
     Mode mode_;
 };
+
+//! Observer recording the first notification it receives
+/*! The ids of the notified recorders are appended to a list shared between the recorders, this is used to detect the
+    dependencies between observables in ObservationMode::Mode::DirtyFlag.
+
+    \ingroup utilities
+ */
+class NotificationRecorder : public QuantLib::Observer {
+public:
+    NotificationRecorder(std::vector<QuantLib::Size>& notified, const QuantLib::Size id)
+        : notified_(notified), id_(id) {}
+    void update() override {
+        if (!hit_) {
+            hit_ = true;
+            notified_.push_back(id_);
+        }
+    }
+    void reset() { hit_ = false; }
+
+private:
+    std::vector<QuantLib::Size>& notified_;
+    QuantLib::Size id_;
+    bool hit_ = false;
+};
 } // namespace analytics
 } // namespace ore
@@ -39,8 +39,12 @@ namespace ore {
 namespace analytics {   
 
 ParametricVarCalculator::ParametricVarParams::ParametricVarParams(const std::string& m, QuantLib::Size samp,
-                                                                  QuantLib::Size sd)
-    : method(parseParametricVarMethod(m)), samples(samp), seed(sd) {}
+                                                                  QuantLib::Size sd, QuantLib::Size thr,
+                                                                  QuantLib::Real covLambda, QuantLib::Real covShrinkage)
+    : method(parseParametricVarMethod(m)), samples(samp), seed(sd), threads(thr), covarianceLambda(covLambda),
+      covarianceShrinkage(covShrinkage) {
+    QL_REQUIRE(threads > 0, "ParametricVarParams: threads must be positive");
+}
 
 ParametricVarCalculator::ParametricVarParams::Method parseParametricVarMethod(const std::string& s) {
     static map<std::string, ParametricVarCalculator::ParametricVarParams::Method> m = {
@@ -75,28 +79,33 @@ std::ostream& operator<<(std::ostream& out, const ParametricVarCalculator::Param
     }
 }
 
-QuantLib::Real ParametricVarCalculator::var(QuantLib::Real confidence, const bool isCall, 
-    const set<pair<string, Size>>& tradeIds) {
+void ParametricVarCalculator::deltaGamma(const bool isCall, Array& delta, Matrix& gamma) const {
+    deltaGamma(deltas_, gammas_, isCall, delta, gamma);
+}
+
+void ParametricVarCalculator::deltaGamma(const std::map<RiskFactorKey, Real>& deltas,
+                                         const std::map<CrossPair, Real>& gammas, const bool isCall, Array& delta,
+                                         Matrix& gamma) const {
     Real factor = isCall ? 1.0 : -1.0;
 
-    Array delta(deltas_.size(), 0.0);
-    Matrix gamma(deltas_.size(), deltas_.size(), 0.0);
+    delta = Array(deltas.size(), 0.0);
+    gamma = Matrix(deltas.size(), deltas.size(), 0.0);
 
     if (includeDeltaMargin_) {
         Size counter = 0;
-        for (auto it = deltas_.begin(); it != deltas_.end(); it++)
+        for (auto it = deltas.begin(); it != deltas.end(); it++)
             delta[counter++] = factor * it->second;
     }
 
     if (includeGammaMargin_) {
         Size outerIdx = 0;
-        for (auto ito = deltas_.begin(); ito != deltas_.end(); ito++) {
+        for (auto ito = deltas.begin(); ito != deltas.end(); ito++) {
             Size innerIdx = 0;
             // Error if no diagonal element
-            gamma[outerIdx][outerIdx] = factor * gammas_.at(std::make_pair(ito->first, ito->first));
-            for (auto iti = deltas_.begin(); iti != ito; iti++) {
-                auto it = gammas_.find(std::make_pair(iti->first, ito->first));
-                if (it != gammas_.end()) {
+            gamma[outerIdx][outerIdx] = factor * gammas.at(std::make_pair(ito->first, ito->first));
+            for (auto iti = deltas.begin(); iti != ito; iti++) {
+                auto it = gammas.find(std::make_pair(iti->first, ito->first));
+                if (it != gammas.end()) {
                     gamma[innerIdx][outerIdx] = factor * it->second;
                     gamma[outerIdx][innerIdx] = factor * it->second;
                 }
@@ -105,20 +114,39 @@ QuantLib::Real ParametricVarCalculator::var(QuantLib::Real confidence, const boo
             outerIdx++;
         }
     }
+}
+
+std::vector<Real> ParametricVarCalculator::varMc(const Array& delta, const Matrix& gamma,
+                                                 const std::vector<Real>& confidences) const {
+    return varMc(std::vector<Array>(1, delta), std::vector<Matrix>(1, gamma), confidences).front();
+}
+
+std::vector<std::vector<Real>> ParametricVarCalculator::varMc(const std::vector<Array>& deltas,
+                                                              const std::vector<Matrix>& gammas,
+                                                              const std::vector<Real>& confidences) const {
+    QL_REQUIRE(parametricVarParams_.samples != Null<Size>(),
+               "ParametricVarCalculator::computeVar(): method MonteCarlo requires mcSamples");
+    QL_REQUIRE(parametricVarParams_.seed != Null<Size>(),
+               "ParametricVarCalculator::computeVar(): method MonteCarlo requires mcSeed");
+    return QuantExt::deltaGammaVarMc<PseudoRandom>(omega_, deltas, gammas, confidences, parametricVarParams_.samples,
+                                                   parametricVarParams_.seed, *covarianceSalvage_,
+                                                   parametricVarParams_.threads);
+}
+
+QuantLib::Real ParametricVarCalculator::var(QuantLib::Real confidence, const bool isCall, 
+    const set<pair<string, Size>>& tradeIds) {
+    Array delta;
+    Matrix gamma;
+    deltaGamma(isCall, delta, gamma);
 
     if (parametricVarParams_.method == ParametricVarCalculator::ParametricVarParams::Method::Delta)
         return QuantExt::deltaVar(omega_, delta, confidence, *covarianceSalvage_);
     else if (parametricVarParams_.method ==
                 ParametricVarCalculator::ParametricVarParams::Method::DeltaGammaNormal)
         return QuantExt::deltaGammaVarNormal(omega_, delta, gamma, confidence, *covarianceSalvage_);
-    else if (parametricVarParams_.method == ParametricVarCalculator::ParametricVarParams::Method::MonteCarlo) {
-        QL_REQUIRE(parametricVarParams_.samples != Null<Size>(),
-                    "ParametricVarCalculator::computeVar(): method MonteCarlo requires mcSamples");
-        QL_REQUIRE(parametricVarParams_.seed != Null<Size>(),
-                    "ParametricVarCalculator::computeVar(): method MonteCarlo requires mcSamples");
-        return QuantExt::deltaGammaVarMc<PseudoRandom>(omega_, delta, gamma, confidence, parametricVarParams_.samples,
-                                                        parametricVarParams_.seed, *covarianceSalvage_);
-    } else if (parametricVarParams_.method == ParametricVarCalculator::ParametricVarParams::Method::CornishFisher)
+    else if (parametricVarParams_.method == ParametricVarCalculator::ParametricVarParams::Method::MonteCarlo)
+        return varMc(delta, gamma, {confidence}).front();
+    else if (parametricVarParams_.method == ParametricVarCalculator::ParametricVarParams::Method::CornishFisher)
         return QuantExt::deltaGammaVarCornishFisher(omega_, delta, gamma, confidence, *covarianceSalvage_);
     else if (parametricVarParams_.method == ParametricVarCalculator::ParametricVarParams::Method::Saddlepoint) {
         Real res;
@@ -127,14 +155,46 @@ QuantLib::Real ParametricVarCalculator::var(QuantLib::Real confidence, const boo
         } catch (const std::exception& e) {
             ALOG("Saddlepoint VaR computation exited with an error: " << e.what()
                                                                         << ", falling back on Monte-Carlo");
-            res = QuantExt::deltaGammaVarMc<PseudoRandom>(omega_, delta, gamma, confidence,
-                parametricVarParams_.samples, parametricVarParams_.seed, *covarianceSalvage_);
+            res = varMc(delta, gamma, {confidence}).front();
         }        
         return res;
     } else
         QL_FAIL("ParametricVarCalculator::computeVar(): method " << parametricVarParams_.method << " not known.");
 }
 
+std::vector<Real> ParametricVarCalculator::vars(const std::vector<Real>& confidences, const bool isCall) {
+    if (parametricVarParams_.method != ParametricVarCalculator::ParametricVarParams::Method::MonteCarlo) {
+        std::vector<Real> res;
+        for (auto const& c : confidences)
+            res.push_back(var(c, isCall));
+        return res;
+    }
+    // one simulation for all confidence levels, this gives the same results as calling var() per level since the
+    // same seed is used in each call
+    Array delta;
+    Matrix gamma;
+    deltaGamma(isCall, delta, gamma);
+    return varMc(delta, gamma, confidences);
+}
+
+std::vector<std::vector<Real>>
+ParametricVarCalculator::varsMc(const std::vector<std::map<RiskFactorKey, Real>>& deltas,
+                                const std::vector<std::map<CrossPair, Real>>& gammas,
+                                const std::vector<Real>& confidences, const bool isCall) const {
+    QL_REQUIRE(deltas.size() == gammas.size(), "ParametricVarCalculator::varsMc(): number of deltas ("
+                                                   << deltas.size() << ") and gammas (" << gammas.size()
+                                                   << ") must be equal");
+    std::vector<Array> d(deltas.size());
+    std::vector<Matrix> g(deltas.size());
+    for (Size i = 0; i < deltas.size(); ++i) {
+        QL_REQUIRE(deltas[i].size() == omega_.rows(), "ParametricVarCalculator::varsMc(): portfolio "
+                                                          << i << " has " << deltas[i].size()
+                                                          << " deltas, expected " << omega_.rows());
+        deltaGamma(deltas[i], gammas[i], isCall, d[i], g[i]);
+    }
+    return varMc(d, g, confidences);
+}
+
 ParametricVarReport::ParametricVarReport(
     const map<string, set<pair<string, Size>>>& tradePortfolios, 
     const string& portfolioFilter,
@@ -215,89 +275,121 @@ void ParametricVarReport::calculate(ore::data::Report& report) {
             ext::shared_ptr<RiskFilter> rf = ext::make_shared<RiskFilter>(j, k);
             sensiAgg.aggregate(*sensitivities_, rf);
                         
+            // collect the sensitivities per portfolio, portfolios with the same risk factor keys share the
+            // covariance matrix and are processed together, for the Monte Carlo method in one simulation
+            vector<string> ids;
+            vector<map<RiskFactorKey, Real>> portfolioDeltas;
+            vector<map<CrossPair, Real>> portfolioGammas;
+            map<vector<RiskFactorKey>, vector<Size>> groups;
             for (const auto& portfolioId : portfolioIds) {
                 if (!hasFilter || portfolioId == allStr || boost::regex_match(portfolioId, filter)) {
-
-                    set<SensitivityRecord> srs = sensiAgg.sensitivities(portfolioId);
-                    deltas.clear();
-                    gammas.clear();
+                    ids.push_back(portfolioId);
+                    portfolioDeltas.push_back(map<RiskFactorKey, Real>());
+                    portfolioGammas.push_back(map<CrossPair, Real>());
                     // Populate the deltas and gammas for a parametric VAR benchmark calculation
-                    sensiAgg.generateDeltaGamma(portfolioId, deltas, gammas);
-
-                    std::vector<Real> var;
-                    if (deltas.size() > 0) {
+                    sensiAgg.generateDeltaGamma(portfolioId, portfolioDeltas.back(), portfolioGammas.back());
+                    if (portfolioDeltas.back().size() > 0) {
                         vector<RiskFactorKey> keys;
-                        transform(deltas.begin(), deltas.end(), back_inserter(keys),
+                        transform(portfolioDeltas.back().begin(), portfolioDeltas.back().end(), back_inserter(keys),
                                   [](const pair<RiskFactorKey, Real>& kv) { return kv.first; });
+                        groups[keys].push_back(ids.size() - 1);
+                    }
+                }
+            }
 
-                        // If covariance is provided use it, otherwise generate
-                        if (covariance_.size() > 0) {
-                            std::vector<bool> sensiKeyHasNonZeroVariance(keys.size(), false);
-
-                            // build global covariance matrix
-                            covariance = Matrix(keys.size(), keys.size(), 0.0);
-                            Size unusedCovariance = 0;
-                            for (const auto& c : covariance_) {
-                                auto k1 = std::find(keys.begin(), keys.end(), c.first.first);
-                                auto k2 = std::find(keys.begin(), keys.end(), c.first.second);
-                                if (k1 != keys.end() && k2 != keys.end()) {
-                                    covariance(k1 - keys.begin(), k2 - keys.begin()) = c.second;
-                                    if (k1 == k2)
-                                        sensiKeyHasNonZeroVariance[k1 - keys.begin()] = true;
-                                } else
-                                    ++unusedCovariance;
-                            }
-                            DLOG("Found " << covariance_.size() << " covariance matrix entries, " << unusedCovariance
-                                          << " do not match a portfolio sensitivity and will not be used.");
-                            for (Size i = 0; i < sensiKeyHasNonZeroVariance.size(); ++i) {
-                                if (!sensiKeyHasNonZeroVariance[i])
-                                    WLOG("Zero variance assigned to sensitivity key " << keys[i]);
-                            }
-                        } else {
-                            QL_REQUIRE(benchmarkPeriod_, "No benchmark period provided to generate covariance matrix");
-                            ext::shared_ptr<CovarianceCalculator> covCalculator =
-                                QuantLib::ext::make_shared<CovarianceCalculator>(benchmarkPeriod_.value());
-                            ext::shared_ptr<ScenarioShiftCalculator> shiftCalculator =
-                                ext::make_shared<ScenarioShiftCalculator>(sensitivityConfig_, simMarketConfig_);
-                            ext::shared_ptr<HistoricalSensiPnlCalculator> sensiPnlCalculator =
-                                ext::make_shared<HistoricalSensiPnlCalculator>(hisScenGen_, sensitivities_);
-
-                            ext::shared_ptr<NPVCube> npvCube;
-
-                            sensiPnlCalculator->populateSensiShifts(npvCube, keys, shiftCalculator);
-                            sensiPnlCalculator->calculateSensiPnl(srs, keys, npvCube, {}, covCalculator);
-
-                            covariance = covCalculator->covariance();
-                        }
-
-                        // make covariance matrix positive semi-definite
-                        DLOG("Covariance matrix has dimension " << keys.size() << " x " << keys.size());
-                        if (!salvageCovarianceMatrix_) {
-                            LOG("Covariance matrix is no salvaged, check for positive semi-definiteness");
-                            SymmetricSchurDecomposition ssd(covariance);
-                            Real evMin = ssd.eigenvalues().back();
-                            QL_REQUIRE(evMin > 0.0 || close_enough(evMin, 0.0),
-                                       "ParametricVar: input covariance matrix is not positive semi-definite, smallest "
-                                       "eigenvalue is "
-                                           << evMin);
-                            DLOG("Smallest eigenvalue is " << evMin);
-                            covarianceSalvage = boost::make_shared<QuantExt::NoCovarianceSalvage>();
-                        }
-                        DLOG("Covariance matrix salvage complete.");
-                        // compute var and write to report
-                        for (Size i = 0; i < p_.size(); i++)
-                            var.push_back(calculator.var(p_[i]));
-                    } else
-                        var = std::vector<Real>(p_.size(), 0.0);
-
-                    if (!close_enough(QuantExt::detail::absMax(var), 0.0)) {
-                        report.next();
-                        report.add(portfolioId);
-                        report.add(rf->riskClassLabel());
-                        report.add(rf->riskTypeLabel());
-                        for (auto const& v : var)
-                            report.add(v);
+            std::vector<std::vector<Real>> vars(ids.size(), std::vector<Real>(p_.size(), 0.0));
+            for (const auto& [keys, members] : groups) {
+
+                // If covariance is provided use it, otherwise generate
+                if (covariance_.size() > 0) {
+                    std::vector<bool> sensiKeyHasNonZeroVariance(keys.size(), false);
+
+                    // build global covariance matrix
+                    covariance = Matrix(keys.size(), keys.size(), 0.0);
+                    Size unusedCovariance = 0;
+                    for (const auto& c : covariance_) {
+                        auto k1 = std::find(keys.begin(), keys.end(), c.first.first);
+                        auto k2 = std::find(keys.begin(), keys.end(), c.first.second);
+                        if (k1 != keys.end() && k2 != keys.end()) {
+                            covariance(k1 - keys.begin(), k2 - keys.begin()) = c.second;
+                            if (k1 == k2)
+                                sensiKeyHasNonZeroVariance[k1 - keys.begin()] = true;
+                        } else
+                            ++unusedCovariance;
+                    }
+                    DLOG("Found " << covariance_.size() << " covariance matrix entries, " << unusedCovariance
+                                  << " do not match a portfolio sensitivity and will not be used.");
+                    for (Size i = 0; i < sensiKeyHasNonZeroVariance.size(); ++i) {
+                        if (!sensiKeyHasNonZeroVariance[i])
+                            WLOG("Zero variance assigned to sensitivity key " << keys[i]);
                     }
+                } else {
+                    // the covariance of the historical shifts depends on the keys only, so the sensitivities of
+                    // any portfolio in the group can be used
+                    QL_REQUIRE(benchmarkPeriod_, "No benchmark period provided to generate covariance matrix");
+                    set<SensitivityRecord> srs = sensiAgg.sensitivities(ids[members.front()]);
+                    ext::shared_ptr<CovarianceCalculator> covCalculator =
+                        QuantLib::ext::make_shared<CovarianceCalculator>(
+                            benchmarkPeriod_.value(), parametricVarParams_.threads,
+                            parametricVarParams_.covarianceLambda, parametricVarParams_.covarianceShrinkage);
+                    ext::shared_ptr<ScenarioShiftCalculator> shiftCalculator =
+                        ext::make_shared<ScenarioShiftCalculator>(sensitivityConfig_, simMarketConfig_);
+                    ext::shared_ptr<HistoricalSensiPnlCalculator> sensiPnlCalculator =
+                        ext::make_shared<HistoricalSensiPnlCalculator>(hisScenGen_, sensitivities_);
+
+                    ext::shared_ptr<NPVCube> npvCube;
+
+                    sensiPnlCalculator->populateSensiShifts(npvCube, keys, shiftCalculator);
+                    sensiPnlCalculator->calculateSensiPnl(srs, keys, npvCube, {}, covCalculator);
+
+                    covariance = covCalculator->covariance();
+                }
+
+                // make covariance matrix positive semi-definite
+                DLOG("Covariance matrix has dimension " << keys.size() << " x " << keys.size() << ", shared by "
+                                                        << members.size() << " portfolio(s)");
+                if (!salvageCovarianceMatrix_) {
+                    LOG("Covariance matrix is no salvaged, check for positive semi-definiteness");
+                    SymmetricSchurDecomposition ssd(covariance);
+                    Real evMin = ssd.eigenvalues().back();
+                    QL_REQUIRE(evMin > 0.0 || close_enough(evMin, 0.0),
+                               "ParametricVar: input covariance matrix is not positive semi-definite, smallest "
+                               "eigenvalue is "
+                                   << evMin);
+                    DLOG("Smallest eigenvalue is " << evMin);
+                    covarianceSalvage = boost::make_shared<QuantExt::NoCovarianceSalvage>();
+                }
+                DLOG("Covariance matrix salvage complete.");
+
+                // compute var
+                if (parametricVarParams_.method == ParametricVarCalculator::ParametricVarParams::Method::MonteCarlo) {
+                    vector<map<RiskFactorKey, Real>> groupDeltas;
+                    vector<map<CrossPair, Real>> groupGammas;
+                    for (auto const m : members) {
+                        groupDeltas.push_back(portfolioDeltas[m]);
+                        groupGammas.push_back(portfolioGammas[m]);
+                    }
+                    auto groupVars = calculator.varsMc(groupDeltas, groupGammas, p_);
+                    for (Size i = 0; i < members.size(); ++i)
+                        vars[members[i]] = groupVars[i];
+                } else {
+                    for (auto const m : members) {
+                        deltas = portfolioDeltas[m];
+                        gammas = portfolioGammas[m];
+                        vars[m] = calculator.vars(p_);
+                    }
+                }
+            }
+
+            // write the vars to the report
+            for (Size i = 0; i < ids.size(); ++i) {
+                if (!close_enough(QuantExt::detail::absMax(vars[i]), 0.0)) {
+                    report.next();
+                    report.add(ids[i]);
+                    report.add(rf->riskClassLabel());
+                    report.add(rf->riskTypeLabel());
+                    for (auto const& v : vars[i])
+                        report.add(v);
                 }
             }
             sensiAgg.reset();
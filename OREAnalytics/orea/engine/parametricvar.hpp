@@ -61,11 +61,20 @@ public:
         };
 
         ParametricVarParams() {};
-        ParametricVarParams(const std::string& m, QuantLib::Size samples, QuantLib::Size seed);
+        ParametricVarParams(const std::string& m, QuantLib::Size samples, QuantLib::Size seed,
+                            QuantLib::Size threads = 1,
+                            QuantLib::Real covarianceLambda = QuantLib::Null<QuantLib::Real>(),
+                            QuantLib::Real covarianceShrinkage = 0.0);
 
         Method method = Method::Delta;
         QuantLib::Size samples = QuantLib::Null<QuantLib::Size>();
         QuantLib::Size seed = QuantLib::Null<QuantLib::Size>();
+        //! Number of threads for the Monte Carlo simulation and the covariance estimation
+        QuantLib::Size threads = 1;
+        //! EWMA decay factor for the covariance estimation from historical shifts, equal weights if null
+        QuantLib::Real covarianceLambda = QuantLib::Null<QuantLib::Real>();
+        //! Shrinkage intensity towards the diagonal for the covariance estimation from historical shifts
+        QuantLib::Real covarianceShrinkage = 0.0;
     };
 
     ParametricVarCalculator(const ParametricVarParams& parametricVarParams, const QuantLib::Matrix& omega,
@@ -79,7 +88,28 @@ public:
     QuantLib::Real var(QuantLib::Real confidence, const bool isCall = true, 
         const std::set<std::pair<std::string, QuantLib::Size>>& tradeIds = {}) override;
 
+    /*! vars for several confidence levels, for the Monte Carlo method all confidence levels are estimated from one
+        simulation */
+    std::vector<QuantLib::Real> vars(const std::vector<QuantLib::Real>& confidences, const bool isCall = true);
+
+    /*! Monte Carlo vars of several portfolios with the same risk factor keys, i.e. sharing the covariance matrix,
+        the vars of all portfolios are estimated from one simulation */
+    std::vector<std::vector<QuantLib::Real>> varsMc(const std::vector<std::map<RiskFactorKey, QuantLib::Real>>& deltas,
+                                                    const std::vector<std::map<CrossPair, QuantLib::Real>>& gammas,
+                                                    const std::vector<QuantLib::Real>& confidences,
+                                                    const bool isCall = true) const;
+
 private:
+    void deltaGamma(const bool isCall, QuantLib::Array& delta, QuantLib::Matrix& gamma) const;
+    void deltaGamma(const std::map<RiskFactorKey, QuantLib::Real>& deltas,
+                    const std::map<CrossPair, QuantLib::Real>& gammas, const bool isCall, QuantLib::Array& delta,
+                    QuantLib::Matrix& gamma) const;
+    std::vector<QuantLib::Real> varMc(const QuantLib::Array& delta, const QuantLib::Matrix& gamma,
+                                      const std::vector<QuantLib::Real>& confidences) const;
+    std::vector<std::vector<QuantLib::Real>> varMc(const std::vector<QuantLib::Array>& deltas,
+                                                   const std::vector<QuantLib::Matrix>& gammas,
+                                                   const std::vector<QuantLib::Real>& confidences) const;
+
     const ParametricVarParams& parametricVarParams_;
     const QuantLib::Matrix& omega_;
     const std::map<RiskFactorKey, QuantLib::Real>& deltas_;
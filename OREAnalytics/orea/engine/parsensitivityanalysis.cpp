@@ -868,7 +868,8 @@ void ParSensitivityAnalysis::computeParInstrumentSensitivities(const boost::shar
 
         // Since we are not using ValuationEngine we need to manually perform the trade updates here
         // TODO - explore means of utilising valuation engine
-        if (ObservationMode::instance().mode() == ObservationMode::Mode::Disable) {
+        if (ObservationMode::instance().mode() == ObservationMode::Mode::Disable ||
+            ObservationMode::instance().mode() == ObservationMode::Mode::DirtyFlag) {
             for (auto it : parHelpers_)
                 it.second->deepUpdate();
             for (auto it : parCaps_)
@@ -21,17 +21,24 @@
 #include <ored/utilities/log.hpp>
 #include <ql/errors.hpp>
 
+#include <qle/utilities/workerpool.hpp>
+
+#include <algorithm>
+#include <memory>
+
 using ore::analytics::ScenarioFilter;
 using std::function;
 using std::map;
 using std::set;
 using std::string;
+using std::vector;
 
 namespace ore {
 namespace analytics {
 
-SensitivityAggregator::SensitivityAggregator(const map<string, set<pair<string, Size>>>& categories)
-    : setCategories_(categories) {
+SensitivityAggregator::SensitivityAggregator(const map<string, set<pair<string, Size>>>& categories,
+                                             const Size threads)
+    : setCategories_(categories), threads_(threads) {
 
     // Initialise the category functions
     for (const auto& kv : setCategories_) {
@@ -40,10 +47,21 @@ SensitivityAggregator::SensitivityAggregator(const map<string, set<pair<string,
 
     // Initialise the categorised records
     init();
+
+    // Initialise the category membership of the trades in the sets, trades not in any set are in no category
+    Size c = 0;
+    for (const auto& kv : setCategories_) {
+        for (const auto& t : kv.second) {
+            auto it = tradeCategories_.emplace(t.first, vector<bool>(categoryNames_.size(), false)).first;
+            it->second[c] = true;
+        }
+        ++c;
+    }
 }
 
-SensitivityAggregator::SensitivityAggregator(const map<string, function<bool(string)>>& categories)
-    : categories_(categories) {
+SensitivityAggregator::SensitivityAggregator(const map<string, function<bool(string)>>& categories,
+                                             const Size threads)
+    : categories_(categories), threads_(threads) {
 
     // Initialise the categorised records
     init();
@@ -53,27 +71,78 @@ void SensitivityAggregator::aggregate(SensitivityStream& ss, const boost::shared
     // Ensure at start of stream
     ss.reset();
 
+    // Filter decisions per risk factor key id, evaluated on first use
+    vector<int> allowed;
+    auto allow = [this, &allowed, &filter](const RiskFactorKey& key, Size& id) {
+        id = keyId(key);
+        if (id >= allowed.size())
+            allowed.resize(id + 1, -1);
+        if (allowed[id] == -1)
+            allowed[id] = filter->allow(key) ? 1 : 0;
+        return allowed[id] == 1;
+    };
+
+    // A record read from the stream together with its key ids and the categories of its trade
+    struct Entry {
+        SensitivityRecord sr;
+        KeyIds ids;
+        const vector<bool>* categories;
+    };
+    const Size chunkSize = 100000;
+    vector<Entry> chunk;
+    chunk.reserve(chunkSize);
+
+    Size nThreads = std::max<Size>(std::min(threads_, records_.size()), 1);
+    std::unique_ptr<QuantExt::WorkerPool> pool;
+    if (nThreads > 1)
+        pool = std::make_unique<QuantExt::WorkerPool>(nThreads);
+
+    // Update the records of the categories c with c % nThreads = t from the current chunk
+    auto task = [this, &chunk, nThreads](Size t) {
+        for (const auto& e : chunk) {
+            for (Size c = t; c < records_.size(); c += nThreads) {
+                if ((*e.categories)[c])
+                    add(e.sr, e.ids, records_[c]);
+            }
+        }
+    };
+    auto process = [&chunk, &pool, &task, nThreads]() {
+        if (pool)
+            pool->run(nThreads, task);
+        else
+            task(0);
+        chunk.clear();
+    };
+
     // Loop over stream's records
     while (SensitivityRecord sr = ss.next()) {
         // Skip this record if the risk factor is not in the filter
-        if (!sr.isCrossGamma() && !filter->allow(sr.key_1))
+        Size id1, id2;
+        if (!allow(sr.key_1, id1))
             continue;
-        if (sr.isCrossGamma() && (!filter->allow(sr.key_1) || !filter->allow(sr.key_2)))
+        if (sr.isCrossGamma()) {
+            if (!allow(sr.key_2, id2))
+                continue;
+        } else {
+            id2 = keyId(sr.key_2);
+        }
+
+        // Skip this record if the trade is in no category
+        const vector<bool>& categories = tradeCategories(sr.tradeId);
+        if (std::find(categories.begin(), categories.end(), true) == categories.end())
             continue;
 
         // "Blank out" trade ID before adding
-        string tradeId = sr.tradeId;
         sr.tradeId = "";
-
-        // Update aggRecords_ for each category
-        for (const auto& kv : categories_) {
-            // Check if the sensitivity record's trade ID is in the category
-            if (kv.second(tradeId)) {
-                DLOG("Updating aggregated sensitivities for category " << kv.first << " with record: " << sr);
-                add(sr, aggRecords_[kv.first]);
-            }
-        }
+        chunk.push_back({std::move(sr), std::make_pair(id1, id2), &categories});
+        if (chunk.size() == chunkSize)
+            process();
     }
+    if (!chunk.empty())
+        process();
+
+    // The ordered sets are rebuilt on the next request
+    aggRecords_.clear();
 }
 
 void SensitivityAggregator::reset() {
@@ -86,11 +155,17 @@ void SensitivityAggregator::reset() {
 
 const set<SensitivityRecord>& SensitivityAggregator::sensitivities(const string& category) const {
 
-    auto it = aggRecords_.find(category);
-    QL_REQUIRE(it != aggRecords_.end(),
+    auto it = std::lower_bound(categoryNames_.begin(), categoryNames_.end(), category);
+    QL_REQUIRE(it != categoryNames_.end() && *it == category,
                "The category " << category << " was not used in the construction of the SensitivityAggregator");
 
-    return it->second;
+    auto r = aggRecords_.find(category);
+    if (r == aggRecords_.end()) {
+        const auto& records = records_[it - categoryNames_.begin()].records;
+        r = aggRecords_.emplace(category, set<SensitivityRecord>(records.begin(), records.end())).first;
+    }
+
+    return r->second;
 }
 
 void SensitivityAggregator::generateDeltaGamma(const string& category, map<RiskFactorKey, Real>& deltas,
@@ -122,26 +197,56 @@ void SensitivityAggregator::generateDeltaGamma(const string& category, map<RiskF
 }
 
 void SensitivityAggregator::init() {
-    // Add an empty set for each of the categories
-    for (const auto& kv : categories_) {
-        aggRecords_[kv.first] = {};
+    // Add an empty container for each of the categories
+    categoryNames_.clear();
+    for (const auto& kv : categories_)
+        categoryNames_.push_back(kv.first);
+    records_ = vector<CategoryRecords>(categoryNames_.size());
+    aggRecords_.clear();
+}
+
+const vector<bool>& SensitivityAggregator::tradeCategories(const string& tradeId) {
+    auto it = tradeCategories_.find(tradeId);
+    if (it == tradeCategories_.end()) {
+        // Evaluate the category functions once for a new trade ID
+        vector<bool> flags(categoryNames_.size(), false);
+        Size c = 0;
+        for (const auto& kv : categories_)
+            flags[c++] = kv.second(tradeId);
+        it = tradeCategories_.emplace(tradeId, flags).first;
     }
+    return it->second;
+}
+
+Size SensitivityAggregator::keyId(const RiskFactorKey& key) {
+    return keyIds_.emplace(key, keyIds_.size()).first->second;
+}
+
+std::size_t SensitivityAggregator::RiskFactorKeyHash::operator()(const RiskFactorKey& key) const {
+    std::size_t seed = 0;
+    boost::hash_combine(seed, static_cast<int>(key.keytype));
+    boost::hash_combine(seed, key.name);
+    boost::hash_combine(seed, key.index);
+    return seed;
 }
 
-void SensitivityAggregator::add(SensitivityRecord& sr, set<SensitivityRecord>& records) {
+void SensitivityAggregator::add(const SensitivityRecord& sr, const KeyIds& ids, CategoryRecords& records) {
     // Try to insert sr. This will only pass if sr is not there already.
-    auto p = records.insert(sr);
-    if (!p.second) {
-        // If sr is already in the set, update it.
-        p.first->baseNpv += sr.baseNpv;
-        p.first->delta += sr.delta;
-        p.first->gamma += sr.gamma;
+    auto p = records.index.emplace(ids, records.records.size());
+    if (p.second) {
+        records.records.push_back(sr);
+    } else {
+        // If sr is already there, update it.
+        auto& r = records.records[p.first->second];
+        r.baseNpv += sr.baseNpv;
+        r.delta += sr.delta;
+        r.gamma += sr.gamma;
     }
 }
 
 bool SensitivityAggregator::inCategory(const string& tradeId, const string& category) const {
     QL_REQUIRE(setCategories_.count(category), "The category " << category << " is not valid");
-    auto tradeIds = setCategories_.at(category);
+    const auto& tradeIds = setCategories_.at(category);
     for (auto it = tradeIds.begin(); it != tradeIds.end(); ++it) {
         if (it->first == tradeId)
             return true;
@@ -25,10 +25,14 @@
 #include <orea/engine/sensitivitystream.hpp>
 #include <orea/scenario/scenariosimmarket.hpp>
 
+#include <boost/functional/hash.hpp>
+
 #include <functional>
 #include <map>
 #include <set>
 #include <string>
+#include <unordered_map>
+#include <vector>
 
 namespace ore {
 namespace analytics {
@@ -36,6 +40,14 @@ namespace analytics {
 /*! Class for aggregating SensitivityRecords.
 
     The SensitivityRecords are aggregated according to categories of predefined trade IDs.
+
+    The category membership is evaluated once per trade ID and stored as a vector of flags per trade. The risk
+    factor keys are mapped to integer ids, the records of each category are accumulated in a hash map keyed by the
+    ids of key_1 and key_2. The ordered sets of aggregated records are only built on request in sensitivities().
+
+    The records are read from the stream in chunks by the calling thread. If more than one thread is given, the
+    categories are distributed over the threads and each thread accumulates the records of a chunk for its own
+    categories.
 */
 class SensitivityAggregator {
 public:
@@ -44,7 +56,8 @@ public:
         The \p categories map has a string key that defines the name of the category and a value
         that defines the set of trade IDs in that category.
     */
-    SensitivityAggregator(const std::map<std::string, std::set<std::pair<std::string, QuantLib::Size>>>& categories);
+    SensitivityAggregator(const std::map<std::string, std::set<std::pair<std::string, QuantLib::Size>>>& categories,
+                          const QuantLib::Size threads = 1);
 
     /*! Constructor that uses functions to define the aggregation categories.
 
@@ -52,7 +65,8 @@ public:
         is a function that when given a trade ID, returns a bool indicating if the trade ID is in the
         category.
     */
-    SensitivityAggregator(const std::map<std::string, std::function<bool(std::string)>>& categories);
+    SensitivityAggregator(const std::map<std::string, std::function<bool(std::string)>>& categories,
+                          const QuantLib::Size threads = 1);
 
     /*! Update the aggregator with SensitivityRecords from the stream \p ss after applying the
         optional filter. If no filter is specified, all risk factors are aggregated.
@@ -83,13 +97,37 @@ private:
     std::map<std::string, std::set<std::pair<std::string, QuantLib::Size>>> setCategories_;
     //! Container for category names and their definition via functions
     std::map<std::string, std::function<bool(std::string)>> categories_;
-    //! Sensitivity records aggregated according to <code>categories_</code>
-    std::map<std::string, std::set<SensitivityRecord>> aggRecords_;
+    //! Number of threads used in aggregate()
+    QuantLib::Size threads_;
+    //! Category names in the order of <code>categories_</code>
+    std::vector<std::string> categoryNames_;
+    //! Category membership flags per trade ID, in the order of <code>categoryNames_</code>
+    std::unordered_map<std::string, std::vector<bool>> tradeCategories_;
+    //! Integer ids of the risk factor keys
+    struct RiskFactorKeyHash {
+        std::size_t operator()(const RiskFactorKey& key) const;
+    };
+    std::unordered_map<RiskFactorKey, QuantLib::Size, RiskFactorKeyHash> keyIds_;
+
+    //! Sensitivity records of one category and the position of the record for the (key_1, key_2) ids
+    typedef std::pair<QuantLib::Size, QuantLib::Size> KeyIds;
+    struct CategoryRecords {
+        std::unordered_map<KeyIds, QuantLib::Size, boost::hash<KeyIds>> index;
+        std::vector<SensitivityRecord> records;
+    };
+    //! Sensitivity records aggregated according to <code>categories_</code>, in the order of categoryNames_
+    std::vector<CategoryRecords> records_;
+    //! Ordered sets of aggregated records, built on request
+    mutable std::map<std::string, std::set<SensitivityRecord>> aggRecords_;
 
     //! Initialise the container of aggregated records
     void init();
-    //! Add a sensitivity record to the set of aggregated \p records
-    void add(SensitivityRecord& sr, std::set<SensitivityRecord>& records);
+    //! Return the category membership flags for the \p tradeId
+    const std::vector<bool>& tradeCategories(const std::string& tradeId);
+    //! Return the integer id of the risk factor \p key
+    QuantLib::Size keyId(const RiskFactorKey& key);
+    //! Add a sensitivity record with the given key \p ids to the aggregated \p records
+    void add(const SensitivityRecord& sr, const KeyIds& ids, CategoryRecords& records);
     //! Determine if the \p tradeId is in the given \p category
     bool inCategory(const std::string& tradeId, const std::string& category) const;
 };
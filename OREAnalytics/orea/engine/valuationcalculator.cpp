@@ -21,10 +21,15 @@
     \ingroup simulation
 */
 
+#include <orea/engine/observationmode.hpp>
 #include <orea/engine/valuationcalculator.hpp>
 #include <ored/portfolio/optionwrapper.hpp>
 #include <ored/utilities/log.hpp>
 
+#include <ql/instruments/swap.hpp>
+
+#include <typeinfo>
+
 namespace ore {
 namespace analytics {
 
@@ -76,6 +81,88 @@ Real NPVCalculator::npv(Size tradeIndex, const boost::shared_ptr<Trade>& trade,
     return npv * fx / numeraire;
 }
 
+void BatchNPVCalculator::init(const boost::shared_ptr<Portfolio>& portfolio,
+                              const boost::shared_ptr<SimMarket>& simMarket) {
+    NPVCalculator::init(portfolio, simMarket);
+    DLOG("init BatchNPVCalculator");
+    pricers_.clear();
+    batchInstruments_.clear();
+    tradeBatch_.assign(portfolio->size(), QuantLib::Null<Size>());
+    tradeBatchPosition_.assign(portfolio->size(), QuantLib::Null<Size>());
+    std::map<std::string, Size> batchIndex;
+    Size i = 0, n = 0;
+    for (auto const& [tradeId, trade] : portfolio->trades()) {
+        auto const& inst = trade->instrument();
+        boost::shared_ptr<QuantLib::Instrument> qlInstr = inst ? inst->qlInstrument() : nullptr;
+        bool eligible = trade->tradeType() == "Swap" && qlInstr != nullptr && inst->additionalInstruments().empty() &&
+                        typeid(*qlInstr) == typeid(QuantLib::Swap);
+        for (auto const& c : trade->legCurrencies())
+            eligible = eligible && c == trade->npvCurrency();
+        if (eligible) {
+            auto b = batchIndex.find(trade->npvCurrency());
+            if (b == batchIndex.end()) {
+                b = batchIndex.insert(std::make_pair(trade->npvCurrency(), pricers_.size())).first;
+                pricers_.push_back(boost::make_shared<QuantExt::BatchSwapPricer>(
+                    simMarket->discountCurve(trade->npvCurrency())));
+            }
+            tradeBatch_[i] = b->second;
+            tradeBatchPosition_[i] = pricers_[b->second]->add(*boost::static_pointer_cast<QuantLib::Swap>(qlInstr));
+            batchInstruments_.push_back(inst);
+            ++n;
+        }
+        ++i;
+    }
+    batchNpvs_.resize(pricers_.size());
+    batchValid_.resize(pricers_.size());
+    batchesCalculated_ = false;
+    LOG("BatchNPVCalculator: " << n << " out of " << portfolio->size() << " trades are priced in " << pricers_.size()
+                               << " batches");
+}
+
+void BatchNPVCalculator::initScenario() {
+    NPVCalculator::initScenario();
+    batchesCalculated_ = false;
+}
+
+void BatchNPVCalculator::calculateBatches() {
+    // The valuation engine deep-updates a trade's instrument only right before the trade's own calculators run. The
+    // batches read the coupons of all batched trades on the first request though, so we update them all up front,
+    // otherwise lazy floating rate coupons of trades further down the portfolio would still hold stale amounts.
+    ObservationMode::Mode om = ObservationMode::instance().mode();
+    if (om == ObservationMode::Mode::Disable || om == ObservationMode::Mode::Unregister ||
+        om == ObservationMode::Mode::DirtyFlag) {
+        for (auto const& inst : batchInstruments_)
+            inst->updateQlInstruments();
+    }
+    for (Size b = 0; b < pricers_.size(); ++b) {
+        try {
+            pricers_[b]->npvs(batchNpvs_[b]);
+            batchValid_[b] = true;
+        } catch (const std::exception& e) {
+            DLOG("BatchNPVCalculator: batch " << b << " failed (" << e.what() << "), fall back to single trade pricing");
+            batchValid_[b] = false;
+        }
+    }
+    batchesCalculated_ = true;
+}
+
+Real BatchNPVCalculator::npv(Size tradeIndex, const boost::shared_ptr<Trade>& trade,
+                             const boost::shared_ptr<SimMarket>& simMarket) {
+    Size b = tradeBatch_[tradeIndex];
+    if (b == QuantLib::Null<Size>())
+        return NPVCalculator::npv(tradeIndex, trade, simMarket);
+    if (!batchesCalculated_)
+        calculateBatches();
+    if (!batchValid_[b])
+        return NPVCalculator::npv(tradeIndex, trade, simMarket);
+    Real npv = batchNpvs_[b][tradeBatchPosition_[tradeIndex]] * trade->instrument()->multiplier();
+    if (close_enough(npv, 0.0))
+        return npv;
+    Real fx = fxRates_[tradeCcyIndex_[tradeIndex]];
+    Real numeraire = simMarket->numeraire();
+    return npv * fx / numeraire;
+}
+
 void CashflowCalculator::init(const boost::shared_ptr<Portfolio>& portfolio,
                               const boost::shared_ptr<SimMarket>& simMarket) {
     DLOG("init CashflowCalculator");
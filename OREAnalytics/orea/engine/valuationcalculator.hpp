@@ -28,6 +28,8 @@
 #include <ored/portfolio/trade.hpp>
 #include <ored/utilities/dategrid.hpp>
 
+#include <qle/pricingengines/batchswappricer.hpp>
+
 namespace ore {
 namespace analytics {
 using ore::data::Trade;
@@ -113,6 +115,39 @@ protected:
     std::vector<Size> tradeCcyIndex_;
 };
 
+//! BatchNPVCalculator
+/*! Same as the NPVCalculator, but single currency vanilla swaps are priced in batches per currency using the
+ *  QuantExt::BatchSwapPricer instead of calling NPV() on the trade's instrument. The batch results are identical to
+ *  those of the DiscountingSwapEngineMultiCurve (DiscountingSwapEngineOptimised), so the calculator should only be
+ *  used if the trades were built with this engine.
+ *
+ *  The batch npvs are computed once per scenario on the first request. In the Disable, Unregister and DirtyFlag
+ *  observation modes the instruments of all batched trades are deep-updated before that. If the batch pricing fails,
+ *  the npvs of the affected trades are computed using the instrument for the current scenario.
+ */
+class BatchNPVCalculator : public NPVCalculator {
+public:
+    //! base ccy and index to write to
+    BatchNPVCalculator(const std::string& baseCcyCode, Size index = 0) : NPVCalculator(baseCcyCode, index) {}
+
+    Real npv(Size tradeIndex, const boost::shared_ptr<Trade>& trade,
+             const boost::shared_ptr<SimMarket>& simMarket) override;
+
+    void init(const boost::shared_ptr<Portfolio>& portfolio, const boost::shared_ptr<SimMarket>& simMarket) override;
+    void initScenario() override;
+
+private:
+    void calculateBatches();
+
+    std::vector<boost::shared_ptr<QuantExt::BatchSwapPricer>> pricers_;
+    std::vector<boost::shared_ptr<ore::data::InstrumentWrapper>> batchInstruments_;
+    std::vector<std::vector<Real>> batchNpvs_;
+    std::vector<bool> batchValid_;
+    // batch and position in batch for each trade index, Null<Size>() if the trade is not batch priced
+    std::vector<Size> tradeBatch_, tradeBatchPosition_;
+    bool batchesCalculated_ = false;
+};
+
 //! CashflowCalculator
 /*! Calculates the cashflow, converted to base ccy, from t to t+1, this interval is defined by the provided dategrid
  *  The interval is (t, t+1], i.e. we exclude todays flows and include flows that fall exactly on t+1.
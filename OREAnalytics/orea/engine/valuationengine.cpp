@@ -36,6 +36,8 @@
 
 #include <boost/timer/timer.hpp>
 
+#include <algorithm>
+
 using namespace QuantLib;
 using namespace QuantExt;
 using namespace std;
@@ -61,7 +63,7 @@ ValuationEngine::ValuationEngine(const Date& today, const boost::shared_ptr<Date
 void ValuationEngine::recalibrateModels() {
     ObservationMode::Mode om = ObservationMode::instance().mode();
     for (auto const& b : modelBuilders_) {
-        if (om == ObservationMode::Mode::Disable)
+        if (om == ObservationMode::Mode::Disable || om == ObservationMode::Mode::DirtyFlag)
             b.second->forceRecalculate();
         b.second->recalibrate();
     }
@@ -169,6 +171,9 @@ void ValuationEngine::buildCube(const boost::shared_ptr<data::Portfolio>& portfo
         simMarket_->fixingManager()->initialise(portfolio, simMarket_);
     }
 
+    if (om == ObservationMode::Mode::DirtyFlag)
+        initDirtyFlags(trades);
+
     cpu_timer timer;
     cpu_timer loopTimer;
 
@@ -296,6 +301,61 @@ void ValuationEngine::buildCube(const boost::shared_ptr<data::Portfolio>& portfo
     }
 }
 
+void ValuationEngine::initDirtyFlags(const std::map<std::string, boost::shared_ptr<Trade>>& trades) {
+    simMarket_->initDirtyFlags();
+    const auto& observables = simMarket_->dirtyFlagObservables();
+
+    // register a recorder with the instruments of each trade, the instruments and the coupons must forward all
+    // notifications, so that we detect all dependencies and not only those of the first probe
+
+    std::vector<Size> notified;
+    std::vector<boost::shared_ptr<NotificationRecorder>> recorders;
+    for (auto const& [tradeId, trade] : trades) {
+        recorders.push_back(boost::make_shared<NotificationRecorder>(notified, recorders.size()));
+        std::vector<boost::shared_ptr<QuantLib::Instrument>> instruments = trade->instrument()->additionalInstruments();
+        instruments.push_back(trade->instrument()->qlInstrument());
+        for (auto const& i : instruments) {
+            if (i == nullptr)
+                continue;
+            i->alwaysForwardNotifications();
+            recorders.back()->registerWith(i);
+        }
+        for (auto const& l : trade->legs()) {
+            for (auto const& c : l) {
+                if (auto lazy = boost::dynamic_pointer_cast<LazyObject>(c))
+                    lazy->alwaysForwardNotifications();
+            }
+        }
+    }
+
+    // probe the dependencies of the trades on the tracked observables
+
+    tradeDirtyFlags_.assign(trades.size(), std::vector<Size>());
+    for (Size k = 0; k < observables.size(); ++k) {
+        notified.clear();
+        observables[k]->notifyObservers();
+        for (auto const j : notified) {
+            tradeDirtyFlags_[j].push_back(k);
+            recorders[j]->reset();
+        }
+    }
+
+    Size independent = std::count_if(tradeDirtyFlags_.begin(), tradeDirtyFlags_.end(),
+                                     [](const std::vector<Size>& f) { return f.empty(); });
+    LOG("ValuationEngine: dirty flags initialised for " << trades.size() << " trades and " << observables.size()
+                                                        << " observables, " << independent
+                                                        << " trades without detected dependencies are always updated");
+}
+
+bool ValuationEngine::tradeIsDirty(const Size tradeIndex) const {
+    // trades without detected dependencies are updated in every scenario to be on the safe side
+    const auto& flags = tradeDirtyFlags_[tradeIndex];
+    if (flags.empty())
+        return true;
+    const auto& dirty = simMarket_->dirtyFlags();
+    return std::any_of(flags.begin(), flags.end(), [&dirty](const Size k) { return dirty[k]; });
+}
+
 void ValuationEngine::runCalculators(bool isCloseOutDate, const std::map<std::string, boost::shared_ptr<Trade>>& trades,
                                      std::vector<bool>& tradeHasError,
                                      const std::vector<boost::shared_ptr<ValuationCalculator>>& calculators,
@@ -314,7 +374,8 @@ void ValuationEngine::runCalculators(bool isCloseOutDate, const std::map<std::st
         }
 
         // We can avoid checking mode here and always call updateQlInstruments()
-        if (om == ObservationMode::Mode::Disable || om == ObservationMode::Mode::Unregister)
+        if (om == ObservationMode::Mode::Disable || om == ObservationMode::Mode::Unregister ||
+            (om == ObservationMode::Mode::DirtyFlag && tradeIsDirty(j)))
             trade->instrument()->updateQlInstruments();
         try {
             for (auto& calc : calculators)
@@ -112,10 +112,14 @@ private:
                         boost::shared_ptr<analytics::NPVCube>& cptyCube, const QuantLib::Date& d,
                         const QuantLib::Size cubeDateIndex, const QuantLib::Size sample);
     void tradeExercisable(bool enable, const std::map<std::string, boost::shared_ptr<ore::data::Trade>>& trades);
+    void initDirtyFlags(const std::map<std::string, boost::shared_ptr<ore::data::Trade>>& trades);
+    bool tradeIsDirty(const QuantLib::Size tradeIndex) const;
     QuantLib::Date today_;
     boost::shared_ptr<ore::data::DateGrid> dg_;
     boost::shared_ptr<ore::analytics::SimMarket> simMarket_;
     set<std::pair<std::string, boost::shared_ptr<QuantExt::ModelBuilder>>> modelBuilders_;
+    // for ObservationMode::Mode::DirtyFlag, indices of the sim market's tracked observables per trade
+    std::vector<std::vector<QuantLib::Size>> tradeDirtyFlags_;
 };
 } // namespace analytics
 } // namespace ore
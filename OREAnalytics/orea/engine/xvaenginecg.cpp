@@ -116,10 +116,11 @@ XvaEngineCG::XvaEngineCG(const Size nThreads, const Date& asof, const boost::sha
     LOG("XvaEngineCG: build cam model builder");
 
     // note: sim market has one config only, no in-ccy config to calibrate IR components
+    // note: the model is recalibrated for each sensitivity scenario, so we use the warm start calibration mode
     camBuilder_ = boost::make_shared<CrossAssetModelBuilder>(
         simMarket_, crossAssetModelData_, marketConfigurationInCcy_, marketConfiguration_, marketConfiguration_,
         marketConfiguration_, marketConfiguration_, marketConfiguration_, false, continueOnCalibrationError_,
-        std::string(), SalvagingAlgorithm::Spectral, "xva engine cg - cam builder");
+        std::string(), SalvagingAlgorithm::Spectral, "xva engine cg - cam builder", true);
 
     // Set up gaussian cam cg model
 
@@ -16,6 +16,7 @@
 #include <orea/aggregation/dynamiccreditxvacalculator.hpp>
 #include <orea/aggregation/exposureallocator.hpp>
 #include <orea/aggregation/exposurecalculator.hpp>
+#include <orea/aggregation/incrementalxvacalculator.hpp>
 #include <orea/aggregation/nettedexposurecalculator.hpp>
 #include <orea/aggregation/postprocess.hpp>
 #include <orea/aggregation/staticcreditxvacalculator.hpp>
@@ -55,6 +56,7 @@
 #include <orea/cube/sensicube.hpp>
 #include <orea/cube/sensitivitycube.hpp>
 #include <orea/cube/sparsenpvcube.hpp>
+#include <orea/cube/truncatednpvcube.hpp>
 #include <orea/engine/amcvaluationengine.hpp>
 #include <orea/engine/bufferedsensitivitystream.hpp>
 #include <orea/engine/cptycalculator.hpp>
@@ -241,6 +241,11 @@ void ScenarioSimMarket::writeSimData(std::map<RiskFactorKey, boost::shared_ptr<S
     absoluteSimDataTmp.clear();
 }
 
+void ScenarioSimMarket::addNestedLazy(const boost::shared_ptr<Observable>& ts) {
+    if (auto l = boost::dynamic_pointer_cast<LazyObject>(ts))
+        nestedLazies_.push_back(l);
+}
+
 void ScenarioSimMarket::addYieldCurve(const boost::shared_ptr<Market>& initMarket, const std::string& configuration,
                                       const RiskFactorKey::KeyType rf, const string& key, const vector<Period>& tenors,
                                       bool& simDataWritten, bool simulate, bool spreaded) {
@@ -804,6 +809,7 @@ ScenarioSimMarket::ScenarioSimMarket(
                                         // strike", i.e. it will not react to changes in the ATM level
                                         svp = Handle<SwaptionVolatilityStructure>(
                                             boost::make_shared<SwaptionVolatilityConstantSpread>(atm, wrapper));
+                                        addNestedLazy(*atm);
                                     }
                                 } else {
                                     if (isCube) {
@@ -815,6 +821,8 @@ ScenarioSimMarket::ScenarioSimMarket(
                                         tmp->setAdjustReferenceDate(false);
                                         svp = Handle<SwaptionVolatilityStructure>(
                                             boost::make_shared<SwaptionVolCubeWithATM>(tmp));
+                                        addNestedLazy(*atm);
+                                        addNestedLazy(tmp);
                                     } else {
                                         svp = atm;
                                     }
@@ -1075,6 +1083,7 @@ ScenarioSimMarket::ScenarioSimMarket(
                                 hCapletVol = Handle<OptionletVolatilityStructure>(
                                     boost::make_shared<QuantExt::StrippedOptionletAdapter<LinearFlat, LinearFlat>>(
                                         optionlet));
+                                addNestedLazy(optionlet);
                             }
                         } else {
                             string decayModeString = parameters->capFloorVolDecayMode();
@@ -1272,10 +1281,11 @@ ScenarioSimMarket::ScenarioSimMarket(
                                     wrapper, expiryDates, spreads, !stickyStrike, simTerms, simTermCurves));
                             } else {
                                 // TODO support strike and term dependence
+                                auto atmCurve = boost::make_shared<BlackVarianceCurve3>(
+                                    0, NullCalendar(), wrapper->businessDayConvention(), dc, times, quotes, false);
                                 cvh = Handle<CreditVolCurve>(boost::make_shared<CreditVolCurveWrapper>(
-                                    Handle<BlackVolTermStructure>(boost::make_shared<BlackVarianceCurve3>(
-                                        0, NullCalendar(), wrapper->businessDayConvention(), dc, times, quotes,
-                                        false))));
+                                    Handle<BlackVolTermStructure>(atmCurve)));
+                                addNestedLazy(atmCurve);
                             }
                         } else {
                             string decayModeString = parameters->cdsVolDecayMode();
@@ -1546,6 +1556,7 @@ ScenarioSimMarket::ScenarioSimMarket(
                                         LOG("Simulating FX Vols (FXVolatilityConstantSpread) for " << name);
                                         fxVolCurve = boost::make_shared<BlackVolatilityConstantSpread>(
                                             Handle<BlackVolTermStructure>(atmCurve), wrapper);
+                                        addNestedLazy(atmCurve);
                                     } else {
                                         fxVolCurve = atmCurve;
                                     }
@@ -1786,6 +1797,7 @@ ScenarioSimMarket::ScenarioSimMarket(
                                         LOG("Simulating EQ Vols (EquityVolatilityConstantSpread) for " << name);
                                         eqVolCurve = boost::make_shared<BlackVolatilityConstantSpread>(
                                             Handle<BlackVolTermStructure>(atmCurve), wrapper);
+                                        addNestedLazy(atmCurve);
                                     } else {
                                         eqVolCurve = atmCurve;
                                     }
@@ -2379,6 +2391,7 @@ ScenarioSimMarket::ScenarioSimMarket(
                                            << "' while building commodity basis curve '" << name << "'");
                             pts = Handle<PriceTermStructure>(boost::make_shared<CommodityBasisPriceCurveWrapper>(
                                 orgBasisCurve, baseIndex->second.currentLink(), priceCurve));
+                            addNestedLazy(priceCurve);
                         } 
 
                         pts->setAdjustReferenceDate(false);
@@ -2788,7 +2801,7 @@ void ScenarioSimMarket::applyScenario(const boost::shared_ptr<Scenario>& scenari
         for (auto const& key : diffToBaseKeys_) {
             auto it = simData_.find(key);
             if (it != simData_.end()) {
-                it->second->setValue(baseScenario_->get(key));
+                setSimDataValue(it->second, baseScenario_->get(key));
             }
         }
         diffToBaseKeys_.clear();
@@ -2801,7 +2814,7 @@ void ScenarioSimMarket::applyScenario(const boost::shared_ptr<Scenario>& scenari
                 missingPoint = true;
             } else {
                 if (filter_->allow(key)) {
-                    it->second->setValue(delta->get(key));
+                    setSimDataValue(it->second, delta->get(key));
                     diffToBaseKeys_.insert(key);
                 }
             }
@@ -2848,7 +2861,7 @@ void ScenarioSimMarket::applyScenario(const boost::shared_ptr<Scenario>& scenari
             Size i = 0;
             for (auto const& q : s->data()) {
                 if (cachedSimDataActive_[i])
-                    cachedSimData_[i]->setValue(q.second);
+                    setSimDataValue(cachedSimData_[i], q.second);
                 ++i;
             }
 
@@ -2872,7 +2885,7 @@ void ScenarioSimMarket::applyScenario(const boost::shared_ptr<Scenario>& scenari
             WLOG("simulation data point missing for key " << key);
         } else {
             if (filter_->allow(key)) {
-                it->second->setValue(scenario->get(key));
+                setSimDataValue(it->second, scenario->get(key));
             }
             count++;
         }
@@ -2888,19 +2901,112 @@ void ScenarioSimMarket::applyScenario(const boost::shared_ptr<Scenario>& scenari
     }
 }
 
+void ScenarioSimMarket::setSimDataValue(const boost::shared_ptr<SimpleQuote>& quote, const Real value) {
+    if (trackDirtyFlags_ && (!quote->isValid() || quote->value() != value)) {
+        auto f = quoteDirtyFlags_.find(quote.get());
+        if (f == quoteDirtyFlags_.end())
+            allDirty_ = true;
+        else
+            for (auto const k : f->second)
+                dirtyFlags_[k] = true;
+    }
+    quote->setValue(value);
+}
+
+void ScenarioSimMarket::initDirtyFlags() {
+    if (dirtyFlagsInitialised_)
+        return;
+
+    QL_REQUIRE(ObservableSettings::instance().updatesEnabled(),
+               "ScenarioSimMarket::initDirtyFlags(): updates must be enabled to detect dependencies");
+
+    // the tracked term structures are those refreshed in observation mode Disable
+
+    refresh();
+    dirtyFlagTermStructures_.assign(refreshTs_[Market::defaultConfiguration].begin(),
+                                    refreshTs_[Market::defaultConfiguration].end());
+    dirtyFlagObservables_.assign(dirtyFlagTermStructures_.begin(), dirtyFlagTermStructures_.end());
+    for (auto const& d : simData_)
+        dirtyFlagObservables_.push_back(d.second);
+    dirtyFlags_.assign(dirtyFlagObservables_.size(), true);
+
+    // notifications must be forwarded by the tracked and the nested term structures also if they are not calculated,
+    // so that they reach all dependent term structures and instruments when we probe the dependencies, this is
+    // switched back on the first scenario update, i.e. after the valuation engine has probed its dependencies, too
+
+    for (auto const& l : nestedLazies_)
+        l->alwaysForwardNotifications();
+    for (auto const& ts : dirtyFlagTermStructures_) {
+        if (auto l = boost::dynamic_pointer_cast<LazyObject>(ts))
+            l->alwaysForwardNotifications();
+    }
+    forwardAllNotifications_ = true;
+
+    std::vector<Size> notified;
+    std::vector<boost::shared_ptr<NotificationRecorder>> recorders;
+    for (Size i = 0; i < dirtyFlagTermStructures_.size(); ++i) {
+        recorders.push_back(boost::make_shared<NotificationRecorder>(notified, i));
+        recorders.back()->registerWith(dirtyFlagTermStructures_[i]);
+    }
+
+    Size i = dirtyFlagTermStructures_.size(), nDependencies = 0;
+    for (auto const& d : simData_) {
+        notified.clear();
+        d.second->notifyObservers();
+        std::vector<Size>& flags = quoteDirtyFlags_[d.second.get()];
+        flags.push_back(i++);
+        for (auto const k : notified) {
+            flags.push_back(k);
+            recorders[k]->reset();
+        }
+        nDependencies += flags.size() - 1;
+    }
+
+    dirtyFlagsInitialised_ = true;
+    LOG("ScenarioSimMarket: dirty flags initialised for " << dirtyFlagTermStructures_.size() << " term structures, "
+                                                          << nestedLazies_.size() << " nested term structures and "
+                                                          << simData_.size() << " sim data quotes, found "
+                                                          << nDependencies << " dependencies");
+}
+
+void ScenarioSimMarket::restoreNotificationForwarding() {
+    if (!forwardAllNotifications_)
+        return;
+    if (!LazyObject::Defaults::instance().forwardsAllNotifications()) {
+        for (auto const& l : nestedLazies_)
+            l->forwardFirstNotificationOnly();
+        for (auto const& ts : dirtyFlagTermStructures_) {
+            if (auto l = boost::dynamic_pointer_cast<LazyObject>(ts))
+                l->forwardFirstNotificationOnly();
+        }
+    }
+    forwardAllNotifications_ = false;
+}
+
 void ScenarioSimMarket::preUpdate() {
     ObservationMode::Mode om = ObservationMode::instance().mode();
     if (om == ObservationMode::Mode::Disable)
         ObservableSettings::instance().disableUpdates(false);
     else if (om == ObservationMode::Mode::Defer)
         ObservableSettings::instance().disableUpdates(true);
+    else if (om == ObservationMode::Mode::DirtyFlag) {
+        initDirtyFlags();
+        restoreNotificationForwarding();
+        ObservableSettings::instance().disableUpdates(false);
+        std::fill(dirtyFlags_.begin(), dirtyFlags_.end(), false);
+        allDirty_ = false;
+        trackDirtyFlags_ = true;
+    }
 }
 
 void ScenarioSimMarket::updateDate(const Date& d) {
     ObservationMode::Mode om = ObservationMode::instance().mode();
-    if (d != Settings::instance().evaluationDate())
+    if (d != Settings::instance().evaluationDate()) {
         Settings::instance().evaluationDate() = d;
-    else if (om == ObservationMode::Mode::Unregister) {
+        // all term structures and instruments might depend on the evaluation date
+        if (om == ObservationMode::Mode::DirtyFlag)
+            allDirty_ = true;
+    } else if (om == ObservationMode::Mode::Unregister) {
         // Due to some of the notification chains having been unregistered,
         // it is possible that some lazy objects might be missed in the case
         // that the evaluation date has not been updated. Therefore, we
@@ -2931,6 +3037,18 @@ void ScenarioSimMarket::postUpdate(const Date& d, bool withFixings) {
         ObservableSettings::instance().enableUpdates();
     } else if (om == ObservationMode::Mode::Defer) {
         ObservableSettings::instance().enableUpdates();
+    } else if (om == ObservationMode::Mode::DirtyFlag) {
+        trackDirtyFlags_ = false;
+        if (allDirty_) {
+            refresh();
+            std::fill(dirtyFlags_.begin(), dirtyFlags_.end(), true);
+        } else {
+            for (Size i = 0; i < dirtyFlagTermStructures_.size(); ++i) {
+                if (dirtyFlags_[i])
+                    dirtyFlagTermStructures_[i]->deepUpdate();
+            }
+        }
+        ObservableSettings::instance().enableUpdates();
     }
 
     // Apply fixings as historical fixings. Must do this before we populate ASD
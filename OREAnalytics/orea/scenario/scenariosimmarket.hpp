@@ -31,7 +31,10 @@
 #include <ored/configuration/curveconfigurations.hpp>
 #include <ored/configuration/iborfallbackconfig.hpp>
 
+#include <ql/patterns/lazyobject.hpp>
+
 #include <map>
+#include <unordered_map>
 
 namespace ore {
 namespace analytics {
@@ -134,12 +137,29 @@ public:
     //! is risk factor key simulated by this sim market instance?
     virtual bool isSimulated(const RiskFactorKey::KeyType& factor) const;
 
+    /*! The tracked observables are the term structures refreshed in ObservationMode::Mode::Disable followed by the
+        simulation data quotes. The dependencies of the term structures on the quotes are detected by notifying each
+        quote and recording the term structures reached. The tracked and the nested lazy term structures forward all
+        notifications until the first scenario update, so that the dependency probes of the valuation engine see
+        them as well. */
+    void initDirtyFlags() override;
+
 protected:
     void applyScenario(const boost::shared_ptr<Scenario>& scenario);
 
+    //! set a sim data quote, in ObservationMode::Mode::DirtyFlag the dependent observables are marked as dirty
+    void setSimDataValue(const boost::shared_ptr<SimpleQuote>& quote, const Real value);
+
     void writeSimData(std::map<RiskFactorKey, boost::shared_ptr<SimpleQuote>>& simDataTmp,
                       std::map<RiskFactorKey, Real>& absoluteSimDataTmp);
 
+    /*! register a lazy term structure built on simulation data quotes which is wrapped by another term structure, so
+        that it does not block the notifications when the dirty flag dependencies are probed */
+    void addNestedLazy(const boost::shared_ptr<Observable>& ts);
+
+    //! switch the term structures back to the default notification forwarding after the dependency probes
+    void restoreNotificationForwarding();
+
     void addYieldCurve(const boost::shared_ptr<Market>& initMarket, const std::string& configuration,
                        const RiskFactorKey::KeyType rf, const string& key, const vector<Period>& tenors,
                        bool& simDataWritten, bool simulate = true, bool spreaded = false);
@@ -183,6 +203,15 @@ protected:
     std::set<ore::analytics::RiskFactorKey> diffToBaseKeys_;
 
     mutable boost::shared_ptr<Scenario> currentScenario_;
+
+    // for ObservationMode::Mode::DirtyFlag
+    bool dirtyFlagsInitialised_ = false;
+    bool trackDirtyFlags_ = false;
+    bool allDirty_ = false;
+    std::vector<boost::shared_ptr<TermStructure>> dirtyFlagTermStructures_;
+    std::vector<boost::shared_ptr<LazyObject>> nestedLazies_;
+    bool forwardAllNotifications_ = false;
+    std::unordered_map<const SimpleQuote*, std::vector<Size>> quoteDirtyFlags_;
 };
 } // namespace analytics
 } // namespace ore
@@ -39,6 +39,8 @@
 #include <ql/experimental/coupons/cmsspreadcoupon.hpp>
 #include <ql/experimental/coupons/digitalcmsspreadcoupon.hpp>
 
+#include <algorithm>
+
 using namespace std;
 using namespace QuantLib;
 using namespace QuantExt;
@@ -66,6 +68,7 @@ void FixingManager::initialise(const boost::shared_ptr<Portfolio>& portfolio, co
                                const std::string& configuration) {
 
     // populate the map "Index -> set of required fixing dates", where the index on the LHS is linked to curves
+    FixingMap fixingMap;
     for (auto const& [tradeId,t] : portfolio->trades()) {
         auto r = t->requiredFixings();
         r.unsetPayDates();
@@ -78,8 +81,8 @@ void FixingManager::initialise(const boost::shared_ptr<Portfolio>& portfolio, co
                 auto rawIndex = parseIndex(name);
                 if (auto index = boost::dynamic_pointer_cast<EquityIndex2>(rawIndex)) {
                     
-                    fixingMap_[*market->equityCurve(index->familyName(), configuration)].insert(dates.begin(),
-                                                                                                dates.end());
+                    fixingMap[*market->equityCurve(index->familyName(), configuration)].insert(dates.begin(),
+                                                                                               dates.end());
                 } else if (auto index = boost::dynamic_pointer_cast<BondIndex>(rawIndex)) {
                     QL_FAIL("BondIndex not handled");
                 } else if (auto index = boost::dynamic_pointer_cast<CommodityIndex>(rawIndex)) {
@@ -88,21 +91,21 @@ void FixingManager::initialise(const boost::shared_ptr<Portfolio>& portfolio, co
                     if (safeExpiryDate != Date() && !index->keepDays()) {
                         safeExpiryDate = Date::endOfMonth(safeExpiryDate);
                     }
-                    fixingMap_[index->clone(safeExpiryDate,
-                                            market->commodityPriceCurve(index->underlyingName(), configuration))]
+                    fixingMap[index->clone(safeExpiryDate,
+                                           market->commodityPriceCurve(index->underlyingName(), configuration))]
                         .insert(dates.begin(), dates.end());
                 } else if (auto index = boost::dynamic_pointer_cast<FxIndex>(rawIndex)) {
-                    fixingMap_[*market->fxIndex(index->oreName(), configuration)].insert(dates.begin(), dates.end());
+                    fixingMap[*market->fxIndex(index->oreName(), configuration)].insert(dates.begin(), dates.end());
                 } else if (auto index = boost::dynamic_pointer_cast<GenericIndex>(rawIndex)) {
                     QL_FAIL("GenericIndex not handled");
                 } else if (auto index = boost::dynamic_pointer_cast<ConstantMaturityBondIndex>(rawIndex)) {
                     QL_FAIL("ConstantMaturityBondIndex not handled");
                 } else if (auto index = boost::dynamic_pointer_cast<IborIndex>(rawIndex)) {
-                    fixingMap_[*market->iborIndex(name, configuration)].insert(dates.begin(), dates.end());
+                    fixingMap[*market->iborIndex(name, configuration)].insert(dates.begin(), dates.end());
                 } else if (auto index = boost::dynamic_pointer_cast<SwapIndex>(rawIndex)) {
-                    fixingMap_[*market->swapIndex(name, configuration)].insert(dates.begin(), dates.end());
+                    fixingMap[*market->swapIndex(name, configuration)].insert(dates.begin(), dates.end());
                 } else if (auto index = boost::dynamic_pointer_cast<ZeroInflationIndex>(rawIndex)) {
-                    fixingMap_[*market->zeroInflationIndex(name, configuration)].insert(dates.begin(), dates.end());
+                    fixingMap[*market->zeroInflationIndex(name, configuration)].insert(dates.begin(), dates.end());
                 }
             } catch (const std::exception& e) {
                 ALOG("FixingManager: error " << e.what() << " - no fixings are added for '" << name << "'");
@@ -111,15 +114,33 @@ void FixingManager::initialise(const boost::shared_ptr<Portfolio>& portfolio, co
         }
     }
 
-    // Now cache the original fixings so we can re-write on reset()
-    for (auto const& m : fixingMap_) {
-        fixingCache_[m.first] = IndexManager::instance().getHistory(m.first->name());
+    // Flatten the map into sorted arrays of valid fixing dates per index, the fixing dates include the valuation grid
+    // dates which might not be valid fixing dates (BMA/SIFMA), and cache the original fixings so we can re-write them
+    // on reset()
+    fixings_.clear();
+    fixings_.reserve(fixingMap.size());
+    for (auto const& [index, dates] : fixingMap) {
+        IndexFixings f;
+        f.index = index;
+        f.zeroInflationIndex = boost::dynamic_pointer_cast<ZeroInflationIndex>(index);
+        f.yoyInflationIndex = boost::dynamic_pointer_cast<YoYInflationIndex>(index);
+        f.commodityIndex = boost::dynamic_pointer_cast<QuantExt::CommodityIndex>(index);
+        f.dates.reserve(dates.size());
+        for (auto const& d : dates) {
+            if (index->isValidFixingDate(d))
+                f.dates.push_back(d);
+        }
+        if (f.dates.empty())
+            continue;
+        f.values.reserve(f.dates.size());
+        f.history = IndexManager::instance().getHistory(index->name());
+        fixings_.push_back(std::move(f));
     }
 }
 
 //! Update fixings to date d
 void FixingManager::update(Date d) {
-    if (!fixingMap_.empty()) {
+    if (!fixings_.empty()) {
         QL_REQUIRE(d >= fixingsEnd_, "Can't go back in time, fixings must be reset."
                                      " Update date "
                                          << d << " but current fixings go to " << fixingsEnd_);
@@ -132,8 +153,12 @@ void FixingManager::update(Date d) {
 //! Reset fixings to t0 (today)
 void FixingManager::reset() {
     if (modifiedFixingHistory_) {
-        for (auto& kv : fixingCache_)
-            IndexManager::instance().setHistory(kv.first->name(), kv.second);
+        for (auto& f : fixings_) {
+            if (f.modified) {
+                IndexManager::instance().setHistory(f.index->name(), f.history);
+                f.modified = false;
+            }
+        }
         modifiedFixingHistory_ = false;
     }
     fixingsEnd_ = today_;
@@ -141,18 +166,18 @@ void FixingManager::reset() {
 
 void FixingManager::applyFixings(Date start, Date end) {
     // Loop over all indices
-    for (auto const& m : fixingMap_) {
+    for (auto& f : fixings_) {
         Date fixStart = start;
         Date fixEnd = end;
         Date currentFixingDate;
-        if (auto zii = boost::dynamic_pointer_cast<ZeroInflationIndex>(m.first)) {
+        if (auto const& zii = f.zeroInflationIndex) {
             fixStart =
                 inflationPeriod(fixStart - zii->zeroInflationTermStructure()->observationLag(), zii->frequency()).first;
             fixEnd =
                 inflationPeriod(fixEnd - zii->zeroInflationTermStructure()->observationLag(), zii->frequency()).first +
                 1;
             currentFixingDate = fixEnd;
-        } else if (auto yii = boost::dynamic_pointer_cast<YoYInflationIndex>(m.first)) {
+        } else if (auto const& yii = f.yoyInflationIndex) {
             fixStart =
                 inflationPeriod(fixStart - yii->yoyInflationTermStructure()->observationLag(), yii->frequency()).first;
             fixEnd =
@@ -160,45 +185,30 @@ void FixingManager::applyFixings(Date start, Date end) {
                 1;
             currentFixingDate = fixEnd;
         } else {
-            currentFixingDate = m.first->fixingCalendar().adjust(fixEnd, Following);
+            currentFixingDate = f.index->fixingCalendar().adjust(fixEnd, Following);
             // This date is a business day but may not be a valid fixing date in case of BMA/SIFMA
-            if (!m.first->isValidFixingDate(currentFixingDate))
-                currentFixingDate = nextValidFixingDate(currentFixingDate, m.first);
+            if (!f.index->isValidFixingDate(currentFixingDate))
+                currentFixingDate = nextValidFixingDate(currentFixingDate, f.index);
         }
 
-        // Add we have a coupon between start and asof.
-        bool needFixings = false;
-        for (auto const& d : m.second) {
-            if (d >= fixStart && d < fixEnd) {
-                needFixings = true;
-                break;
-            }
-        }
+        // Find the required fixing dates in [fixStart, fixEnd)
+        auto first = std::lower_bound(f.dates.begin(), f.dates.end(), fixStart);
+        auto last = std::lower_bound(first, f.dates.end(), fixEnd);
+        if (first == last)
+            continue;
 
-        if (needFixings) {
-            Rate currentFixing;
-            if (auto comm = boost::dynamic_pointer_cast<QuantExt::CommodityIndex>(m.first);
-                comm != nullptr && comm->expiryDate() < currentFixingDate) {
-                currentFixing = comm->priceCurve()->price(currentFixingDate);
-            } else {
-                currentFixing = m.first->fixing(currentFixingDate);
-            }
-            // if we read the fixing from an inverted FxIndex we have to undo the inversion
-            TimeSeries<Real> history;
-            for (auto const& d : m.second) {
-                if (d >= fixStart && d < fixEnd) {
-                    // Fixing dates include the valuation grid dates which might not be valid fixing dates (BMA/SIFMA)
-                    bool valid = m.first->isValidFixingDate(d);
-                    if (valid) {
-                        history[d] = currentFixing;
-                        modifiedFixingHistory_ = true;
-                    }
-                }
-                if (d >= fixEnd)
-                    break;
-            }
-            m.first->addFixings(history, true);
+        Rate currentFixing;
+        if (f.commodityIndex != nullptr && f.commodityIndex->expiryDate() < currentFixingDate) {
+            currentFixing = f.commodityIndex->priceCurve()->price(currentFixingDate);
+        } else {
+            currentFixing = f.index->fixing(currentFixingDate);
         }
+
+        // bulk update of the fixings history
+        f.values.assign(std::distance(first, last), currentFixing);
+        f.index->addFixings(first, last, f.values.begin(), true);
+        f.modified = true;
+        modifiedFixingHistory_ = true;
     }
 }
 
@@ -25,6 +25,10 @@
 #include <ored/marketdata/market.hpp>
 #include <ored/portfolio/portfolio.hpp>
 
+#include <qle/indexes/commodityindex.hpp>
+
+#include <ql/indexes/inflationindex.hpp>
+
 namespace ore {
 namespace analytics {
 using namespace QuantLib;
@@ -52,6 +56,10 @@ struct IndexComparator {
   When stepping between simulation dated t_(n-1) and t_(n) and update a fixing t with t_(n-1) < t < t(n) than the fixing
   from t(n) will be backfilled. There is currently no interpolation of fixings.
 
+  The required fixing dates are held in a flat sorted array per index, so that the fixings for a simulation step are
+  located by a binary search and written to the IndexManager in one bulk update per index. On reset() only the
+  histories of indices that received simulated fixings are restored.
+
   \ingroup simulation
  */
 class FixingManager {
@@ -79,10 +87,24 @@ private:
     Date today_, fixingsEnd_;
     bool modifiedFixingHistory_;
 
-    using FixingCache = std::map<boost::shared_ptr<Index>, TimeSeries<Real>, detail::IndexComparator>;
-
-    FixingMap fixingMap_;
-    FixingCache fixingCache_;
+    //! required fixing dates of an index and its historical fixings before the simulation
+    struct IndexFixings {
+        boost::shared_ptr<Index> index;
+        // the index cast to the types that need special treatment, null if not applicable
+        boost::shared_ptr<ZeroInflationIndex> zeroInflationIndex;
+        boost::shared_ptr<YoYInflationIndex> yoyInflationIndex;
+        boost::shared_ptr<QuantExt::CommodityIndex> commodityIndex;
+        // valid required fixing dates, sorted
+        std::vector<Date> dates;
+        // buffer for the simulated fixings of a step
+        std::vector<Real> values;
+        // the historical fixings to restore on reset()
+        TimeSeries<Real> history;
+        // true if simulated fixings were written since the last reset()
+        bool modified = false;
+    };
+
+    std::vector<IndexFixings> fixings_;
 };
 
 } // namespace analytics
@@ -81,9 +81,23 @@ public:
     //! Get the fixing manager
     virtual const boost::shared_ptr<FixingManager>& fixingManager() const = 0;
 
+    /*! Set up the observables tracked in ObservationMode::Mode::DirtyFlag and their dependencies, this is done
+        once, subsequent calls have no effect */
+    virtual void initDirtyFlags() {}
+
+    //! Observables tracked in ObservationMode::Mode::DirtyFlag
+    const std::vector<boost::shared_ptr<QuantLib::Observable>>& dirtyFlagObservables() const {
+        return dirtyFlagObservables_;
+    }
+
+    //! Flags marking the tracked observables that were updated in the last update
+    const std::vector<bool>& dirtyFlags() const { return dirtyFlags_; }
+
 protected:
     Real numeraire_;
     std::string label_;
+    std::vector<boost::shared_ptr<QuantLib::Observable>> dirtyFlagObservables_;
+    std::vector<bool> dirtyFlags_;
 };
 } // namespace analytics
 } // namespace ore
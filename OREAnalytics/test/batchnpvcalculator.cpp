@@ -0,0 +1,171 @@
+/*
+ Copyright (C) 2023 Quaternion Risk Management Ltd
+ All rights reserved.
+
+ This file is part of ORE, a free-software/open-source library
+ for transparent pricing and risk analysis - http://opensourcerisk.org
+
+ ORE is free software: you can redistribute it and/or modify it
+ under the terms of the Modified BSD License.  You should have received a
+ copy of the license along with this program.
+ The license is also available online at <http://opensourcerisk.org>
+
+ This program is distributed on the basis that it will form a useful
+ contribution to risk analytics and model standardisation, but WITHOUT
+ ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ FITNESS FOR A PARTICULAR PURPOSE. See the license for more details.
+*/
+
+#include "testmarket.hpp"
+#include <boost/test/unit_test.hpp>
+#include <orea/cube/inmemorycube.hpp>
+#include <orea/engine/observationmode.hpp>
+#include <orea/engine/valuationcalculator.hpp>
+#include <orea/engine/valuationengine.hpp>
+#include <orea/scenario/crossassetmodelscenariogenerator.hpp>
+#include <orea/scenario/scenariosimmarket.hpp>
+#include <orea/scenario/scenariosimmarketparameters.hpp>
+#include <orea/scenario/simplescenariofactory.hpp>
+#include <ored/model/crossassetmodelbuilder.hpp>
+#include <ored/model/irlgmdata.hpp>
+#include <ored/portfolio/portfolio.hpp>
+#include <ored/portfolio/swap.hpp>
+#include <ql/time/calendars/target.hpp>
+#include <qle/methods/multipathgeneratorbase.hpp>
+#include <test/oreatoplevelfixture.hpp>
+
+using namespace std;
+using namespace QuantLib;
+using namespace QuantExt;
+using namespace boost::unit_test_framework;
+using namespace ore;
+using namespace ore::data;
+using namespace ore::analytics;
+
+using testsuite::TestMarket;
+
+namespace {
+
+boost::shared_ptr<Trade> buildSwap(const string& id, const string& ccy, const string& index, const string& floatFreq,
+                                   Real fixedRate, Size term, bool isPayer, const Date& startDate) {
+    Calendar cal = TARGET();
+    ostringstream start, end;
+    start << io::iso_date(cal.adjust(startDate));
+    end << io::iso_date(cal.adjust(startDate + term * Years));
+    ScheduleData floatSchedule(ScheduleRules(start.str(), end.str(), floatFreq, "TARGET", "MF", "MF", "Forward"));
+    ScheduleData fixedSchedule(ScheduleRules(start.str(), end.str(), "1Y", "TARGET", "MF", "MF", "Forward"));
+    vector<double> notional(1, 1000000), spread(1, 0.0);
+    LegData fixedLeg(boost::make_shared<FixedLegData>(vector<double>(1, fixedRate)), isPayer, ccy, fixedSchedule,
+                     "30/360", notional);
+    LegData floatingLeg(boost::make_shared<FloatingLegData>(index, 2, false, spread), !isPayer, ccy, floatSchedule,
+                        "ACT/360", notional);
+    boost::shared_ptr<Trade> swap = boost::make_shared<data::Swap>(Envelope("CP"), floatingLeg, fixedLeg);
+    swap->id() = id;
+    return swap;
+}
+
+// builds a cube of depth 2 holding the batch npvs at depth 0 and the single trade npvs at depth 1
+boost::shared_ptr<NPVCube> simulation() {
+    Date today(14, April, 2016);
+    Settings::instance().evaluationDate() = today;
+    testsuite::TestConfigurationObjects::setConventions();
+
+    boost::shared_ptr<DateGrid> dg = boost::make_shared<DateGrid>("10,6M");
+    Size samples = 20;
+
+    boost::shared_ptr<Market> initMarket = boost::make_shared<TestMarket>(today);
+
+    auto parameters = boost::make_shared<ScenarioSimMarketParameters>();
+    parameters->baseCcy() = "EUR";
+    parameters->setDiscountCurveNames({"EUR", "USD"});
+    parameters->setYieldCurveTenors("",
+                                    {1 * Months, 6 * Months, 1 * Years, 2 * Years, 5 * Years, 10 * Years, 20 * Years});
+    parameters->setIndices({"EUR-EURIBOR-6M", "EUR-EONIA", "USD-LIBOR-3M"});
+    parameters->interpolation() = "LogLinear";
+    parameters->setFxCcyPairs({"USDEUR"});
+
+    CalibrationType calibrationType = CalibrationType::Bootstrap;
+    vector<string> swaptionExpiries = {"1Y", "2Y", "3Y", "5Y", "7Y", "10Y"};
+    vector<string> swaptionTerms(swaptionExpiries.size(), "5Y");
+    vector<string> swaptionStrikes(swaptionExpiries.size(), "ATM");
+    std::vector<boost::shared_ptr<IrModelData>> irConfigs;
+    irConfigs.push_back(boost::make_shared<IrLgmData>(
+        "EUR", calibrationType, LgmData::ReversionType::HullWhite, LgmData::VolatilityType::Hagan, false,
+        ParamType::Constant, vector<Time>(), vector<Real>{0.02}, true, ParamType::Piecewise, vector<Time>(),
+        vector<Real>{0.008}, 0.0, 1.0, swaptionExpiries, swaptionTerms, swaptionStrikes));
+    irConfigs.push_back(boost::make_shared<IrLgmData>(
+        "USD", calibrationType, LgmData::ReversionType::HullWhite, LgmData::VolatilityType::Hagan, false,
+        ParamType::Constant, vector<Time>(), vector<Real>{0.03}, true, ParamType::Piecewise, vector<Time>(),
+        vector<Real>{0.009}, 0.0, 1.0, swaptionExpiries, swaptionTerms, swaptionStrikes));
+    vector<string> optionExpiries = {"1Y", "2Y", "3Y", "5Y", "7Y", "10Y"};
+    vector<string> optionStrikes(optionExpiries.size(), "ATMF");
+    std::vector<boost::shared_ptr<FxBsData>> fxConfigs;
+    fxConfigs.push_back(boost::make_shared<FxBsData>("USD", "EUR", calibrationType, true, ParamType::Piecewise,
+                                                     vector<Time>(), vector<Real>{0.15}, optionExpiries,
+                                                     optionStrikes));
+    map<CorrelationKey, Handle<Quote>> corr;
+    CorrelationFactor f_1{CrossAssetModel::AssetType::IR, "EUR", 0};
+    CorrelationFactor f_2{CrossAssetModel::AssetType::IR, "USD", 0};
+    corr[make_pair(f_1, f_2)] = Handle<Quote>(boost::make_shared<SimpleQuote>(0.6));
+    auto config = boost::make_shared<CrossAssetModelData>(irConfigs, fxConfigs, corr);
+    boost::shared_ptr<CrossAssetModel> model = *CrossAssetModelBuilder(initMarket, config).model();
+
+    if (auto tmp = boost::dynamic_pointer_cast<CrossAssetStateProcess>(model->stateProcess()))
+        tmp->resetCache(dg->timeGrid().size() - 1);
+    auto pathGen = boost::make_shared<MultiPathGeneratorMersenneTwister>(model->stateProcess(), dg->timeGrid(), 42);
+
+    auto simMarket = boost::make_shared<ScenarioSimMarket>(initMarket, parameters);
+    simMarket->scenarioGenerator() = boost::make_shared<CrossAssetModelScenarioGenerator>(
+        model, pathGen, boost::make_shared<SimpleScenarioFactory>(), parameters, today, dg, initMarket);
+
+    // the batch pricing replicates the optimised swap engine only
+    auto data = boost::make_shared<EngineData>();
+    data->model("Swap") = "DiscountedCashflows";
+    data->engine("Swap") = "DiscountingSwapEngineOptimised";
+    auto factory = boost::make_shared<EngineFactory>(data, simMarket);
+
+    // several swaps per currency including an ois swap, so that the later trades in a batch have lazy coupons
+    auto portfolio = boost::make_shared<Portfolio>();
+    portfolio->add(buildSwap("EUR_1", "EUR", "EUR-EURIBOR-6M", "6M", 0.02, 10, true, today + 1 * Months));
+    portfolio->add(buildSwap("EUR_2", "EUR", "EUR-EURIBOR-6M", "6M", 0.015, 5, false, today + 1 * Years));
+    portfolio->add(buildSwap("EUR_3", "EUR", "EUR-EONIA", "1Y", 0.01, 7, true, today + 1 * Months));
+    portfolio->add(buildSwap("USD_1", "USD", "USD-LIBOR-3M", "3M", 0.03, 10, false, today + 1 * Months));
+    portfolio->add(buildSwap("USD_2", "USD", "USD-LIBOR-3M", "3M", 0.025, 3, true, today + 6 * Months));
+    portfolio->build(factory);
+
+    auto cube = boost::make_shared<DoublePrecisionInMemoryCubeN>(today, portfolio->ids(), dg->dates(), samples, 2);
+    vector<boost::shared_ptr<ValuationCalculator>> calculators;
+    calculators.push_back(boost::make_shared<BatchNPVCalculator>("EUR", 0));
+    calculators.push_back(boost::make_shared<NPVCalculator>("EUR", 1));
+    ValuationEngine(today, dg, simMarket).buildCube(portfolio, cube, calculators);
+    return cube;
+}
+
+} // namespace
+
+BOOST_FIXTURE_TEST_SUITE(OREAnalyticsTestSuite, ore::test::OreaTopLevelFixture)
+
+BOOST_AUTO_TEST_SUITE(BatchNPVCalculatorTest)
+
+BOOST_AUTO_TEST_CASE(testBatchNpvsAgainstSingleTradeNpvs) {
+
+    BOOST_TEST_MESSAGE("Testing BatchNPVCalculator against NPVCalculator in the valuation engine...");
+
+    for (auto const mode : {ObservationMode::Mode::None, ObservationMode::Mode::Disable,
+                            ObservationMode::Mode::Unregister, ObservationMode::Mode::DirtyFlag}) {
+        ObservationMode::instance().setMode(mode);
+        BOOST_TEST_MESSAGE("Observation mode " << static_cast<int>(mode));
+        boost::shared_ptr<NPVCube> cube = simulation();
+        for (Size i = 0; i < cube->numIds(); ++i) {
+            BOOST_CHECK_CLOSE(cube->getT0(i, 0), cube->getT0(i, 1), 1e-8);
+            for (Size d = 0; d < cube->numDates(); ++d) {
+                for (Size s = 0; s < cube->samples(); ++s)
+                    BOOST_CHECK_CLOSE(cube->get(i, d, s, 0), cube->get(i, d, s, 1), 1e-8);
+            }
+        }
+    }
+}
+
+BOOST_AUTO_TEST_SUITE_END()
+
+BOOST_AUTO_TEST_SUITE_END()
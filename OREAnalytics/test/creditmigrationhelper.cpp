@@ -0,0 +1,155 @@
+/*
+ Copyright (C) 2023 Quaternion Risk Management Ltd
+ All rights reserved.
+
+ This file is part of ORE, a free-software/open-source library
+ for transparent pricing and risk analysis - http://opensourcerisk.org
+
+ ORE is free software: you can redistribute it and/or modify it
+ under the terms of the Modified BSD License.  You should have received a
+ copy of the license along with this program.
+ The license is also available online at <http://opensourcerisk.org>
+
+ This program is distributed on the basis that it will form a useful
+ contribution to risk analytics and model standardisation, but WITHOUT
+ ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ FITNESS FOR A PARTICULAR PURPOSE. See the license for more details.
+*/
+
+#include <boost/test/unit_test.hpp>
+#include <orea/aggregation/creditmigrationhelper.hpp>
+#include <orea/aggregation/creditsimulationparameters.hpp>
+#include <orea/cube/inmemorycube.hpp>
+#include <orea/scenario/aggregationscenariodata.hpp>
+#include <ored/portfolio/trade.hpp>
+#include <oret/toplevelfixture.hpp>
+#include <test/oreatoplevelfixture.hpp>
+
+#include <ql/math/distributions/normaldistribution.hpp>
+#include <ql/math/randomnumbers/mt19937uniformrng.hpp>
+
+#include <numeric>
+
+using namespace std;
+using namespace QuantLib;
+using namespace boost::unit_test_framework;
+using namespace ore;
+using namespace ore::data;
+using namespace ore::analytics;
+
+namespace {
+
+// trade stub, the credit migration helper only uses the envelope and the issuer
+class TestTrade : public Trade {
+public:
+    TestTrade(const string& id, const Envelope& env) : Trade("Swap", env) { id_ = id; }
+    void build(const boost::shared_ptr<EngineFactory>&) override {}
+};
+
+// two counterparties with one netting set each, random trade npvs and global credit factor paths
+struct TestData {
+    TestData() : asof(5, Feb, 2016) {
+        Settings::instance().evaluationDate() = asof;
+        for (Size i = 1; i <= 4; ++i)
+            dates.push_back(asof + 6 * i * Months);
+
+        parameters = boost::make_shared<CreditSimulationParameters>();
+        Real m[] = {0.90, 0.08, 0.02, 0.10, 0.85, 0.05, 0.00, 0.00, 1.00};
+        parameters->transitionMatrix()["Matrix"] = Matrix(3, 3, m, m + 9);
+        parameters->entities() = {"CPTY_A", "CPTY_B"};
+        parameters->factorLoadings() = {Array(1, 0.5), Array(1, 0.3)};
+        parameters->transitionMatrices() = {"Matrix", "Matrix"};
+        parameters->initialStates() = {0, 1};
+        parameters->marketRisk() = true;
+        parameters->creditRisk() = true;
+        parameters->zeroMarketPnl() = false;
+        parameters->doubleDefault() = false;
+        parameters->seed() = 42;
+        parameters->paths() = 100;
+        parameters->creditMode() = "Default";
+        parameters->loanExposureMode() = "Value";
+        parameters->nettingSetIds() = {"NS_A", "NS_B"};
+
+        trades["T_A"] = boost::make_shared<TestTrade>("T_A", Envelope("CPTY_A", "NS_A"));
+        trades["T_B"] = boost::make_shared<TestTrade>("T_B", Envelope("CPTY_B", "NS_B"));
+
+        cube = boost::make_shared<DoublePrecisionInMemoryCubeN>(asof, set<string>{"T_A", "T_B"}, dates, samples, 1);
+        nettedCube = boost::make_shared<DoublePrecisionInMemoryCubeN>(asof, set<string>{"NS_A", "NS_B"}, dates,
+                                                                      samples, 1);
+        aggData = boost::make_shared<InMemoryAggregationScenarioData>(dates.size(), samples);
+
+        MersenneTwisterUniformRng rng(17);
+        InverseCumulativeNormal icn;
+        for (auto const& [id, index] : cube->idsAndIndexes()) {
+            Real notional = 1.0E6 * (1.0 + index);
+            cube->setT0(0.0, index);
+            for (Size k = 0; k < samples; ++k) {
+                Real x = 0.0;
+                for (Size j = 0; j < dates.size(); ++j) {
+                    x += 0.1 * std::sqrt(0.5) * icn(rng.nextReal());
+                    cube->set(notional * x, index, j, k);
+                    nettedCube->set(notional * x, index, j, k);
+                }
+            }
+        }
+        for (Size k = 0; k < samples; ++k) {
+            Real x = 0.0;
+            for (Size j = 0; j < dates.size(); ++j) {
+                x += std::sqrt(0.5) * icn(rng.nextReal());
+                aggData->set(j, k, x, AggregationScenarioDataType::CreditState, "0");
+            }
+        }
+    }
+
+    Array pnlDistribution(const string& evaluation, const Size threads, const Size date) {
+        parameters->evaluation() = evaluation;
+        parameters->threads() = threads;
+        CreditMigrationHelper helper(parameters, cube, nettedCube, aggData, Null<Size>(), Null<Size>(), -5.0E6,
+                                     5.0E6, 50, Matrix(1, 1, 1.0), "EUR");
+        helper.build(trades);
+        return helper.pnlDistribution(date);
+    }
+
+    Date asof;
+    Size samples = 200;
+    vector<Date> dates;
+    boost::shared_ptr<CreditSimulationParameters> parameters;
+    map<string, boost::shared_ptr<Trade>> trades;
+    boost::shared_ptr<NPVCube> cube, nettedCube;
+    boost::shared_ptr<AggregationScenarioData> aggData;
+};
+
+} // namespace
+
+BOOST_FIXTURE_TEST_SUITE(OREAnalyticsTestSuite, ore::test::OreaTopLevelFixture)
+
+BOOST_AUTO_TEST_SUITE(CreditMigrationHelperTest)
+
+BOOST_AUTO_TEST_CASE(testPnlDistributionThreads) {
+
+    BOOST_TEST_MESSAGE("Testing credit migration pnl distribution with one and several threads...");
+
+    TestData data;
+
+    for (auto const& evaluation : {"TerminalSimulation", "Analytic"}) {
+        for (Size date : {1, 3}) {
+            Array dist1 = data.pnlDistribution(evaluation, 1, date);
+            Real sum = std::accumulate(dist1.begin(), dist1.end(), 0.0);
+            BOOST_CHECK_CLOSE(sum, 1.0, 1.0E-8);
+            for (Size threads : {2, 3, 8}) {
+                Array distN = data.pnlDistribution(evaluation, threads, date);
+                BOOST_REQUIRE_EQUAL(dist1.size(), distN.size());
+                // the per thread distributions are summed in a different order, so we allow for rounding differences
+                for (Size b = 0; b < dist1.size(); ++b) {
+                    BOOST_CHECK_MESSAGE(std::abs(dist1[b] - distN[b]) < 1.0E-14,
+                                        evaluation << " date " << date << " threads " << threads << " bucket " << b
+                                                   << ": " << dist1[b] << " vs " << distN[b]);
+                }
+            }
+        }
+    }
+}
+
+BOOST_AUTO_TEST_SUITE_END()
+
+BOOST_AUTO_TEST_SUITE_END()
@@ -22,6 +22,7 @@
 #include <orea/cube/cube_io.hpp>
 #include <orea/cube/npvcube.hpp>
 #include <orea/cube/jaggedcube.hpp>
+#include <orea/cube/truncatednpvcube.hpp>
 #include <orea/engine/filteredsensitivitystream.hpp>
 #include <orea/engine/observationmode.hpp>
 #include <orea/engine/parametricvar.hpp>
@@ -537,6 +538,57 @@ BOOST_AUTO_TEST_CASE(testDoublePrecisionJaggedCube) {
     IndexManager::instance().clearHistories();
 }
 
+BOOST_AUTO_TEST_CASE(testTruncatedNpvCube) {
+    BOOST_TEST_MESSAGE("Testing TruncatedNpvCube");
+
+    Date asof(1, Jan, 2023);
+    vector<Date> dates;
+    for (Size j = 1; j <= 20; ++j)
+        dates.push_back(asof + j * Months);
+    Size samples = 50;
+    Size depth = 2;
+
+    // without maturities the cube stores all dates and behaves like an in memory cube
+    std::set<string> ids{"id1", "id2", "id3"};
+    DoublePrecisionTruncatedNpvCube full(asof, ids, dates, samples, depth, {});
+    testCube(full, "DoublePrecisionTruncatedNpvCube", 1e-14);
+    for (Size i = 0; i < full.numIds(); ++i)
+        BOOST_CHECK_EQUAL(full.liveDates(i), dates.size());
+
+    // id1 matures between dates[4] and dates[5], id2 has a null maturity, id3 matures after the last date
+    std::map<string, Date> maturities{{"id1", dates[4] + 10}, {"id2", Date()}, {"id3", dates.back() + 100}};
+    DoublePrecisionTruncatedNpvCube cube(asof, ids, dates, samples, depth, maturities);
+    BOOST_CHECK_EQUAL(cube.liveDates(0), 6);
+    BOOST_CHECK_EQUAL(cube.liveDates(1), dates.size());
+    BOOST_CHECK_EQUAL(cube.liveDates(2), dates.size());
+    BOOST_CHECK_EQUAL(cube.storedValues(), (6 + 2 * dates.size()) * samples * depth);
+
+    // values beyond the maturity are zero, setting zeros there does not allocate storage
+    cube.set(1.0, 0, 5, 0, 1);
+    BOOST_CHECK_CLOSE(cube.get(0, 5, 0, 1), 1.0, 1e-14);
+    for (Size j = 6; j < dates.size(); ++j) {
+        BOOST_CHECK_EQUAL(cube.get(0, j, 3, 1), 0.0);
+        cube.set(0.0, 0, j, 3, 1);
+    }
+    BOOST_CHECK_EQUAL(cube.liveDates(0), 6);
+
+    // setting a non-zero value beyond the maturity extends the stored range and keeps existing values
+    cube.set(2.0, 0, 10, 7, 0);
+    BOOST_CHECK_EQUAL(cube.liveDates(0), 11);
+    BOOST_CHECK_CLOSE(cube.get(0, 5, 0, 1), 1.0, 1e-14);
+    BOOST_CHECK_CLOSE(cube.get(0, 10, 7, 0), 2.0, 1e-14);
+    BOOST_CHECK_EQUAL(cube.get(0, 9, 7, 0), 0.0);
+
+    // out of bounds access still throws
+    BOOST_CHECK_THROW(cube.get(0, dates.size(), 0), std::exception);
+    BOOST_CHECK_THROW(cube.set(1.0, 0, 0, samples), std::exception);
+
+    // removing an id clears its values
+    cube.remove(0);
+    BOOST_CHECK_EQUAL(cube.get(0, 5, 0, 1), 0.0);
+    BOOST_CHECK_EQUAL(cube.get(0, 10, 7, 0), 0.0);
+}
+
 BOOST_AUTO_TEST_SUITE_END()
 
 BOOST_AUTO_TEST_SUITE_END()
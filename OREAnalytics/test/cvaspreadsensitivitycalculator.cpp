@@ -0,0 +1,122 @@
+/*
+ Copyright (C) 2023 Quaternion Risk Management Ltd
+ All rights reserved.
+
+ This file is part of ORE, a free-software/open-source library
+ for transparent pricing and risk analysis - http://opensourcerisk.org
+
+ ORE is free software: you can redistribute it and/or modify it
+ under the terms of the Modified BSD License.  You should have received a
+ copy of the license along with this program.
+ The license is also available online at <http://opensourcerisk.org>
+
+ This program is distributed on the basis that it will form a useful
+ contribution to risk analytics and model standardisation, but WITHOUT
+ ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ FITNESS FOR A PARTICULAR PURPOSE. See the license for more details.
+*/
+
+#include <boost/test/unit_test.hpp>
+#include <boost/timer/timer.hpp>
+
+#include <orea/aggregation/cvaspreadsensitivitycalculator.hpp>
+#include <oret/toplevelfixture.hpp>
+#include <test/oreatoplevelfixture.hpp>
+
+#include "testmarket.hpp"
+
+using namespace std;
+using namespace QuantLib;
+using namespace boost::unit_test_framework;
+using namespace ore;
+using namespace ore::data;
+using namespace ore::analytics;
+
+using testsuite::TestMarket;
+
+BOOST_FIXTURE_TEST_SUITE(OREAnalyticsTestSuite, ore::test::OreaTopLevelFixture)
+
+BOOST_AUTO_TEST_SUITE(CVASpreadSensitivityCalculatorTest)
+
+BOOST_AUTO_TEST_CASE(testAnalyticVersusBumpAndRevalue) {
+
+    BOOST_TEST_MESSAGE("Testing analytic CVA spread sensitivities against bump and revalue...");
+
+    Date asof(5, Feb, 2016);
+    Settings::instance().evaluationDate() = asof;
+    auto market = boost::make_shared<TestMarket>(asof);
+    Handle<DefaultProbabilityTermStructure> dts = market->defaultCurve("dc")->curve();
+    Real recovery = market->recoveryRate("dc")->value();
+    Handle<YieldTermStructure> yts = market->discountCurve("EUR");
+
+    // amortising swap like exposure profile on a monthly grid, the first entry is the t0 exposure
+    vector<Date> dates;
+    vector<Real> epe(1, 1.0E5);
+    for (Size i = 1; i <= 144; ++i) {
+        dates.push_back(asof + i * Months);
+        Real t = i / 12.0;
+        epe.push_back(1.0E5 * (1.0 + std::sqrt(t)) * std::max(1.0 - t / 12.0, 0.0));
+    }
+    vector<Period> grid = {6 * Months, 1 * Years, 2 * Years, 3 * Years, 5 * Years, 7 * Years, 10 * Years};
+    Real shiftSize = 0.0001;
+
+    boost::timer::cpu_timer timer;
+    CVASpreadSensitivityCalculator bumped("NS", asof, epe, dates, dts, recovery, yts, grid, shiftSize,
+                                          CVASpreadSensitivityCalculator::Method::BumpAndRevalue);
+    timer.stop();
+    Real bumpTiming = timer.elapsed().wall * 1e-6;
+    timer.start();
+    CVASpreadSensitivityCalculator analytic("NS", asof, epe, dates, dts, recovery, yts, grid, shiftSize,
+                                            CVASpreadSensitivityCalculator::Method::Analytic);
+    timer.stop();
+    Real analyticTiming = timer.elapsed().wall * 1e-6;
+    BOOST_TEST_MESSAGE("bump and revalue: " << bumpTiming << " ms, analytic: " << analyticTiming << " ms");
+
+    // the analytic results are first order, the bumped ones differ by terms of order shift size times bucket time
+    Real tolerance = 0.5; // percent
+    BOOST_REQUIRE_EQUAL(analytic.hazardRateSensitivities().size(), grid.size());
+    BOOST_REQUIRE_EQUAL(analytic.cdsSpreadSensitivities().size(), grid.size());
+    for (Size i = 0; i < grid.size(); ++i) {
+        BOOST_TEST_MESSAGE(grid[i] << ": hazard rate sensitivity " << bumped.hazardRateSensitivities()[i] << " "
+                                   << analytic.hazardRateSensitivities()[i] << ", cds spread sensitivity "
+                                   << bumped.cdsSpreadSensitivities()[i] << " "
+                                   << analytic.cdsSpreadSensitivities()[i]);
+        BOOST_CHECK_CLOSE(analytic.hazardRateSensitivities()[i], bumped.hazardRateSensitivities()[i], tolerance);
+        BOOST_CHECK_CLOSE(analytic.cdsSpreadSensitivities()[i], bumped.cdsSpreadSensitivities()[i], tolerance);
+        for (Size j = 0; j < grid.size(); ++j) {
+            if (j <= i)
+                BOOST_CHECK_CLOSE(analytic.jacobi()[j][i], bumped.jacobi()[j][i], tolerance);
+            else
+                BOOST_CHECK_EQUAL(analytic.jacobi()[j][i], 0.0);
+        }
+    }
+
+    // the validation mode returns the analytic results and the bump and revalue results
+    CVASpreadSensitivityCalculator validated("NS", asof, epe, dates, dts, recovery, yts, grid, shiftSize,
+                                             CVASpreadSensitivityCalculator::Method::AnalyticWithValidation);
+    BOOST_REQUIRE_EQUAL(validated.bumpedHazardRateSensitivities().size(), grid.size());
+    BOOST_REQUIRE_EQUAL(validated.bumpedCdsSpreadSensitivities().size(), grid.size());
+    BOOST_CHECK(bumped.bumpedHazardRateSensitivities().empty());
+    BOOST_CHECK(analytic.bumpedCdsSpreadSensitivities().empty());
+    for (Size i = 0; i < grid.size(); ++i) {
+        BOOST_CHECK_EQUAL(validated.hazardRateSensitivities()[i], analytic.hazardRateSensitivities()[i]);
+        BOOST_CHECK_EQUAL(validated.cdsSpreadSensitivities()[i], analytic.cdsSpreadSensitivities()[i]);
+        BOOST_CHECK_EQUAL(validated.bumpedHazardRateSensitivities()[i], bumped.hazardRateSensitivities()[i]);
+        BOOST_CHECK_EQUAL(validated.bumpedCdsSpreadSensitivities()[i], bumped.cdsSpreadSensitivities()[i]);
+    }
+}
+
+BOOST_AUTO_TEST_CASE(testParseMethod) {
+    for (auto m : {CVASpreadSensitivityCalculator::Method::BumpAndRevalue,
+                   CVASpreadSensitivityCalculator::Method::Analytic,
+                   CVASpreadSensitivityCalculator::Method::AnalyticWithValidation}) {
+        std::ostringstream s;
+        s << m;
+        BOOST_CHECK(parseCvaSensitivityMethod(s.str()) == m);
+    }
+    BOOST_CHECK_THROW(parseCvaSensitivityMethod("Bump"), std::exception);
+}
+
+BOOST_AUTO_TEST_SUITE_END()
+
+BOOST_AUTO_TEST_SUITE_END()
@@ -0,0 +1,148 @@
+/*
+ Copyright (C) 2023 Quaternion Risk Management Ltd
+ All rights reserved.
+
+ This file is part of ORE, a free-software/open-source library
+ for transparent pricing and risk analysis - http://opensourcerisk.org
+
+ ORE is free software: you can redistribute it and/or modify it
+ under the terms of the Modified BSD License.  You should have received a
+ copy of the license along with this program.
+ The license is also available online at <http://opensourcerisk.org>
+
+ This program is distributed on the basis that it will form a useful
+ contribution to risk analytics and model standardisation, but WITHOUT
+ ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ FITNESS FOR A PARTICULAR PURPOSE. See the license for more details.
+*/
+
+#include <boost/test/unit_test.hpp>
+#include <orea/simulation/fixingmanager.hpp>
+#include <ored/portfolio/builders/swap.hpp>
+#include <ored/portfolio/enginedata.hpp>
+#include <ored/portfolio/enginefactory.hpp>
+#include <ored/portfolio/portfolio.hpp>
+#include <oret/toplevelfixture.hpp>
+#include <test/oreatoplevelfixture.hpp>
+
+#include <ql/indexes/indexmanager.hpp>
+
+#include <algorithm>
+
+#include "testmarket.hpp"
+#include "testportfolio.hpp"
+
+using namespace std;
+using namespace QuantLib;
+using namespace boost::unit_test_framework;
+using namespace ore;
+using namespace ore::data;
+using namespace ore::analytics;
+
+using testsuite::buildSwap;
+using testsuite::TestMarket;
+
+namespace {
+
+void checkHistory(const string& name, const TimeSeries<Real>& expected) {
+    const TimeSeries<Real>& history = IndexManager::instance().getHistory(name);
+    BOOST_REQUIRE_MESSAGE(history.size() == expected.size(), "history of " << name << " has " << history.size()
+                                                                           << " fixings, expected "
+                                                                           << expected.size());
+    for (auto h = history.cbegin(), e = expected.cbegin(); h != history.cend(); ++h, ++e) {
+        BOOST_CHECK_EQUAL(h->first, e->first);
+        BOOST_CHECK_EQUAL(h->second, e->second);
+    }
+}
+
+} // namespace
+
+BOOST_FIXTURE_TEST_SUITE(OREAnalyticsTestSuite, ore::test::OreaTopLevelFixture)
+
+BOOST_AUTO_TEST_SUITE(FixingManagerTest)
+
+BOOST_AUTO_TEST_CASE(testFixingsUpdateAndReset) {
+
+    BOOST_TEST_MESSAGE("Testing FixingManager updates over several steps and reset to the original histories...");
+
+    Date today(14, April, 2016);
+    Settings::instance().evaluationDate() = today;
+    boost::shared_ptr<Market> market = boost::make_shared<TestMarket>(today);
+
+    // the EUR swap has fixings in each simulation step, the GBP swap starts after the last simulation date, so its
+    // index is initialised in the manager but receives no fixings, the USD index is not referenced by the portfolio
+    boost::shared_ptr<EngineData> data = boost::make_shared<EngineData>();
+    data->model("Swap") = "DiscountedCashflows";
+    data->engine("Swap") = "DiscountingSwapEngine";
+    boost::shared_ptr<EngineFactory> factory = boost::make_shared<EngineFactory>(data, market);
+    boost::shared_ptr<Portfolio> portfolio = boost::make_shared<Portfolio>();
+    portfolio->add(buildSwap("EUR_SWAP", "EUR", true, 1.0E6, 0, 5, 0.02, 0.0, "1Y", "30/360", "3M", "A360",
+                             "EUR-EURIBOR-3M"));
+    portfolio->add(buildSwap("GBP_SWAP", "GBP", true, 1.0E6, 5, 5, 0.03, 0.0, "6M", "30/360", "6M", "A360",
+                             "GBP-LIBOR-6M"));
+    portfolio->build(factory);
+
+    boost::shared_ptr<IborIndex> eurIndex = *market->iborIndex("EUR-EURIBOR-3M");
+    vector<string> names = {eurIndex->name(), (*market->iborIndex("GBP-LIBOR-6M"))->name(),
+                            (*market->iborIndex("USD-LIBOR-3M"))->name()};
+    map<string, TimeSeries<Real>> originals;
+    for (auto const& n : names) {
+        originals[n] = IndexManager::instance().getHistory(n);
+        BOOST_REQUIRE(!originals[n].empty());
+    }
+
+    // the future fixing dates of the EUR swap
+    vector<Date> eurFixingDates;
+    auto r = portfolio->get("EUR_SWAP")->requiredFixings();
+    r.unsetPayDates();
+    for (auto const& [d, _] : r.fixingDatesIndices(Date::maxDate()).at("EUR-EURIBOR-3M")) {
+        if (d >= today)
+            eurFixingDates.push_back(d);
+    }
+    BOOST_REQUIRE(!eurFixingDates.empty());
+
+    vector<Date> dates;
+    for (Size i = 1; i <= 8; ++i)
+        dates.push_back(today + 3 * i * Months);
+
+    FixingManager fixingManager(today);
+    fixingManager.initialise(portfolio, market);
+
+    // two passes to check that the manager writes fixings again after a reset
+    for (Size pass = 0; pass < 2; ++pass) {
+        Date start = today;
+        long fixingsSet = 0;
+        for (auto const& d : dates) {
+            fixingManager.update(d);
+            // the fixings in [start, d) are backfilled with the fixing on the next valid fixing date on or after d
+            Real expected = eurIndex->fixing(eurIndex->fixingCalendar().adjust(d, Following));
+            const TimeSeries<Real>& history = IndexManager::instance().getHistory(eurIndex->name());
+            for (auto const& f : eurFixingDates) {
+                if (f >= start && f < d) {
+                    BOOST_REQUIRE_MESSAGE(history[f] != Null<Real>(), "no fixing for " << io::iso_date(f));
+                    BOOST_CHECK_CLOSE(history[f], expected, 1.0E-10);
+                    ++fixingsSet;
+                } else if (f >= d) {
+                    BOOST_CHECK_MESSAGE(history[f] == Null<Real>(),
+                                        "unexpected fixing for " << io::iso_date(f) << " after update to "
+                                                                 << io::iso_date(d));
+                }
+            }
+            start = d;
+        }
+        BOOST_CHECK_EQUAL(fixingsSet, std::count_if(eurFixingDates.begin(), eurFixingDates.end(),
+                                                    [&dates](const Date& f) { return f < dates.back(); }));
+
+        // indices without simulated fixings keep their original histories
+        checkHistory(names[1], originals[names[1]]);
+        checkHistory(names[2], originals[names[2]]);
+
+        fixingManager.reset();
+        for (auto const& n : names)
+            checkHistory(n, originals[n]);
+    }
+}
+
+BOOST_AUTO_TEST_SUITE_END()
+
+BOOST_AUTO_TEST_SUITE_END()
@@ -0,0 +1,143 @@
+/*
+ Copyright (C) 2023 Quaternion Risk Management Ltd
+ All rights reserved.
+
+ This file is part of ORE, a free-software/open-source library
+ for transparent pricing and risk analysis - http://opensourcerisk.org
+
+ ORE is free software: you can redistribute it and/or modify it
+ under the terms of the Modified BSD License.  You should have received a
+ copy of the license along with this program.
+ The license is also available online at <http://opensourcerisk.org>
+
+ This program is distributed on the basis that it will form a useful
+ contribution to risk analytics and model standardisation, but WITHOUT
+ ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ FITNESS FOR A PARTICULAR PURPOSE. See the license for more details.
+*/
+
+#include <boost/test/unit_test.hpp>
+#include <orea/cube/inmemorycube.hpp>
+#include <orea/engine/historicalsensipnlcalculator.hpp>
+#include <oret/toplevelfixture.hpp>
+#include <test/oreatoplevelfixture.hpp>
+
+#include <ql/math/randomnumbers/mt19937uniformrng.hpp>
+
+#include <cmath>
+
+using namespace std;
+using namespace QuantLib;
+using namespace boost::unit_test_framework;
+using namespace ore;
+using namespace ore::data;
+using namespace ore::analytics;
+
+namespace {
+
+// straightforward weighted covariance of the observations k with included[k] = true
+Matrix referenceCovariance(const vector<vector<Real>>& shifts, const vector<bool>& included, const Real lambda,
+                           const Real shrinkage) {
+    Size n = shifts.front().size();
+    vector<Real> w;
+    for (Size k = 0; k < shifts.size(); ++k)
+        if (included[k])
+            w.push_back(1.0);
+    if (lambda != Null<Real>()) {
+        for (Size k = 0; k < w.size(); ++k)
+            w[k] = std::pow(lambda, static_cast<Real>(w.size() - 1 - k));
+    }
+    Real sumW = 0.0;
+    for (auto const& v : w)
+        sumW += v;
+    Matrix c(n, n, 0.0);
+    for (Size i = 0; i < n; ++i) {
+        for (Size j = 0; j < n; ++j) {
+            Real mi = 0.0, mj = 0.0, mij = 0.0;
+            for (Size k = 0, l = 0; k < shifts.size(); ++k) {
+                if (!included[k])
+                    continue;
+                mi += w[l] * shifts[k][i];
+                mj += w[l] * shifts[k][j];
+                mij += w[l] * shifts[k][i] * shifts[k][j];
+                ++l;
+            }
+            c[i][j] = (mij - mi * mj / sumW) / sumW * (i == j ? 1.0 : 1.0 - shrinkage);
+        }
+    }
+    return c;
+}
+
+} // namespace
+
+BOOST_FIXTURE_TEST_SUITE(OREAnalyticsTestSuite, ore::test::OreaTopLevelFixture)
+
+BOOST_AUTO_TEST_SUITE(HistoricalSensiPnlCalculatorTest)
+
+BOOST_AUTO_TEST_CASE(testCovarianceCalculator) {
+
+    BOOST_TEST_MESSAGE("Testing covariance of historical shifts in CovarianceCalculator...");
+
+    // more risk factors and observations than fit into one block of the covariance computation
+
+    Size n = 150, m = 600;
+    Date asof(14, April, 2023);
+    Date start = asof - m;
+
+    set<string> ids;
+    set<pair<RiskFactorKey, Size>> keys;
+    for (Size i = 0; i < n; ++i) {
+        ids.insert(std::to_string(i));
+        // the cube indices are assigned in reverse order of the keys
+        keys.insert(make_pair(RiskFactorKey(RiskFactorKey::KeyType::DiscountCurve, "EUR", i), n - 1 - i));
+    }
+    auto cube = boost::make_shared<DoublePrecisionInMemoryCube>(asof, ids, vector<Date>(1, asof), m);
+
+    // shifts in key order, with a common factor to get non-trivial correlations
+
+    MersenneTwisterUniformRng rng(42);
+    vector<vector<Real>> shifts(m, vector<Real>(n));
+    for (Size k = 0; k < m; ++k) {
+        Real common = rng.nextReal() - 0.5;
+        for (Size i = 0; i < n; ++i) {
+            shifts[k][i] = 0.01 * (common + (rng.nextReal() - 0.5) * (1.0 + i % 3)) + 0.001;
+            cube->set(shifts[k][i], n - 1 - i, 0, k);
+        }
+    }
+
+    // the first observations are outside the covariance period
+
+    Size excluded = 50;
+    TimePeriod period({start + excluded, asof});
+    vector<bool> included(m);
+    for (Size k = 0; k < m; ++k)
+        included[k] = k >= excluded;
+
+    struct Config {
+        Size threads;
+        Real lambda, shrinkage;
+    };
+    vector<Config> configs = {{1, Null<Real>(), 0.0}, {4, Null<Real>(), 0.0}, {4, 0.97, 0.0}, {3, 0.99, 0.25}};
+
+    for (auto const& config : configs) {
+        CovarianceCalculator calculator(period, config.threads, config.lambda, config.shrinkage);
+        calculator.initialise(keys);
+        for (Size k = 0; k < m; ++k)
+            calculator.updateAccumulators(cube, start + k, start + k + 1, k);
+        calculator.populateCovariance(keys);
+        Matrix c = calculator.covariance();
+        Matrix ref = referenceCovariance(shifts, included, config.lambda, config.shrinkage);
+        BOOST_REQUIRE_EQUAL(c.rows(), n);
+        BOOST_REQUIRE_EQUAL(c.columns(), n);
+        for (Size i = 0; i < n; ++i) {
+            for (Size j = 0; j < n; ++j) {
+                BOOST_CHECK_SMALL(c[i][j] - ref[i][j], 1.0E-12);
+                BOOST_CHECK_EQUAL(c[i][j], c[j][i]);
+            }
+        }
+    }
+}
+
+BOOST_AUTO_TEST_SUITE_END()
+
+BOOST_AUTO_TEST_SUITE_END()
@@ -0,0 +1,215 @@
+/*
+ Copyright (C) 2023 Quaternion Risk Management Ltd
+ All rights reserved.
+
+ This file is part of ORE, a free-software/open-source library
+ for transparent pricing and risk analysis - http://opensourcerisk.org
+
+ ORE is free software: you can redistribute it and/or modify it
+ under the terms of the Modified BSD License.  You should have received a
+ copy of the license along with this program.
+ The license is also available online at <http://opensourcerisk.org>
+
+ This program is distributed on the basis that it will form a useful
+ contribution to risk analytics and model standardisation, but WITHOUT
+ ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ FITNESS FOR A PARTICULAR PURPOSE. See the license for more details.
+*/
+
+#include <boost/test/unit_test.hpp>
+#include <boost/timer/timer.hpp>
+
+#include <orea/aggregation/exposurecalculator.hpp>
+#include <orea/aggregation/incrementalxvacalculator.hpp>
+#include <orea/aggregation/nettedexposurecalculator.hpp>
+#include <orea/aggregation/staticcreditxvacalculator.hpp>
+#include <orea/cube/inmemorycube.hpp>
+#include <ored/portfolio/nettingsetdefinition.hpp>
+#include <ored/portfolio/nettingsetmanager.hpp>
+#include <ored/portfolio/trade.hpp>
+#include <oret/toplevelfixture.hpp>
+#include <test/oreatoplevelfixture.hpp>
+
+#include <ql/math/distributions/normaldistribution.hpp>
+#include <ql/math/randomnumbers/mt19937uniformrng.hpp>
+
+#include "testmarket.hpp"
+
+using namespace std;
+using namespace QuantLib;
+using namespace boost::unit_test_framework;
+using namespace ore;
+using namespace ore::data;
+using namespace ore::analytics;
+
+using testsuite::TestMarket;
+
+namespace {
+
+// trade stub, the exposure and xva calculators only use the envelope and the maturity
+class TestTrade : public Trade {
+public:
+    TestTrade(const string& id, const Envelope& env, const Date& maturity) : Trade("Swap", env) {
+        id_ = id;
+        maturity_ = maturity;
+    }
+    void build(const boost::shared_ptr<EngineFactory>&) override {}
+};
+
+struct TestData {
+    TestData() : asof(5, Feb, 2016) {
+        Settings::instance().evaluationDate() = asof;
+        market = boost::make_shared<TestMarket>(asof);
+        for (Size i = 1; i <= 20; ++i)
+            dates.push_back(asof + 3 * i * Months);
+        nettingSetManager = boost::make_shared<NettingSetManager>();
+        for (auto const& nid : {"NS1", "NS2", "NS3"})
+            nettingSetManager->add(boost::make_shared<NettingSetDefinition>(nid));
+        cubeInterpretation = boost::make_shared<CubeInterpretation>(false, false);
+    }
+
+    // trades with random npv paths, the trade ids are given by the prefix and the netting set
+    void addTrades(const boost::shared_ptr<Portfolio>& portfolio, map<string, vector<Real>>& values,
+                   const string& prefix, const string& nettingSetId, const Size n, MersenneTwisterUniformRng& rng) {
+        InverseCumulativeNormal icn;
+        for (Size t = 0; t < n; ++t) {
+            string id = prefix + "_" + nettingSetId + "_" + std::to_string(t);
+            Real notional = 1.0E6 * (1.0 + t);
+            Real drift = (t % 2 == 0 ? 1.0 : -1.0) * 1.0E4;
+            portfolio->add(boost::make_shared<TestTrade>(id, Envelope("dc", nettingSetId), dates.back()));
+            vector<Real>& v = values[id];
+            v.resize(dates.size() * samples);
+            for (Size k = 0; k < samples; ++k) {
+                Real x = 0.0;
+                for (Size j = 0; j < dates.size(); ++j) {
+                    x += 0.1 * std::sqrt(0.25) * icn(rng.nextReal());
+                    v[j * samples + k] = drift + notional * x;
+                }
+            }
+        }
+    }
+
+    boost::shared_ptr<NPVCube> buildCube(const boost::shared_ptr<Portfolio>& portfolio,
+                                         const map<string, vector<Real>>& values) {
+        auto cube = boost::make_shared<DoublePrecisionInMemoryCubeN>(asof, portfolio->ids(), dates, samples, 1);
+        for (auto const& [id, index] : cube->idsAndIndexes()) {
+            const vector<Real>& v = values.at(id);
+            cube->setT0(v[0], index);
+            for (Size j = 0; j < dates.size(); ++j)
+                for (Size k = 0; k < samples; ++k)
+                    cube->set(v[j * samples + k], index, j, k);
+        }
+        return cube;
+    }
+
+    // netting set cva computed as in PostProcess on the full portfolio
+    map<string, Real> nettingSetCva(const boost::shared_ptr<Portfolio>& portfolio,
+                                    const boost::shared_ptr<NPVCube>& cube) {
+        auto ec = boost::make_shared<ExposureCalculator>(portfolio, cube, cubeInterpretation, market, false, "EUR",
+                                                         Market::defaultConfiguration, 0.95,
+                                                         CollateralExposureHelper::Symmetric, false, false);
+        ec->build();
+        auto nec = boost::make_shared<NettedExposureCalculator>(
+            portfolio, market, cube, "EUR", Market::defaultConfiguration, 0.95, CollateralExposureHelper::Symmetric,
+            false, nettingSetManager, ec->nettingSetDefaultValue(), ec->nettingSetCloseOutValue(),
+            ec->nettingSetMporPositiveFlow(), ec->nettingSetMporNegativeFlow(), nullptr, cubeInterpretation, false,
+            nullptr, false, false, 1.0, ec->exposureCube(), 0, 0, false, false, MporCashFlowMode::BothPay);
+        nec->build();
+        StaticCreditXvaCalculator xva(portfolio, market, Market::defaultConfiguration, "EUR", "dc2", "", "", false,
+                                      nullptr, ec->exposureCube(), nec->exposureCube(), ExposureCalculator::EPE,
+                                      ExposureCalculator::ENE, NettedExposureCalculator::EPE,
+                                      NettedExposureCalculator::ENE);
+        xva.build();
+        return xva.nettingSetCva();
+    }
+
+    Date asof;
+    Size samples = 500;
+    vector<Date> dates;
+    boost::shared_ptr<Market> market;
+    boost::shared_ptr<NettingSetManager> nettingSetManager;
+    boost::shared_ptr<CubeInterpretation> cubeInterpretation;
+};
+
+} // namespace
+
+BOOST_FIXTURE_TEST_SUITE(OREAnalyticsTestSuite, ore::test::OreaTopLevelFixture)
+
+BOOST_AUTO_TEST_SUITE(IncrementalXvaCalculatorTest)
+
+BOOST_AUTO_TEST_CASE(testIncrementalCva) {
+
+    BOOST_TEST_MESSAGE("Testing incremental CVA against a full recalculation...");
+
+    TestData d;
+    MersenneTwisterUniformRng rng(42);
+
+    // existing portfolio in NS1 and NS2, candidate trades in NS1 and in the new netting set NS3
+
+    auto portfolio = boost::make_shared<Portfolio>();
+    auto candidates = boost::make_shared<Portfolio>();
+    map<string, vector<Real>> values;
+    d.addTrades(portfolio, values, "Existing", "NS1", 10, rng);
+    d.addTrades(portfolio, values, "Existing", "NS2", 50, rng);
+    d.addTrades(candidates, values, "Candidate", "NS1", 1, rng);
+    d.addTrades(candidates, values, "Candidate", "NS3", 1, rng);
+
+    auto cube = d.buildCube(portfolio, values);
+    auto candidateCube = d.buildCube(candidates, values);
+
+    // reference results
+
+    auto all = boost::make_shared<Portfolio>();
+    for (auto const& p : {portfolio, candidates})
+        for (auto const& [id, trade] : p->trades())
+            all->add(trade);
+    auto allCube = d.buildCube(all, values);
+
+    boost::timer::cpu_timer timer;
+    map<string, Real> cvaBefore = d.nettingSetCva(portfolio, cube);
+    map<string, Real> cvaAfter = d.nettingSetCva(all, allCube);
+    timer.stop();
+    Real fullTiming = timer.elapsed().wall * 1e-6 / 2.0;
+
+    // incremental results
+
+    IncrementalXvaCalculator calc(portfolio, d.nettingSetManager, d.market, Market::defaultConfiguration, cube, nullptr,
+                                  d.cubeInterpretation, "EUR", 0.95, "Symmetric", "dc2");
+    timer.start();
+    IncrementalXvaCalculator::Result result = calc.calculate(candidates, candidateCube);
+    timer.stop();
+    Real firstTiming = timer.elapsed().wall * 1e-6;
+    timer.start();
+    result = calc.calculate(candidates, candidateCube);
+    timer.stop();
+    Real secondTiming = timer.elapsed().wall * 1e-6;
+
+    BOOST_TEST_MESSAGE("full recalculation: " << fullTiming << " ms, incremental (first run): " << firstTiming
+                                              << " ms, incremental (cached baseline): " << secondTiming << " ms");
+
+    Real tol = 1.0E-8;
+
+    BOOST_REQUIRE_EQUAL(result.baseline.size(), 2);
+    BOOST_REQUIRE_EQUAL(result.incremental.size(), 2);
+    BOOST_CHECK(result.baseline.find("NS2") == result.baseline.end());
+
+    BOOST_CHECK_CLOSE(result.baseline.at("NS1").cva, cvaBefore.at("NS1"), tol);
+    BOOST_CHECK_SMALL(result.baseline.at("NS3").cva, tol);
+    BOOST_CHECK_CLOSE(result.incremental.at("NS1").cva, cvaAfter.at("NS1"), tol);
+    BOOST_CHECK_CLOSE(result.incremental.at("NS3").cva, cvaAfter.at("NS3"), tol);
+
+    Real marginalCva = 0.0;
+    for (auto const& [nid, cva] : cvaAfter)
+        marginalCva += cva - cvaBefore[nid];
+    BOOST_CHECK_CLOSE(result.marginalCva(), marginalCva, tol);
+    BOOST_CHECK(result.marginalCva() > 0.0);
+
+    // the candidate in the new netting set is allocated the whole netting set cva
+
+    BOOST_REQUIRE_EQUAL(result.allocatedCva.size(), 2);
+    BOOST_CHECK_CLOSE(result.allocatedCva.at("Candidate_NS3_0"), cvaAfter.at("NS3"), 1.0E-6);
+}
+
+BOOST_AUTO_TEST_SUITE_END()
+
+BOOST_AUTO_TEST_SUITE_END()
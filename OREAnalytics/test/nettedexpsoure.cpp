@@ -36,6 +36,7 @@
 #include <ored/utilities/log.hpp>
 #include <ored/utilities/osutils.hpp>
 #include <oret/toplevelfixture.hpp>
+#include <ql/math/distributions/normaldistribution.hpp>
 #include <ql/math/randomnumbers/mt19937uniformrng.hpp>
 #include <ql/time/calendars/target.hpp>
 #include <ql/time/date.hpp>
@@ -695,5 +696,191 @@ BOOST_AUTO_TEST_CASE(NettedExposureCalculatorTest) {
     }
 }
 
+BOOST_AUTO_TEST_CASE(testVectorisedCollateralBalances) {
+
+    BOOST_TEST_MESSAGE("Testing vectorised collateral balances against the collateral account paths...");
+
+    Date today(5, Feb, 2016);
+    Settings::instance().evaluationDate() = today;
+
+    vector<Date> dateGrid;
+    for (Size i = 1; i <= 104; ++i)
+        dateGrid.push_back(today + i * Weeks);
+    Date maturity = today + 18 * Months;
+    Size samples = 200;
+
+    // netting set values, fx rates and collateral rates along random walks
+    MersenneTwisterUniformRng rng(42);
+    InverseCumulativeNormal icn;
+    vector<vector<Real>> values(dateGrid.size(), vector<Real>(samples)), fx(dateGrid.size(), vector<Real>(samples)),
+        rates(dateGrid.size(), vector<Real>(samples));
+    for (Size k = 0; k < samples; ++k) {
+        Real v = 1.0E5, f = 1.1, r = 0.01;
+        for (Size j = 0; j < dateGrid.size(); ++j) {
+            v += 2.0E5 * icn(rng.nextReal());
+            f *= std::exp(0.01 * icn(rng.nextReal()));
+            r += 0.001 * icn(rng.nextReal());
+            values[j][k] = v;
+            fx[j][k] = f;
+            rates[j][k] = r;
+        }
+    }
+
+    struct CsaConfig {
+        string callFreq, postFreq, mpor;
+        Real threshold, mta, ia;
+        CollateralExposureHelper::CalculationType calcType;
+    };
+    vector<CsaConfig> configs = {{"1D", "1D", "2W", 0.0, 0.0, 0.0, CollateralExposureHelper::Symmetric},
+                                 {"1D", "1D", "10D", 1.0E5, 2.0E4, 0.0, CollateralExposureHelper::AsymmetricCVA},
+                                 {"1W", "1D", "2W", 5.0E4, 1.0E4, 1.0E4, CollateralExposureHelper::AsymmetricDVA},
+                                 {"3D", "1W", "1W", 0.0, 5.0E4, 0.0, CollateralExposureHelper::NoLag},
+                                 {"2W", "2W", "3W", 2.0E5, 0.0, -5.0E4, CollateralExposureHelper::Symmetric}};
+
+    for (auto const& c : configs) {
+        BOOST_TEST_MESSAGE("call frequency " << c.callFreq << ", post frequency " << c.postFreq << ", mpor " << c.mpor
+                                             << ", calculation type " << c.calcType);
+        auto csaDef = boost::make_shared<NettingSetDefinition>(
+            "NS", "Bilateral", "EUR", "EUR-EONIA", c.threshold, c.threshold, c.mta, c.mta, c.ia, "FIXED", c.callFreq,
+            c.postFreq, c.mpor, 0.001, 0.002, vector<string>{"EUR"});
+
+        boost::timer::cpu_timer timer;
+        auto paths = CollateralExposureHelper::collateralBalancePaths(csaDef, 1.0E5, today, values, maturity,
+                                                                      dateGrid, 1.1, fx, 0.01, rates, c.calcType);
+        timer.stop();
+        Real pathsTiming = timer.elapsed().wall * 1e-6;
+        timer.start();
+        vector<vector<Real>> balances = CollateralExposureHelper::collateralBalances(
+            csaDef, 1.0E5, today, values, maturity, dateGrid, 1.1, fx, 0.01, rates, c.calcType);
+        timer.stop();
+        Real balancesTiming = timer.elapsed().wall * 1e-6;
+        BOOST_TEST_MESSAGE("collateral account paths: " << pathsTiming << " ms, vectorised: " << balancesTiming
+                                                        << " ms");
+
+        BOOST_REQUIRE_EQUAL(balances.size(), dateGrid.size());
+        Real maxDiff = 0.0;
+        for (Size j = 0; j < dateGrid.size(); ++j) {
+            BOOST_REQUIRE_EQUAL(balances[j].size(), samples);
+            for (Size k = 0; k < samples; ++k)
+                maxDiff = std::max(maxDiff, std::abs(balances[j][k] - paths->at(k)->accountBalance(dateGrid[j])));
+        }
+        BOOST_CHECK_SMALL(maxDiff, 1.0E-6);
+    }
+}
+
+class DimTestTrade : public Trade {
+public:
+    DimTestTrade(const string& id, const Envelope& env, const Date& maturity) : Trade("Swap", env) {
+        id_ = id;
+        maturity_ = maturity;
+    }
+    void build(const boost::shared_ptr<EngineFactory>&) override {}
+};
+
+BOOST_AUTO_TEST_CASE(testParallelDimRegression) {
+
+    BOOST_TEST_MESSAGE("Testing parallel DIM regression against single threaded DIM regression...");
+
+    Date today(5, Feb, 2016);
+    Settings::instance().evaluationDate() = today;
+
+    vector<Date> dateGrid;
+    for (Size i = 1; i <= 52; ++i)
+        dateGrid.push_back(today + i * Weeks);
+    Size samples = 1000;
+
+    // three netting sets with two trades each, npvs and an index fixing along random walks
+    boost::shared_ptr<Portfolio> portfolio = boost::make_shared<Portfolio>();
+    for (Size i = 0; i < 6; ++i)
+        portfolio->add(boost::make_shared<DimTestTrade>("Trade_" + std::to_string(i),
+                                                        Envelope("CPTY_A", "NS" + std::to_string(i % 3)),
+                                                        dateGrid.back()));
+    auto cube = boost::make_shared<DoublePrecisionInMemoryCubeN>(today, portfolio->ids(), dateGrid, samples, 1);
+    auto asd = boost::make_shared<InMemoryAggregationScenarioData>(dateGrid.size(), samples);
+    MersenneTwisterUniformRng rng(42);
+    InverseCumulativeNormal icn;
+    for (Size k = 0; k < samples; ++k) {
+        Real fixing = 0.01, numeraire = 1.0;
+        for (Size j = 0; j < dateGrid.size(); ++j) {
+            fixing += 0.001 * icn(rng.nextReal());
+            numeraire *= 1.0 + 0.0002 + 0.00005 * icn(rng.nextReal());
+            asd->set(j, k, fixing, AggregationScenarioDataType::IndexFixing, "EUR-EURIBOR-6M");
+            asd->set(j, k, numeraire, AggregationScenarioDataType::Numeraire);
+        }
+    }
+    for (auto const& [id, index] : cube->idsAndIndexes()) {
+        cube->setT0(0.0, index);
+        for (Size k = 0; k < samples; ++k) {
+            Real npv = 0.0;
+            for (Size j = 0; j < dateGrid.size(); ++j) {
+                Real fixing = asd->get(j, k, AggregationScenarioDataType::IndexFixing, "EUR-EURIBOR-6M");
+                npv += 1.0E4 * (1.0 + index) * icn(rng.nextReal()) * (1.0 + 10.0 * std::abs(fixing));
+                cube->set(npv, index, j, k);
+            }
+        }
+    }
+    auto cubeInterpreter =
+        boost::make_shared<CubeInterpretation>(false, false, Handle<AggregationScenarioData>(asd));
+
+    for (auto const& regressors : {vector<string>(), vector<string>{"EUR-EURIBOR-6M", "NPV"}}) {
+        BOOST_TEST_MESSAGE("number of regressors " << regressors.size());
+        vector<boost::shared_ptr<RegressionDynamicInitialMarginCalculator>> dimCalculators;
+        for (Size threads : {1, 4}) {
+            auto dimCalculator = boost::make_shared<RegressionDynamicInitialMarginCalculator>(
+                nullptr, portfolio, cube, cubeInterpreter, asd, 0.99, 14, 2, regressors, 10, 0.25,
+                std::map<std::string, Real>(), threads);
+            boost::timer::cpu_timer timer;
+            dimCalculator->build();
+            timer.stop();
+            BOOST_TEST_MESSAGE("DIM regression with " << threads << " threads: " << timer.elapsed().wall * 1e-6
+                                                      << " ms");
+            dimCalculators.push_back(dimCalculator);
+        }
+
+        Size stopDatesLoop = dateGrid.size() - 1;
+        Size simpleIndexH = Size(floor(0.99 * (samples - 1) + 0.5));
+        Size simpleIndexP = Size(floor(0.01 * (samples - 1) + 0.5));
+        for (Size n = 0; n < 3; ++n) {
+            string nettingSet = "NS" + std::to_string(n);
+            auto serial = dimCalculators[0], parallel = dimCalculators[1];
+            for (Size j = 0; j < stopDatesLoop; ++j) {
+                BOOST_CHECK_EQUAL(serial->expectedIM(nettingSet)[j], parallel->expectedIM(nettingSet)[j]);
+                BOOST_CHECK_EQUAL(serial->zeroOrderResults(nettingSet)[j], parallel->zeroOrderResults(nettingSet)[j]);
+                BOOST_CHECK_EQUAL(serial->simpleResultsUpper(nettingSet)[j],
+                                  parallel->simpleResultsUpper(nettingSet)[j]);
+                BOOST_CHECK_EQUAL(serial->simpleResultsLower(nettingSet)[j],
+                                  parallel->simpleResultsLower(nettingSet)[j]);
+                for (Size k = 0; k < samples; ++k) {
+                    BOOST_CHECK_EQUAL(serial->dynamicIM(nettingSet)[j][k], parallel->dynamicIM(nettingSet)[j][k]);
+                    BOOST_CHECK_EQUAL(serial->localRegressionResults(nettingSet)[j][k],
+                                      parallel->localRegressionResults(nettingSet)[j][k]);
+                }
+                BOOST_CHECK(serial->expectedIM(nettingSet)[j] > 0.0);
+
+                // the simple DIM is given by the sorted distribution of the npv changes over the mpor
+                vector<Real> delta(samples);
+                Real oneOverNumeraire = 0.0;
+                for (Size k = 0; k < samples; ++k) {
+                    Real numeraire = asd->get(j, k, AggregationScenarioDataType::Numeraire);
+                    Real closeOutNumeraire = asd->get(j + 1, k, AggregationScenarioDataType::Numeraire);
+                    Real npv = 0.0, closeOutNpv = 0.0;
+                    for (Size i = n; i < 6; i += 3) {
+                        npv += cube->get(i, j, k);
+                        closeOutNpv += cube->get(i, j + 1, k);
+                    }
+                    delta[k] = closeOutNpv * closeOutNumeraire - npv * numeraire;
+                    oneOverNumeraire += 1.0 / numeraire / samples;
+                }
+                std::sort(delta.begin(), delta.end());
+                Real horizonScaling = std::sqrt(14.0 / (dateGrid[j + 1] - dateGrid[j]));
+                BOOST_CHECK_CLOSE(serial->simpleResultsUpper(nettingSet)[j],
+                                  delta[simpleIndexP] * horizonScaling * oneOverNumeraire, 1.0E-8);
+                BOOST_CHECK_CLOSE(serial->simpleResultsLower(nettingSet)[j],
+                                  delta[simpleIndexH] * horizonScaling * oneOverNumeraire, 1.0E-8);
+            }
+        }
+    }
+}
+
 BOOST_AUTO_TEST_SUITE_END()
 BOOST_AUTO_TEST_SUITE_END()
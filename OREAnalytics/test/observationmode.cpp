@@ -144,7 +144,7 @@ boost::shared_ptr<Portfolio> buildPortfolio(boost::shared_ptr<EngineFactory>& fa
     return portfolio;
 }
 
-void simulation(string dateGridString, bool checkFixings) {
+boost::shared_ptr<NPVCube> simulation(string dateGridString, bool checkFixings) {
     SavedSettings backup;
 
     // Log::instance().registerLogger(boost::make_shared<StderrLogger>());
@@ -352,6 +352,8 @@ void simulation(string dateGridString, bool checkFixings) {
                 BOOST_FAIL("Stored fixing differs from reference value, found " << fix << ", expected " << ref);
         }
     }
+
+    return cube;
 }
 
 BOOST_FIXTURE_TEST_SUITE(OREAnalyticsTestSuite, ore::test::OreaTopLevelFixture)
@@ -431,6 +433,32 @@ BOOST_AUTO_TEST_CASE(testDefer) {
     simulation("10,1Y", true);
 }
 
+BOOST_AUTO_TEST_CASE(testDirtyFlag) {
+    setConventions();
+
+    ObservationMode::instance().setMode(ObservationMode::Mode::None);
+    BOOST_TEST_MESSAGE("Generating reference cube with Observation Mode None, Long Grid");
+    boost::shared_ptr<NPVCube> reference = simulation("11,1Y", false);
+
+    ObservationMode::instance().setMode(ObservationMode::Mode::DirtyFlag);
+    BOOST_TEST_MESSAGE("Testing Observation Mode DirtyFlag, Long Grid, With Fixing Checks");
+    boost::shared_ptr<NPVCube> cube = simulation("11,1Y", true);
+
+    BOOST_REQUIRE_EQUAL(cube->numIds(), reference->numIds());
+    BOOST_REQUIRE_EQUAL(cube->numDates(), reference->numDates());
+    BOOST_REQUIRE_EQUAL(cube->samples(), reference->samples());
+    for (Size i = 0; i < cube->numIds(); ++i) {
+        BOOST_CHECK_CLOSE(cube->getT0(i), reference->getT0(i), 1e-10);
+        for (Size d = 0; d < cube->numDates(); ++d) {
+            for (Size s = 0; s < cube->samples(); ++s)
+                BOOST_CHECK_CLOSE(cube->get(i, d, s), reference->get(i, d, s), 1e-10);
+        }
+    }
+
+    BOOST_TEST_MESSAGE("Testing Observation Mode DirtyFlag, Short Grid, No Fixing Checks");
+    simulation("10,1Y", false);
+}
+
 BOOST_AUTO_TEST_SUITE_END()
 
 BOOST_AUTO_TEST_SUITE_END()
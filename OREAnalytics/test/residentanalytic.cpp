@@ -0,0 +1,163 @@
+/*
+ Copyright (C) 2023 Quaternion Risk Management Ltd
+ All rights reserved.
+
+ This file is part of ORE, a free-software/open-source library
+ for transparent pricing and risk analysis - http://opensourcerisk.org
+
+ ORE is free software: you can redistribute it and/or modify it
+ under the terms of the Modified BSD License.  You should have received a
+ copy of the license along with this program.
+ The license is also available online at <http://opensourcerisk.org>
+
+ This program is distributed on the basis that it will form a useful
+ contribution to risk analytics and model standardisation, but WITHOUT
+ ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ FITNESS FOR A PARTICULAR PURPOSE. See the license for more details.
+*/
+
+#include <boost/test/unit_test.hpp>
+#include <orea/app/analytic.hpp>
+#include <orea/app/inputparameters.hpp>
+#include <ored/portfolio/enginedata.hpp>
+#include <ored/portfolio/enginefactory.hpp>
+#include <ored/portfolio/portfolio.hpp>
+#include <oret/toplevelfixture.hpp>
+#include <test/oreatoplevelfixture.hpp>
+
+#include <ql/termstructures/yield/flatforward.hpp>
+#include <ql/time/daycounters/actualactual.hpp>
+
+#include "testmarket.hpp"
+#include "testportfolio.hpp"
+
+using namespace std;
+using namespace QuantLib;
+using namespace boost::unit_test_framework;
+using namespace ore;
+using namespace ore::data;
+using namespace ore::analytics;
+
+using testsuite::buildSwap;
+using testsuite::TestMarket;
+
+namespace {
+
+const string pricingEngineXml = "<PricingEngines>"
+                                "  <Product type=\"Swap\">"
+                                "    <Model>DiscountedCashflows</Model>"
+                                "    <ModelParameters/>"
+                                "    <Engine>DiscountingSwapEngine</Engine>"
+                                "    <EngineParameters/>"
+                                "  </Product>"
+                                "</PricingEngines>";
+
+// an analytic that only builds the portfolio
+class PortfolioAnalyticImpl : public Analytic::Impl {
+public:
+    PortfolioAnalyticImpl(const boost::shared_ptr<InputParameters>& inputs) : Analytic::Impl(inputs) {
+        setLabel("PORTFOLIO");
+    }
+    void runAnalytic(const boost::shared_ptr<InMemoryLoader>&, const std::set<std::string>& = {}) override {}
+};
+
+class PortfolioAnalytic : public Analytic {
+public:
+    PortfolioAnalytic(const boost::shared_ptr<InputParameters>& inputs)
+        : Analytic(std::make_unique<PortfolioAnalyticImpl>(inputs), {"PORTFOLIO"}, inputs) {}
+};
+
+// the test market with different discount curves, plays the role of the xva simulation market
+class ShiftedTestMarket : public TestMarket {
+public:
+    ShiftedTestMarket(const Date& asof) : TestMarket(asof) {
+        for (auto const& [ccy, rate] : std::map<string, Real>{{"EUR", 0.05}, {"USD", 0.06}})
+            yieldCurves_[make_tuple(Market::defaultConfiguration, YieldCurveType::Discount, ccy)] =
+                Handle<YieldTermStructure>(
+                    boost::make_shared<FlatForward>(asof, rate, ActualActual(ActualActual::ISDA)));
+    }
+};
+
+// compare the analytic's portfolio with a fresh build of the input portfolio on the market
+void checkAgainstFreshBuild(const boost::shared_ptr<Portfolio>& portfolio,
+                            const boost::shared_ptr<InputParameters>& inputs,
+                            const boost::shared_ptr<Market>& market) {
+    Portfolio fresh;
+    fresh.fromXMLString(inputs->portfolio()->toXMLString());
+    fresh.build(boost::make_shared<EngineFactory>(inputs->pricingEngine(), market));
+    BOOST_REQUIRE_EQUAL(portfolio->size(), fresh.size());
+    for (auto const& [tradeId, trade] : fresh.trades()) {
+        auto t = portfolio->get(tradeId);
+        BOOST_REQUIRE_MESSAGE(t, "trade " << tradeId << " not found in resident portfolio");
+        BOOST_CHECK_CLOSE(t->instrument()->NPV(), trade->instrument()->NPV(), 1E-10);
+    }
+}
+
+} // namespace
+
+BOOST_FIXTURE_TEST_SUITE(OREAnalyticsTestSuite, ore::test::OreaTopLevelFixture)
+
+BOOST_AUTO_TEST_SUITE(ResidentAnalyticTest)
+
+BOOST_AUTO_TEST_CASE(testIncrementalPortfolioBuild) {
+
+    BOOST_TEST_MESSAGE("Testing resident analytic portfolio builds after amendments, removals and xva runs...");
+
+    auto inputs = boost::make_shared<InputParameters>();
+    inputs->setAsOfDate("2016-04-14");
+    Date today = inputs->asof();
+    inputs->setPricingEngine(pricingEngineXml);
+
+    Portfolio initial;
+    initial.add(buildSwap("EUR_SWAP", "EUR", true, 1.0E6, 0, 10, 0.02, 0.0, "1Y", "30/360", "6M", "A360",
+                          "EUR-EURIBOR-6M"));
+    initial.add(buildSwap("USD_SWAP", "USD", false, 1.0E6, 0, 5, 0.03, 0.0, "6M", "30/360", "3M", "A360",
+                          "USD-LIBOR-3M"));
+    initial.add(buildSwap("GBP_SWAP", "GBP", true, 1.0E6, 0, 7, 0.04, 0.0, "1Y", "30/360", "6M", "A360",
+                          "GBP-LIBOR-6M"));
+    inputs->setPortfolio(initial.toXMLString());
+
+    boost::shared_ptr<Market> market = boost::make_shared<TestMarket>(today);
+    PortfolioAnalytic analytic(inputs);
+    analytic.setResident(true);
+    analytic.setMarket(market);
+
+    // initial full build
+    analytic.buildPortfolio();
+    checkAgainstFreshBuild(analytic.portfolio(), inputs, market);
+    auto usdInstrument = analytic.portfolio()->get("USD_SWAP")->instrument();
+
+    // amend the EUR swap and remove the GBP swap, the USD swap is not rebuilt
+    inputs->portfolio()->remove("EUR_SWAP");
+    inputs->portfolio()->add(buildSwap("EUR_SWAP", "EUR", true, 2.0E6, 0, 10, 0.03, 0.0, "1Y", "30/360", "6M",
+                                       "A360", "EUR-EURIBOR-6M"));
+    BOOST_REQUIRE(inputs->portfolio()->remove("GBP_SWAP"));
+    analytic.buildPortfolio();
+    checkAgainstFreshBuild(analytic.portfolio(), inputs, market);
+    BOOST_CHECK(analytic.portfolio()->get("USD_SWAP")->instrument() == usdInstrument);
+
+    // the xva analytic resets the input trades and builds them against the simulation market, the resident
+    // analytic must detect this and rebuild the trades against its own market on the next run
+    auto simFactory = boost::make_shared<EngineFactory>(inputs->pricingEngine(),
+                                                        boost::make_shared<ShiftedTestMarket>(today));
+    std::map<std::string, Real> simNpvs;
+    for (auto const& [tradeId, trade] : inputs->portfolio()->trades()) {
+        trade->reset();
+        trade->build(simFactory);
+        simNpvs[tradeId] = trade->instrument()->NPV();
+    }
+    analytic.buildPortfolio();
+    checkAgainstFreshBuild(analytic.portfolio(), inputs, market);
+    for (auto const& [tradeId, npv] : simNpvs)
+        BOOST_CHECK(std::abs(analytic.portfolio()->get(tradeId)->instrument()->NPV() - npv) > 1.0);
+
+    // a rerun without changes is a no-op
+    usdInstrument = analytic.portfolio()->get("USD_SWAP")->instrument();
+    analytic.buildPortfolio();
+    checkAgainstFreshBuild(analytic.portfolio(), inputs, market);
+    BOOST_CHECK(analytic.portfolio()->get("USD_SWAP")->instrument() == usdInstrument);
+}
+
+BOOST_AUTO_TEST_SUITE_END()
+
+BOOST_AUTO_TEST_SUITE_END()
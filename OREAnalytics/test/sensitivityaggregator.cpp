@@ -240,6 +240,47 @@ BOOST_AUTO_TEST_CASE(testGeneralAggregationFunctionCategories) {
     check(expAggregationAll, res, "all_except_002");
 }
 
+BOOST_AUTO_TEST_CASE(testGeneralAggregationMultipleThreads) {
+
+    BOOST_TEST_MESSAGE("Testing general aggregation using sets of trades for categories and multiple threads");
+
+    // Streamer
+    SensitivityInMemoryStream ss(records.begin(), records.end());
+
+    // Categories for aggregator
+    map<string, set<std::pair<std::string, QuantLib::Size>>> categories;
+    set<pair<string, QuantLib::Size>> trades = {make_pair("trade_001", 0), make_pair("trade_003", 1),
+                                                make_pair("trade_004", 2), make_pair("trade_005", 3),
+                                                make_pair("trade_006", 4)};
+
+    for (const auto& trade : trades) {
+        categories[trade.first] = {trade};
+    }
+    categories["all_except_002"] = trades;
+
+    // Create aggregator with more threads than categories and aggregate twice, resetting in between
+    SensitivityAggregator sAgg(categories, 8);
+    sAgg.aggregate(ss);
+    sAgg.reset();
+    sAgg.aggregate(ss);
+
+    set<SensitivityRecord> exp;
+    set<SensitivityRecord> res;
+
+    for (const auto& trade : trades) {
+        exp = filter(records, trade.first);
+        res = sAgg.sensitivities(trade.first);
+        BOOST_TEST_MESSAGE("Testing for category with single trade " << trade.first);
+        check(exp, res, trade.first);
+    }
+
+    BOOST_TEST_MESSAGE("Testing for category 'all_except_002'");
+    res = sAgg.sensitivities("all_except_002");
+    check(expAggregationAll, res, "all_except_002");
+
+    BOOST_CHECK_THROW(sAgg.sensitivities("trade_002"), QuantLib::Error);
+}
+
 BOOST_AUTO_TEST_SUITE_END()
 
 BOOST_AUTO_TEST_SUITE_END()
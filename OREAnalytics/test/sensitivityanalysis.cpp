@@ -840,6 +840,11 @@ BOOST_AUTO_TEST_CASE(testPortfolioSensitivityUnregisterObs) {
     testPortfolioSensitivity(ObservationMode::Mode::Unregister);
 }
 
+BOOST_AUTO_TEST_CASE(testPortfolioSensitivityDirtyFlagObs) {
+    BOOST_TEST_MESSAGE("Testing Portfolio sensitivity (DirtyFlag observation mode)");
+    testPortfolioSensitivity(ObservationMode::Mode::DirtyFlag);
+}
+
 void test1dShifts(bool granular) {
     BOOST_TEST_MESSAGE("Testing 1d shifts " << (granular ? "granular" : "sparse"));
 
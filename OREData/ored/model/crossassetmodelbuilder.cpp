@@ -60,6 +60,7 @@
 
 #include <boost/algorithm/string/case_conv.hpp>
 #include <boost/lexical_cast.hpp>
+#include <boost/timer/timer.hpp>
 
 using QuantExt::AnalyticJyCpiCapFloorEngine;
 using QuantExt::AnalyticJyYoYCapFloorEngine;
@@ -81,7 +82,7 @@ CrossAssetModelBuilder::CrossAssetModelBuilder(
     const std::string& configurationEqCalibration, const std::string& configurationInfCalibration,
     const std::string& configurationCrCalibration, const std::string& configurationFinalModel, const bool dontCalibrate,
     const bool continueOnError, const std::string& referenceCalibrationGrid, const SalvagingAlgorithm::Type salvaging,
-    const std::string& id)
+    const std::string& id, const bool warmStartCalibration)
     : market_(market), config_(config), configurationLgmCalibration_(configurationLgmCalibration),
       configurationFxCalibration_(configurationFxCalibration), configurationEqCalibration_(configurationEqCalibration),
       configurationInfCalibration_(configurationInfCalibration),
@@ -89,6 +90,7 @@ CrossAssetModelBuilder::CrossAssetModelBuilder(
       configurationComCalibration_(Market::defaultConfiguration), configurationFinalModel_(configurationFinalModel),
       dontCalibrate_(dontCalibrate), continueOnError_(continueOnError),
       referenceCalibrationGrid_(referenceCalibrationGrid), salvaging_(salvaging), id_(id),
+      warmStartCalibration_(warmStartCalibration),
       optimizationMethod_(boost::shared_ptr<OptimizationMethod>(new LevenbergMarquardt(1E-8, 1E-8, 1E-8))),
       endCriteria_(EndCriteria(1000, 500, 1E-8, 1E-8, 1E-8)) {
     buildModel();
@@ -153,7 +155,7 @@ void CrossAssetModelBuilder::performCalculations() const {
     // TODO we could do this more selectively
     if (!dontCalibrate_ && requiresRecalibration()) {
         // reset market observer update flag
-        marketObserver_->hasUpdated(true);
+        correlationsUpdated_ = marketObserver_->hasUpdated(true);
         // the cast is a bit ugly, but we pretty much know what we are doing here
         const_cast<CrossAssetModelBuilder*>(this)->unregisterWithSubBuilders();
         buildModel();
@@ -235,6 +237,10 @@ void CrossAssetModelBuilder::buildModel() const {
                                                continueOnError_, referenceCalibrationGrid_, false, id_);
             if (dontCalibrate_)
                 builder->freeze();
+            else if (warmStartCalibration_) {
+                auto state = irCalibrationStates_.find(i);
+                builder->enableWarmStart(state == irCalibrationStates_.end() ? CalibrationState() : state->second);
+            }
             lgmBuilder.push_back(builder);
             auto parametrization = builder->parametrization();
             swaptionBaskets_[i] = builder->swaptionBasket();
@@ -471,6 +477,22 @@ void CrossAssetModelBuilder::buildModel() const {
         swaptionCalibrationErrors_[i] = hwBuilder[i]->error();
     }
 
+    // the IR components were calibrated on building the parametrizations above, collect the statistics before
+    // the discount curves are relinked below
+    std::vector<bool> irRecalibrated(irParametrizations.size(), true);
+    if (warmStartCalibration_ && !dontCalibrate_) {
+        for (auto const& b : subBuilders_[CrossAssetModel::AssetType::IR]) {
+            if (auto builder = boost::dynamic_pointer_cast<LgmBuilder>(b.second)) {
+                irCalibrationStates_[b.first] = builder->calibrationState();
+                irRecalibrated[b.first] = !builder->calibrationSkipped();
+                LOG("IR " << currencies[b.first] << " calibration "
+                          << (builder->calibrationSkipped() ? "skipped" : "done") << ": "
+                          << builder->calibrationIterations() << " model pricings, " << builder->calibrationTime()
+                          << " s");
+            }
+        }
+    }
+
     /*************************
      * Relink LGM discount curves to curves used for FX calibration
      */
@@ -506,15 +528,55 @@ void CrossAssetModelBuilder::buildModel() const {
 
         if (!dontCalibrate_) {
 
-            if (fx->calibrationType() == CalibrationType::Bootstrap && fx->sigmaParamType() == ParamType::Piecewise)
-                model_->calibrateBsVolatilitiesIterative(CrossAssetModel::AssetType::FX, i, fxOptionBaskets_[i],
-                                                         *optimizationMethod_, endCriteria_);
-            else
-                model_->calibrateBsVolatilitiesGlobal(CrossAssetModel::AssetType::FX, i, fxOptionBaskets_[i],
-                                                      *optimizationMethod_, endCriteria_);
+            boost::timer::cpu_timer timer;
+            model_->resetFunctionEvaluations();
+
+            // in warm start mode start from the last calibration and skip the calibration if neither the fx
+            // option market values nor the involved ir components or the correlations have changed
+            bool skipped = false;
+            Date referenceDate = irDiscountCurves[0]->referenceDate();
+            std::vector<Real> marketValues;
+            if (warmStartCalibration_) {
+                marketValues = getMarketValues(fxOptionBaskets_[i]);
+                auto state = fxCalibrationStates_.find(i);
+                auto sigma = fxParametrizations[i]->parameter(0);
+                if (state != fxCalibrationStates_.end() && state->second.params.size() == sigma->size()) {
+                    for (Size j = 0; j < sigma->size(); ++j)
+                        sigma->setParam(j, state->second.params[j]);
+                    model_->update();
+                    skipped = !irRecalibrated[0] && !irRecalibrated[i + 1] && !correlationsUpdated_ &&
+                              calibrationUnchanged(state->second, referenceDate, marketValues);
+                }
+            }
+
+            if (skipped) {
+                DLOG("FX " << fx->foreignCcy() << " calibration skipped, market data has not changed");
+                fxOptionCalibrationErrors_[i] = fxCalibrationStates_[i].error;
+            } else {
+                if (fx->calibrationType() == CalibrationType::Bootstrap &&
+                    fx->sigmaParamType() == ParamType::Piecewise)
+                    model_->calibrateBsVolatilitiesIterative(CrossAssetModel::AssetType::FX, i, fxOptionBaskets_[i],
+                                                             *optimizationMethod_, endCriteria_);
+                else
+                    model_->calibrateBsVolatilitiesGlobal(CrossAssetModel::AssetType::FX, i, fxOptionBaskets_[i],
+                                                          *optimizationMethod_, endCriteria_);
+                DLOG("FX " << fx->foreignCcy() << " calibration errors:");
+                fxOptionCalibrationErrors_[i] = getCalibrationError(fxOptionBaskets_[i]);
+            }
+
+            if (warmStartCalibration_) {
+                if (!skipped) {
+                    auto& state = fxCalibrationStates_[i];
+                    state.referenceDate = referenceDate;
+                    state.params = fxParametrizations[i]->parameter(0)->params();
+                    state.marketValues = marketValues;
+                    state.error = fxOptionCalibrationErrors_[i];
+                }
+                LOG("FX " << fx->foreignCcy() << " calibration " << (skipped ? "skipped" : "done") << ": "
+                          << model_->functionEvaluations() << " model pricings, "
+                          << static_cast<double>(timer.elapsed().wall) * 1e-9 << " s");
+            }
 
-            DLOG("FX " << fx->foreignCcy() << " calibration errors:");
-            fxOptionCalibrationErrors_[i] = getCalibrationError(fxOptionBaskets_[i]);
             if (fx->calibrationType() == CalibrationType::Bootstrap) {
                 if (fabs(fxOptionCalibrationErrors_[i]) < config_->bootstrapTolerance()) {
                     TLOGGERSTREAM("Calibration details:");
@@ -38,6 +38,7 @@
 #include <ored/model/inflation/infdkdata.hpp>
 #include <ored/model/inflation/infjydata.hpp>
 #include <ored/model/inflation/infjybuilder.hpp>
+#include <ored/model/utilities.hpp>
 #include <ored/utilities/xmlutils.hpp>
 
 namespace ore {
@@ -84,7 +85,10 @@ public:
 	//! salvaging algorithm to apply to correlation matrix
 	const SalvagingAlgorithm::Type salvaging = SalvagingAlgorithm::None,
         //! id of the builder
-        const std::string& id = "unknown");
+        const std::string& id = "unknown",
+        /*! warm start recalibrations from the previous calibration result and skip the calibration of IR and FX
+            components whose calibration instruments are unaffected by market changes */
+        const bool warmStartCalibration = false);
 
     //! Default destructor
     ~CrossAssetModelBuilder() {}
@@ -141,6 +145,12 @@ private:
     const std::string referenceCalibrationGrid_;
     const SalvagingAlgorithm::Type salvaging_;
     const std::string id_;
+    const bool warmStartCalibration_;
+
+    // results of the last IR and FX calibrations used in warm start mode, keyed by component index
+    mutable std::map<QuantLib::Size, CalibrationState> irCalibrationStates_, fxCalibrationStates_;
+    // did the correlations change since the last build?
+    mutable bool correlationsUpdated_ = true;
 
     // TODO: Move CalibrationErrorType, optimizer and end criteria parameters to data
     boost::shared_ptr<OptimizationMethod> optimizationMethod_;
@@ -37,6 +37,8 @@
 #include <ored/utilities/parsers.hpp>
 #include <ored/utilities/strike.hpp>
 
+#include <boost/timer/timer.hpp>
+
 using namespace QuantLib;
 using namespace QuantExt;
 using namespace std;
@@ -349,21 +351,44 @@ void LgmBuilder::performCalculations() const {
         swaptionBasket_[j]->update();
     }
 
-    // reset model parameters to ensure identical results on identical market data input
-    model_->setParams(params_);
+    boost::timer::cpu_timer timer;
+    Date referenceDate = modelDiscountCurve_->referenceDate();
+    std::vector<Real> marketValues;
+    if (warmStart_)
+        marketValues = getMarketValues(swaptionBasket_);
+
+    // reset model parameters to ensure identical results on identical market data input, in warm start mode we
+    // start from the result of the last calibration instead, if that is compatible with the current basket
+    bool warmStart = warmStart_ && calibrationState_.params.size() == params_.size();
+    model_->setParams(warmStart ? calibrationState_.params : params_);
     parametrization_->shift() = 0.0;
     parametrization_->scaling() = 1.0;
+    model_->resetFunctionEvaluations();
 
     LgmCalibrationInfo calibrationInfo;
     error_ = QL_MAX_REAL;
+    calibrationSkipped_ = warmStart && !forceCalibration_ &&
+                          calibrationUnchanged(calibrationState_, referenceDate, marketValues);
     std::string errorTemplate =
         std::string("Failed to calibrate LGM Model. ") +
         (continueOnError_ ? std::string("Calculation will proceed anyway - using the calibration as is!")
                           : std::string("Calculation will aborted."));
     try {
-        if (data_->calibrateA() && !data_->calibrateH() && data_->calibrationType() == CalibrationType::Bootstrap) {
-            DLOG("call calibrateVolatilitiesIterative for volatility calibration (bootstrap)");
-            model_->calibrateVolatilitiesIterative(swaptionBasket_, *optimizationMethod_, endCriteria_);
+        if (calibrationSkipped_) {
+            DLOG("Skipping calibration as the calibration helper market values have not changed");
+            error_ = calibrationState_.error;
+        } else if (data_->calibrateA() && !data_->calibrateH() &&
+                   data_->calibrationType() == CalibrationType::Bootstrap) {
+            if (warmStart_) {
+                DLOG("call calibrateVolatilitiesIterativeNewton for volatility calibration (bootstrap)");
+                Size fallbacks = model_->calibrateVolatilitiesIterativeNewton(swaptionBasket_, *optimizationMethod_,
+                                                                              endCriteria_);
+                if (fallbacks > 0)
+                    DLOG("Newton iteration did not converge for " << fallbacks << " helpers, used optimizer instead");
+            } else {
+                DLOG("call calibrateVolatilitiesIterative for volatility calibration (bootstrap)");
+                model_->calibrateVolatilitiesIterative(swaptionBasket_, *optimizationMethod_, endCriteria_);
+            }
         } else if (data_->calibrateH() && !data_->calibrateA() &&
                    data_->calibrationType() == CalibrationType::Bootstrap) {
             DLOG("call calibrateReversionsIterative for reversion calibration (bootstrap)");
@@ -383,8 +408,10 @@ void LgmBuilder::performCalculations() const {
                 model_->calibrate(swaptionBasket_, *optimizationMethod_, endCriteria_);
             }
         }
-        TLOG("LGM " << data_->qualifier() << " calibration errors:");
-        error_ = getCalibrationError(swaptionBasket_);
+        if (!calibrationSkipped_) {
+            TLOG("LGM " << data_->qualifier() << " calibration errors:");
+            error_ = getCalibrationError(swaptionBasket_);
+        }
     } catch (const std::exception& e) {
         // just log a warning, we check below if we meet the bootstrap tolerance and handle the result there
         StructuredModelErrorMessage(errorTemplate, e.what(), id_).log();
@@ -441,6 +468,18 @@ void LgmBuilder::performCalculations() const {
     }
     model_->setCalibrationInfo(calibrationInfo);
 
+    calibrationIterations_ = model_->functionEvaluations();
+    calibrationTime_ = static_cast<double>(timer.elapsed().wall) * 1e-9;
+    DLOG("LGM " << data_->qualifier() << " calibration " << (calibrationSkipped_ ? "skipped" : "done") << ", "
+                << calibrationIterations_ << " model pricings, " << calibrationTime_ << " s");
+
+    if (warmStart_ && !calibrationSkipped_) {
+        calibrationState_.referenceDate = referenceDate;
+        calibrationState_.params = model_->params();
+        calibrationState_.marketValues = marketValues;
+        calibrationState_.error = error_;
+    }
+
     DLOG("Apply shift horizon and scale (if not 0.0 and 1.0 respectively)");
 
     QL_REQUIRE(data_->shiftHorizon() >= 0.0, "shift horizon must be non negative");
@@ -687,6 +726,31 @@ std::string LgmBuilder::getBasketDetails(LgmCalibrationInfo& info) const {
     return log.str();
 }
 
+void LgmBuilder::enableWarmStart(const CalibrationState& previousState) {
+    warmStart_ = true;
+    calibrationState_ = previousState;
+}
+
+const CalibrationState& LgmBuilder::calibrationState() const {
+    calculate();
+    return calibrationState_;
+}
+
+Size LgmBuilder::calibrationIterations() const {
+    calculate();
+    return calibrationIterations_;
+}
+
+Real LgmBuilder::calibrationTime() const {
+    calculate();
+    return calibrationTime_;
+}
+
+bool LgmBuilder::calibrationSkipped() const {
+    calculate();
+    return calibrationSkipped_;
+}
+
 void LgmBuilder::forceRecalculate() {
     forceCalibration_ = true;
     ModelBuilder::forceRecalculate();
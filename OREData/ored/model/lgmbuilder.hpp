@@ -30,6 +30,7 @@
 #include <qle/models/lgm.hpp>
 
 #include <ored/model/irlgmdata.hpp>
+#include <ored/model/utilities.hpp>
 #include <qle/models/marketobserver.hpp>
 #include <qle/models/modelbuilder.hpp>
 
@@ -76,6 +77,25 @@ public:
     bool requiresRecalibration() const override;
     //@}
 
+    /*! Enable the warm start mode: the calibration starts from the last calibrated parameters (or from the given
+        state of a previous calibration, e.g. taken from another builder for the same model data) instead of the
+        initial values from the model data, it is skipped if the calibration helper market values did not change,
+        and bootstrapped volatilities are calibrated with a Newton iteration using analytic swaption price
+        derivatives. Must be called before the model is calibrated for the first time. */
+    void enableWarmStart(const CalibrationState& previousState = CalibrationState());
+
+    //! \name Calibration statistics
+    //@{
+    //! state of the last calibration, only populated in warm start mode
+    const CalibrationState& calibrationState() const;
+    //! number of model pricings in the last calibration, zero if the calibration was skipped
+    Size calibrationIterations() const;
+    //! wall time of the last calibration in seconds
+    Real calibrationTime() const;
+    //! true if the last calibration was skipped in warm start mode
+    bool calibrationSkipped() const;
+    //@}
+
 private:
     void performCalculations() const override;
     void buildSwaptionBasket() const;
@@ -128,6 +148,13 @@ private:
 
     bool forceCalibration_ = false;
 
+    // warm start mode and calibration statistics
+    bool warmStart_ = false;
+    mutable CalibrationState calibrationState_;
+    mutable Size calibrationIterations_ = 0;
+    mutable Real calibrationTime_ = 0.0;
+    mutable bool calibrationSkipped_ = false;
+
     // LGM Observer
     boost::shared_ptr<QuantExt::MarketObserver> marketObserver_;
 };
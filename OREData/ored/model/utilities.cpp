@@ -26,6 +26,7 @@
 #include <qle/models/yoyswaphelper.hpp>
 
 #include <ql/exercise.hpp>
+#include <ql/math/comparison.hpp>
 #include <ql/models/shortrate/calibrationhelpers/swaptionhelper.hpp>
 
 using QuantExt::InfJyParameterization;
@@ -122,6 +123,18 @@ map<Date, HelperValues> jyHelperValues(const vector<boost::shared_ptr<Calibratio
 
 } // namespace
 
+bool calibrationUnchanged(const CalibrationState& state, const Date& referenceDate,
+                          const std::vector<Real>& marketValues) {
+    if (state.error == Null<Real>() || state.referenceDate != referenceDate ||
+        state.marketValues.size() != marketValues.size())
+        return false;
+    for (Size i = 0; i < marketValues.size(); ++i) {
+        if (!close_enough(state.marketValues[i], marketValues[i]))
+            return false;
+    }
+    return true;
+}
+
 std::string getCalibrationDetails(LgmCalibrationInfo& info,
                                      const std::vector<boost::shared_ptr<BlackCalibrationHelper>>& basket,
                                      const boost::shared_ptr<IrLgm1fParametrization>& parametrization) {
@@ -53,6 +53,31 @@ template <typename Helper> Real getCalibrationError(const std::vector<boost::sha
     return std::sqrt(rmse / static_cast<Real>(basket.size()));
 }
 
+//! Result of a calibration, used to warm start a subsequent recalibration of the same model component
+struct CalibrationState {
+    //! reference date of the market the calibration was performed against
+    Date referenceDate;
+    //! calibrated raw model parameters
+    Array params;
+    //! market values of the calibration helpers
+    std::vector<Real> marketValues;
+    //! calibration error
+    Real error = Null<Real>();
+};
+
+//! Return the market values of the helpers in the basket
+template <typename Helper> std::vector<Real> getMarketValues(const std::vector<boost::shared_ptr<Helper>>& basket) {
+    std::vector<Real> result;
+    for (auto const& h : basket)
+        result.push_back(h->marketValue());
+    return result;
+}
+
+/*! Return true if the state holds a calibration against the given reference date and calibration helper market values,
+    i.e. a recalibration would reproduce the parameters stored in the state */
+bool calibrationUnchanged(const CalibrationState& state, const Date& referenceDate,
+                          const std::vector<Real>& marketValues);
+
 std::string getCalibrationDetails(
     LgmCalibrationInfo& info, const std::vector<boost::shared_ptr<BlackCalibrationHelper>>& basket,
     const boost::shared_ptr<IrLgm1fParametrization>& parametrization = boost::shared_ptr<IrLgm1fParametrization>());
@@ -272,6 +272,12 @@ ScriptedTradeEngineBuilder::engine(const std::string& id, const ScriptedTrade& s
         }
         DLOG("sobol bb ordering    = " << mcParams_.sobolOrdering);
         DLOG("sobol direction int. = " << mcParams_.sobolDirectionIntegers);
+        DLOG("control variate      = " << std::boolalpha << controlVariate_);
+        if (adaptiveMaxSamples_ != Null<Size>()) {
+            DLOG("adaptive tolerance   = " << adaptiveTolerance_);
+            DLOG("adaptive rel. tol.   = " << adaptiveRelativeTolerance_);
+            DLOG("adaptive max samples = " << adaptiveMaxSamples_);
+        }
     } else if (engineParam_ == "FD") {
         DLOG("stateGridPoints      = " << modelSize_);
         DLOG("mesherEpsilon        = " << mesherEpsilon_);
@@ -279,6 +285,7 @@ ScriptedTradeEngineBuilder::engine(const std::string& id, const ScriptedTrade& s
         DLOG("mesherConcentration  = " << mesherConcentration_);
         DLOG("mesherMaxConcentrPts = " << mesherMaxConcentratingPoints_);
         DLOG("mesherIsStatic       = " << std::boolalpha << mesherIsStatic_);
+        DLOG("threads              = " << fdThreads_);
     }
     if (modelParam_ == "GaussianCam") {
         DLOG("fullDynamicIr        = " << std::boolalpha << fullDynamicIr_);
@@ -303,7 +310,8 @@ ScriptedTradeEngineBuilder::engine(const std::string& id, const ScriptedTrade& s
         engine = boost::make_shared<ScriptedInstrumentPricingEngine>(
             script.npv(), script.results(), model_, ast_, context, script.code(), interactive_, amcCam_ != nullptr,
             std::set<std::string>(script.stickyCloseOutStates().begin(), script.stickyCloseOutStates().end()),
-            generateAdditionalResults);
+            generateAdditionalResults, controlVariate_, adaptiveTolerance_, adaptiveRelativeTolerance_,
+            adaptiveMaxSamples_);
     } else if (modelCG_) {
         auto rt = globalParameters_.find("RunType");
         bool useCachedSensis = useAd_ && (rt != globalParameters_.end() && rt->second == "SensitivityDelta");
@@ -484,6 +492,11 @@ void ScriptedTradeEngineBuilder::populateModelParameters() {
     mesherConcentration_ = 0.1;
     mesherMaxConcentratingPoints_ = 9999;
     mesherIsStatic_ = false;
+    fdThreads_ = 1;
+    controlVariate_ = false;
+    adaptiveTolerance_ = Null<Real>();
+    adaptiveRelativeTolerance_ = Null<Real>();
+    adaptiveMaxSamples_ = Null<Size>();
 
     // parameters only needed for certain model / engine pairs
 
@@ -519,6 +532,16 @@ void ScriptedTradeEngineBuilder::populateModelParameters() {
         } else {
             mcParams_.trainingSamples = Null<Size>();
         }
+        controlVariate_ = parseBool(engineParameter("ControlVariate", {resolvedProductTag_}, false, "false"));
+        if (auto tmp = engineParameter("AdaptiveMaxSamples", {resolvedProductTag_}, false, ""); !tmp.empty()) {
+            adaptiveMaxSamples_ = parseInteger(tmp);
+            if (auto tol = engineParameter("AdaptiveTolerance", {resolvedProductTag_}, false, ""); !tol.empty())
+                adaptiveTolerance_ = parseReal(tol);
+            if (auto tol = engineParameter("AdaptiveRelativeTolerance", {resolvedProductTag_}, false, ""); !tol.empty())
+                adaptiveRelativeTolerance_ = parseReal(tol);
+            QL_REQUIRE(adaptiveTolerance_ != Null<Real>() || adaptiveRelativeTolerance_ != Null<Real>(),
+                       "AdaptiveMaxSamples is given, expected AdaptiveTolerance and / or AdaptiveRelativeTolerance");
+        }
     } else if (engineParam_ == "FD") {
         modelSize_ = parseInteger(engineParameter("StateGridPoints", {resolvedProductTag_}));
         mesherEpsilon_ = parseReal(engineParameter("MesherEpsilon", {resolvedProductTag_}, false, "1.0E-4"));
@@ -527,6 +550,8 @@ void ScriptedTradeEngineBuilder::populateModelParameters() {
         mesherMaxConcentratingPoints_ =
             parseInteger(engineParameter("MesherMaxConcentratingPoints", {resolvedProductTag_}, false, "9999"));
         mesherIsStatic_ = parseBool(engineParameter("MesherIsStatic", {resolvedProductTag_}, false, "false"));
+        fdThreads_ = parseInteger(engineParameter("Threads", {resolvedProductTag_}, false, "1"));
+        QL_REQUIRE(fdThreads_ > 0, "ScriptedTradeEngineBuilder: Threads (" << fdThreads_ << ") must be positive");
     }
 
     // global parameters that are relevant
@@ -1186,7 +1211,7 @@ void ScriptedTradeEngineBuilder::buildFdBlackScholes(const std::string& id,
         modelSize_, modelCcys_, modelCurves_, modelFxSpots_, modelIrIndices_, modelInfIndices_, modelIndices_,
         modelIndicesCurrencies_, payCcys_, builder->model(), correlations_, simulationDates_, iborFallbackConfig,
         calibration_, filteredStrikes, mesherEpsilon_, mesherScaling_, mesherConcentration_,
-        mesherMaxConcentratingPoints_, mesherIsStatic_);
+        mesherMaxConcentratingPoints_, mesherIsStatic_, fdThreads_);
     modelBuilders_.insert(std::make_pair(id, builder));
 }
 
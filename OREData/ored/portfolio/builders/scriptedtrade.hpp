@@ -145,11 +145,15 @@ protected:
     bool fullDynamicFx_, fullDynamicIr_, enforceBaseCcy_;
     Size modelSize_, timeStepsPerYear_;
     Model::McParams mcParams_;
+    bool controlVariate_;
+    Real adaptiveTolerance_, adaptiveRelativeTolerance_;
+    Size adaptiveMaxSamples_;
     bool interactive_, zeroVolatility_, continueOnCalibrationError_;
     std::vector<Real> calibrationMoneyness_;
     Real mesherEpsilon_, mesherScaling_, mesherConcentration_;
     Size mesherMaxConcentratingPoints_;
     bool mesherIsStatic_;
+    Integer fdThreads_;
     std::string referenceCalibrationGrid_;
     Real bootstrapTolerance_;
     bool calibrate_;
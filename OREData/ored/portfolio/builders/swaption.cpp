@@ -41,7 +41,8 @@ boost::shared_ptr<PricingEngine> buildMcEngine(const std::function<string(string
                                                const boost::shared_ptr<LGM>& lgm,
                                                const Handle<YieldTermStructure>& discountCurve,
                                                const std::vector<Date>& simulationDates,
-                                               const std::vector<Size>& externalModelIndices) {
+                                               const std::vector<Size>& externalModelIndices, const Size threads,
+                                               const bool controlVariate) {
 
     return boost::make_shared<QuantExt::McMultiLegOptionEngine>(
         lgm, parseSequenceType(engineParameters("Training.Sequence")),
@@ -51,7 +52,8 @@ boost::shared_ptr<PricingEngine> buildMcEngine(const std::function<string(string
         parsePolynomType(engineParameters("Training.BasisFunction")),
         parseSobolBrownianGeneratorOrdering(engineParameters("BrownianBridgeOrdering")),
         parseSobolRsgDirectionIntegers(engineParameters("SobolDirectionIntegers")), discountCurve, simulationDates,
-        externalModelIndices, parseBool(engineParameters("MinObsDate")));
+        externalModelIndices, parseBool(engineParameters("MinObsDate")), McMultiLegBaseEngine::RegressorModel::Simple,
+        threads, controlVariate);
 }
 } // namespace
 
@@ -215,13 +217,23 @@ boost::shared_ptr<PricingEngine> LGMGridBermudanSwaptionEngineBuilder::engineImp
     Size ny = parseInteger(engineParameter("ny"));
     Real sx = parseReal(engineParameter("sx"));
     Size nx = parseInteger(engineParameter("nx"));
+    std::string rollbackMethod = engineParameter("RollbackMethod", {}, false, "Direct");
+    QuantExt::LgmConvolutionSolver2::Method method;
+    if (rollbackMethod == "Direct")
+        method = QuantExt::LgmConvolutionSolver2::Method::Direct;
+    else if (rollbackMethod == "Banded")
+        method = QuantExt::LgmConvolutionSolver2::Method::Banded;
+    else {
+        QL_FAIL("LGMGridBermudanSwaptionEngineBuilder: RollbackMethod '" << rollbackMethod
+                                                                         << "' not recognised, expected Direct, Banded");
+    }
 
     // Build engine
     DLOG("Build engine (configuration " << configuration(MarketContext::pricing) << ")");
     boost::shared_ptr<IborIndex> index;
     std::string ccy = tryParseIborIndex(key, index) ? index->currency().code() : key;
     return boost::make_shared<QuantExt::NumericLgmMultiLegOptionEngine>(
-        lgm, sy, ny, sx, nx, market_->discountCurve(ccy, configuration(MarketContext::pricing)));
+        lgm, sy, ny, sx, nx, market_->discountCurve(ccy, configuration(MarketContext::pricing)), method);
 }
 
 boost::shared_ptr<PricingEngine> LgmMcBermudanSwaptionEngineBuilder::engineImpl(const string& id, const string& key,
@@ -238,7 +250,9 @@ boost::shared_ptr<PricingEngine> LgmMcBermudanSwaptionEngineBuilder::engineImpl(
     std::string ccy = tryParseIborIndex(key, index) ? index->currency().code() : key;
     auto discountCurve = market_->discountCurve(ccy, configuration(MarketContext::pricing));
     return buildMcEngine([this](const std::string& p) { return this->engineParameter(p); }, lgm, discountCurve,
-                         std::vector<Date>(), std::vector<Size>());
+                         std::vector<Date>(), std::vector<Size>(),
+                         parseInteger(engineParameter("Threads", {}, false, "1")),
+                         parseBool(engineParameter("ControlVariate", {}, false, "false")));
 } // LgmMc engineImpl()
 
 boost::shared_ptr<PricingEngine> LgmAmcBermudanSwaptionEngineBuilder::engineImpl(const string& id, const string& key,
@@ -260,7 +274,8 @@ boost::shared_ptr<PricingEngine> LgmAmcBermudanSwaptionEngineBuilder::engineImpl
     // we assume that the given cam has pricing discount curves attached already
     Handle<YieldTermStructure> discountCurve;
     return buildMcEngine([this](const std::string& p) { return this->engineParameter(p); }, lgm, discountCurve,
-                         simulationDates_, modelIndex);
+                         simulationDates_, modelIndex, parseInteger(engineParameter("Threads", {}, false, "1")),
+                         parseBool(engineParameter("ControlVariate", {}, false, "false")));
 } // LgmCam engineImpl
 
 } // namespace data
@@ -26,6 +26,9 @@
 #include <ored/utilities/xmlutils.hpp>
 #include <ql/errors.hpp>
 #include <ql/time/date.hpp>
+#include <qle/utilities/workerpool.hpp>
+
+#include <exception>
 
 using namespace QuantLib;
 using namespace std;
@@ -46,50 +49,134 @@ void Portfolio::reset() {
         t->reset();
 }
 
+namespace {
+
+// result of parsing a single trade node in Portfolio::fromXML()
+struct ParsedTrade {
+    std::string id, tradeType;
+    boost::shared_ptr<Trade> trade;
+    std::string error;
+    // dummy trade with the same id and envelope, if the trade could not be loaded
+    boost::shared_ptr<Trade> failedTrade;
+    std::string failedTradeType, failedTradeError;
+    // errors that are not handled by building a failed trade, rethrown in Portfolio::fromXML()
+    std::exception_ptr exception;
+};
+
+void parseFailedTrade(XMLNode* node, ParsedTrade& p) {
+    try {
+        auto trade = TradeFactory::instance().build("Failed");
+        // this loads only type, id and envelope, but type will be set to the original trade's type
+        trade->fromXML(node);
+        // create a dummy trade of type "Dummy"
+        boost::shared_ptr<FailedTrade> failedTrade = boost::make_shared<FailedTrade>();
+        // copy id and envelope
+        failedTrade->id() = p.id;
+        failedTrade->setUnderlyingTradeType(p.tradeType);
+        failedTrade->envelope() = trade->envelope();
+        p.failedTrade = failedTrade;
+        p.failedTradeType = trade->tradeType();
+    } catch (std::exception& ex) {
+        p.failedTradeError = ex.what();
+    }
+}
+
+ParsedTrade parseTrade(XMLNode* node, const bool buildFailedTrades) {
+    ParsedTrade p;
+    try {
+        p.tradeType = XMLUtils::getChildValue(node, "TradeType", true);
+
+        // Get the id attribute
+        p.id = XMLUtils::getAttribute(node, "id");
+        QL_REQUIRE(p.id != "", "No id attribute in Trade Node");
+        DLOG("Parsing trade id:" << p.id);
+
+        try {
+            p.trade = TradeFactory::instance().build(p.tradeType);
+            p.trade->fromXML(node);
+            p.trade->id() = p.id;
+        } catch (std::exception& ex) {
+            p.trade = nullptr;
+            p.error = ex.what();
+        }
+
+        // If trade loading failed, then prepare a dummy trade with same id and envelope
+        if (!p.trade && buildFailedTrades)
+            parseFailedTrade(node, p);
+    } catch (...) {
+        p.exception = std::current_exception();
+    }
+    return p;
+}
+
+} // namespace
+
 void Portfolio::fromXML(XMLNode* node) {
     XMLUtils::checkNode(node, "Portfolio");
     vector<XMLNode*> nodes = XMLUtils::getChildrenNodes(node, "Trade");
+
+    /* parse the trade nodes, concurrently if several threads are available; this requires thread local QuantLib
+       singletons, since the trades' fromXML() may read the Settings and the IndexManager */
+
+    std::vector<ParsedTrade> parsed(nodes.size());
+    Size nThreads = std::min<Size>(nThreads_, nodes.size());
+#ifndef QL_ENABLE_SESSIONS
+    if (nThreads > 1) {
+        DLOG("Portfolio::fromXML(): parallel parsing requires a build with QL_ENABLE_SESSIONS = ON, parse "
+             << nodes.size() << " trades sequentially");
+        nThreads = 1;
+    }
+#endif
+    if (nThreads > 1) {
+        LOG("Parsing " << nodes.size() << " trades using " << nThreads << " threads");
+        QuantExt::WorkerPool pool(nThreads);
+        pool.run(nodes.size(),
+                 [&nodes, &parsed, this](Size i) { parsed[i] = parseTrade(nodes[i], buildFailedTrades_); });
+    } else {
+        for (Size i = 0; i < nodes.size(); i++)
+            parsed[i] = parseTrade(nodes[i], buildFailedTrades_);
+    }
+
+    // add the trades to the portfolio and log errors in the order of the trade nodes
+
     for (Size i = 0; i < nodes.size(); i++) {
-        string tradeType = XMLUtils::getChildValue(nodes[i], "TradeType", true);
+        ParsedTrade& p = parsed[i];
+        if (p.exception)
+            std::rethrow_exception(p.exception);
 
-        // Get the id attribute
-        string id = XMLUtils::getAttribute(nodes[i], "id");
-        QL_REQUIRE(id != "", "No id attribute in Trade Node");
-        DLOG("Parsing trade id:" << id);
-        
-        boost::shared_ptr<Trade> trade;
         bool failedToLoad = true;
-        try {
-            trade = TradeFactory::instance().build(tradeType);
-            trade->fromXML(nodes[i]);
-            trade->id() = id;
-            add(trade);
-            DLOG("Added Trade " << id << " (" << trade->id() << ")"
-                                << " type:" << tradeType);
-            failedToLoad = false;
-        } catch (std::exception& ex) {
-            StructuredTradeErrorMessage(id, tradeType, "Error parsing Trade XML", ex.what()).log();
+        if (p.trade) {
+            try {
+                add(p.trade);
+                DLOG("Added Trade " << p.id << " (" << p.trade->id() << ")"
+                                    << " type:" << p.tradeType);
+                failedToLoad = false;
+            } catch (std::exception& ex) {
+                p.error = ex.what();
+            }
         }
+        if (!failedToLoad)
+            continue;
+
+        StructuredTradeErrorMessage(p.id, p.tradeType, "Error parsing Trade XML", p.error).log();
 
         // If trade loading failed, then insert a dummy trade with same id and envelope
-        if (failedToLoad && buildFailedTrades_) {
-            try {
-                trade = TradeFactory::instance().build("Failed");
-                // this loads only type, id and envelope, but type will be set to the original trade's type
-                trade->fromXML(nodes[i]);
-                // create a dummy trade of type "Dummy"
-                boost::shared_ptr<FailedTrade> failedTrade = boost::make_shared<FailedTrade>();
-                // copy id and envelope
-                failedTrade->id() = id;
-                failedTrade->setUnderlyingTradeType(tradeType);
-                failedTrade->envelope() = trade->envelope();
-                // and add it to the portfolio
-                add(failedTrade);
-                WLOG("Added trade id " << failedTrade->id() << " type " << failedTrade->tradeType()
-                                       << " for original trade type " << trade->tradeType());
-            } catch (std::exception& ex) {
-                StructuredTradeErrorMessage(id, tradeType, "Error parsing type and envelope", ex.what()).log();
+        if (buildFailedTrades_) {
+            if (!p.failedTrade && p.failedTradeError.empty())
+                parseFailedTrade(nodes[i], p);
+            if (p.failedTrade) {
+                try {
+                    // and add it to the portfolio
+                    add(p.failedTrade);
+                    WLOG("Added trade id " << p.failedTrade->id() << " type " << p.failedTrade->tradeType()
+                                           << " for original trade type " << p.failedTradeType);
+                } catch (std::exception& ex) {
+                    p.failedTradeError = ex.what();
+                }
             }
+            if (!p.failedTradeError.empty())
+                StructuredTradeErrorMessage(p.id, p.tradeType, "Error parsing type and envelope", p.failedTradeError)
+                    .log();
         }
     }
     LOG("Finished Parsing XML doc");
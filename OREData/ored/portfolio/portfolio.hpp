@@ -42,8 +42,11 @@ class ReferenceDataManager;
 */
 class Portfolio : public XMLSerializable {
 public:
-    //! Default constructor
-    explicit Portfolio(bool buildFailedTrades = true) : buildFailedTrades_(buildFailedTrades) {}
+    /*! Default constructor, if nThreads > 1 and QL_ENABLE_SESSIONS is defined the trade nodes are parsed
+        concurrently in fromXML(), the trades are added to the portfolio and errors are logged in the order of the
+        trade nodes though. The build() is always sequential. */
+    explicit Portfolio(bool buildFailedTrades = true, QuantLib::Size nThreads = 1)
+        : buildFailedTrades_(buildFailedTrades), nThreads_(nThreads) {}
 
     //! Add a trade to the portfolio
     void add(const boost::shared_ptr<Trade>& trade);
@@ -126,6 +129,7 @@ public:
 
 private:
     bool buildFailedTrades_;
+    QuantLib::Size nThreads_;
     std::map<std::string, boost::shared_ptr<Trade>> trades_;
     std::map<AssetClass, std::set<std::string>> underlyingIndicesCache_;
 };
@@ -24,6 +24,7 @@
 #include <ored/utilities/log.hpp>
 
 #include <qle/instruments/cashflowresults.hpp>
+#include <qle/math/mcvariancereduction.hpp>
 #include <qle/math/randomvariable.hpp>
 
 namespace ore {
@@ -57,12 +58,32 @@ Real ScriptedInstrumentPricingEngine::addMcErrorEstimate(const std::string& labe
         return Null<Real>();
     if (v.which() != ValueTypeWhich::Number)
         return Null<Real>();
-    Real var = variance(boost::get<RandomVariable>(v)).at(0);
-    Real errEst = std::sqrt(var / static_cast<double>(model_->size()));
+    Real errEst = QuantExt::mcErrorEstimate(boost::get<RandomVariable>(v), model_->antitheticPaths());
     results_.additionalResults[label] = errEst;
     return errEst;
 }
 
+Real ScriptedInstrumentPricingEngine::npvEstimate(const RandomVariable& npv, Real* errorEstimate) const {
+    if (model_->type() != Model::Type::MC) {
+        if (errorEstimate != nullptr)
+            *errorEstimate = Null<Real>();
+        return model_->extractT0Result(npv);
+    }
+    if (controlVariate_) {
+        // use the control variates provided by the model
+        std::vector<RandomVariable> controls;
+        std::vector<Real> controlMeans;
+        for (auto const& c : model_->controlVariates()) {
+            controls.push_back(c.first);
+            controlMeans.push_back(c.second);
+        }
+        return QuantExt::controlVariateMean(npv, controls, controlMeans, model_->antitheticPaths(), errorEstimate);
+    }
+    if (errorEstimate != nullptr)
+        *errorEstimate = QuantExt::mcErrorEstimate(npv, model_->antitheticPaths());
+    return model_->extractT0Result(npv);
+}
+
 void ScriptedInstrumentPricingEngine::calculate() const {
 
     lastCalculationWasValid_ = false;
@@ -103,6 +124,15 @@ void ScriptedInstrumentPricingEngine::calculate() const {
         trainingEngine.run(script_, interactive_);
     }
 
+    // keep a copy of the initial context if we run the script on several batches of paths below
+
+    bool adaptive = model_->type() == Model::Type::MC && !amcEnabled_ &&
+                    (tolerance_ != Null<Real>() || relativeTolerance_ != Null<Real>()) &&
+                    maxSamples_ != Null<Size>() && maxSamples_ > model_->size();
+    boost::shared_ptr<Context> initialContext;
+    if (adaptive)
+        initialContext = boost::make_shared<Context>(*workingContext);
+
     // set up script engine and run it
 
     ScriptEngine engine(ast_, workingContext, model_);
@@ -116,13 +146,54 @@ void ScriptedInstrumentPricingEngine::calculate() const {
                "did not find npv result variable '" << npv_ << "' as scalar in context");
     QL_REQUIRE(npv->second.which() == ValueTypeWhich::Number,
                "result variable '" << npv_ << "' must be of type NUMBER, got " << npv->second.which());
-    results_.value = model_->extractT0Result(boost::get<RandomVariable>(npv->second));
+
+    Real npvErrorEstimate = Null<Real>();
+    results_.value = npvEstimate(boost::get<RandomVariable>(npv->second),
+                                 adaptive || controlVariate_ ? &npvErrorEstimate : nullptr);
+
+    // in adaptive mode run the script on further batches of paths until the requested accuracy is reached, the
+    // batch estimates are independent, so the error of their average is sqrt(sum of squared errors) / #batches
+
+    Size samples = model_->size();
+    if (adaptive) {
+        auto tolerance = [this](const Real value) {
+            return std::max(tolerance_ == Null<Real>() ? 0.0 : tolerance_,
+                            relativeTolerance_ == Null<Real>() ? 0.0 : relativeTolerance_ * std::abs(value));
+        };
+        Real sumEstimates = results_.value, sumSquaredErrors = npvErrorEstimate * npvErrorEstimate;
+        Size batches = 1;
+        while (npvErrorEstimate > tolerance(results_.value) && samples + model_->size() <= maxSamples_ &&
+               model_->nextPathBatch()) {
+            workingContext = boost::make_shared<Context>(*initialContext);
+            paylog = boost::make_shared<PayLog>();
+            ScriptEngine batchEngine(ast_, workingContext, model_);
+            batchEngine.run(script_, interactive_, paylog);
+            npv = workingContext->scalars.find(npv_);
+            Real batchErrorEstimate;
+            sumEstimates += npvEstimate(boost::get<RandomVariable>(npv->second), &batchErrorEstimate);
+            sumSquaredErrors += batchErrorEstimate * batchErrorEstimate;
+            ++batches;
+            samples += model_->size();
+            results_.value = sumEstimates / static_cast<Real>(batches);
+            npvErrorEstimate = std::sqrt(sumSquaredErrors) / static_cast<Real>(batches);
+        }
+        DLOG("adaptive mc: used " << samples << " samples in " << batches << " batches, error estimate "
+                                  << npvErrorEstimate << ", tolerance " << tolerance(results_.value));
+    }
+
     DLOG("got NPV = " << results_.value << " " << model_->baseCcy());
 
     // set additional results, if this feature is enabled
 
     if (generateAdditionalResults_) {
-        results_.errorEstimate = addMcErrorEstimate("NPV_MCErrEst", npv->second);
+        if (npvErrorEstimate != Null<Real>()) {
+            results_.errorEstimate = npvErrorEstimate;
+            results_.additionalResults["NPV_MCErrEst"] = npvErrorEstimate;
+        } else {
+            results_.errorEstimate = addMcErrorEstimate("NPV_MCErrEst", npv->second);
+        }
+        if (adaptive)
+            results_.additionalResults["NPV_MCSamples"] = samples;
         for (auto const& r : additionalResults_) {
             auto s = workingContext->scalars.find(r.second);
             bool resultSet = false;
@@ -184,12 +255,13 @@ void ScriptedInstrumentPricingEngine::calculate() const {
         paylog->consolidateAndSort();
         std::vector<CashFlowResults> cashFlowResults(paylog->size());
         std::map<Size, Size> cashflowNumber;
+        std::vector<Real> t0Amounts = model_->extractT0Results(paylog->amounts());
         for (Size i = 0; i < paylog->size(); ++i) {
             // cashflow is written as expectation of deflated base ccy amount at T0, converted to flow ccy
             // with the T0 FX Spot and compounded back to the pay date on T0 curves
             Real fx = model_->fxSpotT0(paylog->currencies().at(i), model_->baseCcy());
             Real discount = model_->discount(referenceDate, paylog->dates().at(i), paylog->currencies().at(i)).at(0);
-            cashFlowResults[i].amount = model_->extractT0Result(paylog->amounts().at(i)) / fx / discount;
+            cashFlowResults[i].amount = t0Amounts[i] / fx / discount;
             cashFlowResults[i].payDate = paylog->dates().at(i);
             cashFlowResults[i].currency = paylog->currencies().at(i);
             cashFlowResults[i].legNumber = paylog->legNos().at(i);
@@ -32,6 +32,11 @@
 namespace ore {
 namespace data {
 
+/*! If a tolerance is given for a MC model and maxSamples is greater than the model size, the script is run on
+    batches of model size paths until the standard error of the npv is below max(tolerance, relativeTolerance * |npv|)
+    or maxSamples is reached. The npv is the average of the batch estimates in this case, all other additional results
+    refer to the paths of the last batch. The adaptive mode is not used for amc enabled engines and requires a model
+    that supports Model::nextPathBatch(). */
 class ScriptedInstrumentPricingEngine : public QuantExt::ScriptedInstrument::engine {
 public:
     ScriptedInstrumentPricingEngine(
@@ -39,10 +44,14 @@ public:
         const boost::shared_ptr<Model>& model, const ASTNodePtr ast, const boost::shared_ptr<Context>& context,
         const std::string& script = "", const bool interactive = false,
         const bool amcEnabled = false,
-        const std::set<std::string>& amcStickyCloseOutStates = {}, const bool generateAdditionalResults = false)
+        const std::set<std::string>& amcStickyCloseOutStates = {}, const bool generateAdditionalResults = false,
+        const bool controlVariate = false, const Real tolerance = Null<Real>(),
+        const Real relativeTolerance = Null<Real>(), const Size maxSamples = Null<Size>())
         : npv_(npv), additionalResults_(additionalResults), model_(model), ast_(ast), context_(context),
           script_(script), interactive_(interactive), amcEnabled_(amcEnabled),
-          amcStickyCloseOutStates_(amcStickyCloseOutStates), generateAdditionalResults_(generateAdditionalResults) {
+          amcStickyCloseOutStates_(amcStickyCloseOutStates), generateAdditionalResults_(generateAdditionalResults),
+          controlVariate_(controlVariate), tolerance_(tolerance), relativeTolerance_(relativeTolerance),
+          maxSamples_(maxSamples) {
         registerWith(model_);
     }
 
@@ -51,6 +60,8 @@ public:
 private:
     void calculate() const override;
     Real addMcErrorEstimate(const std::string& label, const ValueType& v) const;
+    // T0 npv estimate, if errorEstimate is not null, it is set to the mc error (or null for non-mc models)
+    Real npvEstimate(const RandomVariable& npv, Real* errorEstimate) const;
 
     // calculation state, true iff calculate() was called at least once and last call went without errors
     mutable bool lastCalculationWasValid_ = false;
@@ -65,6 +76,9 @@ private:
     const bool amcEnabled_;
     const std::set<std::string> amcStickyCloseOutStates_;
     const bool generateAdditionalResults_;
+    const bool controlVariate_;
+    const Real tolerance_, relativeTolerance_;
+    const Size maxSamples_;
 };
 
 } // namespace data
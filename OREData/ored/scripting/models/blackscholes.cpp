@@ -26,6 +26,8 @@
 #include <ql/math/matrixutilities/pseudosqrt.hpp>
 #include <ql/math/matrixutilities/symmetricschurdecomposition.hpp>
 
+#include <algorithm>
+
 namespace ore {
 namespace data {
 
@@ -62,14 +64,14 @@ void BlackScholes::performCalculations() const {
     if (indices_.empty())
         return;
 
-    // init underlying path where we map a date to a randomvariable representing the path values
+    // init underlying path where we map a date index to a randomvariable representing the path values
 
-    for (auto const& d : effectiveSimulationDates_) {
-        underlyingPaths_[d] = std::vector<RandomVariable>(model_->processes().size(), RandomVariable(size(), 0.0));
-        if (trainingSamples() != Null<Size>())
-            underlyingPathsTraining_[d] =
-                std::vector<RandomVariable>(model_->processes().size(), RandomVariable(trainingSamples(), 0.0));
-    }
+    underlyingPaths_.assign(effectiveSimulationDates_.size(),
+                            std::vector<RandomVariable>(model_->processes().size(), RandomVariable(size(), 0.0)));
+    if (trainingSamples() != Null<Size>())
+        underlyingPathsTraining_.assign(
+            effectiveSimulationDates_.size(),
+            std::vector<RandomVariable>(model_->processes().size(), RandomVariable(trainingSamples(), 0.0)));
 
     // compile the correlation matrix
 
@@ -98,9 +100,9 @@ void BlackScholes::performCalculations() const {
     // set reference date values, if there are no future simulation dates we are done
 
     for (Size l = 0; l < indices_.size(); ++l) {
-        underlyingPaths_[*effectiveSimulationDates_.begin()][l].setAll(model_->processes()[l]->x0());
+        underlyingPaths_[0][l].setAll(model_->processes()[l]->x0());
         if (trainingSamples() != Null<Size>()) {
-            underlyingPathsTraining_[*effectiveSimulationDates_.begin()][l].setAll(model_->processes()[l]->x0());
+            underlyingPathsTraining_[0][l].setAll(model_->processes()[l]->x0());
         }
     }
 
@@ -198,11 +200,13 @@ void BlackScholes::performCalculations() const {
 
     // evolve the process using correlated normal variates and set the underlying path values
 
-    populatePathValues(size(), underlyingPaths_,
-                       makeMultiPathVariateGenerator(mcParams_.sequenceType, indices_.size(),
-                                                     effectiveSimulationDates_.size() - 1, mcParams_.seed,
-                                                     mcParams_.sobolOrdering, mcParams_.sobolDirectionIntegers),
-                       drift, sqrtCov);
+    auto gen = makeMultiPathVariateGenerator(mcParams_.sequenceType, indices_.size(),
+                                             effectiveSimulationDates_.size() - 1, mcParams_.seed,
+                                             mcParams_.sobolOrdering, mcParams_.sobolDirectionIntegers);
+    populatePathValues(size(), underlyingPaths_, gen, drift, sqrtCov);
+    nextPathBatch_ = [this, gen, drift, sqrtCov]() {
+        populatePathValues(size(), underlyingPaths_, gen, drift, sqrtCov);
+    };
 
     if (trainingSamples() != Null<Size>()) {
         populatePathValues(trainingSamples(), underlyingPathsTraining_,
@@ -244,37 +248,56 @@ void BlackScholes::performCalculations() const {
     }
 }
 
-void BlackScholes::populatePathValues(const Size nSamples, std::map<Date, std::vector<RandomVariable>>& paths,
+void BlackScholes::populatePathValues(const Size nSamples, std::vector<std::vector<RandomVariable>>& paths,
                                       const boost::shared_ptr<MultiPathVariateGeneratorBase>& gen,
                                       const std::vector<Array>& drift, const std::vector<Matrix>& sqrtCov) const {
 
     std::vector<std::vector<RandomVariable*>> rvs(indices_.size(),
                                                   std::vector<RandomVariable*>(effectiveSimulationDates_.size() - 1));
-    auto date = effectiveSimulationDates_.begin();
     for (Size i = 0; i < effectiveSimulationDates_.size() - 1; ++i) {
-        ++date;
         for (Size j = 0; j < indices_.size(); ++j) {
-            rvs[j][i] = &paths[*date][j];
+            rvs[j][i] = &paths[i + 1][j];
             rvs[j][i]->expand();
         }
     }
 
-    Array logState(indices_.size()), logState0(indices_.size());
+    Array logState0(indices_.size());
     for (Size j = 0; j < indices_.size(); ++j) {
         logState0[j] = std::log(model_->processes()[j]->x0());
     }
 
-    for (Size path = 0; path < nSamples; ++path) {
-        auto seq = gen->next();
-        logState = logState0;
-        for (Size i = 0; i < effectiveSimulationDates_.size() - 1; ++i) {
-            for (Size j = 0; j < indices_.size(); ++j) {
-                for (Size k = 0; k < indices_.size(); ++k)
-                    logState[j] += sqrtCov[i][j][k] * seq.value[i][k];
+    // the paths are generated in blocks, within a block the log states of all paths are evolved date by date, so
+    // that the path values of an index and date are written contiguously
+
+    const Size blockSize = 256;
+    Size nDates = effectiveSimulationDates_.size() - 1, nIndices = indices_.size();
+    std::vector<std::vector<Array>> variates(blockSize);
+    std::vector<Real> logState(nIndices * blockSize); // by index and path within the block
+
+    for (Size firstPath = 0; firstPath < nSamples; firstPath += blockSize) {
+        Size nb = std::min(blockSize, nSamples - firstPath);
+        for (Size b = 0; b < nb; ++b)
+            variates[b] = gen->next().value;
+        for (Size j = 0; j < nIndices; ++j)
+            std::fill(&logState[j * blockSize], &logState[j * blockSize] + nb, logState0[j]);
+        for (Size i = 0; i < nDates; ++i) {
+            for (Size j = 0; j < nIndices; ++j) {
+                Real* s = &logState[j * blockSize];
+                for (Size k = 0; k < nIndices; ++k) {
+                    Real c = sqrtCov[i][j][k];
+                    // skip the zero entries of the (triangular) square root
+                    if (c == 0.0)
+                        continue;
+                    for (Size b = 0; b < nb; ++b)
+                        s[b] += c * variates[b][i][k];
+                }
+                Real d = drift[i][j];
+                Real* v = rvs[j][i]->data() + firstPath;
+                for (Size b = 0; b < nb; ++b) {
+                    s[b] += d;
+                    v[b] = std::exp(s[b]);
+                }
             }
-            logState += drift[i];
-            for (Size j = 0; j < indices_.size(); ++j)
-                rvs[j][i]->data()[path] = std::exp(logState[j]);
         }
     }
 } // populatePathValues()
@@ -30,6 +30,8 @@
 #include <ql/math/comparison.hpp>
 #include <ql/quotes/simplequote.hpp>
 
+#include <algorithm>
+
 namespace ore {
 namespace data {
 
@@ -120,6 +122,7 @@ void BlackScholesBase::performCalculations() const {
     // set up time grid
 
     effectiveSimulationDates_ = model_->effectiveSimulationDates();
+    simulationDateIndex_.assign(effectiveSimulationDates_.begin(), effectiveSimulationDates_.end());
 
     std::vector<Real> times;
     for (auto const& d : effectiveSimulationDates_) {
@@ -133,6 +136,7 @@ void BlackScholesBase::performCalculations() const {
 
     underlyingPaths_.clear();
     underlyingPathsTraining_.clear();
+    nextPathBatch_ = nullptr;
 }
 
 RandomVariable BlackScholesBase::getIndexValue(const Size indexNo, const Date& d, const Date& fwd) const {
@@ -147,8 +151,7 @@ RandomVariable BlackScholesBase::getIndexValue(const Size indexNo, const Date& d
         // TOOD should we throw an exception instead?
         effFwd = std::max(effFwd, d);
     }
-    QL_REQUIRE(underlyingPaths_.find(d) != underlyingPaths_.end(), "did not find path for " << d);
-    auto res = underlyingPaths_.at(d).at(indexNo);
+    auto res = underlyingPaths_.at(dateIndex(d)).at(indexNo);
     // compute forwarding factor
     if (effFwd != Null<Date>()) {
         auto p = model_->processes().at(indexNo);
@@ -245,7 +248,7 @@ RandomVariable BlackScholesBase::npv(const RandomVariable& amount, const Date& o
     std::vector<const RandomVariable*> state;
 
     if (!underlyingPaths_.empty()) {
-        for (auto const& r : underlyingPaths_.at(obsdate))
+        for (auto const& r : underlyingPaths_.at(dateIndex(obsdate)))
             state.push_back(&r);
     }
 
@@ -307,11 +310,25 @@ void BlackScholesBase::releaseMemory() {
 
 void BlackScholesBase::resetNPVMem() { storedRegressionCoeff_.clear(); }
 
+bool BlackScholesBase::nextPathBatch() const {
+    calculate();
+    if (!nextPathBatch_ || inTrainingPhase_ || underlyingPaths_.empty())
+        return false;
+    nextPathBatch_();
+    return true;
+}
+
 void BlackScholesBase::toggleTrainingPaths() const {
     std::swap(underlyingPaths_, underlyingPathsTraining_);
     inTrainingPhase_ = !inTrainingPhase_;
 }
 
+Size BlackScholesBase::dateIndex(const Date& d) const {
+    auto it = std::lower_bound(simulationDateIndex_.begin(), simulationDateIndex_.end(), d);
+    QL_REQUIRE(it != simulationDateIndex_.end() && *it == d, "did not find path for " << d);
+    return std::distance(simulationDateIndex_.begin(), it);
+}
+
 Size BlackScholesBase::trainingSamples() const { return mcParams_.trainingSamples; }
 
 Size BlackScholesBase::size() const {
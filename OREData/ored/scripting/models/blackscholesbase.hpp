@@ -32,6 +32,8 @@
 #include <ql/processes/blackscholesprocess.hpp>
 #include <ql/timegrid.hpp>
 
+#include <functional>
+
 namespace ore {
 namespace data {
 
@@ -66,6 +68,9 @@ public:
 
     // Model interface implementation
     Type type() const override { return Type::MC; }
+    bool antitheticPaths() const override {
+        return mcParams_.sequenceType == QuantExt::SequenceType::MersenneTwisterAntithetic;
+    }
     const Date& referenceDate() const override;
     RandomVariable npv(const RandomVariable& amount, const Date& obsdate, const Filter& filter,
                        const boost::optional<long>& memSlot, const RandomVariable& addRegressor1,
@@ -78,6 +83,7 @@ public:
     void releaseMemory() override;
     void resetNPVMem() override;
     void toggleTrainingPaths() const override;
+    bool nextPathBatch() const override;
     Size trainingSamples() const override;
     Size size() const override;
 
@@ -94,6 +100,9 @@ protected:
     // helper function that constructs the correlation matrix
     Matrix getCorrelation() const;
 
+    // position of a date in effectiveSimulationDates_ resp. in the outer vector of underlyingPaths_
+    Size dateIndex(const Date& d) const;
+
     // input parameters
     const std::vector<Handle<YieldTermStructure>> curves_;
     const std::vector<Handle<Quote>> fxSpots_;
@@ -107,9 +116,12 @@ protected:
     mutable std::set<Date> effectiveSimulationDates_; // the dates effectively simulated (including today)
     mutable TimeGrid timeGrid_;                       // the (possibly refined) time grid for the simulation
     mutable std::vector<Size> positionInTimeGrid_;    // for each effective simulation date the index in the time grid
-    mutable std::map<Date, std::vector<RandomVariable>> underlyingPaths_;         // per simulation date index states
-    mutable std::map<Date, std::vector<RandomVariable>> underlyingPathsTraining_; // ditto (training phase)
+    mutable std::vector<Date> simulationDateIndex_;   // the effective simulation dates as a sorted vector
+    // per effective simulation date (in the order of simulationDateIndex_) index states
+    mutable std::vector<std::vector<RandomVariable>> underlyingPaths_;
+    mutable std::vector<std::vector<RandomVariable>> underlyingPathsTraining_; // ditto (training phase)
     mutable bool inTrainingPhase_ = false; // are we currently using training paths?
+    mutable std::function<void()> nextPathBatch_; // set in derived classes, populates the next batch of paths
 
     // stored regression coefficients
     mutable std::map<long, std::pair<Array, Size>> storedRegressionCoeff_;
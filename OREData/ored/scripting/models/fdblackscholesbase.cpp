@@ -20,7 +20,7 @@
 #include <ored/scripting/utilities.hpp>
 
 #include <qle/methods/fdmblackscholesmesher.hpp>
-#include <qle/methods/fdmblackscholesop.hpp>
+#include <qle/utilities/workerpool.hpp>
 
 #include <ored/utilities/indexparser.hpp>
 #include <ored/utilities/to_string.hpp>
@@ -33,8 +33,11 @@
 #include <ql/math/comparison.hpp>
 #include <ql/math/interpolations/cubicinterpolation.hpp>
 #include <ql/methods/finitedifferences/meshers/fdmmeshercomposite.hpp>
+#include <ql/methods/finitedifferences/solvers/fdmbackwardsolver.hpp>
 #include <ql/quotes/simplequote.hpp>
 
+#include <algorithm>
+
 namespace ore {
 namespace data {
 
@@ -48,11 +51,12 @@ FdBlackScholesBase::FdBlackScholesBase(const Size stateGridPoints, const std::st
                                        const IborFallbackConfig& iborFallbackConfig, const std::string& calibration,
                                        const std::vector<Real>& calibrationStrikes, const Real mesherEpsilon,
                                        const Real mesherScaling, const Real mesherConcentration,
-                                       const Size mesherMaxConcentratingPoints, const bool staticMesher)
+                                       const Size mesherMaxConcentratingPoints, const bool staticMesher,
+                                       const Size threads)
     : FdBlackScholesBase(stateGridPoints, {currency}, {curve}, {}, {}, {}, {index}, {indexCurrency}, {currency}, model,
                          {}, simulationDates, iborFallbackConfig, calibration, {{index, calibrationStrikes}},
-                         mesherEpsilon, mesherScaling, mesherConcentration, mesherMaxConcentratingPoints,
-                         staticMesher) {}
+                         mesherEpsilon, mesherScaling, mesherConcentration, mesherMaxConcentratingPoints, staticMesher,
+                         threads) {}
 
 FdBlackScholesBase::FdBlackScholesBase(
     const Size stateGridPoints, const std::vector<std::string>& currencies,
@@ -65,17 +69,18 @@ FdBlackScholesBase::FdBlackScholesBase(
     const std::set<Date>& simulationDates, const IborFallbackConfig& iborFallbackConfig, const std::string& calibration,
     const std::map<std::string, std::vector<Real>>& calibrationStrikes, const Real mesherEpsilon,
     const Real mesherScaling, const Real mesherConcentration, const Size mesherMaxConcentratingPoints,
-    const bool staticMesher)
+    const bool staticMesher, const Size threads)
     : ModelImpl(curves.at(0)->dayCounter(), stateGridPoints, currencies, irIndices, infIndices, indices,
                 indexCurrencies, simulationDates, iborFallbackConfig),
       curves_(curves), fxSpots_(fxSpots), payCcys_(payCcys), model_(model), correlations_(correlations),
       calibration_(calibration), calibrationStrikes_(calibrationStrikes), mesherEpsilon_(mesherEpsilon),
       mesherScaling_(mesherScaling), mesherConcentration_(mesherConcentration),
-      mesherMaxConcentratingPoints_(mesherMaxConcentratingPoints), staticMesher_(staticMesher) {
+      mesherMaxConcentratingPoints_(mesherMaxConcentratingPoints), staticMesher_(staticMesher), threads_(threads) {
 
     // check inputs
 
     QL_REQUIRE(!model_.empty(), "model is empty");
+    QL_REQUIRE(threads_ > 0, "threads must be positive");
     QL_REQUIRE(!curves_.empty(), "no curves given");
     QL_REQUIRE(currencies_.size() == curves_.size(), "number of currencies (" << currencies_.size()
                                                                               << ") does not match number of curves ("
@@ -173,6 +178,7 @@ const Date& FdBlackScholesBase::referenceDate() const {
 void FdBlackScholesBase::performCalculations() const {
 
     referenceDate_ = curves_.front()->referenceDate();
+    stepOperators_.clear();
 
     // 0a set up time grid
 
@@ -263,10 +269,9 @@ void FdBlackScholesBase::performCalculations() const {
         boost::make_shared<QuantExt::FdmBlackScholesOp>(mesher_, model_->processes()[0], calibrationStrikes[0], false,
                                                         -static_cast<Real>(Null<Real>()), 0, quantoHelper, false, true);
 
-    // 4 set up bwd solver, hardcoded Douglas scheme (= CrankNicholson)
+    // 4 the operators per time step are computed on demand in stepOperator()
 
-    solver_ = boost::make_shared<FdmBackwardSolver>(
-        operator_, std::vector<boost::shared_ptr<BoundaryCondition<FdmLinearOp>>>(), nullptr, FdmSchemeDesc::Douglas());
+    stepOperators_.resize(timeGrid_.size() - 1);
 
     // 5 fill random variable with underlying values, these are valid for all times
 
@@ -404,55 +409,112 @@ RandomVariable FdBlackScholesBase::npv(const RandomVariable& amount, const Date&
     QL_REQUIRE(!addRegressor1.initialised(), "FdBlackScholesBase::npv(). addRegressor1 not allowed");
     QL_REQUIRE(!addRegressor2.initialised(), "FdBlackScholesBase::npv(). addRegressor2 not allowed");
 
+    return rollback(std::vector<RandomVariable>(1, amount), obsdate).front();
+}
+
+std::vector<RandomVariable> FdBlackScholesBase::rollback(const std::vector<RandomVariable>& amounts,
+                                                         const Date& obsdate) const {
+
     calculate();
 
-    Real t1 = amount.time();
     Real t0 = curves_.front()->timeFromReference(obsdate);
+    std::vector<RandomVariable> result(amounts.size());
 
-    // handle case when amount is deterministic
+    // handle deterministic amounts and collect the stochastic amounts that need a rollback
 
-    if (amount.deterministic()) {
-        RandomVariable result(amount);
-        result.setTime(t0);
-        return result;
-    }
+    Size ind0 = Null<Size>();
+    std::vector<Size> rolledBack, ind1;
+    for (Size i = 0; i < amounts.size(); ++i) {
 
-    // handle stochastic amount
+        // handle case when amount is deterministic
 
-    QL_REQUIRE(t1 != Null<Real>(),
-               "FdBlackScholesBase::npv(): can not roll back amount wiithout time attached (to t0=" << t0 << ")");
-    calculate();
+        if (amounts[i].deterministic()) {
+            result[i] = amounts[i];
+            result[i].setTime(t0);
+            continue;
+        }
 
-    // might throw if t0, t1 are not found in timeGrid_
+        // handle stochastic amount
 
-    Size ind1 = timeGrid_.index(t1);
-    Size ind0 = timeGrid_.index(t0);
+        Real t1 = amounts[i].time();
+        QL_REQUIRE(t1 != Null<Real>(),
+                   "FdBlackScholesBase::npv(): can not roll back amount wiithout time attached (to t0=" << t0 << ")");
 
-    // check t0 <= t1, i.e. ind0 <= ind1
+        // might throw if t0, t1 are not found in timeGrid_
 
-    QL_REQUIRE(ind0 <= ind1, "FdBlackScholesBase::npv(): can not roll back from t1= "
-                                 << t1 << " (index " << ind1 << ") to t0= " << t0 << " (" << ind0 << ")");
+        Size i1 = timeGrid_.index(t1);
+        if (ind0 == Null<Size>())
+            ind0 = timeGrid_.index(t0);
 
-    // if t0 = t1, no rollback is necessary and we can return the input random variable
+        // check t0 <= t1, i.e. ind0 <= ind1
 
-    if (ind0 == ind1)
-        return amount;
+        QL_REQUIRE(ind0 <= i1, "FdBlackScholesBase::npv(): can not roll back from t1= "
+                                   << t1 << " (index " << i1 << ") to t0= " << t0 << " (" << ind0 << ")");
 
-    // if t0 < t1, we roll back on the time grid
+        // if t0 = t1, no rollback is necessary and we can return the input random variable
 
-    Array workingArray(amount.size());
-    amount.copyToArray(workingArray);
+        if (ind0 == i1) {
+            result[i] = amounts[i];
+            continue;
+        }
 
-    for (int j = static_cast<int>(ind1) - 1; j >= static_cast<int>(ind0); --j) {
-        solver_->rollback(workingArray, timeGrid_[j + 1], timeGrid_[j], 1, 0);
+        rolledBack.push_back(i);
+        ind1.push_back(i1);
     }
 
-    // return the rolled back value
+    if (rolledBack.empty())
+        return result;
+
+    // set up the operators for all time steps in [t0, max t1], this is done single threaded since it modifies the
+    // state of the operator_, afterwards the operators are only read
+
+    Size maxInd1 = *std::max_element(ind1.begin(), ind1.end());
+    for (Size j = ind0; j < maxInd1; ++j)
+        stepOperator(j);
+
+    // roll back each amount on the time grid, with the same Douglas scheme (= CrankNicholson) step as in
+    // QuantLib::FdmBackwardSolver
+
+    const Real theta = FdmSchemeDesc::Douglas().theta;
+    auto rollbackAmount = [this, &amounts, &rolledBack, &ind1, ind0, t0, theta, &result](const Size k) {
+        Array workingArray(amounts[rolledBack[k]].size());
+        amounts[rolledBack[k]].copyToArray(workingArray);
+        for (Size j = ind1[k]; j > ind0; --j) {
+            const TripleBandLinearOp& op = *stepOperators_[j - 1];
+            Real dt = timeGrid_[j] - timeGrid_[j - 1];
+            Array tmp = op.apply(workingArray);
+            Array rhs = workingArray + dt * tmp;
+            rhs -= theta * dt * tmp;
+            workingArray = op.solve_splitting(rhs, -theta * dt, 1.0);
+        }
+        result[rolledBack[k]] = RandomVariable(workingArray, t0);
+    };
 
-    return RandomVariable(workingArray, t0);
+    if (threads_ > 1 && rolledBack.size() > 1) {
+        QuantExt::WorkerPool pool(std::min(threads_, rolledBack.size()));
+        pool.run(rolledBack.size(), rollbackAmount);
+    } else {
+        for (Size k = 0; k < rolledBack.size(); ++k)
+            rollbackAmount(k);
+    }
+
+    // return the rolled back values
+
+    return result;
 }
 
-void FdBlackScholesBase::releaseMemory() {}
+const TripleBandLinearOp& FdBlackScholesBase::stepOperator(const Size j) const {
+    QL_REQUIRE(j < stepOperators_.size(), "FdBlackScholesBase::stepOperator(): time step "
+                                              << j << " out of range, time grid has " << stepOperators_.size()
+                                              << " steps");
+    if (stepOperators_[j] == nullptr) {
+        // same times as in the Douglas scheme step used by QuantLib::FdmBackwardSolver
+        Real dt = timeGrid_[j + 1] - timeGrid_[j];
+        operator_->setTime(std::max(0.0, timeGrid_[j + 1] - dt), timeGrid_[j + 1]);
+        stepOperators_[j] = boost::make_shared<TripleBandLinearOp>(operator_->map());
+    }
+    return *stepOperators_[j];
+}
 
 RandomVariable FdBlackScholesBase::getFutureBarrierProb(const std::string& index, const Date& obsdate1,
                                                         const Date& obsdate2, const RandomVariable& barrier,
@@ -461,27 +523,41 @@ RandomVariable FdBlackScholesBase::getFutureBarrierProb(const std::string& index
 }
 
 Real FdBlackScholesBase::extractT0Result(const RandomVariable& value) const {
+    return extractT0Results(std::vector<RandomVariable>(1, value)).front();
+}
+
+std::vector<Real> FdBlackScholesBase::extractT0Results(const std::vector<RandomVariable>& values) const {
 
     calculate();
 
     // roll back to today (if necessary)
 
-    RandomVariable r = npv(value, referenceDate(), Filter(), boost::none, RandomVariable(), RandomVariable());
+    std::vector<RandomVariable> r = rollback(values, referenceDate());
+
+    std::vector<Real> res(r.size());
+    Array x, y;
+    for (Size i = 0; i < r.size(); ++i) {
 
-    // if result is deterministic, return the value
+        // if result is deterministic, return the value
 
-    if (r.deterministic())
-        return r.at(0);
+        if (r[i].deterministic()) {
+            res[i] = r[i].at(0);
+            continue;
+        }
 
-    // otherwise interpolate the result at the spot of the underlying process
+        // otherwise interpolate the result at the spot of the underlying process
 
-    Array x(underlyingValues_.size());
-    Array y(underlyingValues_.size());
-    underlyingValues_.copyToArray(x);
-    r.copyToArray(y);
-    MonotonicCubicNaturalSpline interpolation(x.begin(), x.end(), y.begin());
-    interpolation.enableExtrapolation();
-    return interpolation(model_->processes()[0]->x0());
+        if (x.empty()) {
+            x = Array(underlyingValues_.size());
+            underlyingValues_.copyToArray(x);
+        }
+        y = Array(underlyingValues_.size());
+        r[i].copyToArray(y);
+        MonotonicCubicNaturalSpline interpolation(x.begin(), x.end(), y.begin());
+        interpolation.enableExtrapolation();
+        res[i] = interpolation(model_->processes()[0]->x0());
+    }
+    return res;
 }
 
 RandomVariable FdBlackScholesBase::pay(const RandomVariable& amount, const Date& obsdate, const Date& paydate,
@@ -25,12 +25,13 @@
 
 #include <ored/scripting/models/modelimpl.hpp>
 
+#include <qle/methods/fdmblackscholesop.hpp>
 #include <qle/termstructures/correlationtermstructure.hpp>
 #include <qle/models/blackscholesmodelwrapper.hpp>
 
 #include <ql/indexes/interestrateindex.hpp>
 #include <ql/methods/finitedifferences/meshers/fdmmesher.hpp>
-#include <ql/methods/finitedifferences/solvers/fdmbackwardsolver.hpp>
+#include <ql/methods/finitedifferences/operators/triplebandlinearop.hpp>
 #include <ql/processes/blackscholesprocess.hpp>
 #include <ql/timegrid.hpp>
 
@@ -48,6 +49,7 @@ public:
        - instead we have a stateGridPoints parameter and additional fd specific parameters
        - if staticMesher is true, the mesh will be held constant after its initial construction, this
          is important to get stable sensitivities
+       - if threads > 1, several amounts passed to rollback() are rolled back in parallel
     */
     FdBlackScholesBase(
         const Size stateGridPoints, const std::vector<std::string>& currencies,
@@ -60,7 +62,7 @@ public:
         const std::set<Date>& simulationDates, const IborFallbackConfig& iborFallbackConfig,
         const std::string& calibration, const std::map<std::string, std::vector<Real>>& calibrationStrikes = {},
         const Real mesherEpsilon = 1E-4, const Real mesherScaling = 1.5, const Real mesherConcentration = 0.1,
-        const Size mesherMaxConcentratingPoints = 9999, const bool staticMesher = false);
+        const Size mesherMaxConcentratingPoints = 9999, const bool staticMesher = false, const Size threads = 1);
 
     // ctor for single underlying
     FdBlackScholesBase(const Size stateGridPoints, const std::string& currency, const Handle<YieldTermStructure>& curve,
@@ -69,7 +71,8 @@ public:
                        const IborFallbackConfig& iborFallbackConfig, const std::string& calibration,
                        const std::vector<Real>& calibrationStrikes = {}, const Real mesherEpsilon = 1E-4,
                        const Real mesherScaling = 1.5, const Real mesherConcentration = 0.1,
-                       const Size mesherMaxConcentratingPoints = 9999, const bool staticMesher = false);
+                       const Size mesherMaxConcentratingPoints = 9999, const bool staticMesher = false,
+                       const Size threads = 1);
 
     // Model interface implementation
     Type type() const override { return Type::FD; }
@@ -82,8 +85,14 @@ public:
                               const Natural rateCutoff, const Natural fixingDays, const bool includeSpread,
                               const Real cap, const Real floor, const bool nakedOption,
                               const bool localCapFloor) const override;
-    void releaseMemory() override;
     Real extractT0Result(const RandomVariable& result) const override;
+    std::vector<Real> extractT0Results(const std::vector<RandomVariable>& values) const override;
+
+    /* Roll back several amounts to obsdate in one pass over the time grid, the result for each amount is the same
+       as the one of npv() without filter, mem slot and additional regressors. The operators of the time steps are
+       computed once per model calculation and shared by all amounts and subsequent calls, they are kept across
+       pricings until the model is recalculated. */
+    std::vector<RandomVariable> rollback(const std::vector<RandomVariable>& amounts, const Date& obsdate) const;
 
     // override to handle cases where we use a quanto-adjusted pde
     const std::string& baseCcy() const override;
@@ -105,6 +114,9 @@ protected:
     // helper function that constructs the correlation matrix
     Matrix getCorrelation() const;
 
+    // the operator for the time step from timeGrid_[j] to timeGrid_[j + 1], computed on first use
+    const TripleBandLinearOp& stepOperator(const Size j) const;
+
     // input parameters
     const std::vector<Handle<YieldTermStructure>> curves_;
     const std::vector<Handle<Quote>> fxSpots_;
@@ -117,6 +129,7 @@ protected:
     const Real mesherEpsilon_, mesherScaling_, mesherConcentration_;
     const Size mesherMaxConcentratingPoints_;
     const bool staticMesher_;
+    const Size threads_;
 
     // quanto adjustment parameters
     bool applyQuantoAdjustment_ = false;
@@ -130,9 +143,9 @@ protected:
     mutable TimeGrid timeGrid_;                       // the (possibly refined) time grid for the FD solver
     mutable std::vector<Size> positionInTimeGrid_;    // for each effective simulation date the index in the time grid
     mutable boost::shared_ptr<FdmMesher> mesher_;     // the mesher for the FD solver
-    mutable boost::shared_ptr<FdmLinearOpComposite> operator_; // the operator
-    mutable boost::shared_ptr<FdmBackwardSolver> solver_;      // the sovler
-    mutable RandomVariable underlyingValues_;                  // the discretised underlying
+    mutable boost::shared_ptr<QuantExt::FdmBlackScholesOp> operator_; // the operator
+    mutable std::vector<boost::shared_ptr<TripleBandLinearOp>> stepOperators_; // the operator per time step
+    mutable RandomVariable underlyingValues_;                                  // the discretised underlying
 };
 
 } // namespace data
@@ -57,6 +57,9 @@ public:
 
     // Model interface implementation
     Type type() const override { return Type::MC; }
+    bool antitheticPaths() const override {
+        return mcParams_.sequenceType == QuantExt::SequenceType::MersenneTwisterAntithetic;
+    }
     const Date& referenceDate() const override;
     Size size() const override;
     RandomVariable npv(const RandomVariable& amount, const Date& obsdate, const Filter& filter,
@@ -59,14 +59,14 @@ void LocalVol::performCalculations() const {
     if (indices_.empty())
         return;
 
-    // init underlying path where we map a date to a randomvariable representing the path values
+    // init underlying path where we map a date index to a randomvariable representing the path values
 
-    for (auto const& d : effectiveSimulationDates_) {
-        underlyingPaths_[d] = std::vector<RandomVariable>(model_->processes().size(), RandomVariable(size(), 0.0));
-        if (trainingSamples() != Null<Size>())
-            underlyingPathsTraining_[d] =
-                std::vector<RandomVariable>(model_->processes().size(), RandomVariable(trainingSamples(), 0.0));
-    }
+    underlyingPaths_.assign(effectiveSimulationDates_.size(),
+                            std::vector<RandomVariable>(model_->processes().size(), RandomVariable(size(), 0.0)));
+    if (trainingSamples() != Null<Size>())
+        underlyingPathsTraining_.assign(
+            effectiveSimulationDates_.size(),
+            std::vector<RandomVariable>(model_->processes().size(), RandomVariable(trainingSamples(), 0.0)));
 
     // compile the correlation matrix
 
@@ -75,9 +75,9 @@ void LocalVol::performCalculations() const {
     // set reference date values, if there are no future simulation dates we are done
 
     for (Size l = 0; l < indices_.size(); ++l) {
-        underlyingPaths_[*effectiveSimulationDates_.begin()][l].setAll(model_->processes()[l]->x0());
+        underlyingPaths_[0][l].setAll(model_->processes()[l]->x0());
         if (trainingSamples() != Null<Size>()) {
-            underlyingPathsTraining_[*effectiveSimulationDates_.begin()][l].setAll(model_->processes()[l]->x0());
+            underlyingPathsTraining_[0][l].setAll(model_->processes()[l]->x0());
         }
     }
 
@@ -131,11 +131,14 @@ void LocalVol::performCalculations() const {
 
     // evolve the process using correlated normal variates and set the underlying path values
 
-    populatePathValues(size(), underlyingPaths_,
-                       makeMultiPathVariateGenerator(mcParams_.sequenceType, indices_.size(), timeGrid_.size() - 1,
-                                                     mcParams_.seed, mcParams_.sobolOrdering,
-                                                     mcParams_.sobolDirectionIntegers),
-                       correlation, sqrtCorr, deterministicDrift, eqComIdx, t, dt, sqrtdt);
+    auto gen = makeMultiPathVariateGenerator(mcParams_.sequenceType, indices_.size(), timeGrid_.size() - 1,
+                                             mcParams_.seed, mcParams_.sobolOrdering, mcParams_.sobolDirectionIntegers);
+    populatePathValues(size(), underlyingPaths_, gen, correlation, sqrtCorr, deterministicDrift, eqComIdx, t, dt,
+                       sqrtdt);
+    nextPathBatch_ = [this, gen, correlation, sqrtCorr, deterministicDrift, eqComIdx, t, dt, sqrtdt]() {
+        populatePathValues(size(), underlyingPaths_, gen, correlation, sqrtCorr, deterministicDrift, eqComIdx, t, dt,
+                           sqrtdt);
+    };
 
     if (trainingSamples() != Null<Size>()) {
         populatePathValues(trainingSamples(), underlyingPathsTraining_,
@@ -147,7 +150,7 @@ void LocalVol::performCalculations() const {
 
 } // initPaths()
 
-void LocalVol::populatePathValues(const Size nSamples, std::map<Date, std::vector<RandomVariable>>& paths,
+void LocalVol::populatePathValues(const Size nSamples, std::vector<std::vector<RandomVariable>>& paths,
                                   const boost::shared_ptr<MultiPathVariateGeneratorBase>& gen,
                                   const Matrix& correlation, const Matrix& sqrtCorr,
                                   const std::vector<Array>& deterministicDrift, const std::vector<Size>& eqComIdx,
@@ -161,16 +164,14 @@ void LocalVol::populatePathValues(const Size nSamples, std::map<Date, std::vecto
 
     std::vector<std::vector<RandomVariable*>> rvs(indices_.size(),
                                                   std::vector<RandomVariable*>(effectiveSimulationDates_.size() - 1));
-    auto date = effectiveSimulationDates_.begin();
     for (Size i = 0; i < effectiveSimulationDates_.size() - 1; ++i) {
-        ++date;
         for (Size j = 0; j < indices_.size(); ++j) {
-            rvs[j][i] = &paths[*date][j];
+            rvs[j][i] = &paths[i + 1][j];
             rvs[j][i]->expand();
         }
     }
 
-    for (Size path = 0; path < size(); ++path) {
+    for (Size path = 0; path < nSamples; ++path) {
         auto p = gen->next();
         logState = logState0;
         std::size_t date = 0;
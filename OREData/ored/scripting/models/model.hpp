@@ -129,6 +129,26 @@ public:
     // extract T0 result from random variable
     virtual Real extractT0Result(const RandomVariable& value) const = 0;
 
+    // extract T0 results from several random variables, models can override this to process them in one batch
+    virtual std::vector<Real> extractT0Results(const std::vector<RandomVariable>& values) const {
+        std::vector<Real> res;
+        res.reserve(values.size());
+        for (auto const& v : values)
+            res.push_back(extractT0Result(v));
+        return res;
+    }
+
+    /* control variates for the T0 result of type MC models, i.e. pairs of deflated values (as returned by pay()) and
+       their known T0 expectations, might be empty */
+    virtual std::vector<std::pair<RandomVariable, Real>> controlVariates() const { return {}; }
+
+    // true if consecutive paths 2i, 2i+1 are antithetic pairs (only relevant for type MC models)
+    virtual bool antitheticPaths() const { return false; }
+
+    /* replace the (pricing) paths by the next batch of size() paths, continuing the sequence used to generate them,
+       returns false if this is not supported by the model (only relevant for type MC models) */
+    virtual bool nextPathBatch() const { return false; }
+
     /* Release memory allocated for caches (if applicable). This should _not_ notify observers of the model, since
        this would in particular trigger a recalculation of the scripted instrument pricing engine after each pricing
        when the memory is released, although the model's observables may not have changed. */
@@ -399,5 +399,24 @@ RandomVariable ModelImpl::barrierProbability(const std::string& index, const Dat
 
 Real ModelImpl::extractT0Result(const RandomVariable& value) const { return expectation(value).at(0); }
 
+std::vector<std::pair<RandomVariable, Real>> ModelImpl::controlVariates() const {
+    std::vector<std::pair<RandomVariable, Real>> result;
+    if (type() != Type::MC || simulationDates_.empty() || *simulationDates_.rbegin() <= referenceDate())
+        return result;
+    calculate();
+    Date ref = referenceDate(), T = *simulationDates_.rbegin();
+    result.push_back(std::make_pair(pay(RandomVariable(size(), 1.0), T, T, baseCcy()),
+                                    pay(RandomVariable(size(), 1.0), ref, T, baseCcy()).at(0)));
+    for (Size i = 0; i < indices_.size(); ++i) {
+        if (!indices_[i].isFx() && !indices_[i].isEq())
+            continue;
+        // fx indices are quoted against the base ccy
+        const std::string& ccy = indices_[i].isFx() ? baseCcy() : indexCurrencies_[i];
+        result.push_back(std::make_pair(pay(getIndexValue(i, T), T, T, ccy),
+                                        pay(getIndexValue(i, ref, T), ref, T, ccy).at(0)));
+    }
+    return result;
+}
+
 } // namespace data
 } // namespace ore
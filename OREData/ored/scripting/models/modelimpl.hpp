@@ -82,6 +82,9 @@ public:
                                       const RandomVariable& barrier, const bool above) const override;
     // provide default implementation for MC type models (taking a simple expectation)
     Real extractT0Result(const RandomVariable& value) const override;
+    /* default implementation for MC type models: the deflated base ccy zero bond and fx / eq spots paid in their
+       currency at the last simulation date */
+    std::vector<std::pair<RandomVariable, Real>> controlVariates() const override;
     //
 
 protected:
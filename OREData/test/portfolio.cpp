@@ -22,6 +22,8 @@
 #include <ored/portfolio/portfolio.hpp>
 #include <oret/toplevelfixture.hpp>
 
+#include <sstream>
+
 using namespace QuantLib;
 using namespace boost::unit_test_framework;
 using namespace std;
@@ -119,6 +121,49 @@ BOOST_AUTO_TEST_CASE(testIds) {
     BOOST_CHECK(portfolio->ids() == trade_ids);
 }
 
+BOOST_AUTO_TEST_CASE(testParallelParsing) {
+
+    BOOST_TEST_MESSAGE("Testing parallel parsing of portfolio XML");
+
+    // fx forwards, an unknown trade type, a trade with invalid data and a duplicate id
+    std::ostringstream xml;
+    xml << "<Portfolio>";
+    for (Size i = 0; i < 100; ++i) {
+        string tradeType = i == 17 ? "UnknownTradeType" : "FxForward";
+        string id = i == 42 ? "FXFWD_41" : "FXFWD_" + std::to_string(i);
+        string amount = i == 73 ? "invalid" : "1000000";
+        xml << "<Trade id=\"" << id << "\"><TradeType>" << tradeType << "</TradeType>"
+            << "<Envelope><CounterParty>CPTY_" << i % 7 << "</CounterParty><NettingSetId>CPTY_" << i % 7
+            << "</NettingSetId><AdditionalFields/></Envelope>"
+            << "<FxForwardData><ValueDate>2030-03-01</ValueDate><BoughtCurrency>EUR</BoughtCurrency>"
+            << "<BoughtAmount>" << amount << "</BoughtAmount><SoldCurrency>USD</SoldCurrency>"
+            << "<SoldAmount>1100000</SoldAmount></FxForwardData></Trade>";
+    }
+    xml << "</Portfolio>";
+
+    for (bool buildFailedTrades : {true, false}) {
+        Portfolio sequential(buildFailedTrades, 1);
+        sequential.fromXMLString(xml.str());
+        Portfolio parallel(buildFailedTrades, 4);
+        parallel.fromXMLString(xml.str());
+
+        BOOST_CHECK_EQUAL(sequential.size(), buildFailedTrades ? 99 : 97);
+        BOOST_REQUIRE_EQUAL(parallel.size(), sequential.size());
+        for (auto const& [id, trade] : sequential.trades()) {
+            auto p = parallel.get(id);
+            BOOST_REQUIRE(p != nullptr);
+            BOOST_CHECK_EQUAL(p->tradeType(), trade->tradeType());
+            BOOST_CHECK_EQUAL(p->envelope().counterparty(), trade->envelope().counterparty());
+        }
+        if (buildFailedTrades) {
+            BOOST_CHECK_EQUAL(parallel.get("FXFWD_17")->tradeType(), "Failed");
+            BOOST_CHECK_EQUAL(parallel.get("FXFWD_73")->tradeType(), "Failed");
+        }
+        // the first trade with a duplicate id is kept
+        BOOST_CHECK_EQUAL(parallel.get("FXFWD_41")->envelope().counterparty(), "CPTY_6");
+    }
+}
+
 BOOST_AUTO_TEST_SUITE_END()
 
 BOOST_AUTO_TEST_SUITE_END()
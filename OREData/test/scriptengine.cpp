@@ -22,16 +22,21 @@
 // clang-format on
 #include <boost/timer/timer.hpp>
 
+#include <ored/scripting/engines/scriptedinstrumentpricingengine.hpp>
 #include <ored/scripting/models/blackscholes.hpp>
 #include <ored/scripting/models/dummymodel.hpp>
+#include <ored/scripting/models/fdblackscholesbase.hpp>
+#include <ored/scripting/models/localvol.hpp>
 #include <ored/scripting/astprinter.hpp>
 #include <ored/scripting/scriptengine.hpp>
+#include <ored/scripting/scriptedinstrument.hpp>
 #include <ored/scripting/scriptparser.hpp>
 #include <ored/scripting/staticanalyser.hpp>
 
 #include <oret/toplevelfixture.hpp>
 
 #include <ored/model/blackscholesmodelbuilder.hpp>
+#include <ored/model/localvolmodelbuilder.hpp>
 
 #include <qle/cashflows/overnightindexedcoupon.hpp>
 #include <qle/methods/multipathgeneratorbase.hpp>
@@ -971,6 +976,94 @@ BOOST_AUTO_TEST_CASE(testEuropeanOption) {
     BOOST_CHECK_CLOSE(avg, expected, 0.1);
 }
 
+BOOST_AUTO_TEST_CASE(testAdaptivePathCount) {
+    BOOST_TEST_MESSAGE("Testing adaptive path count in scripted instrument pricing engine...");
+
+    Date ref(7, May, 2019);
+    Settings::instance().evaluationDate() = ref;
+
+    std::string script = "Option = PAY(max(Underlying(Expiry) - Strike, 0), Expiry, Expiry, PayCcy);";
+    ScriptParser parser(script);
+    BOOST_REQUIRE(parser.success());
+
+    Real s0 = 100.0;
+    Real vol = 0.18;
+    Real rate = 0.02;
+    Real strike = 100.0;
+    Date expiry(7, May, 2020);
+
+    // the model size is the batch size in adaptive mode
+    constexpr Size nPaths = 1000;
+
+    auto context = boost::make_shared<Context>();
+    context->scalars["Strike"] = RandomVariable(nPaths, strike);
+    context->scalars["Underlying"] = IndexVec{nPaths, "EQ-SP5"};
+    context->scalars["Expiry"] = EventVec{nPaths, expiry};
+    context->scalars["PayCcy"] = CurrencyVec{nPaths, "USD"};
+    context->scalars["Option"] = RandomVariable(nPaths, 0.0);
+
+    Handle<YieldTermStructure> yts(boost::make_shared<FlatForward>(ref, rate, ActualActual(ActualActual::ISDA)));
+    Handle<YieldTermStructure> yts0(boost::make_shared<FlatForward>(ref, 0.0, ActualActual(ActualActual::ISDA)));
+    Handle<BlackVolTermStructure> volts(
+        boost::make_shared<BlackConstantVol>(ref, NullCalendar(), vol, ActualActual(ActualActual::ISDA)));
+    auto process = boost::make_shared<GeneralizedBlackScholesProcess>(
+        Handle<Quote>(boost::make_shared<SimpleQuote>(s0)), yts0, yts, volts);
+
+    std::set<Date> simulationDates = {expiry};
+    Model::McParams mcParams;
+    mcParams.sequenceType = MersenneTwister;
+
+    struct Result {
+        Real npv, errorEstimate;
+        Size samples;
+    };
+
+    auto price = [&](const Real tolerance, const Size maxSamples) {
+        auto model = boost::make_shared<BlackScholes>(
+            nPaths, "USD", yts, "EQ-SP5", "USD",
+            BlackScholesModelBuilder(yts, process, simulationDates, std::set<Date>(), 1).model(), mcParams,
+            simulationDates);
+        auto engine = boost::make_shared<ScriptedInstrumentPricingEngine>(
+            "Option", std::vector<std::pair<std::string, std::string>>(), model, parser.ast(), context, script, false,
+            false, std::set<std::string>(), true, false, tolerance, Null<Real>(), maxSamples);
+        QuantExt::ScriptedInstrument instrument(expiry);
+        instrument.setPricingEngine(engine);
+        Result result{instrument.NPV(), instrument.errorEstimate(), nPaths};
+        auto s = instrument.additionalResults().find("NPV_MCSamples");
+        if (s != instrument.additionalResults().end())
+            result.samples = boost::any_cast<Size>(s->second);
+        BOOST_TEST_MESSAGE("tolerance " << tolerance << ", max samples " << maxSamples << ": npv " << result.npv
+                                        << " +- " << result.errorEstimate << ", samples " << result.samples);
+        return result;
+    };
+
+    Real expected = blackFormula(Option::Call, strike, s0 / yts->discount(expiry),
+                                 vol * std::sqrt(yts->timeFromReference(expiry)), yts->discount(expiry));
+
+    // without the adaptive mode and with a tolerance that is met by the first batch we get the same result
+
+    Result r0 = price(Null<Real>(), Null<Size>());
+    Result r1 = price(1.0E6, 100 * nPaths);
+    BOOST_CHECK_EQUAL(r1.samples, nPaths);
+    BOOST_CHECK_CLOSE(r1.npv, r0.npv, 1E-12);
+    BOOST_CHECK_CLOSE(r1.errorEstimate, r0.errorEstimate, 1E-12);
+
+    // require a third of the error of the first batch, this needs about 9 batches
+
+    Real tolerance = r0.errorEstimate / 3.0;
+    Result r2 = price(tolerance, 100 * nPaths);
+    BOOST_CHECK(r2.samples > nPaths);
+    BOOST_CHECK(r2.samples < 100 * nPaths);
+    BOOST_CHECK(r2.errorEstimate <= tolerance);
+    BOOST_CHECK_SMALL(r2.npv - expected, 3.0 * r2.errorEstimate);
+
+    // the maximum number of samples limits the number of batches
+
+    Result r3 = price(r0.errorEstimate / 100.0, 5 * nPaths);
+    BOOST_CHECK_EQUAL(r3.samples, 5 * nPaths);
+    BOOST_CHECK(r3.errorEstimate > r0.errorEstimate / 100.0);
+}
+
 BOOST_AUTO_TEST_CASE(testAmericanOption) {
     BOOST_TEST_MESSAGE("Testing american option...");
 
@@ -1069,6 +1162,167 @@ BOOST_AUTO_TEST_CASE(testAmericanOption) {
     BOOST_CHECK_CLOSE(avg, fdNpv, 5.0);
 }
 
+BOOST_AUTO_TEST_CASE(testTrainingPathsDifferentFromPricingPaths) {
+    BOOST_TEST_MESSAGE("Testing bermudan option with training samples different from pricing samples...");
+
+    Date ref(7, May, 2019);
+    Settings::instance().evaluationDate() = ref;
+
+    std::string script = "NUMBER Exercise;\n"
+                         "NUMBER i;\n"
+                         "FOR i IN (SIZE(Expiry), 1, -1) DO\n"
+                         "    Exercise = PAY( PutCall * (Underlying(Expiry[i]) - Strike),\n"
+                         "                    Expiry[i], Expiry[i], PayCcy );\n"
+                         "    IF Exercise > NPV( Option, Expiry[i], Exercise > 0 ) AND Exercise > 0 THEN\n"
+                         "        Option = Exercise;\n"
+                         "    END;\n"
+                         "END;\n";
+
+    ScriptParser parser(script);
+    BOOST_REQUIRE(parser.success());
+
+    Real s0 = 100.0;
+    Real vol = 0.18;
+    Real rate = 0.01;
+    Real putcall = -1.0;
+    Real strike = 100.0;
+
+    constexpr Size nPaths = 10000;
+
+    Schedule expirySchedule(Date(7, June, 2019), Date(7, May, 2020), 1 * Months, NullCalendar(), Unadjusted,
+                            Unadjusted, DateGeneration::Forward, false);
+    std::vector<ValueType> expiryDates;
+    for (auto const& d : expirySchedule.dates())
+        expiryDates.push_back(EventVec{nPaths, d});
+
+    auto context = boost::make_shared<Context>();
+    context->scalars["PutCall"] = RandomVariable(nPaths, putcall);
+    context->scalars["Strike"] = RandomVariable(nPaths, strike);
+    context->scalars["Underlying"] = IndexVec{nPaths, "EQ-SP5"};
+    context->arrays["Expiry"] = expiryDates;
+    context->scalars["PayCcy"] = CurrencyVec{nPaths, "USD"};
+    context->scalars["Option"] = RandomVariable(nPaths, 0.0);
+
+    std::set<Date> simulationDates(expirySchedule.dates().begin(), expirySchedule.dates().end());
+
+    Handle<YieldTermStructure> yts(boost::make_shared<FlatForward>(ref, rate, ActualActual(ActualActual::ISDA)));
+    Handle<YieldTermStructure> yts0(boost::make_shared<FlatForward>(ref, 0.0, ActualActual(ActualActual::ISDA)));
+    Handle<BlackVolTermStructure> volts(
+        boost::make_shared<BlackConstantVol>(ref, NullCalendar(), vol, ActualActual(ActualActual::ISDA)));
+    auto process = boost::make_shared<GeneralizedBlackScholesProcess>(
+        Handle<Quote>(boost::make_shared<SimpleQuote>(s0)), yts0, yts, volts);
+
+    // reference result from fd engine
+
+    auto fdEngine = boost::make_shared<FdBlackScholesVanillaEngine>(process, 100, 100);
+    VanillaOption option(boost::make_shared<PlainVanillaPayoff>(putcall > 0.0 ? Option::Call : Option::Put, strike),
+                         boost::make_shared<BermudanExercise>(expirySchedule.dates()));
+    option.setPricingEngine(fdEngine);
+    Real fdNpv = option.NPV();
+    BOOST_TEST_MESSAGE("fd engine result " << fdNpv);
+
+    // the training phase runs on a context resized to the training samples, we test fewer and more training samples
+    // than pricing samples for the black scholes and the local vol model
+
+    for (auto const trainingSamples : {nPaths / 4, 3 * nPaths}) {
+        Model::McParams mcParams;
+        mcParams.sequenceType = MersenneTwister;
+        mcParams.trainingSequenceType = MersenneTwister;
+        mcParams.regressionOrder = 4;
+        mcParams.trainingSamples = trainingSamples;
+        std::vector<std::pair<std::string, boost::shared_ptr<Model>>> models = {
+            {"BlackScholes",
+             boost::make_shared<BlackScholes>(
+                 nPaths, "USD", yts, "EQ-SP5", "USD",
+                 BlackScholesModelBuilder(yts, process, simulationDates, std::set<Date>(), 1).model(), mcParams,
+                 simulationDates)},
+            {"LocalVol", boost::make_shared<LocalVol>(
+                             nPaths, "USD", yts, "EQ-SP5", "USD",
+                             LocalVolModelBuilder(yts, process, simulationDates, std::set<Date>(), 12).model(),
+                             mcParams, simulationDates)}};
+        for (auto const& m : models) {
+            BOOST_REQUIRE_EQUAL(m.second->trainingSamples(), trainingSamples);
+            auto engine = boost::make_shared<ScriptedInstrumentPricingEngine>(
+                "Option", std::vector<std::pair<std::string, std::string>>(), m.second, parser.ast(), context, script);
+            QuantExt::ScriptedInstrument instrument(expirySchedule.dates().back());
+            instrument.setPricingEngine(engine);
+            Real npv = 0.0;
+            BOOST_REQUIRE_NO_THROW(npv = instrument.NPV());
+            BOOST_TEST_MESSAGE(m.first << " model, training samples " << trainingSamples << ", pricing samples "
+                                       << nPaths << ": npv " << npv);
+            BOOST_CHECK_CLOSE(npv, fdNpv, 5.0);
+        }
+    }
+}
+
+BOOST_AUTO_TEST_CASE(testFdBlackScholesRollback) {
+    BOOST_TEST_MESSAGE("Testing batched rollback in fd black scholes model...");
+
+    Date ref(7, May, 2019);
+    Settings::instance().evaluationDate() = ref;
+
+    Real s0 = 100.0;
+    Real vol = 0.18;
+    Real rate = 0.02;
+    Real strike = 100.0;
+    Date expiry1(7, November, 2019);
+    Date expiry2(7, May, 2020);
+
+    Handle<YieldTermStructure> yts(boost::make_shared<FlatForward>(ref, rate, ActualActual(ActualActual::ISDA)));
+    Handle<YieldTermStructure> yts0(boost::make_shared<FlatForward>(ref, 0.0, ActualActual(ActualActual::ISDA)));
+    Handle<BlackVolTermStructure> volts(
+        boost::make_shared<BlackConstantVol>(ref, NullCalendar(), vol, ActualActual(ActualActual::ISDA)));
+    auto process = boost::make_shared<GeneralizedBlackScholesProcess>(
+        Handle<Quote>(boost::make_shared<SimpleQuote>(s0)), yts0, yts, volts);
+
+    std::set<Date> simulationDates = {expiry1, expiry2};
+    constexpr Size gridPoints = 200;
+    auto model = boost::make_shared<FdBlackScholesBase>(
+        gridPoints, "USD", yts, "EQ-SP5", "USD",
+        BlackScholesModelBuilder(yts, process, simulationDates, {}, 24).model(), simulationDates,
+        IborFallbackConfig::defaultConfig(), "ATM", std::vector<Real>(), 1E-4, 1.5, 0.1, 9999, false, 4);
+
+    // amounts observed at different times, and a deterministic amount
+
+    RandomVariable s1 = model->eval("EQ-SP5", expiry1, Null<Date>());
+    RandomVariable s2 = model->eval("EQ-SP5", expiry2, Null<Date>());
+    RandomVariable k(gridPoints, strike), zero(gridPoints, 0.0);
+    std::vector<RandomVariable> amounts = {max(s2 - k, zero), max(k - s2, zero), s1 * s1,
+                                           RandomVariable(gridPoints, 5.0)};
+
+    std::vector<RandomVariable> batch;
+    BOOST_REQUIRE_NO_THROW(batch = model->rollback(amounts, ref));
+    BOOST_REQUIRE_EQUAL(batch.size(), amounts.size());
+
+    // compare with the single rollbacks
+
+    for (Size i = 0; i < amounts.size(); ++i) {
+        RandomVariable single = model->npv(amounts[i], ref, Filter(), boost::none, RandomVariable(), RandomVariable());
+        BOOST_REQUIRE_EQUAL(batch[i].size(), single.size());
+        BOOST_CHECK_CLOSE(batch[i].time(), single.time(), 1E-12);
+        BOOST_CHECK_MESSAGE(close_enough_all(batch[i], single),
+                            "batch rollback of amount " << i << " differs from single rollback");
+    }
+
+    // the batched T0 results match the single ones, also after the memory release following a pricing
+
+    std::vector<Real> t0Results = model->extractT0Results(amounts);
+    BOOST_REQUIRE_EQUAL(t0Results.size(), amounts.size());
+    model->releaseMemory();
+    for (Size i = 0; i < amounts.size(); ++i) {
+        BOOST_CHECK_CLOSE(t0Results[i], model->extractT0Result(amounts[i]), 1E-10);
+    }
+    BOOST_CHECK_CLOSE(t0Results[3], 5.0, 1E-12);
+
+    // check the call value against the analytical result
+
+    Real call = model->extractT0Result(amounts[0]);
+    Real expected = blackFormula(Option::Call, strike, s0 / yts->discount(expiry2),
+                                 vol * std::sqrt(yts->timeFromReference(expiry2)));
+    BOOST_TEST_MESSAGE("fd rollback call value " << call << ", expected " << expected);
+    BOOST_CHECK_CLOSE(call, expected, 1.0);
+}
+
 BOOST_AUTO_TEST_CASE(testAsianOption) {
     BOOST_TEST_MESSAGE("Testing asian option...");
 
@@ -26,6 +26,8 @@
 #include <ql/time/calendars/weekendsonly.hpp>
 #include <ql/utilities/vectors.hpp>
 
+#include <boost/make_shared.hpp>
+
 using namespace QuantLib;
 
 namespace QuantExt {
@@ -117,10 +119,22 @@ AverageONIndexedCoupon::AverageONIndexedCoupon(const Date& paymentDate, Real nom
 const std::vector<Rate>& AverageONIndexedCoupon::indexFixings() const {
 
     fixings_.resize(numPeriods_);
-    Size i;
+    Size i, nCutoff = numPeriods_ - rateCutoff_;
 
-    for (i = 0; i < numPeriods_ - rateCutoff_; ++i) {
-        fixings_[i] = index_->fixing(fixingDates_[i]);
+    if (Settings::instance().enforcesTodaysHistoricFixings()) {
+        for (i = 0; i < nCutoff; ++i) {
+            fixings_[i] = index_->fixing(fixingDates_[i]);
+        }
+    } else {
+        // known fixings from the index history, the remaining ones are forecasted in one batch
+        if (!indexFixingsCache_)
+            indexFixingsCache_ = boost::make_shared<OvernightFixingsCache>(
+                overnightIndex_, std::vector<Date>(fixingDates_.begin(), std::next(fixingDates_.begin(), nCutoff)));
+        const std::vector<Rate>& known = indexFixingsCache_->knownFixings();
+        std::copy(known.begin(), known.end(), fixings_.begin());
+        indexFixingsCache_->forecastFixings(known.size(), forecastFixings_);
+        std::copy(forecastFixings_.begin(), forecastFixings_.end(), std::next(fixings_.begin(), known.size()));
+        i = nCutoff;
     }
 
     Rate cutoffFixing = fixings_[i - 1];
@@ -132,6 +146,17 @@ const std::vector<Rate>& AverageONIndexedCoupon::indexFixings() const {
     return fixings_;
 }
 
+const std::vector<Rate>& AverageONIndexedCoupon::knownFixings() const {
+    if (!knownFixingsCache_) {
+        Size nCutoff = numPeriods_ - rateCutoff_;
+        std::vector<Date> dates(numPeriods_);
+        for (Size i = 0; i < numPeriods_; ++i)
+            dates[i] = fixingDates_[std::min(i, nCutoff)];
+        knownFixingsCache_ = boost::make_shared<OvernightFixingsCache>(overnightIndex_, dates);
+    }
+    return knownFixingsCache_->knownFixings();
+}
+
 Date AverageONIndexedCoupon::fixingDate() const { return fixingDates_[fixingDates_.size() - 1 - rateCutoff_]; }
 
 void AverageONIndexedCoupon::accept(AcyclicVisitor& v) {
@@ -17,6 +17,7 @@
 */
 
 #include <qle/cashflows/averageonindexedcouponpricer.hpp>
+#include <qle/termstructures/batchdiscountcurve.hpp>
 
 namespace QuantExt {
 
@@ -35,8 +36,7 @@ void AverageONIndexedCouponPricer::initialize(const FloatingRateCoupon& coupon)
 
 Rate AverageONIndexedCouponPricer::swapletRate() const {
 
-    std::vector<Date> fixingDates = coupon_->fixingDates();
-    std::vector<Time> accrualFractions = coupon_->dt();
+    const std::vector<Time>& accrualFractions = coupon_->dt();
     Size numPeriods = accrualFractions.size();
     Real accumulatedRate = 0;
     QL_REQUIRE(coupon_->rateCutoff() < numPeriods,
@@ -45,24 +45,11 @@ Rate AverageONIndexedCouponPricer::swapletRate() const {
     Size nCutoff = numPeriods - coupon_->rateCutoff();
 
     if (approximationType_ == Takada) {
+        // Deal with past fixings, including the valuation date's fixing if available.
+        const std::vector<Rate>& knownFixings = coupon_->knownFixings();
         Size i = 0;
-        Date valuationDate = Settings::instance().evaluationDate();
-        // Deal with past fixings.
-        while (i < numPeriods && fixingDates[std::min(i, nCutoff)] < valuationDate) {
-            Rate pastFixing = overnightIndex_->pastFixing(fixingDates[std::min(i, nCutoff)]);
-            QL_REQUIRE(pastFixing != Null<Real>(),
-                       "Missing " << overnightIndex_->name() << " fixing for " << fixingDates[std::min(i, nCutoff)]);
-            accumulatedRate += pastFixing * accrualFractions[i];
-            ++i;
-        }
-        // Use valuation date's fixing also if available.
-        if (i < numPeriods && fixingDates[std::min(i, nCutoff)] == valuationDate) {
-            Rate valuationDateFixing = overnightIndex_->pastFixing(valuationDate);
-            if (valuationDateFixing != Null<Real>()) {
-                accumulatedRate += valuationDateFixing * accrualFractions[i];
-                ++i;
-            }
-        }
+        for (; i < knownFixings.size(); ++i)
+            accumulatedRate += knownFixings[i] * accrualFractions[i];
         // Use Takada approximation (2011) for forecasting.
         if (i < numPeriods) {
             Handle<YieldTermStructure> projectionCurve = overnightIndex_->forwardingTermStructure();
@@ -70,16 +57,21 @@ Rate AverageONIndexedCouponPricer::swapletRate() const {
                        "Null term structure set to this instance of " << overnightIndex_->name());
 
             // handle the part until the rate cutoff (might be empty, i.e. startForecast = endForecast)
-            Date startForecast = coupon_->valueDates()[i];
-            Date endForecast = coupon_->valueDates()[std::max(nCutoff, i)];
-            DiscountFactor startDiscount = projectionCurve->discount(startForecast);
-            DiscountFactor endDiscount = projectionCurve->discount(endForecast);
+            // the required discount factors are evaluated in one batch
+            std::vector<Date> discountDates = {coupon_->valueDates()[i], coupon_->valueDates()[std::max(nCutoff, i)]};
+            if (nCutoff < numPeriods) {
+                discountDates.push_back(coupon_->valueDates()[nCutoff]);
+                discountDates.push_back(coupon_->valueDates()[nCutoff] + 1);
+            }
+            std::vector<DiscountFactor> df;
+            discounts(projectionCurve, discountDates, df);
+            DiscountFactor startDiscount = df[0];
+            DiscountFactor endDiscount = df[1];
 
             // handle the rate cutoff period (if there is any, i.e. if nCutoff < n)
             if (nCutoff < numPeriods) {
                 // forward discount factor for one calendar day on the cutoff date
-                DiscountFactor discountCutoffDate = projectionCurve->discount(coupon_->valueDates()[nCutoff] + 1) /
-                                                    projectionCurve->discount(coupon_->valueDates()[nCutoff]);
+                DiscountFactor discountCutoffDate = df[3] / df[2];
                 // keep the above forward discount factor constant during the cutoff period
                 endDiscount *=
                     std::pow(discountCutoffDate, coupon_->valueDates()[numPeriods] - coupon_->valueDates()[nCutoff]);
@@ -88,7 +80,7 @@ Rate AverageONIndexedCouponPricer::swapletRate() const {
             accumulatedRate += log(startDiscount / endDiscount);
         }
     } else if (approximationType_ == None) {
-        std::vector<Rate> fixings = coupon_->indexFixings();
+        const std::vector<Rate>& fixings = coupon_->indexFixings();
         for (Size i = 0; i < numPeriods; ++i) {
             accumulatedRate += fixings[i] * accrualFractions[i];
         }
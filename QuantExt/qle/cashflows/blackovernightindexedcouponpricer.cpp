@@ -125,7 +125,6 @@ Real BlackOvernightIndexedCouponPricer::optionletRateLocal(Option::Type optionTy
 
     ext::shared_ptr<OvernightIndex> index = ext::dynamic_pointer_cast<OvernightIndex>(coupon_->index());
 
-    const std::vector<Date>& fixingDates = coupon_->underlying()->fixingDates();
     const std::vector<Time>& dt = coupon_->underlying()->dt();
 
     Size n = dt.size();
@@ -137,39 +136,15 @@ Real BlackOvernightIndexedCouponPricer::optionletRateLocal(Option::Type optionTy
 
     Real compoundFactor = 1.0, compoundFactorRaw = 1.0;
 
-    // already fixed part
-    Date today = Settings::instance().evaluationDate();
-    while (i < n && fixingDates[std::min(i, nCutoff)] < today) {
-        // rate must have been fixed
-        Rate pastFixing = index->pastFixing(fixingDates[std::min(i, nCutoff)]);
-        QL_REQUIRE(pastFixing != Null<Real>(),
-                   "Missing " << index->name() << " fixing for " << fixingDates[std::min(i, nCutoff)]);
+    // already fixed part, including today's fixing if available
+    const std::vector<Rate>& knownFixings = coupon_->underlying()->knownFixings();
+    for (; i < knownFixings.size(); ++i) {
+        Rate pastFixing = knownFixings[i];
         if (coupon_->underlying()->includeSpread()) {
             pastFixing += coupon_->spread();
         }
         compoundFactor *= 1.0 + cappedFlooredRate(pastFixing, optionType, absStrike) * dt[i];
         compoundFactorRaw *= 1.0 + pastFixing * dt[i];
-        ++i;
-    }
-
-    // today is a border case
-    if (i < n && fixingDates[std::min(i, nCutoff)] == today) {
-        // might have been fixed
-        try {
-            Rate pastFixing = index->pastFixing(today);
-            if (pastFixing != Null<Real>()) {
-                if (coupon_->underlying()->includeSpread()) {
-                    pastFixing += coupon_->spread();
-                }
-                compoundFactor *= 1.0 + cappedFlooredRate(pastFixing, optionType, absStrike) * dt[i];
-                compoundFactorRaw *= 1.0 + pastFixing * dt[i];
-                ++i;
-            } else {
-                ; // fall through and forecast
-            }
-        } catch (Error&) {
-            ; // fall through and forecast
-        }
     }
 
     // forward part, approximation by pricing a cap / floor in the middle of the future period
@@ -356,7 +331,6 @@ Real BlackAverageONIndexedCouponPricer::optionletRateLocal(Option::Type optionTy
 
     ext::shared_ptr<OvernightIndex> index = ext::dynamic_pointer_cast<OvernightIndex>(coupon_->index());
 
-    const std::vector<Date>& fixingDates = coupon_->underlying()->fixingDates();
     const std::vector<Time>& dt = coupon_->underlying()->dt();
 
     Size n = dt.size();
@@ -368,39 +342,15 @@ Real BlackAverageONIndexedCouponPricer::optionletRateLocal(Option::Type optionTy
 
     Real accumulatedRate = 0.0, accumulatedRateRaw = 0.0;
 
-    // already fixed part
-    Date today = Settings::instance().evaluationDate();
-    while (i < n && fixingDates[std::min(i, nCutoff)] < today) {
-        // rate must have been fixed
-        Rate pastFixing = index->pastFixing(fixingDates[std::min(i, nCutoff)]);
-        QL_REQUIRE(pastFixing != Null<Real>(),
-                   "Missing " << index->name() << " fixing for " << fixingDates[std::min(i, nCutoff)]);
+    // already fixed part, including today's fixing if available
+    const std::vector<Rate>& knownFixings = coupon_->underlying()->knownFixings();
+    for (; i < knownFixings.size(); ++i) {
+        Rate pastFixing = knownFixings[i];
         if (coupon_->includeSpread()) {
             pastFixing += coupon_->spread();
         }
         accumulatedRate += cappedFlooredRate(pastFixing, optionType, absStrike) * dt[i];
         accumulatedRateRaw += pastFixing * dt[i];
-        ++i;
-    }
-
-    // today is a border case
-    if (i < n && fixingDates[std::min(i, nCutoff)] == today) {
-        // might have been fixed
-        try {
-            Rate pastFixing = index->pastFixing(today);
-            if (pastFixing != Null<Real>()) {
-                if (coupon_->includeSpread()) {
-                    pastFixing += coupon_->spread();
-                }
-                accumulatedRate += cappedFlooredRate(pastFixing, optionType, absStrike) * dt[i];
-                accumulatedRateRaw += pastFixing * dt[i];
-                ++i;
-            } else {
-                ; // fall through and forecast
-            }
-        } catch (Error&) {
-            ; // fall through and forecast
-        }
     }
 
     // forward part, approximation by pricing a cap / floor in the middle of the future period
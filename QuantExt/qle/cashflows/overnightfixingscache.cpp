@@ -0,0 +1,128 @@
+/*
+ Copyright (C) 2023 Quaternion Risk Management Ltd
+ All rights reserved.
+
+ This file is part of ORE, a free-software/open-source library
+ for transparent pricing and risk analysis - http://opensourcerisk.org
+
+ ORE is free software: you can redistribute it and/or modify it
+ under the terms of the Modified BSD License.  You should have received a
+ copy of the license along with this program.
+ The license is also available online at <http://opensourcerisk.org>
+
+ This program is distributed on the basis that it will form a useful
+ contribution to risk analytics and model standardisation, but WITHOUT
+ ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ FITNESS FOR A PARTICULAR PURPOSE. See the license for more details.
+*/
+
+#include <qle/cashflows/overnightfixingscache.hpp>
+#include <qle/indexes/fallbackovernightindex.hpp>
+#include <qle/termstructures/batchdiscountcurve.hpp>
+
+#include <ql/indexes/indexmanager.hpp>
+#include <ql/settings.hpp>
+
+namespace QuantExt {
+
+OvernightFixingsCache::OvernightFixingsCache(const boost::shared_ptr<OvernightIndex>& index,
+                                             const std::vector<Date>& fixingDates)
+    : index_(index), fixingDates_(fixingDates) {
+    QL_REQUIRE(index_, "OvernightFixingsCache: no index given");
+    // the fallback index overrides the fixing logic, so we can not read its fixings from the history directly
+    bulk_ = boost::dynamic_pointer_cast<FallbackOvernightIndex>(index_) == nullptr;
+    registerWith(IndexManager::instance().notifier(index_->name()));
+}
+
+void OvernightFixingsCache::update() { knownFixingsValid_ = false; }
+
+const std::vector<Real>& OvernightFixingsCache::knownFixings() const {
+    Date today = Settings::instance().evaluationDate();
+    if (bulk_) {
+        // the history size is checked as well, since notifications might be deferred (ObservableSettings)
+        const TimeSeries<Real>& history = index_->timeSeries();
+        if (knownFixingsValid_ && today == evaluationDate_ && history.size() == historySize_)
+            return knownFixings_;
+        knownFixingsValid_ = false;
+        knownFixings_.clear();
+        historySize_ = history.size();
+        for (auto const& d : fixingDates_) {
+            if (d > today)
+                break;
+            Real fixing = history[d];
+            if (d == today) {
+                if (fixing != Null<Real>())
+                    knownFixings_.push_back(fixing);
+                break;
+            }
+            QL_REQUIRE(fixing != Null<Real>(), "Missing " << index_->name() << " fixing for " << d);
+            knownFixings_.push_back(fixing);
+        }
+    } else {
+        knownFixings_.clear();
+        for (auto const& d : fixingDates_) {
+            if (d > today)
+                break;
+            if (d == today) {
+                // might have been fixed
+                try {
+                    Real fixing = index_->pastFixing(d);
+                    if (fixing != Null<Real>())
+                        knownFixings_.push_back(fixing);
+                } catch (Error&) {
+                    ; // forecast
+                }
+                break;
+            }
+            Real fixing = index_->pastFixing(d);
+            QL_REQUIRE(fixing != Null<Real>(), "Missing " << index_->name() << " fixing for " << d);
+            knownFixings_.push_back(fixing);
+        }
+    }
+
+    evaluationDate_ = today;
+    knownFixingsValid_ = true;
+    return knownFixings_;
+}
+
+void OvernightFixingsCache::initForecastDates() const {
+    if (!forecastDates_.empty() || fixingDates_.empty())
+        return;
+    // same as in IborIndex::forecastFixing(const Date& fixingDate)
+    forecastDates_.resize(2 * fixingDates_.size());
+    forecastTimes_.resize(fixingDates_.size());
+    for (Size i = 0; i < fixingDates_.size(); ++i) {
+        Date d1 = index_->valueDate(fixingDates_[i]);
+        Date d2 = index_->maturityDate(d1);
+        forecastDates_[2 * i] = d1;
+        forecastDates_[2 * i + 1] = d2;
+        forecastTimes_[i] = index_->dayCounter().yearFraction(d1, d2);
+    }
+}
+
+void OvernightFixingsCache::forecastFixings(const Size from, std::vector<Real>& result) const {
+    QL_REQUIRE(from <= fixingDates_.size(), "OvernightFixingsCache::forecastFixings(): from (" << from
+                                                << ") exceeds number of fixing dates (" << fixingDates_.size()
+                                                << ")");
+    Size n = fixingDates_.size() - from;
+    result.resize(n);
+    if (n == 0)
+        return;
+
+    if (!bulk_) {
+        for (Size i = 0; i < n; ++i)
+            result[i] = index_->fixing(fixingDates_[from + i]);
+        return;
+    }
+
+    QL_REQUIRE(!index_->forwardingTermStructure().empty(),
+               "null term structure set to this instance of " << index_->name());
+    initForecastDates();
+    std::vector<Date> dates(std::next(forecastDates_.begin(), 2 * from), forecastDates_.end());
+    std::vector<DiscountFactor> df;
+    discounts(index_->forwardingTermStructure(), dates, df);
+    for (Size i = 0; i < n; ++i)
+        result[i] = (df[2 * i] / df[2 * i + 1] - 1.0) / forecastTimes_[from + i];
+}
+
+} // namespace QuantExt
@@ -0,0 +1,78 @@
+/*
+ Copyright (C) 2023 Quaternion Risk Management Ltd
+ All rights reserved.
+
+ This file is part of ORE, a free-software/open-source library
+ for transparent pricing and risk analysis - http://opensourcerisk.org
+
+ ORE is free software: you can redistribute it and/or modify it
+ under the terms of the Modified BSD License.  You should have received a
+ copy of the license along with this program.
+ The license is also available online at <http://opensourcerisk.org>
+
+ This program is distributed on the basis that it will form a useful
+ contribution to risk analytics and model standardisation, but WITHOUT
+ ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ FITNESS FOR A PARTICULAR PURPOSE. See the license for more details.
+*/
+
+/*! \file overnightfixingscache.hpp
+    \brief cache for the known fixings of overnight coupons
+    \ingroup cashflows
+*/
+
+#pragma once
+
+#include <ql/indexes/iborindex.hpp>
+#include <ql/patterns/observable.hpp>
+
+#include <vector>
+
+namespace QuantExt {
+using namespace QuantLib;
+
+//! Cache for the fixings of an overnight index on a given sequence of fixing dates
+/*! The known fixings, i.e. the fixings for the leading fixing dates before the evaluation date plus the fixing on
+    the evaluation date if available, are read from the index history in one pass and kept until the evaluation
+    date changes or a fixing of the index is added or removed. The remaining fixings can be forecasted using one
+    batch evaluation of the required discount factors on the forwarding curve of the index.
+
+    For indices with a custom fixing logic (FallbackOvernightIndex) nothing is cached and the fixings are retrieved
+    and forecasted date by date using the index.
+
+    \ingroup cashflows
+*/
+class OvernightFixingsCache : public Observer {
+public:
+    OvernightFixingsCache(const boost::shared_ptr<OvernightIndex>& index, const std::vector<Date>& fixingDates);
+
+    /*! the known fixings for the leading fixing dates, the size of the result is the position of the first fixing
+        date for which the fixing has to be forecasted, throws if a fixing before the evaluation date is missing */
+    const std::vector<Real>& knownFixings() const;
+
+    /*! the forecasted fixings for the fixing dates from the position from on, the fixing dates are required to be on
+        or after the evaluation date */
+    void forecastFixings(const Size from, std::vector<Real>& result) const;
+
+    //! \name Observer interface
+    //@{
+    void update() override;
+    //@}
+
+private:
+    void initForecastDates() const;
+
+    boost::shared_ptr<OvernightIndex> index_;
+    std::vector<Date> fixingDates_;
+    bool bulk_;
+
+    mutable bool knownFixingsValid_ = false;
+    mutable Date evaluationDate_;
+    mutable Size historySize_ = 0;
+    mutable std::vector<Real> knownFixings_;
+
+    mutable std::vector<Date> forecastDates_;
+    mutable std::vector<Time> forecastTimes_;
+};
+
+} // namespace QuantExt
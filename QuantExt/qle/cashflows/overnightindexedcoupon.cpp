@@ -38,6 +38,7 @@
 */
 
 #include <qle/cashflows/overnightindexedcoupon.hpp>
+#include <qle/termstructures/batchdiscountcurve.hpp>
 
 #include <ql/cashflows/cashflowvectors.hpp>
 #include <ql/cashflows/couponpricer.hpp>
@@ -45,6 +46,8 @@
 #include <ql/time/calendars/weekendsonly.hpp>
 #include <ql/utilities/vectors.hpp>
 
+#include <boost/make_shared.hpp>
+
 using std::vector;
 
 namespace QuantExt {
@@ -148,9 +151,21 @@ OvernightIndexedCoupon::OvernightIndexedCoupon(const Date& paymentDate, Real nom
 
 const vector<Rate>& OvernightIndexedCoupon::indexFixings() const {
     fixings_.resize(n_);
-    Size i;
-    for (i = 0; i < n_ - rateCutoff_; ++i) {
-        fixings_[i] = index_->fixing(fixingDates_[i]);
+    Size i, nCutoff = n_ - rateCutoff_;
+    if (Settings::instance().enforcesTodaysHistoricFixings()) {
+        for (i = 0; i < nCutoff; ++i) {
+            fixings_[i] = index_->fixing(fixingDates_[i]);
+        }
+    } else {
+        // known fixings from the index history, the remaining ones are forecasted in one batch
+        if (!indexFixingsCache_)
+            indexFixingsCache_ = boost::make_shared<OvernightFixingsCache>(
+                overnightIndex_, vector<Date>(fixingDates_.begin(), std::next(fixingDates_.begin(), nCutoff)));
+        const vector<Rate>& known = indexFixingsCache_->knownFixings();
+        std::copy(known.begin(), known.end(), fixings_.begin());
+        indexFixingsCache_->forecastFixings(known.size(), forecastFixings_);
+        std::copy(forecastFixings_.begin(), forecastFixings_.end(), std::next(fixings_.begin(), known.size()));
+        i = nCutoff;
     }
     Rate cutoffFixing = fixings_[i - 1];
     while (i < n_) {
@@ -160,6 +175,17 @@ const vector<Rate>& OvernightIndexedCoupon::indexFixings() const {
     return fixings_;
 }
 
+const vector<Rate>& OvernightIndexedCoupon::knownFixings() const {
+    if (!knownFixingsCache_) {
+        Size nCutoff = n_ - rateCutoff_;
+        vector<Date> dates(n_);
+        for (Size i = 0; i < n_; ++i)
+            dates[i] = fixingDates_[std::min(i, nCutoff)];
+        knownFixingsCache_ = boost::make_shared<OvernightFixingsCache>(overnightIndex_, dates);
+    }
+    return knownFixingsCache_->knownFixings();
+}
+
 void OvernightIndexedCoupon::accept(AcyclicVisitor& v) {
     Visitor<OvernightIndexedCoupon>* v1 = dynamic_cast<Visitor<OvernightIndexedCoupon>*>(&v);
     if (v1 != 0) {
@@ -195,7 +221,6 @@ void OvernightIndexedCouponPricer::initialize(const FloatingRateCoupon& coupon)
 void OvernightIndexedCouponPricer::compute() const {
     ext::shared_ptr<OvernightIndex> index = ext::dynamic_pointer_cast<OvernightIndex>(coupon_->index());
 
-    const vector<Date>& fixingDates = coupon_->fixingDates();
     const vector<Time>& dt = coupon_->dt();
 
     Size n = dt.size();
@@ -207,39 +232,15 @@ void OvernightIndexedCouponPricer::compute() const {
 
     Real compoundFactor = 1.0, compoundFactorWithoutSpread = 1.0;
 
-    // already fixed part
-    Date today = Settings::instance().evaluationDate();
-    while (i < n && fixingDates[std::min(i, nCutoff)] < today) {
-        // rate must have been fixed
-        Rate pastFixing = index->pastFixing(fixingDates[std::min(i, nCutoff)]);
-        QL_REQUIRE(pastFixing != Null<Real>(),
-                   "Missing " << index->name() << " fixing for " << fixingDates[std::min(i, nCutoff)]);
+    // already fixed part, including today's fixing if available
+    const vector<Rate>& knownFixings = coupon_->knownFixings();
+    for (; i < knownFixings.size(); ++i) {
+        Rate pastFixing = knownFixings[i];
         if (coupon_->includeSpread()) {
             compoundFactorWithoutSpread *= (1.0 + pastFixing * dt[i]);
             pastFixing += coupon_->spread();
         }
         compoundFactor *= (1.0 + pastFixing * dt[i]);
-        ++i;
-    }
-
-    // today is a border case
-    if (i < n && fixingDates[std::min(i, nCutoff)] == today) {
-        // might have been fixed
-        try {
-            Rate pastFixing = index->pastFixing(fixingDates[std::min(i, nCutoff)]);
-            if (pastFixing != Null<Real>()) {
-                if (coupon_->includeSpread()) {
-                    compoundFactorWithoutSpread *= (1.0 + pastFixing * dt[i]);
-                    pastFixing += coupon_->spread();
-                }
-                compoundFactor *= (1.0 + pastFixing * dt[i]);
-                ++i;
-            } else {
-                ; // fall through and forecast
-            }
-        } catch (Error&) {
-            ; // fall through and forecast
-        }
     }
 
     // forward part using telescopic property in order
@@ -249,14 +250,23 @@ void OvernightIndexedCouponPricer::compute() const {
         Handle<YieldTermStructure> curve = index->forwardingTermStructure();
         QL_REQUIRE(!curve.empty(), "null term structure set to this instance of " << index->name());
 
+        // the required discount factors are evaluated in one batch
+        vector<Date> discountDates = {dates[i], dates[std::max(nCutoff, i)]};
+        if (nCutoff < n) {
+            discountDates.push_back(dates[nCutoff]);
+            discountDates.push_back(dates[nCutoff] + 1);
+        }
+        vector<DiscountFactor> df;
+        discounts(curve, discountDates, df);
+
         // handle the part until the rate cutoff (might be empty, i.e. startDiscount = endDiscount)
-        DiscountFactor startDiscount = curve->discount(dates[i]);
-        DiscountFactor endDiscount = curve->discount(dates[std::max(nCutoff, i)]);
+        DiscountFactor startDiscount = df[0];
+        DiscountFactor endDiscount = df[1];
 
         // handle the rate cutoff period (if there is any, i.e. if nCutoff < n)
         if (nCutoff < n) {
             // forward discount factor for one calendar day on the cutoff date
-            DiscountFactor discountCutoffDate = curve->discount(dates[nCutoff] + 1) / curve->discount(dates[nCutoff]);
+            DiscountFactor discountCutoffDate = df[3] / df[2];
             // keep the above forward discount factor constant during the cutoff period
             endDiscount *= std::pow(discountCutoffDate, dates[n] - dates[nCutoff]);
         }
@@ -44,6 +44,8 @@
 
 #pragma once
 
+#include <qle/cashflows/overnightfixingscache.hpp>
+
 #include <ql/cashflows/couponpricer.hpp>
 #include <ql/cashflows/floatingratecoupon.hpp>
 #include <ql/indexes/iborindex.hpp>
@@ -86,6 +88,9 @@ public:
     const std::vector<Time>& dt() const { return dt_; }
     //! fixings to be compounded
     const std::vector<Rate>& indexFixings() const;
+    /*! fixings known as of the evaluation date for the leading fixing dates (taking into account the rate cutoff),
+        the size of the result is the index of the first period for which the rate has to be forecasted */
+    const std::vector<Rate>& knownFixings() const;
     //! value dates for the rates to be compounded
     const std::vector<Date>& valueDates() const { return valueDates_; }
     //! include spread in compounding?
@@ -120,13 +125,14 @@ public:
 private:
     boost::shared_ptr<OvernightIndex> overnightIndex_;
     std::vector<Date> valueDates_, fixingDates_;
-    mutable std::vector<Rate> fixings_;
+    mutable std::vector<Rate> fixings_, forecastFixings_;
     Size n_;
     std::vector<Time> dt_;
     bool includeSpread_;
     Period lookback_;
     Natural rateCutoff_;
     Date rateComputationStartDate_, rateComputationEndDate_;
+    mutable boost::shared_ptr<OvernightFixingsCache> knownFixingsCache_, indexFixingsCache_;
 };
 
 //! OvernightIndexedCoupon pricer
@@ -25,6 +25,9 @@
 #include <ql/math/matrixutilities/symmetricschurdecomposition.hpp>
 #include <ql/math/solvers1d/brent.hpp>
 
+#include <algorithm>
+#include <functional>
+
 namespace QuantExt {
 
 namespace detail {
@@ -42,6 +45,39 @@ void check(const Matrix& omega, const Array& delta, const Matrix& gamma) {
                "gamma (" << gamma.rows() << "x" << gamma.columns() << ") must have same dimensions as omega ("
                          << omega.rows() << "x" << omega.columns() << ")");
 }
+
+void rowProducts(const Matrix& m, const Real* x, const Size n, Real* y) {
+    // the rows and columns of m are processed in tiles, so that a tile of m and the corresponding parts of the
+    // vectors x stay in the cache while iterating over the vectors
+    const Size rowTile = 64, columnTile = 256;
+    Size rows = m.rows(), columns = m.columns();
+    std::fill(y, y + n * rows, 0.0);
+    for (Size i0 = 0; i0 < rows; i0 += rowTile) {
+        Size i1 = std::min(i0 + rowTile, rows);
+        for (Size j0 = 0; j0 < columns; j0 += columnTile) {
+            Size j1 = std::min(j0 + columnTile, columns);
+            for (Size b = 0; b < n; ++b) {
+                const Real* xb = x + b * columns;
+                Real* yb = y + b * rows;
+                for (Size i = i0; i < i1; ++i) {
+                    const Real* mi = m.row_begin(i);
+                    Real s = 0.0;
+                    for (Size j = j0; j < j1; ++j)
+                        s += mi[j] * xb[j];
+                    yb[i] += s;
+                }
+            }
+        }
+    }
+}
+
+Real rightTailQuantile(std::vector<Real>& v, const Real p) {
+    QL_REQUIRE(!v.empty(), "rightTailQuantile(): empty sample");
+    Size n = static_cast<Size>(std::ceil(static_cast<Real>(v.size()) * (1.0 - p)));
+    n = std::min(std::max<Size>(n, 1), v.size());
+    std::nth_element(v.begin(), v.begin() + (n - 1), v.end(), std::greater<Real>());
+    return v[n - 1];
+}
 } // namespace detail
 
 namespace {
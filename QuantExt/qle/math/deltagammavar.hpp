@@ -25,6 +25,7 @@
 #define quantext_deltagammavar_hpp
 
 #include <qle/math/covariancesalvage.hpp>
+#include <qle/utilities/workerpool.hpp>
 
 #include <ql/math/comparison.hpp>
 #include <ql/math/array.hpp>
@@ -33,15 +34,11 @@
 #include <ql/math/matrixutilities/pseudosqrt.hpp>
 #include <ql/math/randomnumbers/rngtraits.hpp>
 
-// fix for boost 1.64, see https://lists.boost.org/Archives/boost/2016/11/231756.php
-#if BOOST_VERSION >= 106400
-#include <boost/serialization/array_wrapper.hpp>
-#endif
-#include <boost/accumulators/accumulators.hpp>
-#include <boost/accumulators/statistics/stats.hpp>
-#include <boost/accumulators/statistics/tail_quantile.hpp>
 #include <boost/foreach.hpp>
 
+#include <algorithm>
+#include <memory>
+
 namespace QuantExt {
 using namespace QuantLib;
 
@@ -75,6 +72,25 @@ std::vector<Real> deltaGammaVarMc(const Matrix& omega, const Array& delta, const
 				  const std::vector<Real>& p, const Size paths, const Size seed,
 				  const CovarianceSalvage& sal = NoCovarianceSalvage());
 
+//! function that computes delta-gamma VaRs of several portfolios using Monte Carlo (multiple quantiles)
+/*! For a given covariance matrix and a delta vector and gamma matrix per portfolio this function computes the
+ * parametric vars of all portfolios w.r.t. a vector of given confidence levels. The result contains one vector of
+ * vars per portfolio.
+ *
+ * The same Monte-Carlo realisations of the risk factor moves are used for all portfolios. The deltas and gammas are
+ * projected once onto the m independent normal factors with a non-zero loading, so that the pl of a path is computed
+ * from the factors directly. This avoids the O(nm) correlation of the moves and the O(n^2) gamma term in the space
+ * of the n risk factors per path. The paths are processed in blocks, for each block the gamma terms are computed as
+ * matrix products which are distributed over the given number of threads. The random numbers are drawn from one
+ * sequence in the calling thread, so the result does not depend on the number of threads. The quantiles are
+ * estimated by selection from the stored PL realisations of each portfolio. */
+template <class RNG>
+std::vector<std::vector<Real>> deltaGammaVarMc(const Matrix& omega, const std::vector<Array>& deltas,
+                                               const std::vector<Matrix>& gammas, const std::vector<Real>& p,
+                                               const Size paths, const Size seed,
+                                               const CovarianceSalvage& sal = NoCovarianceSalvage(),
+                                               const Size threads = 1);
+
 namespace detail {
 void check(const Real p);
 void check(const Matrix& omega, const Array& delta);
@@ -87,53 +103,155 @@ template <typename A> Real absMax(const A& a) {
     }
     return tmp;
 }
+/* y[b * m.rows() + i] = sum_j m[i][j] x[b * m.columns() + j] for i = 0, ..., m.rows() - 1 and b = 0, ..., n - 1 */
+void rowProducts(const Matrix& m, const Real* x, const Size n, Real* y);
+/* the right tail quantile of the sample v estimated in the same way as boost's tail_quantile, the order of the
+   elements in v is changed */
+Real rightTailQuantile(std::vector<Real>& v, const Real p);
 } // namespace detail
 
 // implementation
 
 template <class RNG>
-std::vector<Real> deltaGammaVarMc(const Matrix& omega, const Array& delta, const Matrix& gamma,
-				  const std::vector<Real>& p, const Size paths, const Size seed,
-				  const CovarianceSalvage& sal) {
+std::vector<std::vector<Real>> deltaGammaVarMc(const Matrix& omega, const std::vector<Array>& deltas,
+                                               const std::vector<Matrix>& gammas, const std::vector<Real>& p,
+                                               const Size paths, const Size seed, const CovarianceSalvage& sal,
+                                               const Size threads) {
+    QL_REQUIRE(deltas.size() == gammas.size(), "deltaGammaVarMc: number of deltas (" << deltas.size()
+                                                                                     << ") and gammas ("
+                                                                                     << gammas.size()
+                                                                                     << ") must be equal");
+    QL_REQUIRE(threads > 0, "deltaGammaVarMc: threads must be positive");
     BOOST_FOREACH (Real q, p) { detail::check(q); }
-    detail::check(omega, delta, gamma);
+    for (Size k = 0; k < deltas.size(); ++k)
+        detail::check(omega, deltas[k], gammas[k]);
 
-    Real num = std::max(detail::absMax(delta), detail::absMax(gamma));
-    if (QuantLib::close_enough(num, 0.0)) {
-        std::vector<Real> res(p.size(), 0.0);
-        return res;
+    std::vector<std::vector<Real>> res(deltas.size(), std::vector<Real>(p.size(), 0.0));
+
+    // the portfolios with non-zero sensitivities, the gamma term is only computed if the gamma is non-zero
+
+    std::vector<Size> active;
+    std::vector<bool> hasGamma;
+    for (Size k = 0; k < deltas.size(); ++k) {
+        Real deltaMax = detail::absMax(deltas[k]), gammaMax = detail::absMax(gammas[k]);
+        if (!QuantLib::close_enough(std::max(deltaMax, gammaMax), 0.0)) {
+            active.push_back(k);
+            hasGamma.push_back(!QuantLib::close_enough(gammaMax, 0.0));
+        }
     }
+    if (active.empty() || paths == 0)
+        return res;
 
     Matrix L = sal.salvage(omega).second;
     if (L.rows() == 0) {
         L = CholeskyDecomposition(omega, true);
     }
 
-    Real pmin = QL_MAX_REAL;
-    BOOST_FOREACH (Real q, p) { pmin = std::min(pmin, q); }
+    // remove the zero columns of L, which do not contribute to the risk factor moves
 
-    Size cache = Size(std::floor(static_cast<double>(paths) * (1.0 - pmin) + 0.5)) + 2;
-    boost::accumulators::accumulator_set<
-        double, boost::accumulators::stats<boost::accumulators::tag::tail_quantile<boost::accumulators::right> > >
-        acc(boost::accumulators::tag::tail<boost::accumulators::right>::cache_size = cache);
+    Size n = omega.rows();
+    std::vector<Size> columns;
+    for (Size j = 0; j < n; ++j) {
+        for (Size i = 0; i < n; ++i) {
+            if (L[i][j] != 0.0) {
+                columns.push_back(j);
+                break;
+            }
+        }
+    }
+    Size m = columns.size();
+    Matrix Lc(n, m);
+    for (Size i = 0; i < n; ++i) {
+        for (Size c = 0; c < m; ++c)
+            Lc[i][c] = L[i][columns[c]];
+    }
 
-    typename RNG::rsg_type rng = RNG::make_sequence_generator(delta.size(), seed);
+    // project the sensitivities onto the factors, with the risk factor moves u = Lc z the pl of a path is
+    // z^T (Lc^T delta) + 1/2 z^T (Lc^T gamma Lc) z
 
-    for (Size i = 0; i < paths; ++i) {
-        std::vector<Real> seq = rng.nextSequence().value;
-        Array z(seq.begin(), seq.end());
-        Array u = L * z;
-        acc(DotProduct(u, delta) + 0.5 * DotProduct(u, gamma * u));
+    Matrix LcT = transpose(Lc);
+    std::vector<Array> factorDeltas(active.size());
+    std::vector<Matrix> factorGammas(active.size());
+    for (Size a = 0; a < active.size(); ++a) {
+        factorDeltas[a] = LcT * deltas[active[a]];
+        if (hasGamma[a])
+            factorGammas[a] = LcT * gammas[active[a]] * Lc;
     }
 
-    std::vector<Real> res;
-    BOOST_FOREACH (Real q, p) {
-        res.push_back(boost::accumulators::quantile(acc, boost::accumulators::quantile_probability = q));
+    // the random numbers for one batch of paths are drawn in the calling thread, the batch is processed in blocks of
+    // paths, each block is one task
+
+    const Size blockSize = 64;
+    Size nThreads = std::max<Size>(std::min(threads, (paths + blockSize - 1) / blockSize), 1);
+    std::unique_ptr<WorkerPool> pool;
+    if (nThreads > 1)
+        pool = std::make_unique<WorkerPool>(nThreads);
+    Size batchSize = nThreads * blockSize;
+
+    typename RNG::rsg_type rng = RNG::make_sequence_generator(n, seed);
+    std::vector<std::vector<Real>> pl(active.size(), std::vector<Real>(paths));
+    std::vector<Real> z(batchSize * m);
+    Size start = 0, size = 0;
+
+    auto task = [&](Size t) {
+        Size b0 = t * blockSize, nb = std::min(blockSize, size - b0);
+        const Real* zt = z.data() + b0 * m;
+        std::vector<Real> v;
+        for (Size a = 0; a < active.size(); ++a) {
+            const Array& delta = factorDeltas[a];
+            if (hasGamma[a]) {
+                v.resize(nb * m);
+                detail::rowProducts(factorGammas[a], zt, nb, v.data());
+            }
+            for (Size b = 0; b < nb; ++b) {
+                const Real* zb = zt + b * m;
+                Real s = 0.0;
+                if (hasGamma[a]) {
+                    const Real* vb = &v[b * m];
+                    for (Size c = 0; c < m; ++c)
+                        s += zb[c] * (delta[c] + 0.5 * vb[c]);
+                } else {
+                    for (Size c = 0; c < m; ++c)
+                        s += zb[c] * delta[c];
+                }
+                pl[a][start + b0 + b] = s;
+            }
+        }
+    };
+
+    for (start = 0; start < paths; start += batchSize) {
+        size = std::min(batchSize, paths - start);
+        for (Size b = 0; b < size; ++b) {
+            const std::vector<Real>& seq = rng.nextSequence().value;
+            for (Size c = 0; c < m; ++c)
+                z[b * m + c] = seq[columns[c]];
+        }
+        Size nBlocks = (size + blockSize - 1) / blockSize;
+        if (pool)
+            pool->run(nBlocks, task);
+        else {
+            for (Size t = 0; t < nBlocks; ++t)
+                task(t);
+        }
+    }
+
+    for (Size a = 0; a < active.size(); ++a) {
+        for (Size q = 0; q < p.size(); ++q)
+            res[active[a]][q] = detail::rightTailQuantile(pl[a], p[q]);
     }
 
     return res;
 }
 
+template <class RNG>
+std::vector<Real> deltaGammaVarMc(const Matrix& omega, const Array& delta, const Matrix& gamma,
+				  const std::vector<Real>& p, const Size paths, const Size seed,
+				  const CovarianceSalvage& sal) {
+    return deltaGammaVarMc<RNG>(omega, std::vector<Array>(1, delta), std::vector<Matrix>(1, gamma), p, paths, seed,
+                                sal)
+        .front();
+}
+
 template <class RNG>
 Real deltaGammaVarMc(const Matrix& omega, const Array& delta, const Matrix& gamma, const Real p, const Size paths,
                      const Size seed, const CovarianceSalvage& sal) {
@@ -0,0 +1,43 @@
+/*
+ Copyright (C) 2023 Quaternion Risk Management Ltd
+ All rights reserved.
+
+ This file is part of ORE, a free-software/open-source library
+ for transparent pricing and risk analysis - http://opensourcerisk.org
+
+ ORE is free software: you can redistribute it and/or modify it
+ under the terms of the Modified BSD License.  You should have received a
+ copy of the license along with this program.
+ The license is also available online at <http://opensourcerisk.org>
+
+ This program is distributed on the basis that it will form a useful
+ contribution to risk analytics and model standardisation, but WITHOUT
+ ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ FITNESS FOR A PARTICULAR PURPOSE. See the license for more details.
+*/
+
+#include <qle/math/gausslegendreintegral.hpp>
+
+#include <ql/math/integrals/gaussianquadratures.hpp>
+
+namespace QuantExt {
+
+GaussLegendreIntegral::GaussLegendreIntegral(const Size order) : Integrator(QL_MAX_REAL, order) {
+    QL_REQUIRE(order > 0, "GaussLegendreIntegral: order must be positive");
+    GaussLegendreIntegration gl(order);
+    x_ = gl.x();
+    w_ = gl.weights();
+}
+
+Real GaussLegendreIntegral::integrate(const ext::function<Real(Real)>& f, Real a, Real b) const {
+    // map the nodes from [-1,1] to [a,b]
+    const Real c1 = 0.5 * (b - a), c2 = 0.5 * (b + a);
+    Real sum = 0.0;
+    for (Size i = 0; i < x_.size(); ++i)
+        sum += w_[i] * f(c1 * x_[i] + c2);
+    increaseNumberOfEvaluations(x_.size());
+    setAbsoluteError(0.0);
+    return c1 * sum;
+}
+
+} // namespace QuantExt
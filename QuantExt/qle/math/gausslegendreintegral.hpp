@@ -0,0 +1,55 @@
+/*
+ Copyright (C) 2023 Quaternion Risk Management Ltd
+ All rights reserved.
+
+ This file is part of ORE, a free-software/open-source library
+ for transparent pricing and risk analysis - http://opensourcerisk.org
+
+ ORE is free software: you can redistribute it and/or modify it
+ under the terms of the Modified BSD License.  You should have received a
+ copy of the license along with this program.
+ The license is also available online at <http://opensourcerisk.org>
+
+ This program is distributed on the basis that it will form a useful
+ contribution to risk analytics and model standardisation, but WITHOUT
+ ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ FITNESS FOR A PARTICULAR PURPOSE. See the license for more details.
+*/
+
+/*! \file qle/math/gausslegendreintegral.hpp
+    \brief fixed order Gauss-Legendre integrator
+    \ingroup math
+*/
+
+#pragma once
+
+#include <ql/math/array.hpp>
+#include <ql/math/integrals/integral.hpp>
+
+namespace QuantExt {
+using namespace QuantLib;
+
+//! Fixed order Gauss-Legendre integrator
+/*! The integral over \f$[a,b]\f$ is computed with a single Gauss-Legendre rule of the given order, i.e. with exactly
+    order function evaluations, there is no error estimate or refinement. The rule is exact for polynomials up to degree
+    2 * order - 1 and converges exponentially for analytic integrands.
+
+    This is meant to be wrapped in a PiecewiseIntegral whose critical points are the step times of piecewise
+    parametrizations: the cross asset model integrands are then piecewise constant or polynomial, or exponentials of
+    linear functions, between two critical points and the integrals are evaluated in closed form up to rounding.
+
+    \ingroup math
+*/
+class GaussLegendreIntegral : public Integrator {
+public:
+    explicit GaussLegendreIntegral(const Size order = 16);
+    Size order() const { return x_.size(); }
+
+protected:
+    Real integrate(const ext::function<Real(Real)>& f, Real a, Real b) const override;
+
+private:
+    Array x_, w_;
+};
+
+} // namespace QuantExt
@@ -0,0 +1,66 @@
+/*
+ Copyright (C) 2023 Quaternion Risk Management Ltd
+ All rights reserved.
+
+ This file is part of ORE, a free-software/open-source library
+ for transparent pricing and risk analysis - http://opensourcerisk.org
+
+ ORE is free software: you can redistribute it and/or modify it
+ under the terms of the Modified BSD License.  You should have received a
+ copy of the license along with this program.
+ The license is also available online at <http://opensourcerisk.org>
+
+ This program is distributed on the basis that it will form a useful
+ contribution to risk analytics and model standardisation, but WITHOUT
+ ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ FITNESS FOR A PARTICULAR PURPOSE. See the license for more details.
+*/
+
+#include <qle/math/mcvariancereduction.hpp>
+
+#include <cmath>
+
+namespace QuantExt {
+
+Real mcErrorEstimate(const RandomVariable& v, const bool antithetic) {
+    if (v.deterministic() || v.size() < 2)
+        return 0.0;
+    if (!antithetic || v.size() % 2 != 0)
+        return std::sqrt(variance(v).at(0) / static_cast<Real>(v.size()));
+    Size m = v.size() / 2;
+    RandomVariable pairAverage(m);
+    for (Size i = 0; i < m; ++i)
+        pairAverage.set(i, 0.5 * (v[2 * i] + v[2 * i + 1]));
+    return std::sqrt(variance(pairAverage).at(0) / static_cast<Real>(m));
+}
+
+Real controlVariateMean(const RandomVariable& y, const std::vector<RandomVariable>& controls,
+                        const std::vector<Real>& controlMeans, const bool antithetic, Real* errorEstimate) {
+    QL_REQUIRE(controls.size() == controlMeans.size(), "controlVariateMean(): controls size ("
+                                                           << controls.size() << ") does not match control means size ("
+                                                           << controlMeans.size() << ")");
+    Size n = y.size();
+    std::vector<RandomVariable> basis(1, RandomVariable(n, 1.0));
+    for (Size k = 0; k < controls.size(); ++k) {
+        QL_REQUIRE(controls[k].size() == n, "controlVariateMean(): control #" << k << " has size " << controls[k].size()
+                                                                          << ", expected " << n);
+        // skip (numerically) deterministic controls, they would make the regression singular
+        if (!controls[k].deterministic() && !QuantLib::close_enough(variance(controls[k]).at(0), 0.0))
+            basis.push_back(controls[k] - RandomVariable(n, controlMeans[k]));
+    }
+
+    // without (stochastic) controls or if y is deterministic this is the plain sample mean
+
+    if (basis.size() == 1 || y.deterministic()) {
+        if (errorEstimate != nullptr)
+            *errorEstimate = mcErrorEstimate(y, antithetic);
+        return expectation(y).at(0);
+    }
+
+    Array coefficients = regressionCoefficients(y, basis);
+    if (errorEstimate != nullptr)
+        *errorEstimate = mcErrorEstimate(y - conditionalExpectation(basis, coefficients), antithetic);
+    return coefficients[0];
+}
+
+} // namespace QuantExt
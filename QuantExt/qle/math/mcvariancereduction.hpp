@@ -0,0 +1,47 @@
+/*
+ Copyright (C) 2023 Quaternion Risk Management Ltd
+ All rights reserved.
+
+ This file is part of ORE, a free-software/open-source library
+ for transparent pricing and risk analysis - http://opensourcerisk.org
+
+ ORE is free software: you can redistribute it and/or modify it
+ under the terms of the Modified BSD License.  You should have received a
+ copy of the license along with this program.
+ The license is also available online at <http://opensourcerisk.org>
+
+ This program is distributed on the basis that it will form a useful
+ contribution to risk analytics and model standardisation, but WITHOUT
+ ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ FITNESS FOR A PARTICULAR PURPOSE. See the license for more details.
+*/
+
+/*! \file qle/math/mcvariancereduction.hpp
+    \brief monte carlo error estimates and control variates on random variables
+    \ingroup math
+*/
+
+#pragma once
+
+#include <qle/math/randomvariable.hpp>
+
+namespace QuantExt {
+
+/*! Standard error of the sample mean of v. If antithetic is true, consecutive samples 2i, 2i+1 are treated as
+    antithetic pairs and the error is estimated from the pair averages, since the samples themselves are not
+    independent in this case. The error of a deterministic variable is zero. */
+Real mcErrorEstimate(const RandomVariable& v, const bool antithetic = false);
+
+/*! Control variate estimate of the mean of y. The controls x_k must have known expectations mu_k, the estimate is the
+    intercept a of the regression
+
+    y = a + sum_k b_k (x_k - mu_k) + eps
+
+    Controls with zero sample variance are ignored. If errorEstimate is not null, it is set to the standard error of
+    the estimate, which is computed from the regression residuals, see mcErrorEstimate() for the meaning of
+    antithetic. */
+Real controlVariateMean(const RandomVariable& y, const std::vector<RandomVariable>& controls,
+                        const std::vector<Real>& controlMeans, const bool antithetic = false,
+                        Real* errorEstimate = nullptr);
+
+} // namespace QuantExt
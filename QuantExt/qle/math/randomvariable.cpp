@@ -1099,6 +1099,45 @@ RandomVariable applyInverseFilter(RandomVariable x, const Filter& f) {
     return x;
 }
 
+namespace {
+Array solveRegression(const Matrix& A, RandomVariable r, const Filter& filter,
+                      const RandomVariableRegressionMethod regressionMethod) {
+
+    if (filter.size() > 0) {
+        r = applyFilter(r, filter);
+    }
+
+    Array b(r.size());
+    if (r.deterministic())
+        std::fill(b.begin(), b.end(), r[0]);
+    else
+        r.copyToArray(b);
+
+    Array res;
+    if (regressionMethod == RandomVariableRegressionMethod::SVI) {
+        SVD svd(A);
+        const Matrix& V = svd.V();
+        const Matrix& U = svd.U();
+        const Array& w = svd.singularValues();
+        Real threshold = r.size() * QL_EPSILON * svd.singularValues()[0];
+        res = Array(A.columns(), 0.0);
+        for (Size i = 0; i < A.columns(); ++i) {
+            if (w[i] > threshold) {
+                Real u = std::inner_product(U.column_begin(i), U.column_end(i), b.begin(), Real(0.0)) / w[i];
+                for (Size j = 0; j < A.columns(); ++j) {
+                    res[j] += u * V[j][i];
+                }
+            }
+        }
+    } else if (regressionMethod == RandomVariableRegressionMethod::QR) {
+        res = qrSolve(A, b);
+    } else {
+        QL_FAIL("regressionCoefficients(): unknown regression method, expected SVI or QR.");
+    }
+    return res;
+}
+} // namespace
+
 Array regressionCoefficients(
     RandomVariable r, const std::vector<const RandomVariable*>& regressor,
     const std::vector<std::function<RandomVariable(const std::vector<const RandomVariable*>&)>>& basisFn,
@@ -1140,40 +1179,46 @@ Array regressionCoefficients(
         std::cout << std::flush;
     }
 
-    if (filter.size() > 0) {
-        r = applyFilter(r, filter);
-    }
+    Array res = solveRegression(A, r, filter, regressionMethod);
 
-    Array b(r.size());
-    if (r.deterministic())
-        std::fill(b.begin(), b.end(), r[0]);
-    else
-        r.copyToArray(b);
+    // rough estimate, SVI is O(mn min(m,n))
+    stopCalcStats(r.size() * basisFn.size() * std::min(r.size(), basisFn.size()));
+    return res;
+}
 
-    Array res;
-    if (regressionMethod == RandomVariableRegressionMethod::SVI) {
-        SVD svd(A);
-        const Matrix& V = svd.V();
-        const Matrix& U = svd.U();
-        const Array& w = svd.singularValues();
-        Real threshold = r.size() * QL_EPSILON * svd.singularValues()[0];
-        res = Array(basisFn.size(), 0.0);
-        for (Size i = 0; i < basisFn.size(); ++i) {
-            if (w[i] > threshold) {
-                Real u = std::inner_product(U.column_begin(i), U.column_end(i), b.begin(), Real(0.0)) / w[i];
-                for (Size j = 0; j < basisFn.size(); ++j) {
-                    res[j] += u * V[j][i];
-                }
-            }
+Array regressionCoefficients(RandomVariable r, const std::vector<RandomVariable>& basisValues, const Filter& filter,
+                             const RandomVariableRegressionMethod regressionMethod) {
+
+    QL_REQUIRE(filter.size() == 0 || filter.size() == r.size(),
+               "filter size (" << filter.size() << ") must match regressand size (" << r.size() << ")");
+
+    QL_REQUIRE(r.size() >= basisValues.size(), "regressionCoefficients(): sample size ("
+                                                   << r.size() << ") must be geq basis fns size ("
+                                                   << basisValues.size() << ")");
+
+    resumeCalcStats();
+
+    Matrix A(r.size(), basisValues.size());
+    for (Size j = 0; j < basisValues.size(); ++j) {
+        QL_REQUIRE(basisValues[j].size() == r.size(), "basis value size (" << basisValues[j].size()
+                                                                           << ") must match regressand size ("
+                                                                           << r.size() << ")");
+        const RandomVariable* a = &basisValues[j];
+        RandomVariable filtered;
+        if (filter.initialised()) {
+            filtered = applyFilter(basisValues[j], filter);
+            a = &filtered;
         }
-    } else if (regressionMethod == RandomVariableRegressionMethod::QR) {
-        res = qrSolve(A, b);
-    } else {
-        QL_FAIL("regressionCoefficients(): unknown regression method, expected SVI or QR.");
+        if (a->deterministic())
+            std::fill(A.column_begin(j), A.column_end(j), (*a)[0]);
+        else
+            a->copyToMatrixCol(A, j);
     }
 
+    Array res = solveRegression(A, r, filter, regressionMethod);
+
     // rough estimate, SVI is O(mn min(m,n))
-    stopCalcStats(r.size() * basisFn.size() * std::min(r.size(), basisFn.size()));
+    stopCalcStats(r.size() * basisValues.size() * std::min(r.size(), basisValues.size()));
     return res;
 }
 
@@ -1196,6 +1241,19 @@ RandomVariable conditionalExpectation(
     return r;
 }
 
+RandomVariable conditionalExpectation(const std::vector<RandomVariable>& basisValues, const Array& coefficients) {
+    QL_REQUIRE(!basisValues.empty(), "basis values vector is empty");
+    QL_REQUIRE(basisValues.size() == coefficients.size(), "basis values size (" << basisValues.size()
+                                                                                << ") must match coefficients size ("
+                                                                                << coefficients.size() << ")");
+    Size n = basisValues.front().size();
+    RandomVariable r(n, 0.0);
+    for (Size i = 0; i < coefficients.size(); ++i) {
+        r = r + RandomVariable(n, coefficients[i]) * basisValues[i];
+    }
+    return r;
+}
+
 RandomVariable conditionalExpectation(
     const RandomVariable& r, const std::vector<const RandomVariable*>& regressor,
     const std::vector<std::function<RandomVariable(const std::vector<const RandomVariable*>&)>>& basisFn,
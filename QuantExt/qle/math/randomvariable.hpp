@@ -284,12 +284,20 @@ Array regressionCoefficients(
     const Filter& filter = Filter(), const RandomVariableRegressionMethod = RandomVariableRegressionMethod::QR,
     const std::string& debugLabel = std::string());
 
+// compute regression coefficients from precomputed basis function values
+Array regressionCoefficients(RandomVariable r, const std::vector<RandomVariable>& basisValues,
+                             const Filter& filter = Filter(),
+                             const RandomVariableRegressionMethod = RandomVariableRegressionMethod::QR);
+
 // evaluate regression function
 RandomVariable conditionalExpectation(
     const std::vector<const RandomVariable*>& regressor,
     const std::vector<std::function<RandomVariable(const std::vector<const RandomVariable*>&)>>& basisFn,
     const Array& coefficients);
 
+// evaluate regression function from precomputed basis function values
+RandomVariable conditionalExpectation(const std::vector<RandomVariable>& basisValues, const Array& coefficients);
+
 // compute and evaluate regression in one run
 RandomVariable conditionalExpectation(
     const RandomVariable& r, const std::vector<const RandomVariable*>& regressor,
@@ -61,6 +61,9 @@ public:
     Array solve_splitting(Size direction, const Array& r, Real s) const override;
     Array preconditioner(const Array& r, Real s) const override;
 
+    //! the operator for the time interval given in the last call to setTime()
+    const TripleBandLinearOp& map() const { return mapT_; }
+
 #if !defined(QL_NO_UBLAS_SUPPORT)
     std::vector<QuantLib::SparseMatrix> toMatrixDecomp() const override;
 #endif
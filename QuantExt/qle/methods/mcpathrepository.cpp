@@ -0,0 +1,104 @@
+/*
+ Copyright (C) 2023 Quaternion Risk Management Ltd
+ All rights reserved.
+
+ This file is part of ORE, a free-software/open-source library
+ for transparent pricing and risk analysis - http://opensourcerisk.org
+
+ ORE is free software: you can redistribute it and/or modify it
+ under the terms of the Modified BSD License.  You should have received a
+ copy of the license along with this program.
+ The license is also available online at <http://opensourcerisk.org>
+
+ This program is distributed on the basis that it will form a useful
+ contribution to risk analytics and model standardisation, but WITHOUT
+ ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ FITNESS FOR A PARTICULAR PURPOSE. See the license for more details.
+*/
+
+#include <qle/methods/mcpathrepository.hpp>
+
+#include <boost/make_shared.hpp>
+
+#include <tuple>
+
+namespace QuantExt {
+
+bool McPathRepository::Key::operator<(const Key& k) const {
+    return std::tie(model, sequenceType, seed, samples, ordering, directionIntegers, times) <
+           std::tie(k.model, k.sequenceType, k.seed, k.samples, k.ordering, k.directionIntegers, k.times);
+}
+
+boost::shared_ptr<const McPathRepository::Paths>
+McPathRepository::paths(const Key& key, const boost::shared_ptr<CrossAssetModel>& model,
+                        const std::function<Paths()>& generator) {
+
+    QL_REQUIRE(model.get() == key.model, "McPathRepository::paths(): model does not match key");
+
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        if (maxSize_ == 0)
+            return boost::make_shared<Paths>(generator());
+        if (auto e = entries_.find(key); e != entries_.end()) {
+            // the model pointer might have been reused by a new model instance
+            if (e->second.model.lock() == model) {
+                ++hits_;
+                return e->second.paths;
+            }
+            size_ -= e->second.size;
+            entries_.erase(e);
+            insertionOrder_.remove(key);
+        }
+        ++misses_;
+    }
+
+    // generate the paths outside the lock
+
+    boost::shared_ptr<const Paths> paths = boost::make_shared<Paths>(generator());
+    Size size = 0;
+    for (auto const& p : *paths)
+        for (auto const& v : p)
+            size += v.size();
+
+    std::lock_guard<std::mutex> lock(mutex_);
+    if (size > maxSize_ || entries_.find(key) != entries_.end())
+        return paths;
+    while (size_ + size > maxSize_)
+        removeOldest();
+    entries_[key] = Entry{model, paths, size};
+    insertionOrder_.push_back(key);
+    size_ += size;
+    registerWith(model);
+    return paths;
+}
+
+void McPathRepository::removeOldest() {
+    auto e = entries_.find(insertionOrder_.front());
+    size_ -= e->second.size;
+    entries_.erase(e);
+    insertionOrder_.pop_front();
+}
+
+void McPathRepository::setMaxSize(const Size maxSize) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    maxSize_ = maxSize;
+    while (size_ > maxSize_)
+        removeOldest();
+}
+
+void McPathRepository::clear() {
+    std::lock_guard<std::mutex> lock(mutex_);
+    entries_.clear();
+    insertionOrder_.clear();
+    size_ = hits_ = misses_ = 0;
+    unregisterWithAll();
+}
+
+void McPathRepository::update() {
+    std::lock_guard<std::mutex> lock(mutex_);
+    entries_.clear();
+    insertionOrder_.clear();
+    size_ = 0;
+}
+
+} // namespace QuantExt
@@ -0,0 +1,109 @@
+/*
+ Copyright (C) 2023 Quaternion Risk Management Ltd
+ All rights reserved.
+
+ This file is part of ORE, a free-software/open-source library
+ for transparent pricing and risk analysis - http://opensourcerisk.org
+
+ ORE is free software: you can redistribute it and/or modify it
+ under the terms of the Modified BSD License.  You should have received a
+ copy of the license along with this program.
+ The license is also available online at <http://opensourcerisk.org>
+
+ This program is distributed on the basis that it will form a useful
+ contribution to risk analytics and model standardisation, but WITHOUT
+ ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ FITNESS FOR A PARTICULAR PURPOSE. See the license for more details.
+*/
+
+/*! \file mcpathrepository.hpp
+    \brief repository for simulated model state paths shared between mc engines
+    \ingroup methods
+*/
+
+#pragma once
+
+#include <qle/math/randomvariable.hpp>
+#include <qle/methods/multipathgeneratorbase.hpp>
+#include <qle/models/crossassetmodel.hpp>
+
+#include <ql/patterns/observable.hpp>
+#include <ql/patterns/singleton.hpp>
+
+#include <boost/weak_ptr.hpp>
+
+#include <functional>
+#include <list>
+#include <map>
+#include <mutex>
+
+namespace QuantExt {
+using namespace QuantLib;
+
+//! Repository for simulated model state paths shared between mc engines
+/*! Engines simulating the state of a cross asset model on a time grid can retrieve the paths from this repository
+    instead of generating them. The paths are identified by the model, the path generator settings and the time grid,
+    i.e. an engine requesting paths for the same key as a previous engine gets exactly the same paths it would have
+    generated itself.
+
+    The repository is disabled by default (maximum size zero). A client like the amc valuation engine enables it for
+    the duration of a run by setting a maximum size, which is the maximum number of stored values (paths x times x
+    state variables summed over all entries), and clears it afterwards. If adding a new entry exceeds the maximum
+    size, the oldest entries are removed. The repository is cleared if one of the models notifies a change.
+
+    \ingroup methods
+*/
+class McPathRepository : public QuantLib::Singleton<McPathRepository>, public QuantLib::Observer {
+public:
+    //! simulated values indexed by time and model state index
+    typedef std::vector<std::vector<RandomVariable>> Paths;
+
+    struct Key {
+        const CrossAssetModel* model;
+        SequenceType sequenceType;
+        Size seed, samples;
+        SobolBrownianGenerator::Ordering ordering;
+        SobolRsg::DirectionIntegers directionIntegers;
+        std::vector<Real> times;
+        bool operator<(const Key& k) const;
+    };
+
+    /*! return the paths for the given key, if they are not found in the repository they are generated using the
+        given generator and stored if the repository is enabled */
+    boost::shared_ptr<const Paths> paths(const Key& key, const boost::shared_ptr<CrossAssetModel>& model,
+                                         const std::function<Paths()>& generator);
+
+    //! maximum size in number of stored values, zero disables the repository
+    void setMaxSize(const Size maxSize);
+    Size maxSize() const { return maxSize_; }
+    //! current size in number of stored values
+    Size size() const { return size_; }
+
+    //! remove all entries and reset the statistics
+    void clear();
+
+    //! statistics
+    Size hits() const { return hits_; }
+    Size misses() const { return misses_; }
+
+    //! \name Observer interface
+    //@{
+    void update() override;
+    //@}
+
+private:
+    struct Entry {
+        boost::weak_ptr<CrossAssetModel> model;
+        boost::shared_ptr<const Paths> paths;
+        Size size;
+    };
+
+    void removeOldest();
+
+    mutable std::mutex mutex_;
+    Size maxSize_ = 0, size_ = 0, hits_ = 0, misses_ = 0;
+    std::map<Key, Entry> entries_;
+    std::list<Key> insertionOrder_;
+};
+
+} // namespace QuantExt
@@ -167,7 +167,7 @@ void CrossAssetModel::update() {
     for (Size i = 0; i < p_.size(); ++i) {
         p_[i]->update();
     }
-    stateProcess()->resetCache(0); // disable cache
+    stateProcess()->flushCache(); // invalidate the time step tables
     notifyObservers();
 }
 
@@ -267,7 +267,9 @@ public:
     SalvagingAlgorithm::Type salvagingAlgorithm() const { return salvaging_; }
 
     /*! analytical moments require numerical integration,
-      which can be customized here */
+      which can be customized here; the default is an adaptive simpson rule, since all parametrizations are piecewise
+      constant or linear between their parameter times, a GaussLegendreIntegral with piecewise integration evaluates
+      the integrals in closed form up to rounding with far fewer function evaluations */
     void setIntegrationPolicy(const boost::shared_ptr<Integrator> integrator,
                               const bool usePiecewiseIntegration = true) const;
     const boost::shared_ptr<Integrator> integrator() const;
@@ -18,6 +18,7 @@
 
 #include <iostream>
 #include <ql/experimental/math/piecewiseintegral.hpp>
+#include <ql/models/shortrate/calibrationhelpers/swaptionhelper.hpp>
 #include <qle/models/lgm.hpp>
 #include <qle/processes/irlgm1fstateprocess.hpp>
 
@@ -55,6 +56,83 @@ Real LinearGaussMarkovModel::bankAccountNumeraire(const Time t, const Real x, co
            (discountCurve.empty() ? parametrization_->termStructure()->discount(t) : discountCurve->discount(t));
 }
 
+Size LinearGaussMarkovModel::calibrateVolatilitiesIterativeNewton(
+    const std::vector<boost::shared_ptr<BlackCalibrationHelper>>& helpers, OptimizationMethod& method,
+    const EndCriteria& endCriteria, const Real accuracy, const Size maxIterations) {
+    Size fallbacks = 0;
+    for (Size i = 0; i < helpers.size(); ++i) {
+        if (!calibrateVolatilityNewton(i, helpers[i], accuracy, maxIterations)) {
+            std::vector<boost::shared_ptr<BlackCalibrationHelper>> h(1, helpers[i]);
+            calibrate(h, method, endCriteria, Constraint(), std::vector<Real>(), MoveVolatility(i));
+            ++fallbacks;
+        }
+    }
+    return fallbacks;
+}
+
+bool LinearGaussMarkovModel::calibrateVolatilityNewton(const Size i,
+                                                       const boost::shared_ptr<BlackCalibrationHelper>& helper,
+                                                       const Real accuracy, const Size maxIterations) {
+    auto swaptionHelper = boost::dynamic_pointer_cast<SwaptionHelper>(helper);
+    if (swaptionHelper == nullptr)
+        return false;
+
+    const boost::shared_ptr<Parameter>& vol = parametrization_->parameter(0);
+    QL_REQUIRE(i < vol->size(), "LGM::calibrateVolatilityNewton(): volatility index ("
+                                    << i << ") out of range 0..." << vol->size() - 1);
+
+    Real marketValue = helper->marketValue();
+    if (close_enough(marketValue, 0.0))
+        return false;
+
+    Time expiry =
+        parametrization_->termStructure()->timeFromReference(swaptionHelper->swaption()->exercise()->dates().back());
+    const Real theta0 = vol->params()[i];
+    Real theta = theta0;
+
+    // restore the initial parameter, so that the fallback starts from a well defined point
+    auto fail = [this, &vol, i, theta0]() {
+        vol->setParam(i, theta0);
+        update();
+        return false;
+    };
+
+    for (Size k = 0; k < maxIterations; ++k) {
+        Real f = helper->modelValue() - marketValue;
+        ++functionEvaluations_;
+        if (!std::isfinite(f))
+            return fail();
+        if (std::abs(f) <= accuracy * std::abs(marketValue))
+            return true;
+
+        Real dNpvdZeta;
+        try {
+            dNpvdZeta = swaptionHelper->swaption()->result<Real>("zetaDerivative");
+        } catch (...) {
+            return fail();
+        }
+
+        // dzeta / dtheta from a central difference on the parametrization, this does not involve any pricing
+        Real h = 1.0E-6 * std::max(std::abs(theta), 1.0E-4);
+        vol->setParam(i, theta + h);
+        parametrization_->update();
+        Real zetaUp = parametrization_->zeta(expiry);
+        vol->setParam(i, theta - h);
+        parametrization_->update();
+        Real zetaDown = parametrization_->zeta(expiry);
+        Real derivative = dNpvdZeta * (zetaUp - zetaDown) / (2.0 * h);
+
+        if (!std::isfinite(derivative) || close_enough(derivative, 0.0))
+            return fail();
+
+        theta -= f / derivative;
+        vol->setParam(i, theta);
+        update();
+    }
+
+    return fail();
+}
+
 Size LinearGaussMarkovModel::n() const { return 1; }
 Size LinearGaussMarkovModel::m() const { return 1; }
 Size LinearGaussMarkovModel::n_aux() const { return evaluateBankAccount_ && measure_ == Measure::BA ? 1 : 0; }
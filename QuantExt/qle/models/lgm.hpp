@@ -105,6 +105,17 @@ public:
                                         const Constraint& constraint = Constraint(),
                                         const std::vector<Real>& weights = std::vector<Real>());
 
+    /*! calibrate volatilities to a sequence of ir options with expiry times equal to step times in the
+        parametrization using a Newton iteration starting from the current parameter values; the helpers
+        must be swaption helpers priced with the AnalyticLgmSwaptionEngine, which provides the derivative
+        of the npv w.r.t. zeta, the derivative of zeta w.r.t. the raw volatility parameter is computed
+        from the parametrization. If the iteration does not converge within the given number of iterations
+        or the derivative is not available, the method falls back to the optimizer for this helper. Returns
+        the number of helpers for which the fallback was used. */
+    Size calibrateVolatilitiesIterativeNewton(const std::vector<boost::shared_ptr<BlackCalibrationHelper>>& helpers,
+                                              OptimizationMethod& method, const EndCriteria& endCriteria,
+                                              const Real accuracy = 1.0E-8, const Size maxIterations = 20);
+
     /*! calibrate reversion to a sequence of ir options with
         maturities equal to step times in the parametrization */
     void calibrateReversionsIterative(const std::vector<boost::shared_ptr<BlackCalibrationHelper>>& helpers,
@@ -152,6 +163,9 @@ public:
     const LgmCalibrationInfo& getCalibrationInfo() const { return calibrationInfo_; }
 
 private:
+    bool calibrateVolatilityNewton(const Size i, const boost::shared_ptr<BlackCalibrationHelper>& helper,
+                                   const Real accuracy, const Size maxIterations);
+
     boost::shared_ptr<IrLgm1fParametrization> parametrization_;
     boost::shared_ptr<Integrator> integrator_;
     Measure measure_;
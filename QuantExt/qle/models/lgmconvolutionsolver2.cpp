@@ -23,8 +23,8 @@
 namespace QuantExt {
 
 LgmConvolutionSolver2::LgmConvolutionSolver2(const boost::shared_ptr<LinearGaussMarkovModel>& model, const Real sy,
-                                             const Size ny, const Real sx, const Size nx)
-    : model_(model), nx_(static_cast<int>(nx)) {
+                                             const Size ny, const Real sx, const Size nx, const Method method)
+    : model_(model), nx_(static_cast<int>(nx)), method_(method) {
 
     // precompute weights
 
@@ -72,6 +72,8 @@ RandomVariable LgmConvolutionSolver2::rollback(const RandomVariable& v, const Re
     if (QuantLib::close_enough(t0, t1) || v.deterministic())
         return v;
     QL_REQUIRE(t0 < t1, "LgmConvolutionSolver2::rollback(): t0 (" << t0 << ") < t1 (" << t1 << ") required.");
+    if (method_ == Method::Banded)
+        return rollbackBanded(v, t1, t0);
     Real sigma = std::sqrt(model_->parametrization()->zeta(t1));
     Real dx = sigma / static_cast<Real>(nx_);
     if (QuantLib::close_enough(t0, 0.0)) {
@@ -113,4 +115,83 @@ RandomVariable LgmConvolutionSolver2::rollback(const RandomVariable& v, const Re
     }
 }
 
+const LgmConvolutionSolver2::BandedWeights& LgmConvolutionSolver2::bandedWeights(const Real t1, const Real t0) const {
+    Real zeta1 = model_->parametrization()->zeta(t1);
+    Real zeta0 = QuantLib::close_enough(t0, 0.0) ? 0.0 : model_->parametrization()->zeta(t0);
+    BandedWeights& b = bandedWeights_[std::make_pair(t1, t0)];
+    if (!b.offset.empty() && b.zeta1 == zeta1 && b.zeta0 == zeta0)
+        return b;
+
+    b.zeta1 = zeta1;
+    b.zeta0 = zeta0;
+    b.start.clear();
+    b.offset.assign(1, 0);
+    b.weights.clear();
+
+    // the same mapping of y to x indices as in rollback(), for t0 = 0 a single row with dx2 = 0 is sufficient
+    Real sigma = std::sqrt(zeta1);
+    Real dx = sigma / static_cast<Real>(nx_);
+    Real std = std::sqrt(zeta1 - zeta0);
+    Real dx2 = std::sqrt(zeta0) / static_cast<Real>(nx_);
+    int rows = QuantLib::close_enough(t0, 0.0) ? 1 : 2 * mx_ + 1;
+    std::vector<int> col(2 * my_ + 1);
+    std::vector<Real> alpha(2 * my_ + 1);
+    for (int k = 0; k < rows; ++k) {
+        // column and weight of the left interpolation point for each y, the column is nondecreasing in y
+        for (int i = 0; i <= 2 * my_; ++i) {
+            Real kp = (dx2 * (k - mx_) + y_[i] * std) / dx + mx_;
+            int kk = int(floor(kp));
+            if (kk < 0) {
+                col[i] = 0;
+                alpha[i] = 1.0;
+            } else if (kk + 1 > 2 * mx_) {
+                col[i] = 2 * mx_;
+                alpha[i] = 1.0;
+            } else {
+                col[i] = kk;
+                alpha[i] = 1.0 + kk - kp;
+            }
+        }
+        int first = col.front();
+        int last = std::min(col.back() + 1, 2 * mx_);
+        Size offset = b.weights.size();
+        b.weights.resize(offset + (last - first + 1), 0.0);
+        for (int i = 0; i <= 2 * my_; ++i) {
+            b.weights[offset + col[i] - first] += w_[i] * alpha[i];
+            if (alpha[i] != 1.0)
+                b.weights[offset + col[i] + 1 - first] += w_[i] * (1.0 - alpha[i]);
+        }
+        b.start.push_back(first);
+        b.offset.push_back(b.weights.size());
+    }
+    return b;
+}
+
+RandomVariable LgmConvolutionSolver2::rollbackBanded(const RandomVariable& v, const Real t1, const Real t0) const {
+    const BandedWeights& b = bandedWeights(t1, t0);
+    auto row = [&b, &v](const Size k) {
+        Real value = 0.0;
+        for (Size j = b.offset[k], c = b.start[k]; j < b.offset[k + 1]; ++j, ++c)
+            value += b.weights[j] * v[c];
+        return value;
+    };
+    if (b.start.size() == 1)
+        return RandomVariable(2 * mx_ + 1, row(0));
+    RandomVariable value(2 * mx_ + 1, 0.0);
+    value.expand();
+    Real* d = value.data();
+    for (Size k = 0; k < b.start.size(); ++k)
+        d[k] = row(k);
+    return value;
+}
+
+std::ostream& operator<<(std::ostream& out, const LgmConvolutionSolver2::Method m) {
+    if (m == LgmConvolutionSolver2::Method::Direct)
+        return out << "Direct";
+    else if (m == LgmConvolutionSolver2::Method::Banded)
+        return out << "Banded";
+    else
+        QL_FAIL("LgmConvolutionSolver2::Method (" << static_cast<int>(m) << ") not covered.");
+}
+
 } // namespace QuantExt
@@ -27,6 +27,8 @@
 #include <qle/math/randomvariable.hpp>
 #include <qle/models/lgm.hpp>
 
+#include <map>
+
 namespace QuantExt {
 
 //! Numerical convolution solver for the LGM model
@@ -36,8 +38,14 @@ namespace QuantExt {
 
 class LgmConvolutionSolver2 {
 public:
+    /*! Direct: loop over the y-grid for each x-grid point in each rollback
+        Banded: build the banded matrix of interpolation weights once per rollback interval and reuse it for all
+                rollbacks over the same interval (i.e. for the underlying, the cashflow components and the option
+                value) and for later calculations as long as the model variance at both ends is unchanged */
+    enum class Method { Direct, Banded };
+
     LgmConvolutionSolver2(const boost::shared_ptr<LinearGaussMarkovModel>& model, const Real sy, const Size ny,
-                          const Real sx, const Size nx);
+                          const Real sx, const Size nx, const Method method = Method::Direct);
 
     /* get grid size */
     Size gridSize() const { return 2 * mx_ + 1; }
@@ -51,11 +59,28 @@ public:
     /* the underlying model */
     const boost::shared_ptr<LinearGaussMarkovModel>& model() const { return model_; }
 
+    /* the rollback method */
+    Method method() const { return method_; }
+
 private:
+    // row k of the rollback matrix has the entries weights[offset[k]], ..., weights[offset[k+1]-1] in the columns
+    // start[k], start[k]+1, ...
+    struct BandedWeights {
+        Real zeta0, zeta1;
+        std::vector<Size> start, offset;
+        std::vector<Real> weights;
+    };
+    const BandedWeights& bandedWeights(const Real t1, const Real t0) const;
+    RandomVariable rollbackBanded(const RandomVariable& v, const Real t1, const Real t0) const;
+
     boost::shared_ptr<LinearGaussMarkovModel> model_;
     int mx_, my_, nx_;
     Real h_;
     std::vector<Real> y_, w_;
+    Method method_;
+    mutable std::map<std::pair<Real, Real>, BandedWeights> bandedWeights_;
 };
 
+std::ostream& operator<<(std::ostream& out, const LgmConvolutionSolver2::Method m);
+
 } // namespace QuantExt
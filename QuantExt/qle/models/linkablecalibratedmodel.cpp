@@ -28,7 +28,7 @@ using std::vector;
 namespace QuantExt {
 
 LinkableCalibratedModel::LinkableCalibratedModel()
-    : constraint_(new PrivateConstraint(arguments_)), endCriteria_(EndCriteria::None) {}
+    : constraint_(new PrivateConstraint(arguments_)), endCriteria_(EndCriteria::None), functionEvaluations_(0) {}
 
 class LinkableCalibratedModel::CalibrationFunction : public CostFunction {
 public:
@@ -40,6 +40,7 @@ public:
 
     virtual Real value(const Array& params) const override {
         model_->setParams(projection_.include(params));
+        ++model_->functionEvaluations_;
         Real value = 0.0;
         for (Size i = 0; i < instruments_.size(); i++) {
             Real diff = instruments_[i]->calibrationError();
@@ -50,6 +51,7 @@ public:
 
     virtual Array values(const Array& params) const override {
         model_->setParams(projection_.include(params));
+        ++model_->functionEvaluations_;
         Array values(instruments_.size());
         for (Size i = 0; i < instruments_.size(); i++) {
             values[i] = instruments_[i]->calibrationError() * std::sqrt(weights_[i]);
@@ -74,6 +74,12 @@ public:
     //! Returns the problem values
     const Array& problemValues() const { return problemValues_; }
 
+    //! Returns the number of calibration cost function evaluations since the last reset
+    Size functionEvaluations() const { return functionEvaluations_; }
+
+    //! Resets the counter of calibration cost function evaluations
+    void resetFunctionEvaluations() { functionEvaluations_ = 0; }
+
     //! Returns array of arguments on which calibration is done
     Array params() const;
 
@@ -85,6 +91,7 @@ protected:
     boost::shared_ptr<Constraint> constraint_;
     EndCriteria::Type endCriteria_;
     Array problemValues_;
+    Size functionEvaluations_;
 
 private:
     //! Constraint imposed on arguments
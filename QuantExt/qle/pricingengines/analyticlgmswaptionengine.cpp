@@ -300,6 +300,18 @@ void AnalyticLgmSwaptionEngine::calculate() const {
                  nominal_ * D0_ * N(u_ * w_ * yStar / sqrt_zetaex));
     results_.value = sum;
 
+    // derivative of the npv w.r.t. zetaex, the contributions from the implicit dependency of yStar on zetaex
+    // and from the yStar term in the d's cancel out due to the definition of yStar (see yStarHelper)
+    NormalDistribution n;
+    Real dsum = 0.0;
+    for (Size j = j1_; j < fixedLeg_.size(); ++j) {
+        dsum += (fixedLeg_[j]->amount() - S_[j - j1_]) * Dj_[j - j1_] * (Hj_[j - j1_] - H0_) *
+                n(u_ * w_ * (yStar + (Hj_[j - j1_] - H0_) * zetaex_) / sqrt_zetaex);
+    }
+    dsum += nominal_ * Dj_.back() * (Hj_.back() - H0_) *
+            n(u_ * w_ * (yStar + (Hj_.back() - H0_) * zetaex_) / sqrt_zetaex);
+
+    results_.additionalResults["zetaDerivative"] = u_ * dsum / (2.0 * sqrt_zetaex);
     results_.additionalResults["fixedAmountCorrectionSettlement"] = S_m1;
     results_.additionalResults["fixedAmountCorrections"] = S_;
 
@@ -58,6 +58,10 @@ namespace QuantExt {
     requirement of the LGM parametrization anyway (see the base parametrization
     class).
 
+    The derivative of the npv w.r.t. zeta at the option expiry is returned
+    as the additional result "zetaDerivative". This can be used to calibrate
+    piecewise volatilities with a Newton iteration.
+
     \ingroup engines
 */
 
@@ -0,0 +1,202 @@
+/*
+ Copyright (C) 2023 Quaternion Risk Management Ltd
+ All rights reserved.
+
+ This file is part of ORE, a free-software/open-source library
+ for transparent pricing and risk analysis - http://opensourcerisk.org
+
+ ORE is free software: you can redistribute it and/or modify it
+ under the terms of the Modified BSD License.  You should have received a
+ copy of the license along with this program.
+ The license is also available online at <http://opensourcerisk.org>
+
+ This program is distributed on the basis that it will form a useful
+ contribution to risk analytics and model standardisation, but WITHOUT
+ ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ FITNESS FOR A PARTICULAR PURPOSE. See the license for more details.
+*/
+
+#include <qle/pricingengines/batchswappricer.hpp>
+#include <qle/termstructures/batchdiscountcurve.hpp>
+
+#include <ql/cashflows/fixedratecoupon.hpp>
+#include <ql/cashflows/iborcoupon.hpp>
+#include <ql/cashflows/simplecashflow.hpp>
+#include <ql/patterns/visitor.hpp>
+#include <ql/settings.hpp>
+
+#include <algorithm>
+#include <typeinfo>
+
+namespace QuantExt {
+
+namespace {
+
+// classifies cashflows using the same dispatch as the AmountGetter in DiscountingSwapEngineMultiCurve
+class CashFlowClassifier : public AcyclicVisitor,
+                           public Visitor<CashFlow>,
+                           public Visitor<Coupon>,
+                           public Visitor<IborCoupon> {
+public:
+    enum class Type { Fixed, Generic, Ibor };
+    Type type() const { return type_; }
+
+    void visit(CashFlow& c) override {
+        // amounts of these cashflows do not depend on market data
+        type_ = typeid(c) == typeid(SimpleCashFlow) || typeid(c) == typeid(Redemption) ||
+                        typeid(c) == typeid(AmortizingPayment)
+                    ? Type::Fixed
+                    : Type::Generic;
+    }
+    void visit(Coupon& c) override { type_ = typeid(c) == typeid(FixedRateCoupon) ? Type::Fixed : Type::Generic; }
+    void visit(IborCoupon&) override { type_ = Type::Ibor; }
+
+private:
+    Type type_ = Type::Generic;
+};
+
+} // namespace
+
+BatchSwapPricer::BatchSwapPricer(const Handle<YieldTermStructure>& discountCurve,
+                                 boost::optional<bool> includeSettlementDateFlows)
+    : discountCurve_(discountCurve), includeSettlementDateFlows_(includeSettlementDateFlows) {}
+
+Size BatchSwapPricer::add(const Swap& swap) {
+    std::vector<bool> payer(swap.legs().size());
+    for (Size i = 0; i < payer.size(); ++i)
+        payer[i] = swap.payer(i);
+    return add(swap.legs(), payer);
+}
+
+Size BatchSwapPricer::add(const std::vector<Leg>& legs, const std::vector<bool>& payer) {
+    QL_REQUIRE(legs.size() == payer.size(),
+               "BatchSwapPricer::add(): legs size (" << legs.size() << ") does not match payer size (" << payer.size()
+                                                     << ")");
+    Size swapIndex = nSwaps_++;
+    CashFlowClassifier classifier;
+    for (Size i = 0; i < legs.size(); ++i) {
+        Size first = cashflow_.size();
+        for (Size j = 0; j < legs[i].size(); ++j) {
+            const boost::shared_ptr<CashFlow>& cf = legs[i][j];
+            cashflow_.push_back(cf);
+            swap_.push_back(swapIndex);
+            sign_.push_back(payer[i] ? -1.0 : 1.0);
+            payDate_.push_back(cf->date());
+            secondRow_.push_back(legs[i].size() > 1 ? first + 1 : Null<Size>());
+            leading_.push_back(j <= 1);
+            cf->accept(classifier);
+            if (classifier.type() == CashFlowClassifier::Type::Fixed) {
+                type_.push_back(AmountType::Fixed);
+                amount_.push_back(cf->amount());
+                iborRow_.push_back(Null<Size>());
+            } else if (classifier.type() == CashFlowClassifier::Type::Ibor) {
+                auto c = boost::static_pointer_cast<IborCoupon>(cf);
+                Handle<YieldTermStructure> fwd = c->iborIndex()->forwardingTermStructure();
+                QL_REQUIRE(!fwd.empty(), "BatchSwapPricer::add(): forwarding curve is empty.");
+                Size k = std::distance(forwardingCurves_.begin(),
+                                       std::find(forwardingCurves_.begin(), forwardingCurves_.end(), fwd));
+                if (k == forwardingCurves_.size())
+                    forwardingCurves_.push_back(fwd);
+                type_.push_back(AmountType::Ibor);
+                amount_.push_back(0.0);
+                iborRow_.push_back(forwardingCurve_.size());
+                forwardingCurve_.push_back(k);
+                accrualStart_.push_back(c->accrualStartDate());
+                accrualEnd_.push_back(c->accrualEndDate());
+                // same estimation as in DiscountingSwapEngineMultiCurve
+                Real factor = 1.0;
+                if (c->iborIndex()->dayCounter() != c->dayCounter())
+                    factor = c->accrualPeriod() /
+                             c->iborIndex()->dayCounter().yearFraction(c->accrualStartDate(), c->accrualEndDate());
+                gearingNominalFactor_.push_back(c->gearing() * c->nominal() * factor);
+                spreadAmount_.push_back(c->spread() * c->accrualPeriod() * c->nominal());
+            } else {
+                type_.push_back(AmountType::Generic);
+                amount_.push_back(0.0);
+                iborRow_.push_back(Null<Size>());
+            }
+        }
+    }
+    return swapIndex;
+}
+
+void BatchSwapPricer::npvs(std::vector<Real>& result) const {
+    result.assign(nSwaps_, 0.0);
+    if (nSwaps_ == 0)
+        return;
+
+    QL_REQUIRE(!discountCurve_.empty(), "BatchSwapPricer::npvs(): empty discounting term structure handle");
+    Date referenceDate = discountCurve_->referenceDate();
+    bool includeRefDateFlows = includeSettlementDateFlows_ ? *includeSettlementDateFlows_
+                                                           : Settings::instance().includeReferenceDateEvents();
+
+    auto occurred = [this, &referenceDate, includeRefDateFlows](const Size r) {
+        return payDate_[r] <= referenceDate && cashflow_[r]->hasOccurred(referenceDate, includeRefDateFlows);
+    };
+
+    // collect the live cashflows, the last time is the one of the npv date (= reference date)
+
+    live_.clear();
+    times_.clear();
+    for (Size r = 0; r < cashflow_.size(); ++r) {
+        if (!occurred(r)) {
+            live_.push_back(r);
+            times_.push_back(discountCurve_->timeFromReference(payDate_[r]));
+        }
+    }
+    times_.push_back(0.0);
+    discounts(discountCurve_, times_, discounts_);
+
+    // estimate the ibor coupons that are not evaluated using amount(), per forwarding curve
+
+    std::vector<bool> estimate(live_.size(), false);
+    for (Size l = 0; l < live_.size(); ++l) {
+        Size r = live_[l];
+        estimate[l] = type_[r] == AmountType::Ibor && !leading_[r] && secondRow_[r] != Null<Size>() &&
+                      !occurred(secondRow_[r]);
+    }
+    iborAmount_.resize(forwardingCurve_.size());
+    for (Size c = 0; c < forwardingCurves_.size(); ++c) {
+        fwdDates_.clear();
+        fwdIndex_.clear();
+        for (Size l = 0; l < live_.size(); ++l) {
+            if (!estimate[l])
+                continue;
+            Size k = iborRow_[live_[l]];
+            if (forwardingCurve_[k] != c)
+                continue;
+            fwdIndex_.push_back(k);
+            fwdDates_.push_back(accrualStart_[k]);
+            fwdDates_.push_back(accrualEnd_[k]);
+        }
+        if (fwdIndex_.empty())
+            continue;
+        std::vector<DiscountFactor> fwdDiscounts;
+        discounts(forwardingCurves_[c], fwdDates_, fwdDiscounts);
+        for (Size m = 0; m < fwdIndex_.size(); ++m) {
+            Size k = fwdIndex_[m];
+            iborAmount_[k] =
+                gearingNominalFactor_[k] * (fwdDiscounts[2 * m] / fwdDiscounts[2 * m + 1] - 1.0) + spreadAmount_[k];
+        }
+    }
+
+    // aggregate the discounted amounts per swap
+
+    for (Size l = 0; l < live_.size(); ++l) {
+        Size r = live_[l];
+        Real amount;
+        if (type_[r] == AmountType::Fixed)
+            amount = amount_[r];
+        else if (estimate[l])
+            amount = iborAmount_[iborRow_[r]];
+        else
+            amount = cashflow_[r]->amount();
+        result[swap_[r]] += sign_[r] * amount * discounts_[l];
+    }
+
+    DiscountFactor npvDateDiscount = discounts_.back();
+    for (auto& v : result)
+        v /= npvDateDiscount;
+}
+
+} // namespace QuantExt
@@ -0,0 +1,103 @@
+/*
+ Copyright (C) 2023 Quaternion Risk Management Ltd
+ All rights reserved.
+
+ This file is part of ORE, a free-software/open-source library
+ for transparent pricing and risk analysis - http://opensourcerisk.org
+
+ ORE is free software: you can redistribute it and/or modify it
+ under the terms of the Modified BSD License.  You should have received a
+ copy of the license along with this program.
+ The license is also available online at <http://opensourcerisk.org>
+
+ This program is distributed on the basis that it will form a useful
+ contribution to risk analytics and model standardisation, but WITHOUT
+ ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ FITNESS FOR A PARTICULAR PURPOSE. See the license for more details.
+*/
+
+/*! \file batchswappricer.hpp
+    \brief batch pricing of single currency swaps sharing a discount curve
+    \ingroup engines
+*/
+
+#pragma once
+
+#include <ql/instruments/swap.hpp>
+#include <ql/termstructures/yieldtermstructure.hpp>
+
+#include <boost/optional.hpp>
+
+namespace QuantExt {
+using namespace QuantLib;
+
+//! Batch pricer for single currency swaps sharing a discount curve
+/*! The cashflows of all swaps added to the pricer are compiled into a structure-of-arrays table once. The npvs of
+    all swaps are then computed in one pass with one batch evaluation of the discount factors on the discount curve
+    and one batch evaluation of the start and end discount factors per forwarding curve of the ibor coupons.
+
+    The results are identical (up to rounding differences) to those of the DiscountingSwapEngineMultiCurve, i.e.
+    the same assumptions on ibor coupons apply:
+    - all ibor coupons except the first two of each leg are estimated from the forwarding curve of the index, assuming
+      that the index value and maturity dates are equal to the accrual start and end dates
+    - if the second cashflow of a leg has occurred, all coupons are estimated using amount()
+
+    Fixed rate coupons and simple cashflows are evaluated once when the swap is added, all other cashflows are
+    evaluated using amount() in each pricing.
+
+    \ingroup engines
+*/
+class BatchSwapPricer {
+public:
+    explicit BatchSwapPricer(const Handle<YieldTermStructure>& discountCurve,
+                             boost::optional<bool> includeSettlementDateFlows = boost::none);
+
+    //! add a swap given by its legs and payer flags, returns the index of the swap in the result vector
+    Size add(const std::vector<Leg>& legs, const std::vector<bool>& payer);
+    //! add a swap, returns the index of the swap in the result vector
+    Size add(const Swap& swap);
+
+    //! number of swaps
+    Size size() const { return nSwaps_; }
+    //! number of cashflows
+    Size cashflows() const { return cashflow_.size(); }
+
+    //! npvs of all swaps as of the discount curve reference date
+    void npvs(std::vector<Real>& result) const;
+
+private:
+    enum class AmountType { Fixed, Generic, Ibor };
+
+    Handle<YieldTermStructure> discountCurve_;
+    boost::optional<bool> includeSettlementDateFlows_;
+    Size nSwaps_ = 0;
+
+    // cashflow table
+    std::vector<boost::shared_ptr<CashFlow>> cashflow_;
+    std::vector<AmountType> type_;
+    std::vector<Size> swap_;
+    std::vector<Real> sign_;
+    std::vector<Date> payDate_;
+    std::vector<Real> amount_;
+    // row of the second cashflow of the same leg or Null<Size>()
+    std::vector<Size> secondRow_;
+    // true for the first two cashflows of a leg
+    std::vector<bool> leading_;
+
+    // ibor coupon table, indexed by the ibor row number stored in iborRow_
+    std::vector<Size> iborRow_;
+    std::vector<Size> forwardingCurve_;
+    std::vector<Date> accrualStart_, accrualEnd_;
+    std::vector<Real> gearingNominalFactor_, spreadAmount_;
+    std::vector<Handle<YieldTermStructure>> forwardingCurves_;
+
+    // work buffers
+    mutable std::vector<Time> times_;
+    mutable std::vector<DiscountFactor> discounts_;
+    mutable std::vector<Size> live_;
+    mutable std::vector<Date> fwdDates_;
+    mutable std::vector<Size> fwdIndex_;
+    mutable std::vector<Real> iborAmount_;
+};
+
+} // namespace QuantExt
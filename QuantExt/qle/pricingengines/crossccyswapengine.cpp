@@ -21,6 +21,7 @@
 #include <ql/utilities/dataformatters.hpp>
 
 #include <qle/pricingengines/crossccyswapengine.hpp>
+#include <qle/termstructures/batchdiscountcurve.hpp>
 
 namespace QuantExt {
 
@@ -111,8 +112,8 @@ void CrossCcySwapEngine::calculate() const {
 
             // Calculate the NPV and BPS of each leg in its currency.
             std::tie(results_.inCcyLegNPV[legNo], results_.inCcyLegBPS[legNo]) =
-                CashFlows::npvbps(arguments_.legs[legNo], **legDiscountCurve, includeReferenceDateFlows, settlementDate,
-                                  results_.valuationDate);
+                batchNpvBps(arguments_.legs[legNo], legDiscountCurve, includeReferenceDateFlows, settlementDate,
+                            results_.valuationDate);
             results_.inCcyLegNPV[legNo] *= arguments_.payer[legNo];
             results_.inCcyLegBPS[legNo] *= arguments_.payer[legNo];
 
@@ -17,6 +17,7 @@
 */
 
 #include <qle/pricingengines/discountingcurrencyswapengine.hpp>
+#include <qle/termstructures/batchdiscountcurve.hpp>
 
 #include <ql/cashflows/cashflows.hpp>
 #include <ql/cashflows/floatingratecoupon.hpp>
@@ -149,8 +150,8 @@ void DiscountingCurrencySwapEngine::calculate() const {
             Currency ccy = arguments_.currency[i];
             Handle<YieldTermStructure> yts = fetchTS(ccy);
 
-            std::tie(results_.inCcyLegNPV[i], results_.inCcyLegBPS[i]) = QuantLib::CashFlows::npvbps(
-                arguments_.legs[i], **yts, includeRefDateFlows, settlementDate, results_.valuationDate);
+            std::tie(results_.inCcyLegNPV[i], results_.inCcyLegBPS[i]) = QuantExt::batchNpvBps(
+                arguments_.legs[i], yts, includeRefDateFlows, settlementDate, results_.valuationDate);
 
             results_.inCcyLegNPV[i] *= arguments_.payer[i];
             if (results_.inCcyLegBPS[i] != Null<Real>()) {
@@ -20,6 +20,7 @@
 
 #include <qle/pricingengines/discountingfxforwardengine.hpp>
 #include <qle/instruments/cashflowresults.hpp>
+#include <qle/termstructures/batchdiscountcurve.hpp>
 
 namespace QuantExt {
 
@@ -82,10 +83,14 @@ void DiscountingFxForwardEngine::calculate() const {
     results_.additionalResults["currency[2]"] = ccy2_.code();
 
     if (!detail::simple_event(arguments_.payDate).hasOccurred(settlementDate, includeSettlementDateFlows_)) {
-        Real disc1near = currency1Discountcurve_->discount(npvDate);
-        Real disc1far = currency1Discountcurve_->discount(arguments_.payDate);
-        Real disc2near = currency2Discountcurve_->discount(npvDate);
-        Real disc2far = currency2Discountcurve_->discount(arguments_.payDate);
+        std::vector<Date> dates{npvDate, arguments_.payDate};
+        std::vector<DiscountFactor> disc1, disc2;
+        discounts(currency1Discountcurve_, dates, disc1);
+        discounts(currency2Discountcurve_, dates, disc2);
+        Real disc1near = disc1[0];
+        Real disc1far = disc1[1];
+        Real disc2near = disc2[0];
+        Real disc2far = disc2[1];
         Real fxfwd = disc1near / disc1far * disc2far / disc2near * spotFX_->value();
 
         // settle ccy is ccy1 if no pay ccy provided
@@ -25,6 +25,7 @@
 #include <ql/utilities/dataformatters.hpp>
 
 #include <qle/pricingengines/discountingswapenginemulticurve.hpp>
+#include <qle/termstructures/batchdiscountcurve.hpp>
 
 namespace QuantExt {
 
@@ -174,24 +175,35 @@ void DiscountingSwapEngineMultiCurve::calculate() const {
 
     const Spread bp = 1.0e-4;
 
+    std::vector<DiscountFactor> discounts;
+
     for (Size i = 0; i < numLegs; i++) {
 
         Leg leg = arguments_.legs[i];
         results_.legNPV[i] = 0.0;
         results_.legBPS[i] = 0.0;
 
+        // Collect the cashflows that have not occurred taking into account the settlement date and
+        // includeSettlementDateFlows flag and evaluate their discount factors in one batch
+        std::vector<Size> live;
+        std::vector<Date> payDates;
+        live.reserve(leg.size());
+        payDates.reserve(leg.size());
+        for (Size j = 0; j < leg.size(); j++) {
+            if (!leg[j]->hasOccurred(settlementDate, includeRefDateFlows)) {
+                live.push_back(j);
+                payDates.push_back(leg[j]->date());
+            }
+        }
+        QuantExt::discounts(discountCurve_, payDates, discounts);
+
         // Call amount() method of underlying coupon for first coupon.
         impl_->amountGetter_->setCallAmount(true);
 
-        for (Size j = 0; j < leg.size(); j++) {
-
-            /* Exclude cashflows that have occurred taking into account the
-            settlement date and includeSettlementDateFlows flag */
-            if (leg[j]->hasOccurred(settlementDate, includeRefDateFlows)) {
-                continue;
-            }
+        for (Size l = 0; l < live.size(); l++) {
 
-            DiscountFactor discount = discountCurve_->discount(leg[j]->date());
+            Size j = live[l];
+            DiscountFactor discount = discounts[l];
             leg[j]->accept(*(impl_->amountGetter_));
             results_.legNPV[i] += impl_->amountGetter_->amount() * discount;
             results_.legBPS[i] += impl_->amountGetter_->bpsFactor() * discount;
@@ -31,10 +31,12 @@ McCamFxForwardEngine::McCamFxForwardEngine(
     const Size polynomOrder, const LsmBasisSystem::PolynomialType polynomType,
     const SobolBrownianGenerator::Ordering ordering, const SobolRsg::DirectionIntegers directionIntegers,
     const std::vector<Handle<YieldTermStructure>>& discountCurves, const std::vector<Date>& simulationDates,
-    const std::vector<Size>& externalModelIndices, const bool minimalObsDate, const RegressorModel regressorModel)
+    const std::vector<Size>& externalModelIndices, const bool minimalObsDate, const RegressorModel regressorModel,
+    const Size threads, const bool controlVariate)
     : McMultiLegBaseEngine(model, calibrationPathGenerator, pricingPathGenerator, calibrationSamples, pricingSamples,
                            calibrationSeed, pricingSeed, polynomOrder, polynomType, ordering, directionIntegers,
-                           discountCurves, simulationDates, externalModelIndices, minimalObsDate, regressorModel),
+                           discountCurves, simulationDates, externalModelIndices, minimalObsDate, regressorModel,
+                           threads, controlVariate),
       domesticCcy_(domesticCcy), foreignCcy_(foreignCcy), npvCcy_(npvCcy) {
     registerWith(model_);
     for (auto const& h : discountCurves)
@@ -59,6 +61,7 @@ void McCamFxForwardEngine::calculate() const {
     if (npvCcyIndex > 0)
         fxSpot = model_->fxbs(npvCcyIndex - 1)->fxSpotToday()->value();
     results_.value = resultValue_ / fxSpot;
+    results_.errorEstimate = resultValueErrorEstimate_ / fxSpot;
     results_.additionalResults["underlyingNpv"] = resultUnderlyingNpv_ / fxSpot;
     results_.additionalResults["amcCalculator"] = amcCalculator();
 
@@ -45,7 +45,8 @@ public:
         const std::vector<Handle<YieldTermStructure>>& discountCurves = std::vector<Handle<YieldTermStructure>>(),
         const std::vector<Date>& simulationDates = std::vector<Date>(),
         const std::vector<Size>& externalModelIndices = std::vector<Size>(), const bool minimalObsDate = true,
-        const RegressorModel regressorModel = RegressorModel::Simple);
+        const RegressorModel regressorModel = RegressorModel::Simple, const Size threads = 1,
+        const bool controlVariate = false);
 
     void calculate() const override;
     const Handle<CrossAssetModel>& model() const { return model_; }
@@ -29,6 +29,7 @@ void McLgmSwapEngine::calculate() const {
     exercise_ = nullptr;
     McMultiLegBaseEngine::calculate();
     results_.value = resultValue_;
+    results_.errorEstimate = resultValueErrorEstimate_;
     results_.additionalResults["amcCalculator"] = amcCalculator();
 } // McLgmSwaptionEngine::calculate
 
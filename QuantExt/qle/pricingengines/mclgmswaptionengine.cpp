@@ -30,6 +30,7 @@ void McLgmSwaptionEngine::calculate() const {
     optionSettlement_ = arguments_.settlementType;
     McMultiLegBaseEngine::calculate();
     results_.value = resultValue_;
+    results_.errorEstimate = resultValueErrorEstimate_;
     results_.additionalResults["underlyingNpv"] = resultUnderlyingNpv_;
     results_.additionalResults["amcCalculator"] = amcCalculator();
 } // McLgmSwaptionEngine::calculate
@@ -42,6 +43,7 @@ void McLgmNonstandardSwaptionEngine::calculate() const {
     optionSettlement_ = arguments_.settlementType;
     McMultiLegBaseEngine::calculate();
     results_.value = resultValue_;
+    results_.errorEstimate = resultValueErrorEstimate_;
     results_.additionalResults["underlyingNpv"] = resultUnderlyingNpv_;
     results_.additionalResults["amcCalculator"] = amcCalculator();
 } // McLgmSwaptionEngine::calculate
@@ -43,14 +43,16 @@ public:
                         const Handle<YieldTermStructure>& discountCurve = Handle<YieldTermStructure>(),
                         const std::vector<Date> simulationDates = std::vector<Date>(),
                         const std::vector<Size> externalModelIndices = std::vector<Size>(),
-                        const bool minimalObsDate = true, const RegressorModel regressorModel = RegressorModel::Simple)
+                        const bool minimalObsDate = true, const RegressorModel regressorModel = RegressorModel::Simple,
+                        const Size threads = 1, const bool controlVariate = false)
         : GenericEngine<QuantLib::Swaption::arguments, QuantLib::Swaption::results>(),
           McMultiLegBaseEngine(Handle<CrossAssetModel>(boost::make_shared<CrossAssetModel>(
                                    std::vector<boost::shared_ptr<IrModel>>(1, model),
                                    std::vector<boost::shared_ptr<FxBsParametrization>>())),
                                calibrationPathGenerator, pricingPathGenerator, calibrationSamples, pricingSamples,
                                calibrationSeed, pricingSeed, polynomOrder, polynomType, ordering, directionIntegers,
-                               {discountCurve}, simulationDates, externalModelIndices, minimalObsDate, regressorModel) {
+                               {discountCurve}, simulationDates, externalModelIndices, minimalObsDate, regressorModel,
+                               threads, controlVariate) {
         registerWith(model);
     }
 
@@ -72,14 +74,16 @@ public:
                                    const std::vector<Date> simulationDates = std::vector<Date>(),
                                    const std::vector<Size> externalModelIndices = std::vector<Size>(),
                                    const bool minimalObsDate = true,
-                                   const RegressorModel regressorModel = RegressorModel::Simple)
+                                   const RegressorModel regressorModel = RegressorModel::Simple, const Size threads = 1,
+                                   const bool controlVariate = false)
         : GenericEngine<QuantLib::NonstandardSwaption::arguments, QuantLib::NonstandardSwaption::results>(),
           McMultiLegBaseEngine(Handle<CrossAssetModel>(boost::make_shared<CrossAssetModel>(
                                    std::vector<boost::shared_ptr<IrModel>>(1, model),
                                    std::vector<boost::shared_ptr<FxBsParametrization>>())),
                                calibrationPathGenerator, pricingPathGenerator, calibrationSamples, pricingSamples,
                                calibrationSeed, pricingSeed, polynomOrder, polynomType, ordering, directionIntegers,
-                               {discountCurve}, simulationDates, externalModelIndices, minimalObsDate, regressorModel) {
+                               {discountCurve}, simulationDates, externalModelIndices, minimalObsDate, regressorModel,
+                               threads, controlVariate) {
         registerWith(model);
     }
 
@@ -24,9 +24,12 @@
 #include <qle/cashflows/indexedcoupon.hpp>
 #include <qle/cashflows/overnightindexedcoupon.hpp>
 #include <qle/cashflows/subperiodscoupon.hpp>
+#include <qle/math/mcvariancereduction.hpp>
 #include <qle/math/randomvariablelsmbasissystem.hpp>
+#include <qle/methods/mcpathrepository.hpp>
 #include <qle/pricingengines/mcmultilegbaseengine.hpp>
 #include <qle/processes/irlgm1fstateprocess.hpp>
+#include <qle/utilities/workerpool.hpp>
 
 #include <ql/cashflows/averagebmacoupon.hpp>
 #include <ql/cashflows/capflooredcoupon.hpp>
@@ -38,8 +41,49 @@
 #include <ql/experimental/coupons/strippedcapflooredcoupon.hpp>
 #include <ql/indexes/swapindex.hpp>
 
+#include <algorithm>
+#include <memory>
+
 namespace QuantExt {
 
+namespace {
+
+// join the values computed on consecutive blocks of paths to one random variable
+RandomVariable joinPathBlocks(const std::vector<RandomVariable>& blocks, const Size samples) {
+    bool deterministic = std::all_of(blocks.begin(), blocks.end(), [&blocks](const RandomVariable& b) {
+        return b.deterministic() && b.at(0) == blocks.front().at(0);
+    });
+    if (deterministic)
+        return RandomVariable(samples, blocks.front().at(0), blocks.front().time());
+    RandomVariable result(samples, 0.0, blocks.front().time());
+    result.expand();
+    Size k = 0;
+    for (auto const& b : blocks) {
+        for (Size j = 0; j < b.size(); ++j)
+            result.data()[k++] = b[j];
+    }
+    return result;
+}
+
+// the worker pools are shared by the engines calculated on the same thread and requesting the same number of threads
+boost::shared_ptr<WorkerPool> sharedWorkerPool(const Size threads) {
+    static thread_local std::map<Size, boost::weak_ptr<WorkerPool>> pools;
+    boost::shared_ptr<WorkerPool> pool = pools[threads].lock();
+    if (pool == nullptr) {
+        pool = boost::make_shared<WorkerPool>(threads);
+        pools[threads] = pool;
+    }
+    return pool;
+}
+
+// trigger the calculation of a (lazy) yield term structure
+void prepareCurve(const Handle<YieldTermStructure>& curve) {
+    if (!curve.empty())
+        curve->discount(0.0);
+}
+
+} // namespace
+
 McMultiLegBaseEngine::McMultiLegBaseEngine(
     const Handle<CrossAssetModel>& model, const SequenceType calibrationPathGenerator,
     const SequenceType pricingPathGenerator, const Size calibrationSamples, const Size pricingSamples,
@@ -47,12 +91,15 @@ McMultiLegBaseEngine::McMultiLegBaseEngine(
     const LsmBasisSystem::PolynomialType polynomType, const SobolBrownianGenerator::Ordering ordering,
     SobolRsg::DirectionIntegers directionIntegers, const std::vector<Handle<YieldTermStructure>>& discountCurves,
     const std::vector<Date>& simulationDates, const std::vector<Size>& externalModelIndices, const bool minimalObsDate,
-    const RegressorModel regressorModel)
+    const RegressorModel regressorModel, const Size threads, const bool controlVariate)
     : model_(model), calibrationPathGenerator_(calibrationPathGenerator), pricingPathGenerator_(pricingPathGenerator),
       calibrationSamples_(calibrationSamples), pricingSamples_(pricingSamples), calibrationSeed_(calibrationSeed),
       pricingSeed_(pricingSeed), polynomOrder_(polynomOrder), polynomType_(polynomType), ordering_(ordering),
       directionIntegers_(directionIntegers), discountCurves_(discountCurves), simulationDates_(simulationDates),
-      externalModelIndices_(externalModelIndices), minimalObsDate_(minimalObsDate), regressorModel_(regressorModel) {
+      externalModelIndices_(externalModelIndices), minimalObsDate_(minimalObsDate), regressorModel_(regressorModel),
+      threads_(threads), controlVariate_(controlVariate) {
+
+    QL_REQUIRE(threads_ > 0, "McMultiLegBaseEngine: threads must be positive");
 
     if (discountCurves_.empty())
         discountCurves_.resize(model_->components(CrossAssetModel::AssetType::IR));
@@ -646,6 +693,30 @@ Size McMultiLegBaseEngine::timeIndex(const Time t, const std::set<Real>& times)
     return std::distance(times.begin(), it);
 }
 
+void McMultiLegBaseEngine::prepareAmountCalculation(const boost::shared_ptr<CashFlow>& flow) const {
+    if (auto indexed = boost::dynamic_pointer_cast<IndexedCoupon>(flow)) {
+        prepareAmountCalculation(indexed->underlying());
+    } else if (auto wrapped = boost::dynamic_pointer_cast<IndexWrappedCashFlow>(flow)) {
+        prepareAmountCalculation(wrapped->underlying());
+    } else if (auto cpn = boost::dynamic_pointer_cast<FloatingRateCoupon>(flow)) {
+        if (auto ois = boost::dynamic_pointer_cast<OvernightIndexedSwapIndex>(cpn->index())) {
+            prepareCurve(ois->forwardingTermStructure());
+            prepareCurve(ois->discountingTermStructure());
+            if (cpn->fixingDate() > today_)
+                ois->underlyingSwap(cpn->fixingDate());
+        } else if (auto swap = boost::dynamic_pointer_cast<SwapIndex>(cpn->index())) {
+            prepareCurve(swap->forwardingTermStructure());
+            prepareCurve(swap->discountingTermStructure());
+            if (cpn->fixingDate() > today_)
+                swap->underlyingSwap(cpn->fixingDate());
+        } else if (auto ibor = boost::dynamic_pointer_cast<IborIndex>(cpn->index())) {
+            prepareCurve(ibor->forwardingTermStructure());
+        } else if (auto bma = boost::dynamic_pointer_cast<BMAIndex>(cpn->index())) {
+            prepareCurve(bma->forwardingTermStructure());
+        }
+    }
+}
+
 RandomVariable McMultiLegBaseEngine::cashflowPathValue(const CashflowInfo& cf,
                                                        const std::vector<std::vector<RandomVariable>>& pathValues,
                                                        const std::set<Real>& simulationTimes) const {
@@ -713,6 +784,7 @@ void McMultiLegBaseEngine::calculate() const {
     // populate the info to generate the (alive) cashflow amounts
 
     std::vector<CashflowInfo> cashflowInfo;
+    std::vector<boost::shared_ptr<CashFlow>> cashflows;
 
     Size legNo = 0;
     for (auto const& leg : leg_) {
@@ -725,6 +797,7 @@ void McMultiLegBaseEngine::calculate() const {
                 continue;
             // for an alive cashflow, populate the data
             cashflowInfo.push_back(createCashflowInfo(cashflow, currency, payer, legNo, cashflowNo));
+            cashflows.push_back(cashflow);
             // increment counter
             ++cashflowNo;
         }
@@ -779,47 +852,140 @@ void McMultiLegBaseEngine::calculate() const {
 
     QL_REQUIRE(!simulationTimes.empty(),
                "McMultiLegBaseEngine::calculate(): no simulation times, this is not expected.");
-    std::vector<std::vector<RandomVariable>> pathValues(
-        simulationTimes.size(),
-        std::vector<RandomVariable>(model_->stateProcess()->size(), RandomVariable(calibrationSamples_)));
+
+    auto generatePaths = [this, &simulationTimes]() {
+        McPathRepository::Paths pathValues(
+            simulationTimes.size(),
+            std::vector<RandomVariable>(model_->stateProcess()->size(), RandomVariable(calibrationSamples_)));
+
+        for (Size i = 0; i < pathValues.size(); ++i) {
+            for (Size j = 0; j < pathValues[i].size(); ++j) {
+                pathValues[i][j].expand();
+            }
+        }
+
+        TimeGrid timeGrid(simulationTimes.begin(), simulationTimes.end());
+
+        boost::shared_ptr<StochasticProcess> process = model_->stateProcess();
+        if (model_->dimension() == 1) {
+            // use lgm process if possible for better performance
+            auto tmp = boost::make_shared<IrLgm1fStateProcess>(model_->irlgm1f(0));
+            tmp->resetCache(timeGrid.size() - 1);
+            process = tmp;
+        } else if (auto tmp = boost::dynamic_pointer_cast<CrossAssetStateProcess>(process)) {
+            // enable cache
+            tmp->resetCache(timeGrid.size() - 1);
+        }
+
+        auto pathGenerator = makeMultiPathGenerator(calibrationPathGenerator_, process, timeGrid, calibrationSeed_,
+                                                    ordering_, directionIntegers_);
+
+        for (Size i = 0; i < calibrationSamples_; ++i) {
+            const MultiPath& path = pathGenerator->next().value;
+            for (Size j = 0; j < simulationTimes.size(); ++j) {
+                for (Size k = 0; k < model_->stateProcess()->size(); ++k) {
+                    pathValues[j][k].data()[i] = path[k][j + 1];
+                }
+            }
+        }
+
+        return pathValues;
+    };
+
+    // the paths are shared with other engines using the same model, path generator settings and simulation times
+
+    McPathRepository::Key pathKey{model_.currentLink().get(),
+                                  calibrationPathGenerator_,
+                                  calibrationSeed_,
+                                  calibrationSamples_,
+                                  ordering_,
+                                  directionIntegers_,
+                                  std::vector<Real>(simulationTimes.begin(), simulationTimes.end())};
+    auto paths = McPathRepository::instance().paths(pathKey, model_.currentLink(), generatePaths);
+    const std::vector<std::vector<RandomVariable>>& pathValues = *paths;
+
     std::vector<std::vector<const RandomVariable*>> pathValuesRef(
         simulationTimes.size(), std::vector<const RandomVariable*>(model_->stateProcess()->size()));
 
     for (Size i = 0; i < pathValues.size(); ++i) {
         for (Size j = 0; j < pathValues[i].size(); ++j) {
-            pathValues[i][j].expand();
             pathValuesRef[i][j] = &pathValues[i][j];
         }
     }
 
-    TimeGrid timeGrid(simulationTimes.begin(), simulationTimes.end());
-
-    boost::shared_ptr<StochasticProcess> process = model_->stateProcess();
-    if (model_->dimension() == 1) {
-        // use lgm process if possible for better performance
-        auto tmp = boost::make_shared<IrLgm1fStateProcess>(model_->irlgm1f(0));
-        tmp->resetCache(timeGrid.size() - 1);
-        process = tmp;
-    } else if (auto tmp = boost::dynamic_pointer_cast<CrossAssetStateProcess>(process)) {
-        // enable cache
-        tmp->resetCache(timeGrid.size() - 1);
-    }
+    McEngineStats::instance().path_timer.stop();
 
-    auto pathGenerator = makeMultiPathGenerator(calibrationPathGenerator_, process, timeGrid, calibrationSeed_,
-                                                ordering_, directionIntegers_);
+    McEngineStats::instance().calc_timer.resume();
 
-    for (Size i = 0; i < calibrationSamples_; ++i) {
-        const MultiPath& path = pathGenerator->next().value;
-        for (Size j = 0; j < simulationTimes.size(); ++j) {
-            for (Size k = 0; k < model_->stateProcess()->size(); ++k) {
-                pathValues[j][k].data()[i] = path[k][j + 1];
+    /* for a multi-threaded run, get the worker pool, trigger the calculation of the lazy objects used in the amount
+       calculation of all cashflows and split the paths into blocks, one per thread */
+
+    std::vector<McPathRepository::Paths> blockPathValues;
+
+    if (threads_ > 1) {
+        if (workerPool_ == nullptr)
+            workerPool_ = sharedWorkerPool(threads_);
+        Size nBlocks = workerPool_->threads();
+        for (Size i = 0; i < model_->components(CrossAssetModel::AssetType::IR); ++i)
+            prepareCurve(model_->irlgm1f(i)->termStructure());
+        for (auto const& c : discountCurves_)
+            prepareCurve(c);
+        if (nBlocks > 1 && calibrationSamples_ >= nBlocks) {
+            blockPathValues.resize(nBlocks);
+            for (Size b = 0; b < nBlocks; ++b) {
+                Size blockStart = calibrationSamples_ * b / nBlocks;
+                Size blockSize = calibrationSamples_ * (b + 1) / nBlocks - blockStart;
+                blockPathValues[b].resize(pathValues.size(), std::vector<RandomVariable>(pathValues.front().size()));
+                for (Size i = 0; i < pathValues.size(); ++i) {
+                    for (Size j = 0; j < pathValues[i].size(); ++j) {
+                        RandomVariable& v = blockPathValues[b][i][j];
+                        v = RandomVariable(blockSize);
+                        v.expand();
+                        for (Size k = 0; k < blockSize; ++k)
+                            v.data()[k] = pathValues[i][j][blockStart + k];
+                    }
+                }
             }
         }
     }
 
-    McEngineStats::instance().path_timer.stop();
-
-    McEngineStats::instance().calc_timer.resume();
+    auto pathValue = [this, &cashflowInfo, &cashflows, &pathValues, &simulationTimes, &blockPathValues](const Size i) {
+        if (blockPathValues.empty())
+            return cashflowPathValue(cashflowInfo[i], pathValues, simulationTimes);
+        // the single entry caches (e.g. the underlying swap of a swap index) are set up for this cashflow here
+        prepareAmountCalculation(cashflows[i]);
+        std::vector<RandomVariable> blockValues(blockPathValues.size());
+        workerPool_->run(blockPathValues.size(), [this, &cashflowInfo, &simulationTimes, &blockPathValues,
+                                                  &blockValues, i](const Size b) {
+            blockValues[b] = cashflowPathValue(cashflowInfo[i], blockPathValues[b], simulationTimes);
+        });
+        return joinPathBlocks(blockValues, calibrationSamples_);
+    };
+
+    /* the regression models that are not required in the backward induction are trained after the other models for
+       the same time, they are collected per time and trained concurrently in a multi-threaded run */
+
+    struct TrainingTask {
+        BasisValuesCache basisValuesCache;
+        std::vector<std::pair<RegressionModel*, RandomVariable>> models;
+    };
+    std::vector<TrainingTask> trainingTasks;
+
+    auto runTrainingTasks = [this, &trainingTasks, &pathValuesRef, &simulationTimes](const bool all) {
+        if (trainingTasks.empty() || (!all && workerPool_ && trainingTasks.size() < workerPool_->threads()))
+            return;
+        auto train = [this, &trainingTasks, &pathValuesRef, &simulationTimes](const Size k) {
+            for (auto& [model, regressand] : trainingTasks[k].models)
+                model->train(polynomOrder_, polynomType_, regressand, pathValuesRef, simulationTimes, Filter(),
+                             &trainingTasks[k].basisValuesCache);
+        };
+        if (workerPool_)
+            workerPool_->run(trainingTasks.size(), train);
+        else
+            for (Size k = 0; k < trainingTasks.size(); ++k)
+                train(k);
+        trainingTasks.clear();
+    };
 
     // for each xva and exercise time collect the relevant cashflow amounts and train a model on them
 
@@ -851,12 +1017,12 @@ void McMultiLegBaseEngine::calculate() const {
 
             if (cfStatus[i] == CfStatus::open) {
                 if (cashflowInfo[i].exIntoCriterionTime > *t) {
-                    auto tmp = cashflowPathValue(cashflowInfo[i], pathValues, simulationTimes);
+                    auto tmp = pathValue(i);
                     pathValueUndDirty += tmp;
                     pathValueUndExInto += tmp;
                     cfStatus[i] = CfStatus::done;
                 } else if (cashflowInfo[i].payTime > *t) {
-                    auto tmp = cashflowPathValue(cashflowInfo[i], pathValues, simulationTimes);
+                    auto tmp = pathValue(i);
                     pathValueUndDirty += tmp;
                     amountCache[i] = tmp;
                     cfStatus[i] = CfStatus::cached;
@@ -870,65 +1036,113 @@ void McMultiLegBaseEngine::calculate() const {
             }
         }
 
+        // the regression models for the current time share the basis function values for identical regressors
+        TrainingTask task;
+
         if (exercise_ != nullptr) {
             regModelUndExInto[counter] = RegressionModel(
                 *t, cashflowInfo, [&cfStatus](std::size_t i) { return cfStatus[i] == CfStatus::done; }, **model_,
                 regressorModel_);
-            regModelUndExInto[counter].train(polynomOrder_, polynomType_, pathValueUndExInto, pathValuesRef,
-                                             simulationTimes);
+            if (isExerciseTime)
+                regModelUndExInto[counter].train(polynomOrder_, polynomType_, pathValueUndExInto, pathValuesRef,
+                                                 simulationTimes, Filter(), &task.basisValuesCache);
+            else
+                task.models.push_back(std::make_pair(&regModelUndExInto[counter], pathValueUndExInto));
         }
 
         if (isExerciseTime) {
             auto exerciseValue = regModelUndExInto[counter].apply(model_->stateProcess()->initialValues(),
-                                                                  pathValuesRef, simulationTimes);
+                                                                  pathValuesRef, simulationTimes,
+                                                                  &task.basisValuesCache);
             regModelContinuationValue[counter] = RegressionModel(
                 *t, cashflowInfo, [&cfStatus](std::size_t i) { return cfStatus[i] == CfStatus::done; }, **model_,
                 regressorModel_);
             regModelContinuationValue[counter].train(polynomOrder_, polynomType_, pathValueOption, pathValuesRef,
                                                      simulationTimes,
-                                                     exerciseValue > RandomVariable(calibrationSamples_, 0));
-            auto continuationValue = regModelContinuationValue[counter].apply(model_->stateProcess()->initialValues(),
-                                                                              pathValuesRef, simulationTimes);
+                                                     exerciseValue > RandomVariable(calibrationSamples_, 0),
+                                                     &task.basisValuesCache);
+            auto continuationValue = regModelContinuationValue[counter].apply(
+                model_->stateProcess()->initialValues(), pathValuesRef, simulationTimes, &task.basisValuesCache);
             pathValueOption = conditionalResult(exerciseValue > continuationValue &&
                                                     exerciseValue > RandomVariable(calibrationSamples_, 0),
                                                 pathValueUndExInto, pathValueOption);
-            regModelOption[counter] = RegressionModel(
-                *t, cashflowInfo, [&cfStatus](std::size_t i) { return cfStatus[i] == CfStatus::done; }, **model_,
-                regressorModel_);
-            regModelOption[counter].train(polynomOrder_, polynomType_, pathValueOption, pathValuesRef, simulationTimes);
         }
 
         if (isXvaTime) {
             regModelUndDirty[counter] = RegressionModel(
                 *t, cashflowInfo, [&cfStatus](std::size_t i) { return cfStatus[i] != CfStatus::open; }, **model_,
                 regressorModel_);
-            regModelUndDirty[counter].train(polynomOrder_, polynomType_, pathValueUndDirty, pathValuesRef,
-                                            simulationTimes);
+            task.models.push_back(std::make_pair(&regModelUndDirty[counter], pathValueUndDirty));
         }
 
         if (exercise_ != nullptr) {
             regModelOption[counter] = RegressionModel(
                 *t, cashflowInfo, [&cfStatus](std::size_t i) { return cfStatus[i] == CfStatus::done; }, **model_,
                 regressorModel_);
-            regModelOption[counter].train(polynomOrder_, polynomType_, pathValueOption, pathValuesRef, simulationTimes);
+            task.models.push_back(std::make_pair(&regModelOption[counter], pathValueOption));
+        }
+
+        if (!task.models.empty()) {
+            trainingTasks.push_back(std::move(task));
+            runTrainingTasks(false);
         }
 
         --counter;
     }
 
+    runTrainingTasks(true);
+
     // add the remaining live cashflows to get the underlying value
 
     for (Size i = 0; i < cashflowInfo.size(); ++i) {
         if (cfStatus[i] == CfStatus::open)
-            pathValueUndDirty += cashflowPathValue(cashflowInfo[i], pathValues, simulationTimes);
+            pathValueUndDirty += pathValue(i);
     }
 
     // set the result value (= underlying value if no exercise is given, otherwise option value)
 
-    resultUnderlyingNpv_ = expectation(pathValueUndDirty).at(0) * model_->numeraire(0, 0.0, 0.0, discountCurves_[0]);
-    resultValue_ = exercise_ == nullptr
-                       ? resultUnderlyingNpv_
-                       : expectation(pathValueOption).at(0) * model_->numeraire(0, 0.0, 0.0, discountCurves_[0]);
+    std::vector<RandomVariable> controls;
+    std::vector<Real> controlMeans;
+    if (controlVariate_ && model_->measure() == IrModel::Measure::LGM) {
+        // deflated zero bonds in base ccy at (up to) maxControls pay times, E[1 / N(T)] = P(0,T) in the LGM measure
+        constexpr Size maxControls = 10;
+        std::vector<Real> payTimes;
+        for (auto const& info : cashflowInfo) {
+            if (info.payTime > 0.0)
+                payTimes.push_back(info.payTime);
+        }
+        std::sort(payTimes.begin(), payTimes.end());
+        payTimes.erase(std::unique(payTimes.begin(), payTimes.end()), payTimes.end());
+        Size nControls = std::min(maxControls, payTimes.size());
+        Handle<YieldTermStructure> discountCurve =
+            discountCurves_[0].empty() ? model_->irlgm1f(0)->termStructure() : discountCurves_[0];
+        for (Size c = 0; c < nControls; ++c) {
+            Real t = payTimes[(c + 1) * payTimes.size() / nControls - 1];
+            controls.push_back(
+                RandomVariable(calibrationSamples_, 1.0) /
+                lgmVectorised_[0].numeraire(t,
+                                            pathValues[timeIndex(t, simulationTimes)]
+                                                      [model_->pIdx(CrossAssetModel::AssetType::IR, 0)],
+                                            discountCurves_[0]));
+            controlMeans.push_back(discountCurve->discount(t));
+        }
+    }
+
+    bool antithetic = calibrationPathGenerator_ == SequenceType::MersenneTwisterAntithetic;
+    Real numeraire0 = model_->numeraire(0, 0.0, 0.0, discountCurves_[0]);
+    resultUnderlyingNpv_ = controlVariateMean(pathValueUndDirty, controls, controlMeans, antithetic,
+                                              &resultUnderlyingNpvErrorEstimate_) *
+                           numeraire0;
+    resultUnderlyingNpvErrorEstimate_ *= numeraire0;
+    if (exercise_ == nullptr) {
+        resultValue_ = resultUnderlyingNpv_;
+        resultValueErrorEstimate_ = resultUnderlyingNpvErrorEstimate_;
+    } else {
+        resultValue_ =
+            controlVariateMean(pathValueOption, controls, controlMeans, antithetic, &resultValueErrorEstimate_) *
+            numeraire0;
+        resultValueErrorEstimate_ *= numeraire0;
+    }
 
     McEngineStats::instance().calc_timer.stop();
 
@@ -1024,9 +1238,11 @@ std::vector<QuantExt::RandomVariable> McMultiLegBaseEngine::MultiLegBaseAmcCalcu
 
             // make the exercise decision
 
-            RandomVariable exerciseValue = regModelUndExInto_[ind].apply(initialState_, effPaths, xvaTimes_);
+            BasisValuesCache basisValuesCache;
+            RandomVariable exerciseValue =
+                regModelUndExInto_[ind].apply(initialState_, effPaths, xvaTimes_, &basisValuesCache);
             RandomVariable continuationValue =
-                regModelContinuationValue_[ind].apply(initialState_, effPaths, xvaTimes_);
+                regModelContinuationValue_[ind].apply(initialState_, effPaths, xvaTimes_, &basisValuesCache);
 
             exercised_[counter + 1] = !exercised_[counter] && exerciseValue > continuationValue &&
                                       exerciseValue > RandomVariable(samples, 0.0);
@@ -1053,7 +1269,9 @@ std::vector<QuantExt::RandomVariable> McMultiLegBaseEngine::MultiLegBaseAmcCalcu
 
         if (xvaTimes_.find(t) != xvaTimes_.end()) {
 
-            RandomVariable optionValue = regModelOption_[counter].apply(initialState_, effPaths, xvaTimes_);
+            BasisValuesCache basisValuesCache;
+            RandomVariable optionValue =
+                regModelOption_[counter].apply(initialState_, effPaths, xvaTimes_, &basisValuesCache);
 
             /* Exercise value is "undExInto" if we are in the period between the date on which the exercise happend and
                the next exercise date after that, otherwise it is the full dirty npv. This assumes that two exercise
@@ -1069,8 +1287,9 @@ std::vector<QuantExt::RandomVariable> McMultiLegBaseEngine::MultiLegBaseAmcCalcu
                uses the full dirty npv at a too early time. */
 
             RandomVariable exercisedValue = conditionalResult(
-                exercised_[exerciseCounter], regModelUndExInto_[counter].apply(initialState_, effPaths, xvaTimes_),
-                regModelUndDirty_[counter].apply(initialState_, effPaths, xvaTimes_));
+                exercised_[exerciseCounter],
+                regModelUndExInto_[counter].apply(initialState_, effPaths, xvaTimes_, &basisValuesCache),
+                regModelUndDirty_[counter].apply(initialState_, effPaths, xvaTimes_, &basisValuesCache));
 
             if (settlement_ == Settlement::Type::Cash) {
                 exercisedValue = applyInverseFilter(exercisedValue, cashExerciseValueWasAccountedForOnXvaTime);
@@ -1134,7 +1353,8 @@ void McMultiLegBaseEngine::RegressionModel::train(const Size polynomOrder,
                                                   const LsmBasisSystem::PolynomialType polynomType,
                                                   const RandomVariable& regressand,
                                                   const std::vector<std::vector<const RandomVariable*>>& paths,
-                                                  const std::set<Real>& pathTimes, const Filter& filter) {
+                                                  const std::set<Real>& pathTimes, const Filter& filter,
+                                                  BasisValuesCache* basisValuesCache) {
 
     // check if the model is in the correct state
 
@@ -1160,8 +1380,14 @@ void McMultiLegBaseEngine::RegressionModel::train(const Size polynomOrder,
 
         // compute the regression coefficients
 
-        regressionCoeffs_ =
-            regressionCoefficients(regressand, regressor, basisFns_, filter, RandomVariableRegressionMethod::QR);
+        if (basisValuesCache != nullptr) {
+            std::vector<RandomVariable> tmp;
+            regressionCoeffs_ = regressionCoefficients(regressand, basisValues(regressor, basisValuesCache, tmp),
+                                                       filter, RandomVariableRegressionMethod::QR);
+        } else {
+            regressionCoeffs_ =
+                regressionCoefficients(regressand, regressor, basisFns_, filter, RandomVariableRegressionMethod::QR);
+        }
 
     } else {
 
@@ -1180,7 +1406,8 @@ void McMultiLegBaseEngine::RegressionModel::train(const Size polynomOrder,
 RandomVariable
 McMultiLegBaseEngine::RegressionModel::apply(const Array& initialState,
                                              const std::vector<std::vector<const RandomVariable*>>& paths,
-                                             const std::set<Real>& pathTimes) const {
+                                             const std::set<Real>& pathTimes,
+                                             BasisValuesCache* basisValuesCache) const {
 
     // check if model is trained
 
@@ -1261,7 +1488,28 @@ McMultiLegBaseEngine::RegressionModel::apply(const Array& initialState,
 
     // compute result and return it
 
+    if (basisValuesCache != nullptr) {
+        std::vector<RandomVariable> tmpBasisValues;
+        return conditionalExpectation(basisValues(regressor, basisValuesCache, tmpBasisValues), regressionCoeffs_);
+    }
+
     return conditionalExpectation(regressor, basisFns_, regressionCoeffs_);
 }
 
+const std::vector<RandomVariable>&
+McMultiLegBaseEngine::RegressionModel::basisValues(const std::vector<const RandomVariable*>& regressor,
+                                                   BasisValuesCache* basisValuesCache,
+                                                   std::vector<RandomVariable>& result) const {
+    if (basisValuesCache != nullptr) {
+        if (auto c = basisValuesCache->find(regressorTimesModelIndices_); c != basisValuesCache->end())
+            return c->second;
+    }
+    result.resize(basisFns_.size());
+    for (Size j = 0; j < basisFns_.size(); ++j)
+        result[j] = basisFns_[j](regressor);
+    if (basisValuesCache == nullptr)
+        return result;
+    return (*basisValuesCache)[regressorTimesModelIndices_] = std::move(result);
+}
+
 } // namespace QuantExt
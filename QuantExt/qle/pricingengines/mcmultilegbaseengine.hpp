@@ -33,8 +33,13 @@
 #include <ql/instruments/swaption.hpp>
 #include <ql/methods/montecarlo/lsmbasissystem.hpp>
 
+#include <map>
+#include <set>
+
 namespace QuantExt {
 
+class WorkerPool;
+
 // statistics
 
 struct McEngineStats : public QuantLib::Singleton<McEngineStats> {
@@ -63,6 +68,16 @@ protected:
         Current limitations:
         - the parameter minimalObsDate is ignored, the corresponding optimization is not implemented yet
         - pricingSamples are ignored, the npv from the training phase is used alway
+
+        If threads > 1, the cashflow path values are computed on blocks of paths and the regression models that are
+        not required in the backward induction (e.g. those for the xva times) are trained concurrently. The results
+        are identical to those of a single threaded run. The worker pool is shared by the engines calculated on the
+        same thread, its size is capped by the available cores, see WorkerPool::ThreadReservation.
+
+        If controlVariate is true, the t0 values are estimated using the deflated zero bonds in the base currency at
+        (up to 10) cashflow pay times as control variates, the expectations of these are known from the discount
+        curve. This is only supported for the LGM measure and ignored otherwise. In any case the standard errors of
+        the t0 values are estimated, taking into account antithetic pairs of paths for MersenneTwisterAntithetic.
     */
     McMultiLegBaseEngine(
         const Handle<CrossAssetModel>& model, const SequenceType calibrationPathGenerator,
@@ -73,7 +88,8 @@ protected:
         const std::vector<Handle<YieldTermStructure>>& discountCurves = std::vector<Handle<YieldTermStructure>>(),
         const std::vector<Date>& simulationDates = std::vector<Date>(),
         const std::vector<Size>& externalModelIndices = std::vector<Size>(), const bool minimalObsDate = true,
-        const RegressorModel regressorModel = RegressorModel::Simple);
+        const RegressorModel regressorModel = RegressorModel::Simple, const Size threads = 1,
+        const bool controlVariate = false);
 
     // run calibration and pricing (called from derived engines)
     void calculate() const;
@@ -101,12 +117,18 @@ protected:
     std::vector<Size> externalModelIndices_;
     bool minimalObsDate_;
     RegressorModel regressorModel_;
+    Size threads_;
+    bool controlVariate_;
 
     // the generated amc calculator
     mutable boost::shared_ptr<AmcCalculator> amcCalculator_;
 
+    // the worker pool used if threads > 1
+    mutable boost::shared_ptr<WorkerPool> workerPool_;
+
     // results, these are read from derived engines
     mutable Real resultUnderlyingNpv_, resultValue_;
+    mutable Real resultUnderlyingNpvErrorEstimate_, resultValueErrorEstimate_;
 
 private:
     // data structure storing info needed to generate the amount for a cashflow
@@ -122,6 +144,10 @@ private:
             amountCalculator;
     };
 
+    /* cache for basis function values on a given set of paths, keyed by the regressor times and model indices,
+       the basis functions are determined by the regressor size and the polynom order and type of the engine */
+    using BasisValuesCache = std::map<std::set<std::pair<Real, Size>>, std::vector<RandomVariable>>;
+
     // class representing a regression model for a certain observation (= xva, exercise) time
     class RegressionModel {
     public:
@@ -130,14 +156,21 @@ private:
                         const std::function<bool(std::size_t)>& cashflowRelevant, const CrossAssetModel& model,
                         const RegressorModel regressorModel);
         // pathTimes must contain the observation time and the relevant cashflow simulation times
+        // if a basis values cache is given, it must only be used with the same paths and pathTimes
         void train(const Size polynomOrder, const LsmBasisSystem::PolynomialType polynomType,
                    const RandomVariable& regressand, const std::vector<std::vector<const RandomVariable*>>& paths,
-                   const std::set<Real>& pathTimes, const Filter& filter = Filter());
+                   const std::set<Real>& pathTimes, const Filter& filter = Filter(),
+                   BasisValuesCache* basisValuesCache = nullptr);
         // pathTimes do not need to contain the observation time or the relevant cashflow simulation times
         RandomVariable apply(const Array& initialState, const std::vector<std::vector<const RandomVariable*>>& paths,
-                             const std::set<Real>& pathTimes) const;
+                             const std::set<Real>& pathTimes, BasisValuesCache* basisValuesCache = nullptr) const;
 
     private:
+        // basis function values on the given regressor, read from or stored in the cache if given
+        const std::vector<RandomVariable>& basisValues(const std::vector<const RandomVariable*>& regressor,
+                                                       BasisValuesCache* basisValuesCache,
+                                                       std::vector<RandomVariable>& result) const;
+
         Real observationTime_ = Null<Real>();
         bool isTrained_ = false;
         std::set<std::pair<Real, Size>> regressorTimesModelIndices_;
@@ -190,6 +223,10 @@ private:
     // get the index of a time in the given simulation times set
     Size timeIndex(const Time t, const std::set<Real>& simulationTimes) const;
 
+    /* trigger the calculation of the lazy objects and set up the single entry caches used in the amount calculation
+       of a flow, so that the amount can be computed concurrently on several threads afterwards */
+    void prepareAmountCalculation(const boost::shared_ptr<CashFlow>& flow) const;
+
     // compute a cashflow path value (in model base ccy)
     RandomVariable cashflowPathValue(const CashflowInfo& cf, const std::vector<std::vector<RandomVariable>>& pathValues,
                                      const std::set<Real>& simulationTimes) const;
@@ -27,10 +27,11 @@ McMultiLegOptionEngine::McMultiLegOptionEngine(
     const LsmBasisSystem::PolynomialType polynomType, const SobolBrownianGenerator::Ordering ordering,
     const SobolRsg::DirectionIntegers directionIntegers, const std::vector<Handle<YieldTermStructure>>& discountCurves,
     const std::vector<Date>& simulationDates, const std::vector<Size>& externalModelIndices, const bool minObsDate,
-    const RegressorModel regressorModel)
+    const RegressorModel regressorModel, const Size threads, const bool controlVariate)
     : McMultiLegBaseEngine(model, calibrationPathGenerator, pricingPathGenerator, calibrationSamples, pricingSamples,
                            calibrationSeed, pricingSeed, polynomOrder, polynomType, ordering, directionIntegers,
-                           discountCurves, simulationDates, externalModelIndices, minObsDate, regressorModel) {
+                           discountCurves, simulationDates, externalModelIndices, minObsDate, regressorModel, threads,
+                           controlVariate) {
     registerWith(model_);
     for (auto& h : discountCurves_) {
         registerWith(h);
@@ -44,13 +45,14 @@ McMultiLegOptionEngine::McMultiLegOptionEngine(
     const LsmBasisSystem::PolynomialType polynomType, const SobolBrownianGenerator::Ordering ordering,
     const SobolRsg::DirectionIntegers directionIntegers, const Handle<YieldTermStructure>& discountCurve,
     const std::vector<Date>& simulationDates, const std::vector<Size>& externalModelIndices, const bool minimalObsDate,
-    const RegressorModel regressorModel)
+    const RegressorModel regressorModel, const Size threads, const bool controlVariate)
     : McMultiLegOptionEngine(Handle<CrossAssetModel>(boost::make_shared<CrossAssetModel>(
                                  std::vector<boost::shared_ptr<IrModel>>(1, model),
                                  std::vector<boost::shared_ptr<FxBsParametrization>>())),
                              calibrationPathGenerator, pricingPathGenerator, calibrationSamples, pricingSamples,
                              calibrationSeed, pricingSeed, polynomOrder, polynomType, ordering, directionIntegers,
-                             {discountCurve}, simulationDates, externalModelIndices, minimalObsDate, regressorModel) {}
+                             {discountCurve}, simulationDates, externalModelIndices, minimalObsDate, regressorModel,
+                             threads, controlVariate) {}
 
 void McMultiLegOptionEngine::calculate() const {
 
@@ -68,6 +70,7 @@ void McMultiLegOptionEngine::calculate() const {
     if (npvCcyIndex > 0)
         fxSpot = model_->fxbs(npvCcyIndex - 1)->fxSpotToday()->value();
     results_.value = resultValue_ / fxSpot;
+    results_.errorEstimate = resultValueErrorEstimate_ / fxSpot;
     results_.additionalResults["underlyingNpv"] = resultUnderlyingNpv_ / fxSpot;
     results_.additionalResults["amcCalculator"] = amcCalculator();
 } // calculate
@@ -47,7 +47,8 @@ public:
         const std::vector<Handle<YieldTermStructure>>& discountCurves = std::vector<Handle<YieldTermStructure>>(),
         const std::vector<Date>& simulationDates = std::vector<Date>(),
         const std::vector<Size>& externalModelIndices = std::vector<Size>(), const bool minimalObsDate = true,
-        const RegressorModel regressorModel = RegressorModel::Simple);
+        const RegressorModel regressorModel = RegressorModel::Simple, const Size threads = 1,
+        const bool controlVariate = false);
     McMultiLegOptionEngine(const boost::shared_ptr<LinearGaussMarkovModel>& model,
                            const SequenceType calibrationPathGenerator, const SequenceType pricingPathGenerator,
                            const Size calibrationSamples, const Size pricingSamples, const Size calibrationSeed,
@@ -59,7 +60,8 @@ public:
                            const std::vector<Date>& simulationDates = std::vector<Date>(),
                            const std::vector<Size>& externalModelIndices = std::vector<Size>(),
                            const bool minimalObsDate = true,
-                           const RegressorModel regressorModel = RegressorModel::Simple);
+                           const RegressorModel regressorModel = RegressorModel::Simple, const Size threads = 1,
+        const bool controlVariate = false);
 
     void calculate() const override;
     const Handle<CrossAssetModel>& model() const { return model_; }
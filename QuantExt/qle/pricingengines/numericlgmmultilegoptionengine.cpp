@@ -186,8 +186,9 @@ RandomVariable getRebatePv(const LgmVectorised& lgm, const Real t, const RandomV
 
 NumericLgmMultiLegOptionEngineBase::NumericLgmMultiLegOptionEngineBase(
     const boost::shared_ptr<LinearGaussMarkovModel>& model, const Real sy, const Size ny, const Real sx, const Size nx,
-    const Handle<YieldTermStructure>& discountCurve)
-    : LgmConvolutionSolver2(model, sy, ny, sx, nx), discountCurve_(discountCurve) {}
+    const Handle<YieldTermStructure>& discountCurve,
+    const LgmConvolutionSolver2::Method method)
+    : LgmConvolutionSolver2(model, sy, ny, sx, nx, method), discountCurve_(discountCurve) {}
 
 void NumericLgmMultiLegOptionEngineBase::calculate() const {
 
@@ -365,8 +366,9 @@ void NumericLgmMultiLegOptionEngineBase::calculate() const {
 NumericLgmMultiLegOptionEngine::NumericLgmMultiLegOptionEngine(const boost::shared_ptr<LinearGaussMarkovModel>& model,
                                                                const Real sy, const Size ny, const Real sx,
                                                                const Size nx,
-                                                               const Handle<YieldTermStructure>& discountCurve)
-    : NumericLgmMultiLegOptionEngineBase(model, sy, ny, sx, nx, discountCurve) {
+                                                               const Handle<YieldTermStructure>& discountCurve,
+                                                               const LgmConvolutionSolver2::Method method)
+    : NumericLgmMultiLegOptionEngineBase(model, sy, ny, sx, nx, discountCurve, method) {
     registerWith(LgmConvolutionSolver2::model());
     registerWith(discountCurve_);
 }
@@ -389,8 +391,9 @@ void NumericLgmMultiLegOptionEngine::calculate() const {
 
 NumericLgmSwaptionEngine::NumericLgmSwaptionEngine(const boost::shared_ptr<LinearGaussMarkovModel>& model,
                                                    const Real sy, const Size ny, const Real sx, const Size nx,
-                                                   const Handle<YieldTermStructure>& discountCurve)
-    : NumericLgmMultiLegOptionEngineBase(model, sy, ny, sx, nx, discountCurve) {
+                                                   const Handle<YieldTermStructure>& discountCurve,
+                                                   const LgmConvolutionSolver2::Method method)
+    : NumericLgmMultiLegOptionEngineBase(model, sy, ny, sx, nx, discountCurve, method) {
     registerWith(LgmConvolutionSolver2::model());
     registerWith(discountCurve_);
 }
@@ -412,8 +415,9 @@ void NumericLgmSwaptionEngine::calculate() const {
 
 NumericLgmNonstandardSwaptionEngine::NumericLgmNonstandardSwaptionEngine(
     const boost::shared_ptr<LinearGaussMarkovModel>& model, const Real sy, const Size ny, const Real sx, const Size nx,
-    const Handle<YieldTermStructure>& discountCurve)
-    : NumericLgmMultiLegOptionEngineBase(model, sy, ny, sx, nx, discountCurve) {
+    const Handle<YieldTermStructure>& discountCurve,
+    const LgmConvolutionSolver2::Method method)
+    : NumericLgmMultiLegOptionEngineBase(model, sy, ny, sx, nx, discountCurve, method) {
     registerWith(LgmConvolutionSolver2::model());
     registerWith(discountCurve_);
 }
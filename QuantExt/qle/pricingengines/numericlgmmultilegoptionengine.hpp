@@ -30,9 +30,10 @@ namespace QuantExt {
 
 class NumericLgmMultiLegOptionEngineBase : protected LgmConvolutionSolver2 {
 public:
-    NumericLgmMultiLegOptionEngineBase(const boost::shared_ptr<LinearGaussMarkovModel>& model, const Real sy,
-                                       const Size ny, const Real sx, const Size nx,
-                                       const Handle<YieldTermStructure>& discountCurve = Handle<YieldTermStructure>());
+    NumericLgmMultiLegOptionEngineBase(
+        const boost::shared_ptr<LinearGaussMarkovModel>& model, const Real sy, const Size ny, const Real sx,
+        const Size nx, const Handle<YieldTermStructure>& discountCurve = Handle<YieldTermStructure>(),
+        const LgmConvolutionSolver2::Method method = LgmConvolutionSolver2::Method::Direct);
 
 protected:
     void calculate() const;
@@ -58,7 +59,8 @@ class NumericLgmMultiLegOptionEngine
 public:
     NumericLgmMultiLegOptionEngine(const boost::shared_ptr<LinearGaussMarkovModel>& model, const Real sy, const Size ny,
                                    const Real sx, const Size nx,
-                                   const Handle<YieldTermStructure>& discountCurve = Handle<YieldTermStructure>());
+                                   const Handle<YieldTermStructure>& discountCurve = Handle<YieldTermStructure>(),
+                                   const LgmConvolutionSolver2::Method method = LgmConvolutionSolver2::Method::Direct);
 
     void calculate() const override;
 };
@@ -68,7 +70,8 @@ class NumericLgmSwaptionEngine : public QuantLib::GenericEngine<Swaption::argume
 public:
     NumericLgmSwaptionEngine(const boost::shared_ptr<LinearGaussMarkovModel>& model, const Real sy, const Size ny,
                              const Real sx, const Size nx,
-                             const Handle<YieldTermStructure>& discountCurve = Handle<YieldTermStructure>());
+                             const Handle<YieldTermStructure>& discountCurve = Handle<YieldTermStructure>(),
+                             const LgmConvolutionSolver2::Method method = LgmConvolutionSolver2::Method::Direct);
 
     void calculate() const override;
 };
@@ -77,9 +80,10 @@ class NumericLgmNonstandardSwaptionEngine
     : public QuantLib::GenericEngine<NonstandardSwaption::arguments, NonstandardSwaption::results>,
       public NumericLgmMultiLegOptionEngineBase {
 public:
-    NumericLgmNonstandardSwaptionEngine(const boost::shared_ptr<LinearGaussMarkovModel>& model, const Real sy,
-                                        const Size ny, const Real sx, const Size nx,
-                                        const Handle<YieldTermStructure>& discountCurve = Handle<YieldTermStructure>());
+    NumericLgmNonstandardSwaptionEngine(
+        const boost::shared_ptr<LinearGaussMarkovModel>& model, const Real sy, const Size ny, const Real sx,
+        const Size nx, const Handle<YieldTermStructure>& discountCurve = Handle<YieldTermStructure>(),
+        const LgmConvolutionSolver2::Method method = LgmConvolutionSolver2::Method::Direct);
 
     void calculate() const override;
 };
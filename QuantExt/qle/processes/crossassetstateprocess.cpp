@@ -50,6 +50,12 @@ inline void setValue2(Matrix& m, const Real& value, const boost::shared_ptr<cons
     Size j = model->wIdx(t2, i2, offset2);
     m[i][j] = value;
 }
+
+// clear a time step cache that is full before a new time step is added
+template <class Cache> inline void boundCache(Cache& cache, const Size maxSize) {
+    if (cache.size() >= maxSize)
+        cache.clear();
+}
 } // anonymous namespace
 
 CrossAssetStateProcess::CrossAssetStateProcess(boost::shared_ptr<const CrossAssetModel> model)
@@ -80,16 +86,27 @@ Size CrossAssetStateProcess::size() const { return model_->dimension(); }
 Size CrossAssetStateProcess::factors() const { return model_->brownians() + model_->auxBrownians(); }
 
 void CrossAssetStateProcess::resetCache(const Size timeSteps) const {
-    cacheNotReady_m_ = cacheNotReady_d_ = true;
-    timeStepsToCache_m_ = timeStepsToCache_d_ = timeSteps;
-    timeStepCache_m_ = timeStepCache_d_ = 0;
+    cacheEnabled_ = timeSteps > 0;
+    cacheSize_ = timeSteps;
     cache_m_.clear();
     cache_d_.clear();
+    if (cacheEnabled_) {
+        cache_m_.reserve(timeSteps);
+        cache_d_.reserve(timeSteps);
+    }
     if (auto tmp = boost::dynamic_pointer_cast<CrossAssetStateProcess::ExactDiscretization>(discretization_))
         tmp->resetCache(timeSteps);
     updateSqrtCorrelation();
 }
 
+void CrossAssetStateProcess::flushCache() const {
+    cache_m_.clear();
+    cache_d_.clear();
+    if (auto tmp = boost::dynamic_pointer_cast<CrossAssetStateProcess::ExactDiscretization>(discretization_))
+        tmp->flushCache();
+    updateSqrtCorrelation();
+}
+
 void CrossAssetStateProcess::updateSqrtCorrelation() const {
     if (model_->discretization() != CrossAssetModel::Discretization::Euler)
         return;
@@ -136,7 +153,8 @@ Array CrossAssetStateProcess::drift(Time t, const Array& x) const {
     Real Hprime0 = model_->irlgm1f(0)->Hprime(t);
     Real alpha0 = model_->irlgm1f(0)->alpha(t);
     Real zeta0 = model_->irlgm1f(0)->zeta(t);
-    if (cacheNotReady_m_) {
+    auto cached = cacheEnabled_ ? cache_m_.find(t) : cache_m_.end();
+    if (cached == cache_m_.end()) {
         /* z0 has drift 0 in the LGM measure but non-zero drift in the bank account measure, so start loop at i = 0 */
         for (Size i = 0; i < n; ++i) {
             Real Hi = model_->irlgm1f(i)->H(t);
@@ -267,15 +285,12 @@ Array CrossAssetStateProcess::drift(Time t, const Array& x) const {
             }
         }
 
-        if (timeStepsToCache_m_ > 0) {
-            cache_m_.push_back(res);
-            if (cache_m_.size() == timeStepsToCache_m_)
-                cacheNotReady_m_ = false;
+        if (cacheEnabled_) {
+            boundCache(cache_m_, cacheSize_);
+            cache_m_.emplace(t, res);
         }
     } else {
-        res = cache_m_[timeStepCache_m_++];
-        if (timeStepCache_m_ == timeStepsToCache_m_)
-            timeStepCache_m_ = 0;
+        res = cached->second;
     }
     // non-cacheable sections of drifts
     for (Size i = 1; i < n; ++i) {
@@ -342,20 +357,14 @@ Matrix CrossAssetStateProcess::diffusion(Time t, const Array& x) const {
 }
 
 Matrix CrossAssetStateProcess::diffusionOnCorrelatedBrownians(Time t, const Array& x) const {
-    if (cacheNotReady_d_) {
-        Matrix tmp = diffusionOnCorrelatedBrowniansImpl(t, x);
-        if (timeStepsToCache_d_ > 0) {
-            cache_d_.push_back(tmp);
-            if (cache_d_.size() == timeStepsToCache_d_)
-                cacheNotReady_d_ = false;
-        }
-        return tmp;
-    } else {
-        Matrix tmp = cache_d_[timeStepCache_d_++];
-        if (timeStepCache_d_ == timeStepsToCache_d_)
-            timeStepCache_d_ = 0;
-        return tmp;
-    }
+    if (!cacheEnabled_)
+        return diffusionOnCorrelatedBrowniansImpl(t, x);
+    auto cached = cache_d_.find(t);
+    if (cached == cache_d_.end()) {
+        boundCache(cache_d_, cacheSize_);
+        cached = cache_d_.emplace(t, diffusionOnCorrelatedBrowniansImpl(t, x)).first;
+    }
+    return cached->second;
 }
 
 Matrix CrossAssetStateProcess::diffusionOnCorrelatedBrowniansImpl(Time t, const Array&) const {
@@ -585,17 +594,15 @@ CrossAssetStateProcess::ExactDiscretization::ExactDiscretization(boost::shared_p
 Array CrossAssetStateProcess::ExactDiscretization::drift(const StochasticProcess& p, Time t0, const Array& x0,
                                                          Time dt) const {
     Array res;
-    if (cacheNotReady_m_) {
-        res = driftImpl1(p, t0, x0, dt);
-        if (timeStepsToCache_m_ > 0) {
-            cache_m_.push_back(res);
-            if (cache_m_.size() == timeStepsToCache_m_)
-                cacheNotReady_m_ = false;
+    if (cacheEnabled_) {
+        auto cached = cache_m_.find(std::make_pair(t0, dt));
+        if (cached == cache_m_.end()) {
+            boundCache(cache_m_, cacheSize_);
+            cached = cache_m_.emplace(std::make_pair(t0, dt), driftImpl1(p, t0, x0, dt)).first;
         }
+        res = cached->second;
     } else {
-        res = cache_m_[timeStepCache_m_++];
-        if (timeStepCache_m_ == timeStepsToCache_m_)
-            timeStepCache_m_ = 0;
+        res = driftImpl1(p, t0, x0, dt);
     }
     Array res2 = driftImpl2(p, t0, x0, dt);
     for (Size i = 0; i < res.size(); ++i) {
@@ -606,39 +613,28 @@ Array CrossAssetStateProcess::ExactDiscretization::drift(const StochasticProcess
 
 Matrix CrossAssetStateProcess::ExactDiscretization::diffusion(const StochasticProcess& p, Time t0, const Array& x0,
                                                               Time dt) const {
-    if (cacheNotReady_d_) {
+    // note that covariance actually does not depend on x0
+    if (!cacheEnabled_)
+        return pseudoSqrt(covariance(p, t0, x0, dt), salvaging_);
+    auto cached = cache_d_.find(std::make_pair(t0, dt));
+    if (cached == cache_d_.end()) {
         Matrix res = pseudoSqrt(covariance(p, t0, x0, dt), salvaging_);
-        // note that covariance actually does not depend on x0
-        if (timeStepsToCache_d_ > 0) {
-            cache_d_.push_back(res);
-            if (cache_d_.size() == timeStepsToCache_d_)
-                cacheNotReady_d_ = false;
-        }
-        return res;
-    } else {
-        Matrix res = cache_d_[timeStepCache_d_++];
-        if (timeStepCache_d_ == timeStepsToCache_d_)
-            timeStepCache_d_ = 0;
-        return res;
+        boundCache(cache_d_, cacheSize_);
+        cached = cache_d_.emplace(std::make_pair(t0, dt), res).first;
     }
+    return cached->second;
 }
 
 Matrix CrossAssetStateProcess::ExactDiscretization::covariance(const StochasticProcess& p, Time t0, const Array& x0,
                                                                Time dt) const {
-    if (cacheNotReady_v_) {
-        Matrix res = covarianceImpl(p, t0, x0, dt);
-        if (timeStepsToCache_v_ > 0) {
-            cache_v_.push_back(res);
-            if (cache_v_.size() == timeStepsToCache_v_)
-                cacheNotReady_v_ = false;
-        }
-        return res;
-    } else {
-        Matrix res = cache_v_[timeStepCache_v_++];
-        if (timeStepCache_v_ == timeStepsToCache_v_)
-            timeStepCache_v_ = 0;
-        return res;
-    }
+    if (!cacheEnabled_)
+        return covarianceImpl(p, t0, x0, dt);
+    auto cached = cache_v_.find(std::make_pair(t0, dt));
+    if (cached == cache_v_.end()) {
+        boundCache(cache_v_, cacheSize_);
+        cached = cache_v_.emplace(std::make_pair(t0, dt), covarianceImpl(p, t0, x0, dt)).first;
+    }
+    return cached->second;
 }
 
 Array CrossAssetStateProcess::ExactDiscretization::driftImpl1(const StochasticProcess&, Time t0, const Array&,
@@ -980,9 +976,17 @@ Matrix CrossAssetStateProcess::ExactDiscretization::covarianceImpl(const Stochas
 }
 
 void CrossAssetStateProcess::ExactDiscretization::resetCache(const Size timeSteps) const {
-    cacheNotReady_m_ = cacheNotReady_d_ = cacheNotReady_v_ = true;
-    timeStepsToCache_m_ = timeStepsToCache_d_ = timeStepsToCache_v_ = timeSteps;
-    timeStepCache_m_ = timeStepCache_d_ = timeStepCache_v_ = 0;
+    cacheEnabled_ = timeSteps > 0;
+    cacheSize_ = timeSteps;
+    flushCache();
+    if (cacheEnabled_) {
+        cache_m_.reserve(timeSteps);
+        cache_v_.reserve(timeSteps);
+        cache_d_.reserve(timeSteps);
+    }
+}
+
+void CrossAssetStateProcess::ExactDiscretization::flushCache() const {
     cache_m_.clear();
     cache_v_.clear();
     cache_d_.clear();
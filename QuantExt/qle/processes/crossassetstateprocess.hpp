@@ -51,8 +51,12 @@ public:
     Matrix diffusion(Time t, const Array& x) const override;
     Array evolve(Time t0, const Array& x0, Time dt, const Array& dw) const override;
 
-    // enables and resets the cache, once enabled the simulated times must stay the stame
+    /* enables (timeSteps > 0) or disables (timeSteps = 0) and resets the cache for the time step dependent parts of
+       the drift and diffusion; the cache is keyed on the time step and holds at most timeSteps entries, it is cleared
+       when a new time step would exceed this */
     void resetCache(const Size timeSteps) const;
+    // clears the cache, but keeps it enabled if it was, this is called by the model on parameter updates
+    void flushCache() const;
 
 protected:
     virtual Matrix diffusionOnCorrelatedBrownians(Time t, const Array& x) const;
@@ -74,6 +78,7 @@ protected:
         virtual Matrix diffusion(const StochasticProcess&, Time t0, const Array& x0, Time dt) const override;
         virtual Matrix covariance(const StochasticProcess&, Time t0, const Array& x0, Time dt) const override;
         void resetCache(const Size timeSteps) const;
+        void flushCache() const;
 
     protected:
         virtual Array driftImpl1(const StochasticProcess&, Time t0, const Array& x0, Time dt) const;
@@ -83,27 +88,18 @@ protected:
         boost::shared_ptr<const CrossAssetModel> model_;
         SalvagingAlgorithm::Type salvaging_;
 
-        mutable bool cacheNotReady_m_ = true;
-        mutable bool cacheNotReady_d_ = true;
-        mutable bool cacheNotReady_v_ = true;
-        mutable Size timeStepsToCache_m_ = 0;
-        mutable Size timeStepsToCache_d_ = 0;
-        mutable Size timeStepsToCache_v_ = 0;
-        mutable Size timeStepCache_m_ = 0;
-        mutable Size timeStepCache_d_ = 0;
-        mutable Size timeStepCache_v_ = 0;
-        mutable std::vector<Array> cache_m_;
-        mutable std::vector<Matrix> cache_v_, cache_d_;
+        // per time step (t0, dt) tables, only depending on the model parameters
+        mutable bool cacheEnabled_ = false;
+        mutable Size cacheSize_ = 0;
+        mutable boost::unordered_map<std::pair<Real, Real>, Array> cache_m_;
+        mutable boost::unordered_map<std::pair<Real, Real>, Matrix> cache_v_, cache_d_;
     }; // ExactDiscretization
 
-    mutable bool cacheNotReady_m_ = true;
-    mutable bool cacheNotReady_d_ = true;
-    mutable Size timeStepsToCache_m_ = 0;
-    mutable Size timeStepCache_m_ = 0;
-    mutable Size timeStepsToCache_d_ = 0;
-    mutable Size timeStepCache_d_ = 0;
-    mutable std::vector<Array> cache_m_;
-    mutable std::vector<Matrix> cache_d_;
+    // per time t tables, only depending on the model parameters
+    mutable bool cacheEnabled_ = false;
+    mutable Size cacheSize_ = 0;
+    mutable boost::unordered_map<Real, Array> cache_m_;
+    mutable boost::unordered_map<Real, Matrix> cache_d_;
 }; // CrossAssetStateProcess
 
 } // namespace QuantExt
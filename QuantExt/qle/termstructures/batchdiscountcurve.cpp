@@ -0,0 +1,182 @@
+/*
+ Copyright (C) 2023 Quaternion Risk Management Ltd
+ All rights reserved.
+
+ This file is part of ORE, a free-software/open-source library
+ for transparent pricing and risk analysis - http://opensourcerisk.org
+
+ ORE is free software: you can redistribute it and/or modify it
+ under the terms of the Modified BSD License.  You should have received a
+ copy of the license along with this program.
+ The license is also available online at <http://opensourcerisk.org>
+
+ This program is distributed on the basis that it will form a useful
+ contribution to risk analytics and model standardisation, but WITHOUT
+ ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ FITNESS FOR A PARTICULAR PURPOSE. See the license for more details.
+*/
+
+#include <qle/termstructures/batchdiscountcurve.hpp>
+
+#include <ql/cashflows/coupon.hpp>
+#include <ql/math/comparison.hpp>
+#include <ql/settings.hpp>
+
+#include <algorithm>
+
+namespace QuantExt {
+
+DiscountInterpolationKernel::DiscountInterpolationKernel(const std::vector<Time>& times)
+    : times_(times), c0_(times.size(), 0.0), c1_(times.size(), 0.0), c2_(times.size(), 0.0) {
+    QL_REQUIRE(times_.size() > 1, "DiscountInterpolationKernel: at least two times required");
+    for (Size i = 1; i < times_.size(); ++i) {
+        QL_REQUIRE(times_[i] > times_[i - 1], "DiscountInterpolationKernel: times must be increasing, got "
+                                                  << times_[i - 1] << ", " << times_[i] << " at index " << i);
+    }
+}
+
+void DiscountInterpolationKernel::update(const std::vector<Real>& data, const bool logLinear, const bool flatFwd) {
+    Size n = times_.size();
+    QL_REQUIRE(data.size() == n,
+               "DiscountInterpolationKernel: data size (" << data.size() << ") does not match times (" << n << ")");
+
+    // interpolation segments
+
+    Real slope = 0.0;
+    for (Size i = 0; i < n - 1; ++i) {
+        Real h = times_[i + 1] - times_[i];
+        if (logLinear) {
+            c0_[i] = std::log(data[i]);
+            slope = (std::log(data[i + 1]) - c0_[i]) / h;
+            c1_[i] = slope;
+            c2_[i] = 0.0;
+        } else {
+            // -(z_i + s u) (t_i + u) = -z_i t_i - (z_i + s t_i) u - s u^2
+            slope = (data[i + 1] - data[i]) / h;
+            c0_[i] = -data[i] * times_[i];
+            c1_[i] = -(data[i] + slope * times_[i]);
+            c2_[i] = -slope;
+        }
+    }
+
+    // extrapolation segment, consistent with the existing discountImpl() of the curves using this kernel, i.e. the
+    // instantaneous forward at the last pillar is computed as -derivative(tMax) / dMax of the underlying interpolation
+
+    Time tMax = times_.back();
+    Real logDMax = logLinear ? std::log(data.back()) : -data.back() * tMax;
+    c0_[n - 1] = logDMax;
+    c2_[n - 1] = 0.0;
+    if (flatFwd)
+        c1_[n - 1] = logLinear ? slope : slope / std::exp(logDMax);
+    else
+        c1_[n - 1] = logDMax / tMax;
+}
+
+Size DiscountInterpolationKernel::segment(const Time t) const {
+    Size i = std::upper_bound(times_.begin(), times_.end(), t) - times_.begin();
+    return i > 0 ? i - 1 : 0;
+}
+
+void DiscountInterpolationKernel::logDiscounts(const std::vector<Time>& t, std::vector<Real>& result) const {
+    result.resize(t.size());
+    Size hint = 0;
+    Time last = -QL_MAX_REAL;
+    for (Size k = 0; k < t.size(); ++k) {
+        // for increasing times we can restrict the search to the segments from the last hit on
+        Size i = t[k] >= last
+                     ? std::upper_bound(std::next(times_.begin(), hint), times_.end(), t[k]) - times_.begin()
+                     : std::upper_bound(times_.begin(), times_.end(), t[k]) - times_.begin();
+        hint = i > 0 ? i - 1 : 0;
+        last = t[k];
+        Real u = t[k] - times_[hint];
+        result[k] = c0_[hint] + u * (c1_[hint] + u * c2_[hint]);
+    }
+}
+
+void discounts(const Handle<YieldTermStructure>& curve, const std::vector<Time>& times,
+               std::vector<DiscountFactor>& result) {
+    QL_REQUIRE(!curve.empty(), "discounts(): curve is empty");
+    result.resize(times.size());
+    if (auto b = boost::dynamic_pointer_cast<BatchDiscountCurve>(curve.currentLink())) {
+        // same range checks as in TermStructure::checkRange()
+        Time tMax = curve->maxTime();
+        bool extrapolate = curve->allowsExtrapolation();
+        for (auto const& t : times) {
+            QL_REQUIRE(t >= 0.0, "negative time (" << t << ") given");
+            QL_REQUIRE(extrapolate || t <= tMax || close_enough(t, tMax),
+                       "time (" << t << ") is past max curve time (" << tMax << ")");
+        }
+        b->discounts(times, result);
+    } else {
+        for (Size i = 0; i < times.size(); ++i)
+            result[i] = curve->discount(times[i]);
+    }
+}
+
+void discounts(const Handle<YieldTermStructure>& curve, const std::vector<Date>& dates,
+               std::vector<DiscountFactor>& result) {
+    QL_REQUIRE(!curve.empty(), "discounts(): curve is empty");
+    std::vector<Time> times(dates.size());
+    for (Size i = 0; i < dates.size(); ++i)
+        times[i] = curve->timeFromReference(dates[i]);
+    discounts(curve, times, result);
+}
+
+void forwardRates(const Handle<YieldTermStructure>& curve, const std::vector<Time>& t1, const std::vector<Time>& t2,
+                  std::vector<Rate>& result) {
+    QL_REQUIRE(t1.size() == t2.size(),
+               "forwardRates(): t1 size (" << t1.size() << ") does not match t2 size (" << t2.size() << ")");
+    Size n = t1.size();
+    std::vector<Time> times(2 * n);
+    for (Size i = 0; i < n; ++i) {
+        QL_REQUIRE(t2[i] > t1[i], "forwardRates(): t2 (" << t2[i] << ") must be greater than t1 (" << t1[i] << ")");
+        times[2 * i] = t1[i];
+        times[2 * i + 1] = t2[i];
+    }
+    std::vector<DiscountFactor> df;
+    discounts(curve, times, df);
+    result.resize(n);
+    for (Size i = 0; i < n; ++i)
+        result[i] = (df[2 * i] / df[2 * i + 1] - 1.0) / (t2[i] - t1[i]);
+}
+
+std::pair<Real, Real> batchNpvBps(const Leg& leg, const Handle<YieldTermStructure>& discountCurve,
+                                  bool includeSettlementDateFlows, Date settlementDate, Date npvDate) {
+    Real npv = 0.0, bps = 0.0;
+    if (leg.empty())
+        return std::make_pair(npv, bps);
+
+    if (settlementDate == Date())
+        settlementDate = Settings::instance().evaluationDate();
+    if (npvDate == Date())
+        npvDate = settlementDate;
+
+    // collect the live cashflows and their pay dates, the last date is the npv date
+
+    std::vector<boost::shared_ptr<CashFlow>> live;
+    std::vector<Date> dates;
+    live.reserve(leg.size());
+    dates.reserve(leg.size() + 1);
+    for (auto const& cf : leg) {
+        if (!cf->hasOccurred(settlementDate, includeSettlementDateFlows) && !cf->tradingExCoupon(settlementDate)) {
+            live.push_back(cf);
+            dates.push_back(cf->date());
+        }
+    }
+    dates.push_back(npvDate);
+
+    std::vector<DiscountFactor> df;
+    discounts(discountCurve, dates, df);
+
+    for (Size i = 0; i < live.size(); ++i) {
+        npv += live[i]->amount() * df[i];
+        if (auto cp = boost::dynamic_pointer_cast<Coupon>(live[i]))
+            bps += cp->nominal() * cp->accrualPeriod() * df[i];
+    }
+
+    const Spread bp = 1.0e-4;
+    DiscountFactor d = df.back();
+    return std::make_pair(npv / d, bp * bps / d);
+}
+
+} // namespace QuantExt
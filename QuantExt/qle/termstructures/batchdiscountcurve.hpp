@@ -0,0 +1,97 @@
+/*
+ Copyright (C) 2023 Quaternion Risk Management Ltd
+ All rights reserved.
+
+ This file is part of ORE, a free-software/open-source library
+ for transparent pricing and risk analysis - http://opensourcerisk.org
+
+ ORE is free software: you can redistribute it and/or modify it
+ under the terms of the Modified BSD License.  You should have received a
+ copy of the license along with this program.
+ The license is also available online at <http://opensourcerisk.org>
+
+ This program is distributed on the basis that it will form a useful
+ contribution to risk analytics and model standardisation, but WITHOUT
+ ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ FITNESS FOR A PARTICULAR PURPOSE. See the license for more details.
+*/
+
+/*! \file batchdiscountcurve.hpp
+    \brief batch evaluation of discount factors and forward rates
+    \ingroup termstructures
+*/
+
+#pragma once
+
+#include <ql/cashflow.hpp>
+#include <ql/handle.hpp>
+#include <ql/termstructures/yieldtermstructure.hpp>
+
+#include <vector>
+
+namespace QuantExt {
+using namespace QuantLib;
+
+//! Interface for yield curves that can evaluate discount factors for a vector of times in one call
+/*! \ingroup termstructures */
+class BatchDiscountCurve {
+public:
+    virtual ~BatchDiscountCurve() {}
+    /*! discount factors for the given times (relative to the reference date of the curve), no range checks are
+        performed, use the free function discounts() below to get the same checks as in YieldTermStructure */
+    virtual void discounts(const std::vector<Time>& times, std::vector<DiscountFactor>& result) const = 0;
+};
+
+//! Log discount interpolation kernel on contiguous pillar arrays
+/*! The log discount is represented by a quadratic polynomial in \f$ u = t - t_i \f$ on each segment
+    \f$ [t_i, t_{i+1}] \f$, which covers log-linear discount interpolation (linear polynomial) and linear zero rate
+    interpolation (quadratic polynomial), plus one extra segment starting at the last pillar for the flat forward or
+    flat zero extrapolation. Times before the first pillar are extrapolated using the first segment.
+
+    The evaluation consists of a binary search for the segment and a branch-free polynomial evaluation, for a vector
+    of increasing times the search is started at the segment found for the previous time.
+
+    \ingroup termstructures
+*/
+class DiscountInterpolationKernel {
+public:
+    DiscountInterpolationKernel() {}
+    //! pillar times, must be increasing and contain at least two times
+    explicit DiscountInterpolationKernel(const std::vector<Time>& times);
+
+    /*! set the pillar values, these are discount factors if logLinear is true and zero rates otherwise, if flatFwd
+        is false, flat zero extrapolation is used */
+    void update(const std::vector<Real>& data, const bool logLinear, const bool flatFwd);
+
+    Real logDiscount(const Time t) const {
+        Size i = segment(t);
+        Real u = t - times_[i];
+        return c0_[i] + u * (c1_[i] + u * c2_[i]);
+    }
+    void logDiscounts(const std::vector<Time>& t, std::vector<Real>& result) const;
+
+private:
+    Size segment(const Time t) const;
+    std::vector<Time> times_;
+    std::vector<Real> c0_, c1_, c2_;
+};
+
+/*! discount factors for the given times, uses the batch evaluation if the curve supports it and falls back to
+    single evaluations otherwise */
+void discounts(const Handle<YieldTermStructure>& curve, const std::vector<Time>& times,
+               std::vector<DiscountFactor>& result);
+
+//! date based version of discounts()
+void discounts(const Handle<YieldTermStructure>& curve, const std::vector<Date>& dates,
+               std::vector<DiscountFactor>& result);
+
+//! simply compounded forward rates between the times t1[i] and t2[i] using the batch evaluation if possible
+void forwardRates(const Handle<YieldTermStructure>& curve, const std::vector<Time>& t1, const std::vector<Time>& t2,
+                  std::vector<Rate>& result);
+
+/*! same as QuantLib::CashFlows::npvbps(), but evaluates the discount factors in one batch, returns the npv and the
+    bps of the leg as of the npv date */
+std::pair<Real, Real> batchNpvBps(const Leg& leg, const Handle<YieldTermStructure>& discountCurve,
+                                  bool includeSettlementDateFlows, Date settlementDate, Date npvDate);
+
+} // namespace QuantExt
@@ -24,11 +24,12 @@
 #ifndef quantext_interpolated_discount_curve_2_hpp
 #define quantext_interpolated_discount_curve_2_hpp
 
-#include <ql/math/interpolations/loginterpolation.hpp>
 #include <ql/patterns/lazyobject.hpp>
 #include <ql/termstructures/yieldtermstructure.hpp>
 #include <ql/time/calendars/nullcalendar.hpp>
 
+#include <qle/termstructures/batchdiscountcurve.hpp>
+
 #include <boost/make_shared.hpp>
 
 namespace QuantExt {
@@ -39,9 +40,12 @@ using namespace QuantLib;
     reference date is always the global evaluation date,
     i.e. settlement days are zero and calendar is NullCalendar()
 
+    The interpolation is done by a DiscountInterpolationKernel, which also provides the batch evaluation of discount
+    factors for a vector of times.
+
         \ingroup termstructures
 */
-class InterpolatedDiscountCurve2 : public YieldTermStructure, public LazyObject {
+class InterpolatedDiscountCurve2 : public YieldTermStructure, public LazyObject, public BatchDiscountCurve {
 public:
     enum class Interpolation { logLinear, linearZero };
     enum class Extrapolation { flatFwd, flatZero };
@@ -60,12 +64,7 @@ public:
             QL_REQUIRE(!quotes[i].empty(), "quote at index " << i << " is empty");
             registerWith(quotes_[i]);
         }
-        if (interpolation_ == Interpolation::logLinear) {
-            dataInterpolation_ =
-                boost::make_shared<LogLinearInterpolation>(times_.begin(), times_.end(), data_.begin());
-        } else {
-            dataInterpolation_ = boost::make_shared<LinearInterpolation>(times_.begin(), times_.end(), data_.begin());
-        }
+        kernel_ = DiscountInterpolationKernel(times_);
         registerWith(Settings::instance().evaluationDate());
     }
     //! date based constructor
@@ -83,12 +82,7 @@ public:
             QL_REQUIRE(!quotes[i].empty(), "quote at index " << i << " is empty");
             registerWith(quotes_[i]);
         }
-        if (interpolation_ == Interpolation::logLinear) {
-            dataInterpolation_ =
-                boost::make_shared<LogLinearInterpolation>(times_.begin(), times_.end(), data_.begin());
-        } else {
-            dataInterpolation_ = boost::make_shared<LinearInterpolation>(times_.begin(), times_.end(), data_.begin());
-        }
+        kernel_ = DiscountInterpolationKernel(times_);
         registerWith(Settings::instance().evaluationDate());
     }
     //@}
@@ -106,6 +100,16 @@ public:
     Calendar calendar() const override { return NullCalendar(); }
     Natural settlementDays() const override { return 0; }
 
+    //! \name BatchDiscountCurve interface
+    //@{
+    void discounts(const std::vector<Time>& times, std::vector<DiscountFactor>& result) const override {
+        calculate();
+        kernel_.logDiscounts(times, result);
+        for (auto& r : result)
+            r = std::exp(r);
+    }
+    //@}
+
 protected:
     void performCalculations() const override {
         today_ = Settings::instance().evaluationDate();
@@ -118,27 +122,12 @@ protected:
                 data_[i] = -std::log(data_[std::max<Size>(i, 1)]) / times_[std::max<Size>(i, 1)];
             }
         }
-        dataInterpolation_->update();
+        kernel_.update(data_, interpolation_ == Interpolation::logLinear, extrapolation_ == Extrapolation::flatFwd);
     }
 
     DiscountFactor discountImpl(Time t) const override {
         calculate();
-        if (t <= this->times_.back()) {
-            Real tmp = (*dataInterpolation_)(t, true);
-            if (interpolation_ == Interpolation::logLinear)
-                return tmp;
-            else
-                return std::exp(-tmp * t);
-        }
-        Time tMax = this->times_.back();
-        DiscountFactor dMax =
-            interpolation_ == Interpolation::logLinear ? this->data_.back() : std::exp(-this->data_.back() * tMax);
-        if (extrapolation_ == Extrapolation::flatFwd) {
-            Rate instFwdMax = -(*dataInterpolation_).derivative(tMax) / dMax;
-            return dMax * std::exp(-instFwdMax * (t - tMax));
-        } else {
-            return std::pow(dMax, t / tMax);
-        }
+        return std::exp(kernel_.logDiscount(t));
     }
 
 private:
@@ -148,7 +137,7 @@ private:
     Extrapolation extrapolation_;
     mutable std::vector<Real> data_;
     mutable Date today_;
-    boost::shared_ptr<QuantLib::Interpolation> dataInterpolation_;
+    mutable DiscountInterpolationKernel kernel_;
 };
 
 } // namespace QuantExt
@@ -18,8 +18,6 @@
 
 #include <qle/termstructures/spreadeddiscountcurve.hpp>
 
-#include <ql/math/interpolations/loginterpolation.hpp>
-
 namespace QuantExt {
 
 SpreadedDiscountCurve::SpreadedDiscountCurve(const Handle<YieldTermStructure>& referenceCurve,
@@ -33,12 +31,7 @@ SpreadedDiscountCurve::SpreadedDiscountCurve(const Handle<YieldTermStructure>& r
     for (Size i = 0; i < quotes.size(); ++i) {
         registerWith(quotes_[i]);
     }
-    if (interpolation_ == Interpolation::logLinear) {
-        dataInterpolation_ = boost::make_shared<LogLinearInterpolation>(times_.begin(), times_.end(), data_.begin());
-    } else {
-        dataInterpolation_ = boost::make_shared<LinearInterpolation>(times_.begin(), times_.end(), data_.begin());
-    }
-    dataInterpolation_->enableExtrapolation();
+    kernel_ = DiscountInterpolationKernel(times_);
     registerWith(referenceCurve_);
 }
 
@@ -66,27 +59,21 @@ void SpreadedDiscountCurve::performCalculations() const {
             data_[i] = -std::log(data_[std::max<Size>(i, 1)]) / times_[std::max<Size>(i, 1)];
         }
     }
-    dataInterpolation_->update();
+    kernel_.update(data_, interpolation_ == Interpolation::logLinear, extrapolation_ == Extrapolation::flatFwd);
 }
 
 DiscountFactor SpreadedDiscountCurve::discountImpl(Time t) const {
     calculate();
-    Time tMax = this->times_.back();
-    DiscountFactor dMax =
-        interpolation_ == Interpolation::logLinear ? this->data_.back() : std::exp(-this->data_.back() * tMax);
-    if (t <= this->times_.back()) {
-        Real tmp = (*dataInterpolation_)(t, true);
-        if (interpolation_ == Interpolation::logLinear)
-            return referenceCurve_->discount(t) * tmp;
-        else
-            return referenceCurve_->discount(t) * std::exp(-tmp * t);
-    }
-    if (extrapolation_ == Extrapolation::flatFwd) {
-        Rate instFwdMax = -(*dataInterpolation_).derivative(tMax) / dMax;
-        return referenceCurve_->discount(t) * dMax * std::exp(-instFwdMax * (t - tMax));
-    } else {
-        return referenceCurve_->discount(t) * std::pow(dMax, t / tMax);
-    }
+    return referenceCurve_->discount(t) * std::exp(kernel_.logDiscount(t));
+}
+
+void SpreadedDiscountCurve::discounts(const std::vector<Time>& times, std::vector<DiscountFactor>& result) const {
+    calculate();
+    std::vector<Real> spread;
+    kernel_.logDiscounts(times, spread);
+    QuantExt::discounts(referenceCurve_, times, result);
+    for (Size i = 0; i < times.size(); ++i)
+        result[i] *= std::exp(spread[i]);
 }
 
 } // namespace QuantExt
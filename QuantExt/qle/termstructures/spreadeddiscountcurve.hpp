@@ -23,10 +23,11 @@
 
 #pragma once
 
-#include <ql/math/interpolation.hpp>
 #include <ql/patterns/lazyobject.hpp>
 #include <ql/termstructures/yieldtermstructure.hpp>
 
+#include <qle/termstructures/batchdiscountcurve.hpp>
+
 #include <boost/make_shared.hpp>
 
 namespace QuantExt {
@@ -35,8 +36,9 @@ using namespace QuantLib;
 /*! Curve taking a reference curve and discount factor quotes, that are used to overlay the reference
   curve with a spread. The quotes are interpolated loglinearly. The spread curve is given in terms of
   times relative to the reference date, which means that the spread will float with a changing reference
-  date in the reference curve. */
-class SpreadedDiscountCurve : public YieldTermStructure, public LazyObject {
+  date in the reference curve. The spread discount factors can be evaluated in batches, the reference curve
+  is evaluated in batches if it supports this as well. */
+class SpreadedDiscountCurve : public YieldTermStructure, public LazyObject, public BatchDiscountCurve {
 public:
     enum class Interpolation { logLinear, linearZero };
     enum class Extrapolation { flatFwd, flatZero };
@@ -53,6 +55,11 @@ public:
     Calendar calendar() const override;
     Natural settlementDays() const override;
 
+    //! \name BatchDiscountCurve interface
+    //@{
+    void discounts(const std::vector<Time>& times, std::vector<DiscountFactor>& result) const override;
+    //@}
+
 protected:
     void performCalculations() const override;
     DiscountFactor discountImpl(Time t) const override;
@@ -64,7 +71,7 @@ private:
     Interpolation interpolation_;
     Extrapolation extrapolation_;
     mutable std::vector<Real> data_;
-    boost::shared_ptr<QuantLib::Interpolation> dataInterpolation_;
+    mutable DiscountInterpolationKernel kernel_;
 };
 
 } // namespace QuantExt
@@ -0,0 +1,156 @@
+/*
+ Copyright (C) 2023 Quaternion Risk Management Ltd
+ All rights reserved.
+
+ This file is part of ORE, a free-software/open-source library
+ for transparent pricing and risk analysis - http://opensourcerisk.org
+
+ ORE is free software: you can redistribute it and/or modify it
+ under the terms of the Modified BSD License.  You should have received a
+ copy of the license along with this program.
+ The license is also available online at <http://opensourcerisk.org>
+
+ This program is distributed on the basis that it will form a useful
+ contribution to risk analytics and model standardisation, but WITHOUT
+ ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ FITNESS FOR A PARTICULAR PURPOSE. See the license for more details.
+*/
+
+#include <qle/utilities/workerpool.hpp>
+
+#include <ql/errors.hpp>
+#include <ql/indexes/indexmanager.hpp>
+#include <ql/settings.hpp>
+
+#include <algorithm>
+
+namespace QuantExt {
+
+using namespace QuantLib;
+
+namespace {
+std::mutex budgetMutex;
+Size reservedThreads = 0;
+} // namespace
+
+WorkerPool::ThreadReservation::ThreadReservation(const Size threads) {
+    Size budget = std::max<Size>(std::thread::hardware_concurrency(), 1) - 1;
+    std::lock_guard<std::mutex> lock(budgetMutex);
+    threads_ = std::min(threads, budget - std::min(budget, reservedThreads));
+    reservedThreads += threads_;
+}
+
+WorkerPool::ThreadReservation::~ThreadReservation() {
+    std::lock_guard<std::mutex> lock(budgetMutex);
+    reservedThreads -= threads_;
+}
+
+WorkerPool::WorkerPool(const Size threads) : reservation_(threads > 0 ? threads - 1 : 0) {
+    QL_REQUIRE(threads > 0, "WorkerPool: number of threads must be positive");
+#ifdef QL_ENABLE_SESSIONS
+    if (reservation_.threads() > 0) {
+        for (auto const& name : IndexManager::instance().histories())
+            histories_.push_back(std::make_pair(name, IndexManager::instance().getHistory(name)));
+    }
+#endif
+    workers_.reserve(reservation_.threads());
+    for (Size i = 0; i < reservation_.threads(); ++i)
+        workers_.emplace_back(&WorkerPool::work, this);
+}
+
+WorkerPool::~WorkerPool() {
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        stop_ = true;
+    }
+    start_.notify_all();
+    for (auto& w : workers_)
+        w.join();
+}
+
+void WorkerPool::run(const Size n, const std::function<void(Size)>& task) {
+    if (n == 0)
+        return;
+    if (workers_.empty()) {
+        for (Size i = 0; i < n; ++i)
+            task(i);
+        return;
+    }
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+#ifdef QL_ENABLE_SESSIONS
+        evaluationDate_ = Settings::instance().evaluationDate();
+        includeReferenceDateEvents_ = Settings::instance().includeReferenceDateEvents();
+        includeTodaysCashFlows_ = Settings::instance().includeTodaysCashFlows();
+        enforcesTodaysHistoricFixings_ = Settings::instance().enforcesTodaysHistoricFixings();
+#endif
+        task_ = &task;
+        n_ = n;
+        next_ = 0;
+        active_ = workers_.size();
+        error_ = nullptr;
+        ++generation_;
+    }
+    start_.notify_all();
+    process();
+    std::unique_lock<std::mutex> lock(mutex_);
+    done_.wait(lock, [this] { return active_ == 0; });
+    task_ = nullptr;
+    if (error_)
+        std::rethrow_exception(error_);
+}
+
+void WorkerPool::applySettings() const {
+#ifdef QL_ENABLE_SESSIONS
+    if (Settings::instance().evaluationDate() != evaluationDate_)
+        Settings::instance().evaluationDate() = evaluationDate_;
+    Settings::instance().includeReferenceDateEvents() = includeReferenceDateEvents_;
+    Settings::instance().includeTodaysCashFlows() = includeTodaysCashFlows_;
+    Settings::instance().enforcesTodaysHistoricFixings() = enforcesTodaysHistoricFixings_;
+#endif
+}
+
+void WorkerPool::work() {
+#ifdef QL_ENABLE_SESSIONS
+    for (auto const& h : histories_)
+        IndexManager::instance().setHistory(h.first, h.second);
+#endif
+    Size generation = 0;
+    for (;;) {
+        {
+            std::unique_lock<std::mutex> lock(mutex_);
+            start_.wait(lock, [this, generation] { return stop_ || generation_ != generation; });
+            if (stop_)
+                return;
+            generation = generation_;
+            applySettings();
+        }
+        process();
+        {
+            std::lock_guard<std::mutex> lock(mutex_);
+            --active_;
+        }
+        done_.notify_one();
+    }
+}
+
+void WorkerPool::process() {
+    for (;;) {
+        Size i;
+        {
+            std::lock_guard<std::mutex> lock(mutex_);
+            if (next_ >= n_ || error_)
+                return;
+            i = next_++;
+        }
+        try {
+            (*task_)(i);
+        } catch (...) {
+            std::lock_guard<std::mutex> lock(mutex_);
+            if (!error_)
+                error_ = std::current_exception();
+        }
+    }
+}
+
+} // namespace QuantExt
@@ -0,0 +1,113 @@
+/*
+ Copyright (C) 2023 Quaternion Risk Management Ltd
+ All rights reserved.
+
+ This file is part of ORE, a free-software/open-source library
+ for transparent pricing and risk analysis - http://opensourcerisk.org
+
+ ORE is free software: you can redistribute it and/or modify it
+ under the terms of the Modified BSD License.  You should have received a
+ copy of the license along with this program.
+ The license is also available online at <http://opensourcerisk.org>
+
+ This program is distributed on the basis that it will form a useful
+ contribution to risk analytics and model standardisation, but WITHOUT
+ ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ FITNESS FOR A PARTICULAR PURPOSE. See the license for more details.
+*/
+
+/*! \file qle/utilities/workerpool.hpp
+    \brief fixed set of worker threads executing indexed tasks
+*/
+
+#pragma once
+
+#include <ql/time/date.hpp>
+#include <ql/timeseries.hpp>
+#include <ql/types.hpp>
+
+#include <boost/optional.hpp>
+
+#include <condition_variable>
+#include <exception>
+#include <functional>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+namespace QuantExt {
+
+//! Fixed set of worker threads executing indexed tasks together with the calling thread
+/*! The pool uses threads - 1 worker threads, which are started on construction and joined on destruction, and the
+    thread calling run(). run(n, task) executes task(i) for i = 0, ..., n - 1 and returns when all tasks are finished.
+    If a task throws, no further tasks are started and the first exception is rethrown in the calling thread.
+
+    The worker threads are taken from a process wide budget of hardware concurrency - 1 threads, see
+    ThreadReservation, so the pool can have less threads than requested. A pool should therefore be created once and
+    reused for many calls to run().
+
+    If QL_ENABLE_SESSIONS is defined, the QuantLib singletons are thread local. In this case the workers copy the
+    IndexManager histories of the thread constructing the pool and the Settings of the thread calling run(), so that
+    the tasks see the same evaluation date and fixings. Fixings added after the construction of the pool and other
+    thread local singletons are not copied.
+
+    The tasks must be safe to run concurrently. In particular they should not trigger the calculation of lazy objects
+    or modify shared caches, i.e. these calculations must be triggered on the calling thread before run() is called.
+*/
+class WorkerPool {
+public:
+    //! Reservation of threads from the process wide budget of hardware concurrency - 1 threads
+    /*! The budget does not include the thread creating the reservation. The number of granted threads can be lower
+        than the requested number, it is zero if the budget is exhausted. The threads are released on destruction.
+        Code running threads that are not part of a worker pool (e.g. a multi-threaded valuation engine) should
+        reserve these, so that the worker pools created from within these threads do not oversubscribe the cores.
+     */
+    class ThreadReservation {
+    public:
+        explicit ThreadReservation(const QuantLib::Size threads);
+        ~ThreadReservation();
+        ThreadReservation(const ThreadReservation&) = delete;
+        ThreadReservation& operator=(const ThreadReservation&) = delete;
+        //! number of granted threads
+        QuantLib::Size threads() const { return threads_; }
+
+    private:
+        QuantLib::Size threads_;
+    };
+
+    //! threads is the requested total number of threads including the calling thread
+    explicit WorkerPool(const QuantLib::Size threads);
+    ~WorkerPool();
+    WorkerPool(const WorkerPool&) = delete;
+    WorkerPool& operator=(const WorkerPool&) = delete;
+
+    //! total number of threads including the calling thread
+    QuantLib::Size threads() const { return workers_.size() + 1; }
+    //! run task(i) for i = 0, ..., n - 1, blocks until all tasks are finished
+    void run(const QuantLib::Size n, const std::function<void(QuantLib::Size)>& task);
+
+private:
+    void work();
+    void process();
+    void applySettings() const;
+
+    ThreadReservation reservation_;
+    std::vector<std::thread> workers_;
+    std::mutex mutex_;
+    std::condition_variable start_, done_;
+    const std::function<void(QuantLib::Size)>* task_ = nullptr;
+    QuantLib::Size n_ = 0, next_ = 0, active_ = 0, generation_ = 0;
+    bool stop_ = false;
+    std::exception_ptr error_;
+
+#ifdef QL_ENABLE_SESSIONS
+    // global state of the constructing (histories) and running (settings) thread to be copied to the workers
+    QuantLib::Date evaluationDate_;
+    bool includeReferenceDateEvents_, enforcesTodaysHistoricFixings_;
+    boost::optional<bool> includeTodaysCashFlows_;
+    std::vector<std::pair<std::string, QuantLib::TimeSeries<QuantLib::Real>>> histories_;
+#endif
+};
+
+} // namespace QuantExt
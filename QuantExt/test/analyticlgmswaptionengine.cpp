@@ -70,10 +70,13 @@
 #include <qle/pricingengines/paymentdiscountingengine.hpp>
 
 #include <ql/currencies/europe.hpp>
+#include <ql/indexes/ibor/euribor.hpp>
 #include <ql/indexes/swap/euriborswap.hpp>
 #include <ql/instruments/makeswaption.hpp>
 #include <ql/math/array.hpp>
 #include <ql/math/comparison.hpp>
+#include <ql/math/optimization/levenbergmarquardt.hpp>
+#include <ql/models/shortrate/calibrationhelpers/swaptionhelper.hpp>
 #include <ql/models/shortrate/onefactormodels/gsr.hpp>
 #include <ql/pricingengines/swap/discountingswapengine.hpp>
 #include <ql/pricingengines/swaption/fdhullwhiteswaptionengine.hpp>
@@ -568,6 +571,104 @@ BOOST_AUTO_TEST_CASE(testLgmInvariances) {
     }
 } // testInvariances
 
+BOOST_AUTO_TEST_CASE(testZetaDerivative) {
+
+    BOOST_TEST_MESSAGE("Testing zeta derivative in the analytic LGM swaption engine...");
+
+    Handle<YieldTermStructure> discountingCurve(
+        boost::make_shared<FlatForward>(0, NullCalendar(), 0.03, Actual365Fixed()));
+    Handle<YieldTermStructure> forwardingCurve(
+        boost::make_shared<FlatForward>(0, NullCalendar(), 0.04, Actual365Fixed()));
+
+    boost::shared_ptr<SwapIndex> index =
+        boost::make_shared<EuriborSwapIsdaFixA>(10 * Years, forwardingCurve, discountingCurve);
+
+    Real strikes[] = { 0.02, 0.04, 0.06 };
+    Real kappas[] = { -0.02, 0.0, 0.03 };
+
+    for (Size i = 0; i < LENGTH(strikes); ++i) {
+        for (Size j = 0; j < LENGTH(kappas); ++j) {
+            for (auto type : { VanillaSwap::Payer, VanillaSwap::Receiver }) {
+                Swaption swaption = MakeSwaption(index, 5 * Years, strikes[i]).withUnderlyingType(type);
+                Time t = discountingCurve->timeFromReference(swaption.exercise()->dates().back());
+                Real alpha = 0.01, h = 1.0E-6;
+                auto irlgm1f = boost::make_shared<IrLgm1fConstantParametrization>(EURCurrency(), discountingCurve,
+                                                                                  alpha, kappas[j]);
+                auto irlgm1fUp = boost::make_shared<IrLgm1fConstantParametrization>(
+                    EURCurrency(), discountingCurve, alpha + h, kappas[j]);
+                auto irlgm1fDown = boost::make_shared<IrLgm1fConstantParametrization>(
+                    EURCurrency(), discountingCurve, alpha - h, kappas[j]);
+                swaption.setPricingEngine(boost::make_shared<AnalyticLgmSwaptionEngine>(irlgm1f));
+                Real analytic = swaption.result<Real>("zetaDerivative");
+                swaption.setPricingEngine(boost::make_shared<AnalyticLgmSwaptionEngine>(irlgm1fUp));
+                Real npvUp = swaption.NPV();
+                swaption.setPricingEngine(boost::make_shared<AnalyticLgmSwaptionEngine>(irlgm1fDown));
+                Real npvDown = swaption.NPV();
+                Real numeric = (npvUp - npvDown) / (irlgm1fUp->zeta(t) - irlgm1fDown->zeta(t));
+                BOOST_CHECK_CLOSE(analytic, numeric, 1.0E-4);
+            }
+        }
+    }
+} // testZetaDerivative
+
+BOOST_AUTO_TEST_CASE(testNewtonCalibration) {
+
+    BOOST_TEST_MESSAGE("Testing LGM volatility calibration with Newton iteration...");
+
+    Handle<YieldTermStructure> yts(boost::make_shared<FlatForward>(0, TARGET(), 0.02, Actual365Fixed()));
+    boost::shared_ptr<IborIndex> euribor6m = boost::make_shared<Euribor>(6 * Months, yts);
+
+    // coterminal basket 1y-9y, 2y-8y, ... 9y-1y
+
+    std::vector<boost::shared_ptr<BlackCalibrationHelper>> basket;
+    Real impliedVols[] = { 0.4, 0.39, 0.38, 0.35, 0.35, 0.34, 0.33, 0.32, 0.31 };
+    Array stepTimes(8);
+    for (Size i = 0; i < 9; ++i) {
+        auto helper = boost::make_shared<SwaptionHelper>(
+            (i + 1) * Years, (9 - i) * Years, Handle<Quote>(boost::make_shared<SimpleQuote>(impliedVols[i])),
+            euribor6m, 1 * Years, Thirty360(Thirty360::BondBasis), Actual360(), yts);
+        basket.push_back(helper);
+        if (i < 8)
+            stepTimes[i] = yts->timeFromReference(helper->swaption()->exercise()->dates().back());
+    }
+
+    auto lgm_p1 = boost::make_shared<IrLgm1fPiecewiseConstantParametrization>(
+        EURCurrency(), yts, stepTimes, Array(9, 0.0050), Array(), Array(1, 0.01));
+    auto lgm_p2 = boost::make_shared<IrLgm1fPiecewiseConstantParametrization>(
+        EURCurrency(), yts, stepTimes, Array(9, 0.0050), Array(), Array(1, 0.01));
+    auto lgm1 = boost::make_shared<LinearGaussMarkovModel>(lgm_p1);
+    auto lgm2 = boost::make_shared<LinearGaussMarkovModel>(lgm_p2);
+
+    LevenbergMarquardt lm(1E-8, 1E-8, 1E-8);
+    EndCriteria ec(1000, 500, 1E-8, 1E-8, 1E-8);
+
+    for (auto const& h : basket)
+        h->setPricingEngine(boost::make_shared<AnalyticLgmSwaptionEngine>(lgm1));
+    lgm1->calibrateVolatilitiesIterative(basket, lm, ec);
+    Size optimizerEvaluations = lgm1->functionEvaluations();
+
+    for (auto const& h : basket)
+        h->setPricingEngine(boost::make_shared<AnalyticLgmSwaptionEngine>(lgm2));
+    Size fallbacks = lgm2->calibrateVolatilitiesIterativeNewton(basket, lm, ec);
+    Size newtonEvaluations = lgm2->functionEvaluations();
+
+    BOOST_CHECK_EQUAL(fallbacks, 0);
+    BOOST_TEST_MESSAGE("function evaluations: optimizer " << optimizerEvaluations << ", newton "
+                                                          << newtonEvaluations);
+    BOOST_CHECK(newtonEvaluations < optimizerEvaluations);
+
+    Array alpha1 = lgm_p1->parameterValues(0), alpha2 = lgm_p2->parameterValues(0);
+    for (Size i = 0; i < basket.size(); ++i) {
+        BOOST_CHECK_SMALL(basket[i]->modelValue() - basket[i]->marketValue(), 1.0E-8);
+        BOOST_CHECK_CLOSE(alpha1[i], alpha2[i], 1.0E-4);
+    }
+
+    // a second calibration starting from the calibrated parameters should converge immediately
+    lgm2->resetFunctionEvaluations();
+    lgm2->calibrateVolatilitiesIterativeNewton(basket, lm, ec);
+    BOOST_CHECK_EQUAL(lgm2->functionEvaluations(), basket.size());
+} // testNewtonCalibration
+
 BOOST_AUTO_TEST_SUITE_END()
 
 BOOST_AUTO_TEST_SUITE_END()
@@ -0,0 +1,111 @@
+/*
+ Copyright (C) 2023 Quaternion Risk Management Ltd
+ All rights reserved.
+
+ This file is part of ORE, a free-software/open-source library
+ for transparent pricing and risk analysis - http://opensourcerisk.org
+
+ ORE is free software: you can redistribute it and/or modify it
+ under the terms of the Modified BSD License.  You should have received a
+ copy of the license along with this program.
+ The license is also available online at <http://opensourcerisk.org>
+
+ This program is distributed on the basis that it will form a useful
+ contribution to risk analytics and model standardisation, but WITHOUT
+ ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ FITNESS FOR A PARTICULAR PURPOSE. See the license for more details.
+*/
+
+#include "toplevelfixture.hpp"
+#include <boost/test/unit_test.hpp>
+#include <ql/indexes/ibor/euribor.hpp>
+#include <ql/instruments/makevanillaswap.hpp>
+#include <ql/quotes/simplequote.hpp>
+#include <ql/time/calendars/target.hpp>
+#include <ql/time/daycounters/actual365fixed.hpp>
+#include <qle/pricingengines/batchswappricer.hpp>
+#include <qle/pricingengines/discountingswapenginemulticurve.hpp>
+#include <qle/termstructures/interpolateddiscountcurve2.hpp>
+
+using namespace boost::unit_test_framework;
+using namespace QuantLib;
+using std::vector;
+
+BOOST_FIXTURE_TEST_SUITE(QuantExtTestSuite, qle::test::TopLevelFixture)
+
+BOOST_AUTO_TEST_SUITE(BatchSwapPricerTest)
+
+BOOST_AUTO_TEST_CASE(testBatchSwapPricer) {
+
+    BOOST_TEST_MESSAGE("Testing batch swap pricer against DiscountingSwapEngineMultiCurve...");
+
+    SavedSettings backup;
+    Date today(1, Dec, 2015);
+    Settings::instance().evaluationDate() = today;
+    DayCounter dc = Actual365Fixed();
+
+    vector<Time> pillars{0.0, 0.25, 0.5, 1.0, 2.0, 5.0, 10.0, 20.0, 30.0};
+    vector<Handle<Quote>> quotes, fwdQuotes;
+    vector<boost::shared_ptr<SimpleQuote>> fwdSimpleQuotes;
+    for (Size i = 0; i < pillars.size(); ++i) {
+        quotes.push_back(Handle<Quote>(boost::make_shared<SimpleQuote>(std::exp(-(0.01 + 0.002 * i) * pillars[i]))));
+        fwdSimpleQuotes.push_back(boost::make_shared<SimpleQuote>(std::exp(-(0.015 + 0.001 * i) * pillars[i])));
+        fwdQuotes.push_back(Handle<Quote>(fwdSimpleQuotes.back()));
+    }
+    Handle<YieldTermStructure> discount(
+        boost::make_shared<QuantExt::InterpolatedDiscountCurve2>(pillars, quotes, dc));
+    Handle<YieldTermStructure> forward(
+        boost::make_shared<QuantExt::InterpolatedDiscountCurve2>(pillars, fwdQuotes, dc));
+    discount->enableExtrapolation();
+    forward->enableExtrapolation();
+
+    auto euribor6m = boost::make_shared<Euribor6M>(forward);
+    auto euribor3m = boost::make_shared<Euribor3M>(forward);
+    // same index with a day counter different from the coupon day counter
+    auto euribor3mAct365 = boost::make_shared<IborIndex>("EUR-EURIBOR-ACT365", 3 * Months, 2, EURCurrency(),
+                                                         TARGET(), ModifiedFollowing, false, dc, forward);
+    for (auto const& index : vector<boost::shared_ptr<IborIndex>>{euribor6m, euribor3m, euribor3mAct365}) {
+        index->clearFixings();
+        for (Date d = today - 1 * Years; d <= today; ++d)
+            if (index->isValidFixingDate(d))
+                index->addFixing(d, 0.01);
+    }
+
+    // spot and forward starting, seasoned, payer and receiver swaps, one swap with a single coupon floating leg
+    vector<boost::shared_ptr<VanillaSwap>> swaps;
+    swaps.push_back(MakeVanillaSwap(10 * Years, euribor6m, 0.02));
+    swaps.push_back(MakeVanillaSwap(5 * Years, euribor3m, 0.015, 2 * Years)
+                        .withType(VanillaSwap::Receiver)
+                        .withFloatingLegSpread(0.001));
+    swaps.push_back(MakeVanillaSwap(20 * Years, euribor6m, 0.025)
+                        .withEffectiveDate(today - 9 * Months)
+                        .withNominal(3.0E6));
+    swaps.push_back(MakeVanillaSwap(7 * Years, euribor3mAct365, 0.018).withEffectiveDate(today - 1 * Months));
+    swaps.push_back(MakeVanillaSwap(3 * Months, euribor3m, 0.01).withType(VanillaSwap::Receiver));
+
+    auto engine = boost::make_shared<QuantExt::DiscountingSwapEngineMultiCurve>(discount);
+    QuantExt::BatchSwapPricer pricer(discount);
+    for (auto const& s : swaps) {
+        s->setPricingEngine(engine);
+        BOOST_CHECK_EQUAL(pricer.add(*s), pricer.size() - 1);
+    }
+    BOOST_CHECK_EQUAL(pricer.size(), swaps.size());
+
+    // check npvs for several forward curve scenarios
+    vector<Real> npvs;
+    for (Size k = 0; k < 3; ++k) {
+        for (Size i = 0; i < pillars.size(); ++i)
+            fwdSimpleQuotes[i]->setValue(std::exp(-(0.015 + 0.001 * i + 0.005 * k) * pillars[i]));
+        pricer.npvs(npvs);
+        BOOST_REQUIRE_EQUAL(npvs.size(), swaps.size());
+        for (Size i = 0; i < swaps.size(); ++i) {
+            BOOST_TEST_MESSAGE("scenario " << k << " swap " << i << ": " << npvs[i] << " (expected "
+                                           << swaps[i]->NPV() << ")");
+            BOOST_CHECK_CLOSE(npvs[i], swaps[i]->NPV(), 1e-10);
+        }
+    }
+}
+
+BOOST_AUTO_TEST_SUITE_END()
+
+BOOST_AUTO_TEST_SUITE_END()
@@ -20,14 +20,19 @@
 #include <boost/make_shared.hpp>
 #include <boost/test/unit_test.hpp>
 #include <ql/currencies/all.hpp>
+#include <ql/indexes/ibor/eonia.hpp>
 #include <ql/indexes/indexmanager.hpp>
 #include <ql/quotes/simplequote.hpp>
 #include <ql/termstructures/yield/flatforward.hpp>
 #include <ql/time/calendars/target.hpp>
+#include <ql/time/daycounters/actual360.hpp>
 #include <ql/time/daycounters/actualactual.hpp>
+#include <qle/cashflows/averageonindexedcoupon.hpp>
+#include <qle/cashflows/averageonindexedcouponpricer.hpp>
 #include <qle/cashflows/equitycoupon.hpp>
 #include <qle/cashflows/equitycouponpricer.hpp>
 #include <qle/cashflows/fxlinkedcashflow.hpp>
+#include <qle/cashflows/overnightindexedcoupon.hpp>
 
 using namespace QuantLib;
 using namespace QuantExt;
@@ -197,6 +202,78 @@ BOOST_AUTO_TEST_CASE(testEquityCoupon) {
     BOOST_CHECK_CLOSE(eq5.amount(), expectedAmount, 1e-10);
 }
 
+BOOST_AUTO_TEST_CASE(testOvernightCouponKnownFixings) {
+
+    BOOST_TEST_MESSAGE("Testing overnight coupons with past fixings and batch forecasting");
+
+    Date today(15, Jan, 2020);
+    Settings::instance().evaluationDate() = today;
+
+    Handle<YieldTermStructure> curve(boost::make_shared<FlatForward>(today, 0.02, Actual360()));
+    auto index = boost::make_shared<Eonia>(curve);
+
+    Date start(2, Jan, 2020), end(3, Feb, 2020);
+    OvernightIndexedCoupon on(end, 1.0, start, end, index);
+    AverageONIndexedCoupon avg(end, 1.0, start, end, index);
+    avg.setPricer(boost::make_shared<AverageONIndexedCouponPricer>(AverageONIndexedCouponPricer::None));
+
+    const std::vector<Date>& fixingDates = on.fixingDates();
+    const std::vector<Time>& dt = on.dt();
+
+    // a missing past fixing must be reported
+    BOOST_CHECK_THROW(on.rate(), Error);
+
+    // add the past fixings
+    for (Size i = 0; i < fixingDates.size() && fixingDates[i] < today; ++i)
+        index->addFixing(fixingDates[i], 0.01 + 0.0001 * i);
+
+    auto expectedRates = [&index, &fixingDates, &dt, &on, &today](Real& compounded, Real& averaged) {
+        Real compoundFactor = 1.0, accumulatedRate = 0.0;
+        for (Size i = 0; i < fixingDates.size(); ++i) {
+            Real f = index->fixing(fixingDates[i]);
+            accumulatedRate += f * dt[i];
+            if (fixingDates[i] <= today && index->hasHistoricalFixing(fixingDates[i]))
+                compoundFactor *= 1.0 + f * dt[i];
+            else {
+                // telescopic forecast of the remaining periods
+                compoundFactor *= index->forwardingTermStructure()->discount(on.valueDates()[i]) /
+                                  index->forwardingTermStructure()->discount(on.valueDates().back());
+                for (Size j = i + 1; j < fixingDates.size(); ++j)
+                    accumulatedRate += index->fixing(fixingDates[j]) * dt[j];
+                break;
+            }
+        }
+        Real tau = index->dayCounter().yearFraction(on.valueDates().front(), on.valueDates().back());
+        compounded = (compoundFactor - 1.0) / tau;
+        averaged = accumulatedRate / tau;
+    };
+
+    Real compounded, averaged;
+    expectedRates(compounded, averaged);
+    BOOST_CHECK_CLOSE(on.rate(), compounded, 1e-10);
+    BOOST_CHECK_CLOSE(avg.rate(), averaged, 1e-10);
+    Size nKnown = on.knownFixings().size();
+    BOOST_CHECK(nKnown > 0 && fixingDates[nKnown - 1] < today && fixingDates[nKnown] == today);
+
+    // today's fixing is used once it is available
+    index->addFixing(today, 0.015);
+    expectedRates(compounded, averaged);
+    BOOST_CHECK_EQUAL(on.knownFixings().size(), nKnown + 1);
+    BOOST_CHECK_CLOSE(on.rate(), compounded, 1e-10);
+    BOOST_CHECK_CLOSE(avg.rate(), averaged, 1e-10);
+
+    // overwriting a past fixing invalidates the cached fixings
+    index->addFixing(fixingDates.front(), 0.05, true);
+    expectedRates(compounded, averaged);
+    BOOST_CHECK_CLOSE(on.knownFixings().front(), 0.05, 1e-10);
+    BOOST_CHECK_CLOSE(on.rate(), compounded, 1e-10);
+    BOOST_CHECK_CLOSE(avg.rate(), averaged, 1e-10);
+
+    // moving the evaluation date forward turns forecasted fixings into (missing) past fixings
+    Settings::instance().evaluationDate() = TARGET().advance(today, 2, Days);
+    BOOST_CHECK_THROW(on.rate(), Error);
+}
+
 BOOST_AUTO_TEST_SUITE_END()
 
 BOOST_AUTO_TEST_SUITE_END()
@@ -26,6 +26,7 @@
 #include <qle/models/cdsoptionhelper.hpp>
 #include <qle/models/cirppconstantfellerparametrization.hpp>
 #include <qle/models/commodityschwartzmodel.hpp>
+#include <qle/models/lgmconvolutionsolver2.hpp>
 #include <qle/models/commodityschwartzparametrization.hpp>
 #include <qle/models/cpicapfloorhelper.hpp>
 #include <qle/models/crlgm1fparametrization.hpp>
@@ -298,6 +299,59 @@ BOOST_AUTO_TEST_CASE(testNonstandardBermudanSwaption) {
                     << (npv - ns_npv) << ", tolerance is " << tol);
 } // testNonstandardBermudanSwaption
 
+BOOST_AUTO_TEST_CASE(testBandedConvolutionRollback) {
+
+    BOOST_TEST_MESSAGE("Testing banded rollback in LGM convolution solver against direct rollback...");
+
+    BermudanTestData d;
+
+    boost::shared_ptr<IrLgm1fParametrization> lgm_p = boost::make_shared<IrLgm1fPiecewiseConstantHullWhiteAdaptor>(
+        EURCurrency(), d.yts, d.stepTimes_a, d.sigmas_a, d.stepTimes_a, d.kappas_a);
+
+    boost::shared_ptr<LinearGaussMarkovModel> lgm = boost::make_shared<LinearGaussMarkovModel>(lgm_p);
+
+    // rollback of a test function over several intervals, including the rollback to t = 0
+
+    for (auto const& grid : std::vector<std::tuple<Real, Size, Real, Size>>{
+             {3.0, 10, 3.0, 10}, {7.0, 16, 7.0, 32}, {5.0, 40, 4.0, 8}}) {
+        LgmConvolutionSolver2 direct(lgm, std::get<0>(grid), std::get<1>(grid), std::get<2>(grid), std::get<3>(grid));
+        LgmConvolutionSolver2 banded(lgm, std::get<0>(grid), std::get<1>(grid), std::get<2>(grid), std::get<3>(grid),
+                                     LgmConvolutionSolver2::Method::Banded);
+        for (auto const& [t1, t0] :
+             std::vector<std::pair<Real, Real>>{{5.0, 4.0}, {5.0, 4.99}, {10.0, 1.0}, {3.0, 0.0}}) {
+            RandomVariable x = direct.stateGrid(t1);
+            RandomVariable v = exp(x) + max(x - RandomVariable(x.size(), 0.01), RandomVariable(x.size(), 0.0));
+            RandomVariable r1 = direct.rollback(v, t1, t0);
+            // roll back twice to check the reuse of the cached weights
+            RandomVariable r2 = banded.rollback(v, t1, t0);
+            RandomVariable r3 = banded.rollback(v * RandomVariable(v.size(), 2.0), t1, t0);
+            BOOST_REQUIRE_EQUAL(r1.size(), r2.size());
+            for (Size i = 0; i < r1.size(); ++i) {
+                BOOST_CHECK_CLOSE(r1[i], r2[i], 1.0E-10);
+                BOOST_CHECK_CLOSE(2.0 * r1[i], r3[i], 1.0E-10);
+            }
+        }
+    }
+
+    // bermudan swaption prices must agree, also after the model parameters were changed
+
+    boost::shared_ptr<PricingEngine> engine = boost::make_shared<NumericLgmSwaptionEngine>(lgm, 7.0, 16, 7.0, 32);
+    boost::shared_ptr<PricingEngine> bandedEngine = boost::make_shared<NumericLgmSwaptionEngine>(
+        lgm, 7.0, 16, 7.0, 32, Handle<YieldTermStructure>(), LgmConvolutionSolver2::Method::Banded);
+
+    for (Size k = 0; k < 2; ++k) {
+        d.swaption->setPricingEngine(engine);
+        Real npv = d.swaption->NPV();
+        d.swaption->setPricingEngine(bandedEngine);
+        Real bandedNpv = d.swaption->NPV();
+        BOOST_TEST_MESSAGE("npv direct = " << npv << ", banded = " << bandedNpv);
+        BOOST_CHECK_CLOSE(npv, bandedNpv, 1.0E-10);
+        lgm_p->shift() = 1.0;
+        lgm_p->scaling() = 2.0;
+        lgm->update();
+    }
+} // testBandedConvolutionRollback
+
 BOOST_AUTO_TEST_CASE(testLgm1fCalibration) {
 
     BOOST_TEST_MESSAGE("Testing calibration of LGM 1F model (analytic engine) "
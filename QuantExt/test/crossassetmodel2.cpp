@@ -19,6 +19,7 @@
 #include "toplevelfixture.hpp"
 #include "utilities.hpp"
 #include <boost/test/unit_test.hpp>
+#include <qle/math/gausslegendreintegral.hpp>
 #include <qle/methods/multipathgeneratorbase.hpp>
 #include <qle/models/cdsoptionhelper.hpp>
 #include <qle/models/cpicapfloorhelper.hpp>
@@ -72,6 +73,7 @@
 #include <ql/currencies/all.hpp>
 #include <ql/indexes/ibor/euribor.hpp>
 #include <ql/instruments/vanillaoption.hpp>
+#include <ql/math/integrals/simpsonintegral.hpp>
 #include <ql/math/matrixutilities/symmetricschurdecomposition.hpp>
 #include <ql/math/optimization/levenbergmarquardt.hpp>
 #include <ql/math/randomnumbers/rngtraits.hpp>
@@ -96,6 +98,7 @@
 #include <boost/accumulators/statistics/mean.hpp>
 #include <boost/accumulators/statistics/stats.hpp>
 #include <boost/accumulators/statistics/variates/covariate.hpp>
+#include <boost/timer/timer.hpp>
 
 using namespace QuantLib;
 using namespace QuantExt;
@@ -1301,6 +1304,147 @@ BOOST_AUTO_TEST_CASE(testLgm31fMartingaleProperty) {
 
 } // testLgm13fMartingaleProperty
 
+BOOST_AUTO_TEST_CASE(testLgm31fPiecewiseIntegration) {
+
+    BOOST_TEST_MESSAGE("Check closed form piecewise integration against adaptive integration in "
+                       "Ccy LGM 31F model...");
+
+    Lgm31fTestData d;
+
+    boost::shared_ptr<StochasticProcess> p_exact = d.xmodelExact->stateProcess();
+    Array x0 = p_exact->initialValues();
+    TimeGrid grid(50.0, 100);
+
+    auto moments = [&p_exact, &x0, &grid](std::vector<Array>& e, std::vector<Matrix>& v) {
+        for (Size i = 1; i < grid.size(); ++i) {
+            e.push_back(p_exact->expectation(grid[i - 1], x0, grid.dt(i - 1)));
+            v.push_back(p_exact->covariance(grid[i - 1], x0, grid.dt(i - 1)));
+        }
+    };
+
+    // opt in to the fixed order gauss legendre rule on the pieces between the parameter times
+    d.xmodelExact->setIntegrationPolicy(boost::make_shared<GaussLegendreIntegral>(16), true);
+    std::vector<Array> e_gl;
+    std::vector<Matrix> v_gl;
+    boost::timer::cpu_timer timer;
+    moments(e_gl, v_gl);
+    timer.stop();
+    Real t_gl = timer.elapsed().wall * 1e-6;
+
+    // adaptive simpson integration as reference
+    d.xmodelExact->setIntegrationPolicy(boost::make_shared<SimpsonIntegral>(1.0E-10, 100), true);
+    std::vector<Array> e_si;
+    std::vector<Matrix> v_si;
+    timer.start();
+    moments(e_si, v_si);
+    timer.stop();
+    Real t_si = timer.elapsed().wall * 1e-6;
+
+    BOOST_TEST_MESSAGE("timing moments on " << grid.size() - 1 << " steps: gauss legendre " << t_gl
+                                            << " ms, simpson " << t_si << " ms");
+
+    Real tol = 1.0E-9;
+    for (Size k = 0; k < e_gl.size(); ++k) {
+        for (Size i = 0; i < e_gl[k].size(); ++i) {
+            if (std::fabs(e_gl[k][i] - e_si[k][i]) > tol) {
+                BOOST_ERROR("expectation at step " << k << ", index " << i << " (" << e_gl[k][i]
+                                                   << ") differs from adaptive integration (" << e_si[k][i]
+                                                   << "), tolerance is " << tol);
+            }
+            for (Size j = 0; j <= i; ++j) {
+                if (std::fabs(v_gl[k][i][j] - v_si[k][i][j]) > tol) {
+                    BOOST_ERROR("covariance at step " << k << ", index (" << i << "," << j << ") ("
+                                                      << v_gl[k][i][j] << ") differs from adaptive integration ("
+                                                      << v_si[k][i][j] << "), tolerance is " << tol);
+                }
+            }
+        }
+    }
+
+} // testLgm31fPiecewiseIntegration
+
+BOOST_AUTO_TEST_CASE(testLgm31fEvolveCache) {
+
+    BOOST_TEST_MESSAGE("Check time step cache and its invalidation in Ccy LGM 31F model...");
+
+    Lgm31fTestData d;
+
+    auto p_exact = d.xmodelExact->stateProcess();
+    TimeGrid grid(10.0, 40);
+    Size paths = 200;
+    Size seed = 42;
+
+    auto simulate = [&p_exact, paths, seed](std::vector<Array>& states, const TimeGrid& grid) {
+        MultiPathGeneratorSobolBrownianBridge pgen(p_exact, grid, SobolBrownianGenerator::Steps, seed);
+        states.clear();
+        boost::timer::cpu_timer timer;
+        for (Size i = 0; i < paths; ++i) {
+            Sample<MultiPath> path = pgen.next();
+            Array s(path.value.assetNumber());
+            for (Size j = 0; j < s.size(); ++j)
+                s[j] = path.value[j].back();
+            states.push_back(s);
+        }
+        timer.stop();
+        return timer.elapsed().wall * 1e-6;
+    };
+
+    auto check = [](const std::vector<Array>& s1, const std::vector<Array>& s2, const std::string& label) {
+        for (Size i = 0; i < s1.size(); ++i) {
+            for (Size j = 0; j < s1[i].size(); ++j) {
+                if (!close_enough(s1[i][j], s2[i][j])) {
+                    BOOST_ERROR(label << ": state " << j << " on path " << i << " is " << s1[i][j]
+                                      << ", expected " << s2[i][j]);
+                }
+            }
+        }
+    };
+
+    std::vector<Array> noCache, cache;
+
+    p_exact->resetCache(0);
+    Real t_noCache = simulate(noCache, grid);
+    p_exact->resetCache(grid.size() - 1);
+    Real t_cache = simulate(cache, grid);
+
+    BOOST_TEST_MESSAGE("timing evolve " << d.xmodelExact->components(CrossAssetModel::AssetType::IR)
+                                        << " ccys, " << paths << " paths, " << grid.size() - 1
+                                        << " steps: without cache " << t_noCache << " ms, with cache " << t_cache
+                                        << " ms");
+
+    check(cache, noCache, "cached evolve");
+
+    // a parameter update invalidates the cache, but keeps it enabled
+
+    Real rho = d.xmodelExact->correlation(CrossAssetModel::AssetType::IR, 0, CrossAssetModel::AssetType::IR, 1);
+    d.xmodelExact->setCorrelation(CrossAssetModel::AssetType::IR, 0, CrossAssetModel::AssetType::IR, 1, 0.9 * rho);
+
+    std::vector<Array> cacheUpdated, noCacheUpdated;
+    simulate(cacheUpdated, grid);
+    p_exact->resetCache(0);
+    simulate(noCacheUpdated, grid);
+
+    check(cacheUpdated, noCacheUpdated, "cached evolve after correlation update");
+
+    // the cache holds at most the given number of time steps and is cleared when evolving on a longer grid
+
+    TimeGrid grid2(10.0, 65);
+    std::vector<Array> cacheGrid2, noCacheGrid2;
+    p_exact->resetCache(grid.size() - 1);
+    simulate(cacheGrid2, grid2);
+    p_exact->resetCache(0);
+    simulate(noCacheGrid2, grid2);
+
+    check(cacheGrid2, noCacheGrid2, "cached evolve on a grid exceeding the cache size");
+
+    bool changed = false;
+    for (Size i = 0; i < cache.size() && !changed; ++i)
+        changed = !close_enough(cache[i][d.xmodelExact->pIdx(CrossAssetModel::AssetType::IR, 1)],
+                                cacheUpdated[i][d.xmodelExact->pIdx(CrossAssetModel::AssetType::IR, 1)]);
+    BOOST_CHECK_MESSAGE(changed, "correlation update did not change the simulated states");
+
+} // testLgm31fEvolveCache
+
 BOOST_AUTO_TEST_SUITE_END()
 
 BOOST_AUTO_TEST_SUITE_END()
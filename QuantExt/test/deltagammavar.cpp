@@ -317,6 +317,71 @@ BOOST_AUTO_TEST_CASE(testCase003) {
     BOOST_CHECK_CLOSE(sdvar, mcvar, 1.0);
 }
 
+BOOST_AUTO_TEST_CASE(testMultiplePortfolios) {
+
+    BOOST_TEST_MESSAGE("Testing delta gamma VaR Monte Carlo for multiple portfolios...");
+
+    // dimension larger than one tile of the blocked matrix products
+
+    Size dim = 70, paths = 10000, seed = 42;
+    MersenneTwisterUniformRng mt(17);
+    Matrix L(dim, dim, 0.0);
+    for (Size i = 0; i < dim; ++i) {
+        for (Size j = 0; j < dim; ++j) {
+            L[i][j] = mt.nextReal();
+        }
+    }
+    Matrix omega = transpose(L) * L;
+    omega /= QuantExt::detail::absMax(omega) * 10.0;
+
+    // a delta only portfolio, a delta-gamma portfolio and a portfolio without sensitivities
+
+    std::vector<Array> deltas(3, Array(dim, 0.0));
+    std::vector<Matrix> gammas(3, Matrix(dim, dim, 0.0));
+    for (Size i = 0; i < dim; ++i) {
+        deltas[0][i] = mt.nextReal() * 1000.0 - 500.0;
+        deltas[1][i] = mt.nextReal() * 1000.0 - 500.0;
+        for (Size j = 0; j < i; ++j)
+            gammas[1][i][j] = gammas[1][j][i] = mt.nextReal() * 1000.0 - 500.0;
+        gammas[1][i][i] = mt.nextReal() * 1000.0;
+    }
+
+    std::vector<Real> quantiles = {0.9, 0.99, 0.999};
+
+    // reference values from a path by path simulation
+
+    Matrix C = CholeskyDecomposition(omega, true);
+    PseudoRandom::rsg_type rng = PseudoRandom::make_sequence_generator(dim, seed);
+    std::vector<std::vector<Real>> pl(2, std::vector<Real>(paths));
+    for (Size k = 0; k < paths; ++k) {
+        std::vector<Real> seq = rng.nextSequence().value;
+        Array u = C * Array(seq.begin(), seq.end());
+        for (Size a = 0; a < 2; ++a)
+            pl[a][k] = DotProduct(u, deltas[a]) + 0.5 * DotProduct(u, gammas[a] * u);
+    }
+
+    for (auto const threads : {1, 4}) {
+        auto res = deltaGammaVarMc<PseudoRandom>(omega, deltas, gammas, quantiles, paths, seed, NoCovarianceSalvage(),
+                                                 threads);
+        BOOST_REQUIRE_EQUAL(res.size(), 3u);
+        for (Size a = 0; a < 3; ++a) {
+            BOOST_REQUIRE_EQUAL(res[a].size(), quantiles.size());
+            auto single = deltaGammaVarMc<PseudoRandom>(omega, deltas[a], gammas[a], quantiles, paths, seed);
+            for (Size q = 0; q < quantiles.size(); ++q) {
+                BOOST_CHECK_EQUAL(res[a][q], single[q]);
+                if (a == 2) {
+                    BOOST_CHECK_EQUAL(res[a][q], 0.0);
+                } else {
+                    std::vector<Real> tmp(pl[a]);
+                    std::sort(tmp.begin(), tmp.end(), std::greater<Real>());
+                    Size n = static_cast<Size>(std::ceil(static_cast<Real>(paths) * (1.0 - quantiles[q])));
+                    BOOST_CHECK_CLOSE(res[a][q], tmp[n - 1], 1.0E-8);
+                }
+            }
+        }
+    }
+}
+
 BOOST_AUTO_TEST_SUITE_END()
 
 BOOST_AUTO_TEST_SUITE_END()
@@ -18,16 +18,58 @@
 
 #include "toplevelfixture.hpp"
 #include <boost/test/unit_test.hpp>
+#include <boost/timer/timer.hpp>
+#include <ql/cashflows/cashflows.hpp>
+#include <ql/cashflows/fixedratecoupon.hpp>
+#include <ql/math/interpolations/loginterpolation.hpp>
+#include <ql/math/randomnumbers/mt19937uniformrng.hpp>
 #include <ql/quotes/simplequote.hpp>
 #include <ql/termstructures/yield/discountcurve.hpp>
+#include <ql/termstructures/yield/flatforward.hpp>
+#include <ql/time/daycounters/actual365fixed.hpp>
+#include <ql/time/schedule.hpp>
 #include <ql/time/calendars/nullcalendar.hpp>
 #include <ql/time/daycounters/actualactual.hpp>
+#include <qle/termstructures/batchdiscountcurve.hpp>
 #include <qle/termstructures/interpolateddiscountcurve2.hpp>
+#include <qle/termstructures/spreadeddiscountcurve.hpp>
 
 using namespace boost::unit_test_framework;
 using namespace QuantLib;
 using std::vector;
 
+namespace {
+
+// reference implementation of the discount factor interpolation and extrapolation using QuantLib interpolations
+Real referenceDiscount(const vector<Time>& times, const vector<Real>& dfs, const bool logLinear, const bool flatFwd,
+                       const Time t) {
+    vector<Real> data(dfs);
+    if (!logLinear) {
+        for (Size i = 0; i < times.size(); ++i)
+            data[i] = -std::log(dfs[std::max<Size>(i, 1)]) / times[std::max<Size>(i, 1)];
+    }
+    boost::shared_ptr<Interpolation> interpolation;
+    if (logLinear)
+        interpolation = boost::make_shared<LogLinearInterpolation>(times.begin(), times.end(), data.begin());
+    else
+        interpolation = boost::make_shared<LinearInterpolation>(times.begin(), times.end(), data.begin());
+    interpolation->update();
+    if (t <= times.back()) {
+        Real tmp = (*interpolation)(t, true);
+        return logLinear ? tmp : std::exp(-tmp * t);
+    }
+    Time tMax = times.back();
+    DiscountFactor dMax = logLinear ? data.back() : std::exp(-data.back() * tMax);
+    if (flatFwd) {
+        Rate instFwdMax = -interpolation->derivative(tMax) / dMax;
+        return dMax * std::exp(-instFwdMax * (t - tMax));
+    } else {
+        return std::pow(dMax, t / tMax);
+    }
+}
+
+} // namespace
+
 BOOST_FIXTURE_TEST_SUITE(QuantExtTestSuite, qle::test::TopLevelFixture)
 
 BOOST_AUTO_TEST_SUITE(DiscountCurveTest)
@@ -81,6 +123,150 @@ BOOST_AUTO_TEST_CASE(testDiscountCurve) {
     }
 }
 
+BOOST_AUTO_TEST_CASE(testBatchDiscount) {
+
+    BOOST_TEST_MESSAGE("Testing batch discount evaluation of InterpolatedDiscountCurve2 and SpreadedDiscountCurve...");
+
+    SavedSettings backup;
+    Settings::instance().evaluationDate() = Date(1, Dec, 2015);
+    DayCounter dc = Actual365Fixed();
+
+    vector<Time> pillars{0.0, 0.25, 0.5, 1.0, 2.0, 5.0, 10.0, 20.0, 30.0};
+    vector<Real> dfs, spreadDfs;
+    vector<Handle<Quote>> quotes, spreadQuotes;
+    for (Size i = 0; i < pillars.size(); ++i) {
+        dfs.push_back(std::exp(-(0.01 + 0.002 * i) * pillars[i]));
+        spreadDfs.push_back(std::exp(-(0.001 + 0.0001 * i * i) * pillars[i]));
+        quotes.push_back(Handle<Quote>(boost::make_shared<SimpleQuote>(dfs.back())));
+        spreadQuotes.push_back(Handle<Quote>(boost::make_shared<SimpleQuote>(spreadDfs.back())));
+    }
+    Handle<YieldTermStructure> reference(boost::make_shared<FlatForward>(0, NullCalendar(), 0.02, dc));
+
+    // unsorted times, pillar times, times before the first and after the last pillar
+    vector<Time> times{3.0, 0.0, 0.1, 0.25, 0.7, 1.0, 1.5, 4.9, 5.0, 10.0, 12.3, 29.9, 30.0, 31.0, 45.0, 0.3, 60.0};
+
+    for (bool logLinear : {true, false}) {
+        for (bool flatFwd : {true, false}) {
+            BOOST_TEST_MESSAGE("logLinear = " << std::boolalpha << logLinear << ", flatFwd = " << flatFwd);
+            Handle<YieldTermStructure> curve(boost::make_shared<QuantExt::InterpolatedDiscountCurve2>(
+                pillars, quotes, dc,
+                logLinear ? QuantExt::InterpolatedDiscountCurve2::Interpolation::logLinear
+                          : QuantExt::InterpolatedDiscountCurve2::Interpolation::linearZero,
+                flatFwd ? QuantExt::InterpolatedDiscountCurve2::Extrapolation::flatFwd
+                        : QuantExt::InterpolatedDiscountCurve2::Extrapolation::flatZero));
+            Handle<YieldTermStructure> spreaded(boost::make_shared<QuantExt::SpreadedDiscountCurve>(
+                reference, pillars, spreadQuotes,
+                logLinear ? QuantExt::SpreadedDiscountCurve::Interpolation::logLinear
+                          : QuantExt::SpreadedDiscountCurve::Interpolation::linearZero,
+                flatFwd ? QuantExt::SpreadedDiscountCurve::Extrapolation::flatFwd
+                        : QuantExt::SpreadedDiscountCurve::Extrapolation::flatZero));
+            curve->enableExtrapolation();
+            spreaded->enableExtrapolation();
+
+            vector<DiscountFactor> batch, spreadedBatch;
+            QuantExt::discounts(curve, times, batch);
+            QuantExt::discounts(spreaded, times, spreadedBatch);
+            BOOST_REQUIRE_EQUAL(batch.size(), times.size());
+            BOOST_REQUIRE_EQUAL(spreadedBatch.size(), times.size());
+
+            for (Size i = 0; i < times.size(); ++i) {
+                Real expected = referenceDiscount(pillars, dfs, logLinear, flatFwd, times[i]);
+                Real expectedSpreaded =
+                    reference->discount(times[i]) * referenceDiscount(pillars, spreadDfs, logLinear, flatFwd, times[i]);
+                BOOST_CHECK_CLOSE(curve->discount(times[i]), expected, 1e-10);
+                BOOST_CHECK_CLOSE(batch[i], expected, 1e-10);
+                BOOST_CHECK_CLOSE(spreaded->discount(times[i]), expectedSpreaded, 1e-10);
+                BOOST_CHECK_CLOSE(spreadedBatch[i], expectedSpreaded, 1e-10);
+            }
+
+            // forward rates
+            vector<Time> t1{0.0, 0.5, 2.5, 29.0}, t2{0.25, 1.0, 7.5, 40.0};
+            vector<Rate> fwds;
+            QuantExt::forwardRates(curve, t1, t2, fwds);
+            for (Size i = 0; i < t1.size(); ++i)
+                BOOST_CHECK_CLOSE(fwds[i], curve->forwardRate(t1[i], t2[i], Simple).rate(), 1e-10);
+
+            // batch npv and bps of a fixed leg against QuantLib's CashFlows::npvbps()
+            Date today = Settings::instance().evaluationDate();
+            Schedule schedule(today - 3 * Months, today + 12 * Years, 6 * Months, NullCalendar(), Unadjusted,
+                              Unadjusted, DateGeneration::Forward, false);
+            Leg leg = FixedRateLeg(schedule).withNotionals(1.0E6).withCouponRates(0.03, dc);
+            auto expectedNpvBps = CashFlows::npvbps(leg, **spreaded, false, today, today + 2);
+            auto npvBps = QuantExt::batchNpvBps(leg, spreaded, false, today, today + 2);
+            BOOST_CHECK_CLOSE(npvBps.first, expectedNpvBps.first, 1e-10);
+            BOOST_CHECK_CLOSE(npvBps.second, expectedNpvBps.second, 1e-10);
+        }
+    }
+
+    // range checks as for single evaluations
+    Handle<YieldTermStructure> curve(boost::make_shared<QuantExt::InterpolatedDiscountCurve2>(pillars, quotes, dc));
+    vector<DiscountFactor> result;
+    BOOST_CHECK_THROW(QuantExt::discounts(curve, vector<Time>{1.0, -0.5}, result), QuantLib::Error);
+}
+
+BOOST_AUTO_TEST_CASE(testBatchDiscountPerformance) {
+
+    BOOST_TEST_MESSAGE("Testing performance of batch discount evaluation per scenario...");
+
+    SavedSettings backup;
+    Settings::instance().evaluationDate() = Date(1, Dec, 2015);
+    DayCounter dc = Actual365Fixed();
+
+    // a typical simulation curve with 20 pillars, the cashflow times of a 30y quarterly swap and 1000 scenarios
+    vector<Time> pillars{0.0, 0.08, 0.25, 0.5, 0.75, 1.0, 2.0, 3.0, 4.0, 5.0,
+                         7.0, 10.0, 12.0, 15.0, 20.0, 25.0, 30.0, 40.0, 50.0, 60.0};
+    vector<boost::shared_ptr<SimpleQuote>> quotes;
+    vector<Handle<Quote>> quoteHandles;
+    for (Size i = 0; i < pillars.size(); ++i) {
+        quotes.push_back(boost::make_shared<SimpleQuote>(std::exp(-0.02 * pillars[i])));
+        quoteHandles.push_back(Handle<Quote>(quotes.back()));
+    }
+    Handle<YieldTermStructure> curve(
+        boost::make_shared<QuantExt::InterpolatedDiscountCurve2>(pillars, quoteHandles, dc));
+    vector<Time> times;
+    for (Size i = 1; i <= 120; ++i)
+        times.push_back(0.25 * i);
+    Size scenarios = 1000;
+
+    MersenneTwisterUniformRng rng(42);
+    vector<vector<Real>> rates(scenarios, vector<Real>(pillars.size()));
+    for (auto& r : rates)
+        for (auto& z : r)
+            z = 0.05 * rng.nextReal();
+
+    Real sumSingle = 0.0, sumBatch = 0.0;
+    vector<DiscountFactor> result;
+
+    boost::timer::cpu_timer timer;
+    for (Size s = 0; s < scenarios; ++s) {
+        for (Size i = 0; i < pillars.size(); ++i)
+            quotes[i]->setValue(std::exp(-rates[s][i] * pillars[i]));
+        for (auto const& t : times)
+            sumSingle += curve->discount(t);
+    }
+    timer.stop();
+    Real timeSingle = timer.elapsed().wall * 1e-6;
+
+    timer.start();
+    for (Size s = 0; s < scenarios; ++s) {
+        for (Size i = 0; i < pillars.size(); ++i)
+            quotes[i]->setValue(std::exp(-rates[s][i] * pillars[i]));
+        QuantExt::discounts(curve, times, result);
+        for (auto const& d : result)
+            sumBatch += d;
+    }
+    timer.stop();
+    Real timeBatch = timer.elapsed().wall * 1e-6;
+
+    BOOST_CHECK_CLOSE(sumSingle, sumBatch, 1e-10);
+
+    Real n = static_cast<Real>(scenarios * times.size());
+    BOOST_TEST_MESSAGE("single evaluation: " << timeSingle << " ms (" << n / timeSingle * 1E-3
+                                             << " million discount factors per second)");
+    BOOST_TEST_MESSAGE("batch evaluation : " << timeBatch << " ms (" << n / timeBatch * 1E-3
+                                             << " million discount factors per second)");
+}
+
 BOOST_AUTO_TEST_SUITE_END()
 
 BOOST_AUTO_TEST_SUITE_END()
@@ -20,6 +20,7 @@
 #include <test/toplevelfixture.hpp>
 //#include <oret/toplevelfixture.hpp>
 
+#include <qle/methods/mcpathrepository.hpp>
 #include <qle/pricingengines/mcmultilegoptionengine.hpp>
 
 #include <qle/models/crossassetmodel.hpp>
@@ -137,6 +138,95 @@ BOOST_FIXTURE_TEST_CASE(testBermudanSwaption, BermudanTestData) {
 
 } // testBermudanSwaption
 
+BOOST_FIXTURE_TEST_CASE(testBermudanSwaptionSharedPaths, BermudanTestData) {
+
+    BOOST_TEST_MESSAGE("Testing pricing of bermudan swaptions as multi leg options with shared calibration paths");
+
+    auto lgm_p = boost::make_shared<IrLgm1fPiecewiseConstantHullWhiteAdaptor>(EURCurrency(), yts, stepTimes_a, sigmas_a,
+                                                                              stepTimes_a, kappas_a);
+    auto xasset = Handle<CrossAssetModel>(
+        boost::make_shared<CrossAssetModel>(std::vector<boost::shared_ptr<Parametrization>>{lgm_p}));
+
+    auto price = [this, &xasset]() {
+        auto multiLegOption = boost::make_shared<MultiLegOption>(
+            std::vector<Leg>{underlying->leg(0), underlying->leg(1)}, std::vector<bool>{true, false},
+            std::vector<Currency>{EURCurrency(), EURCurrency()}, exercise);
+        multiLegOption->setPricingEngine(boost::make_shared<McMultiLegOptionEngine>(
+            xasset, SobolBrownianBridge, SobolBrownianBridge, 5000, 0, 42, 42, 4, LsmBasisSystem::Monomial));
+        return multiLegOption->NPV();
+    };
+
+    // reference price without repository
+
+    McPathRepository::instance().clear();
+    McPathRepository::instance().setMaxSize(0);
+    Real npv0 = price();
+
+    // two identical options priced with the repository enabled share the paths and yield the reference price
+
+    McPathRepository::instance().setMaxSize(10000000);
+    Real npv1 = price();
+    Real npv2 = price();
+    BOOST_TEST_MESSAGE("npv without repository = " << npv0 << ", with repository = " << npv1 << ", " << npv2);
+    BOOST_CHECK_EQUAL(McPathRepository::instance().misses(), 1);
+    BOOST_CHECK_EQUAL(McPathRepository::instance().hits(), 1);
+    BOOST_CHECK_CLOSE(npv0, npv1, 1E-10);
+    BOOST_CHECK_CLOSE(npv0, npv2, 1E-10);
+
+    // a change in the model invalidates the stored paths
+
+    BOOST_CHECK(McPathRepository::instance().size() > 0);
+    xasset->update();
+    BOOST_CHECK_EQUAL(McPathRepository::instance().size(), 0);
+
+    McPathRepository::instance().clear();
+    McPathRepository::instance().setMaxSize(0);
+
+} // testBermudanSwaptionSharedPaths
+
+BOOST_FIXTURE_TEST_CASE(testBermudanSwaptionMultiThreaded, BermudanTestData) {
+
+    BOOST_TEST_MESSAGE("Testing pricing of bermudan swaptions as multi leg options with several threads per trade");
+
+    auto lgm_p = boost::make_shared<IrLgm1fPiecewiseConstantHullWhiteAdaptor>(EURCurrency(), yts, stepTimes_a, sigmas_a,
+                                                                              stepTimes_a, kappas_a);
+    auto xasset = Handle<CrossAssetModel>(
+        boost::make_shared<CrossAssetModel>(std::vector<boost::shared_ptr<Parametrization>>{lgm_p}));
+
+    // the simulation dates add xva regression models that are trained concurrently
+
+    std::vector<Date> simulationDates;
+    for (Size i = 1; i <= 20; ++i)
+        simulationDates.push_back(TARGET().advance(evalDate, 6 * i * Months));
+
+    auto multiLegOption = boost::make_shared<MultiLegOption>(
+        std::vector<Leg>{underlying->leg(0), underlying->leg(1)}, std::vector<bool>{true, false},
+        std::vector<Currency>{EURCurrency(), EURCurrency()}, exercise);
+
+    Real npv0 = 0.0, npvUnd0 = 0.0;
+    for (Size threads : {1, 2, 4, 7}) {
+        multiLegOption->setPricingEngine(boost::make_shared<McMultiLegOptionEngine>(
+            xasset, SobolBrownianBridge, SobolBrownianBridge, 5000, 0, 42, 42, 4, LsmBasisSystem::Monomial,
+            SobolBrownianGenerator::Steps, SobolRsg::JoeKuoD7, std::vector<Handle<YieldTermStructure>>(),
+            simulationDates, std::vector<Size>(), true, McMultiLegBaseEngine::RegressorModel::Simple, threads));
+        boost::timer::cpu_timer timer;
+        Real npv = multiLegOption->NPV();
+        Real npvUnd = multiLegOption->result<Real>("underlyingNpv");
+        timer.stop();
+        BOOST_TEST_MESSAGE("threads = " << threads << ": underlying = " << npvUnd << ", option = " << npv
+                                        << ", timing " << timer.elapsed().wall * 1e-6 << " ms");
+        if (threads == 1) {
+            npv0 = npv;
+            npvUnd0 = npvUnd;
+        } else {
+            // the results do not depend on the number of threads
+            BOOST_CHECK_CLOSE(npv, npv0, 1E-10);
+            BOOST_CHECK_CLOSE(npvUnd, npvUnd0, 1E-10);
+        }
+    }
+
+} // testBermudanSwaptionMultiThreaded
+
 BOOST_AUTO_TEST_CASE(testFxOption) {
 
     BOOST_TEST_MESSAGE("Testing pricing of fx option as multi leg option vs analytic engine");
@@ -23,9 +23,12 @@
 #include <boost/test/data/test_case.hpp>
 // clang-format on
 
+#include <qle/math/mcvariancereduction.hpp>
 #include <qle/math/randomvariable.hpp>
 
 #include <ql/time/date.hpp>
+#include <ql/math/distributions/normaldistribution.hpp>
+#include <ql/math/randomnumbers/mt19937uniformrng.hpp>
 #include <ql/pricingengines/blackformula.hpp>
 
 #include <boost/math/distributions/normal.hpp>
@@ -192,6 +195,58 @@ BOOST_AUTO_TEST_CASE(testBlack) {
     }
 }
 
+BOOST_AUTO_TEST_CASE(testVarianceReduction) {
+    BOOST_TEST_MESSAGE("Testing mc error estimates and control variates...");
+
+    // antithetic pairs of standard normal samples
+
+    const Size n = 10000;
+    const Real sigma = 0.3;
+    MersenneTwisterUniformRng mt(42);
+    InverseCumulativeNormal icn;
+    RandomVariable z(n);
+    for (Size i = 0; i < n; i += 2) {
+        Real tmp = icn(mt.nextReal());
+        z.set(i, tmp);
+        z.set(i + 1, -tmp);
+    }
+
+    // for a linear function of z the antithetic pair averages are constant
+
+    RandomVariable lin = z + RandomVariable(n, 1.0);
+    BOOST_CHECK_SMALL(mcErrorEstimate(lin, true), 1E-12);
+    BOOST_CHECK_CLOSE(mcErrorEstimate(lin, false), 1.0 / std::sqrt(static_cast<Real>(n)), 5.0);
+    BOOST_CHECK_EQUAL(mcErrorEstimate(RandomVariable(n, 1.0), false), 0.0);
+
+    // call on a lognormal variable with the lognormal variable itself as a control
+
+    RandomVariable s = exp(RandomVariable(n, sigma) * z);
+    RandomVariable call = max(s - RandomVariable(n, 1.0), RandomVariable(n, 0.0));
+    Real fwd = std::exp(0.5 * sigma * sigma);
+    Real exact = blackFormula(Option::Call, 1.0, fwd, sigma);
+
+    Real plainError = mcErrorEstimate(call, true);
+    Real cvError;
+    Real cv = controlVariateMean(call, {s}, {fwd}, true, &cvError);
+    BOOST_TEST_MESSAGE("exact " << exact << " plain " << expectation(call).at(0) << " +- " << plainError << " cv " << cv
+                                << " +- " << cvError);
+    BOOST_CHECK_SMALL(cv - exact, 3.0 * cvError);
+    BOOST_CHECK(cvError < plainError);
+
+    // without the antithetic pairing the control variate reduces the error more significantly
+
+    Real cvErrorNonAntithetic;
+    controlVariateMean(call, {s}, {fwd}, false, &cvErrorNonAntithetic);
+    BOOST_CHECK(cvErrorNonAntithetic < 0.5 * mcErrorEstimate(call, false));
+
+    // deterministic controls are ignored
+
+    Real err;
+    BOOST_CHECK_CLOSE(controlVariateMean(call, {RandomVariable(n, 2.0)}, {1.0}, true, &err), expectation(call).at(0),
+                      1E-10);
+    BOOST_CHECK_CLOSE(err, plainError, 1E-10);
+}
+
 BOOST_AUTO_TEST_SUITE_END()
 
 BOOST_AUTO_TEST_SUITE_END()